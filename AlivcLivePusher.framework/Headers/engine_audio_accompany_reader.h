@@ -0,0 +1,908 @@
+#ifndef ali_rtc_engine_audio_accompany_reader_h
+#define ali_rtc_engine_audio_accompany_reader_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine_lockfree_queue.h"
+#include "engine_interface.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 伴奏文件编码格式
+     */
+    typedef enum {
+      /** 未知 */
+      AliEngineAudioAccompanyCodecUnknown = 0,
+      /** MPEG-1/2/2.5 Layer III */
+      AliEngineAudioAccompanyCodecMp3 = 1,
+      /** ADTS 封装的 AAC */
+      AliEngineAudioAccompanyCodecAacAdts = 2,
+    } AliEngineAudioAccompanyCodec;
+
+    /**
+     * @brief 伴奏预读配置
+     */
+    typedef struct AliEngineAudioAccompanyReaderConfig {
+      /** 预读解码时长，单位：ms，默认值：500 */
+      int readAheadMs = 500;
+      /** 帧索引缓存目录，为空时每次打开都扫描文件，默认值：空 */
+      const char* indexCacheDir = nullptr;
+      /** MP3 解码器固有时延，单位：采样，仅在文件带 LAME 无缝播放信息时用于裁剪首尾，默认值：529 */
+      int mp3DecoderDelay = 529;
+    } AliEngineAudioAccompanyReaderConfig;
+
+    /**
+     * @brief 伴奏预读统计信息
+     */
+    typedef struct AliEngineAudioAccompanyReaderStats {
+      /** 帧数 */
+      int frames = 0;
+      /** 帧索引是否来自磁盘缓存 */
+      bool indexFromCache = false;
+      /** 建立（或加载）帧索引耗时，单位：us */
+      long long indexUs = 0;
+      /** 最近一次跳转从调用到新位置数据就绪的耗时，单位：us */
+      long long lastSeekUs = 0;
+      /** 读取时预读数据不足的次数 */
+      unsigned long long underruns = 0;
+      /** 解码失败的帧数，失败的帧以静音代替 */
+      unsigned long long decodeErrors = 0;
+    } AliEngineAudioAccompanyReaderStats;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @addtogroup AliEngineCallback 回调及监听
+     * AliRtc 回调及监听
+     * @{
+     */
+
+    /**
+     * @brief 伴奏逐帧解码接口，由业务层基于系统或第三方解码器实现
+     * @details OpenDecoder 在调用 Open 的线程调用，DecodeFrame/ResetDecoder 只在预读线程调用，CloseDecoder 在预读线程退出后调用
+     */
+    class IAliEngineAudioAccompanyDecoder {
+    public:
+      virtual ~IAliEngineAudioAccompanyDecoder() {}
+
+      /**
+       * @brief 准备解码
+       * @param codec 编码格式
+       * @param sampleRate 采样率
+       * @param channels 声道数
+       * @return true: 成功；false: 不支持
+       */
+      virtual bool OpenDecoder(AliEngineAudioAccompanyCodec codec, int sampleRate, int channels) = 0;
+
+      /**
+       * @brief 解码一帧
+       * @param frame 完整的一帧，含帧头
+       * @param size 字节数
+       * @param pcm 输出 int16 交错数据
+       * @param maxFrames pcm 可容纳的采样数（单声道）
+       * @return 输出的采样数（单声道），<0 表示失败
+       */
+      virtual int DecodeFrame(const uint8_t* frame, int size, int16_t* pcm, int maxFrames) = 0;
+
+      /**
+       * @brief 跳转前调用，清空解码器内部状态
+       */
+      virtual void ResetDecoder() {}
+
+      virtual void CloseDecoder() {}
+    };
+
+    /**
+     * @}
+     */
+
+    namespace internal {
+      /**
+       * @brief 伴奏文件的帧索引
+       */
+      struct AccompanyIndex {
+        AliEngineAudioAccompanyCodec codec = AliEngineAudioAccompanyCodecUnknown;
+        int sampleRate = 0;
+        int channels = 0;
+        int samplesPerFrame = 0;
+        /** LAME 头记录的编码器时延和尾部补齐，单位：采样 */
+        int encoderDelay = 0;
+        int encoderPadding = 0;
+        bool gapless = false;
+        std::vector<int64_t> offsets;
+        std::vector<uint16_t> sizes;
+      };
+
+      struct AccompanyFrameHeader {
+        AliEngineAudioAccompanyCodec codec;
+        int sampleRate;
+        int channels;
+        int samples;
+        int length;
+        /* MP3 版本，用于定位 Xing/Info 头 */
+        int version;
+      };
+
+      inline bool ParseMp3Header(const uint8_t* p, AccompanyFrameHeader &header)
+      {
+        static const int kBitrateV1[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+        static const int kBitrateV2[16] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 };
+        static const int kSampleRate[3] = { 44100, 48000, 32000 };
+        if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0) {
+          return false;
+        }
+        const int version = (p[1] >> 3) & 3;
+        const int layer = (p[1] >> 1) & 3;
+        const int bitrateIndex = p[2] >> 4;
+        const int rateIndex = (p[2] >> 2) & 3;
+        /* 只支持 Layer III；free format 无法从帧头得到长度 */
+        if (version == 1 || layer != 1 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3) {
+          return false;
+        }
+        const bool mpeg1 = version == 3;
+        header.codec = AliEngineAudioAccompanyCodecMp3;
+        header.sampleRate = kSampleRate[rateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+        header.channels = (p[3] >> 6) == 3 ? 1 : 2;
+        header.samples = mpeg1 ? 1152 : 576;
+        const int bitrate = (mpeg1 ? kBitrateV1 : kBitrateV2)[bitrateIndex] * 1000;
+        header.length = (mpeg1 ? 144 : 72) * bitrate / header.sampleRate + ((p[2] >> 1) & 1);
+        header.version = version;
+        return true;
+      }
+
+      inline bool ParseAdtsHeader(const uint8_t* p, AccompanyFrameHeader &header)
+      {
+        static const int kSampleRate[13] = { 96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350 };
+        if (p[0] != 0xFF || (p[1] & 0xF6) != 0xF0) {
+          return false;
+        }
+        const int rateIndex = (p[2] >> 2) & 0xF;
+        const int channels = ((p[2] & 1) << 2) | (p[3] >> 6);
+        const int length = ((p[3] & 3) << 11) | (p[4] << 3) | (p[5] >> 5);
+        const int headerLength = (p[1] & 1) ? 7 : 9;
+        if (rateIndex >= 13 || channels == 0 || length <= headerLength) {
+          return false;
+        }
+        header.codec = AliEngineAudioAccompanyCodecAacAdts;
+        header.sampleRate = kSampleRate[rateIndex];
+        header.channels = channels == 7 ? 8 : channels;
+        header.samples = 1024 * ((p[6] & 3) + 1);
+        header.length = length;
+        header.version = 0;
+        return true;
+      }
+
+      inline bool ParseFrameHeader(const uint8_t* p, AliEngineAudioAccompanyCodec codec, AccompanyFrameHeader &header)
+      {
+        if (codec != AliEngineAudioAccompanyCodecAacAdts && ParseMp3Header(p, header)) {
+          return true;
+        }
+        return codec != AliEngineAudioAccompanyCodecMp3 && ParseAdtsHeader(p, header);
+      }
+
+      /* 解析 Xing/Info 头中的 LAME 扩展（FFmpeg 以 Lavc/Lavf 写入同样的结构），得到编码器时延和尾部补齐 */
+      inline bool ParseXingFrame(const uint8_t* frame, const AccompanyFrameHeader &header, AccompanyIndex &index)
+      {
+        const int sideInfo = header.version == 3 ? (header.channels == 1 ? 17 : 32) : (header.channels == 1 ? 9 : 17);
+        const uint8_t* p = frame + 4 + sideInfo;
+        if (4 + sideInfo + 8 > header.length || (memcmp(p, "Xing", 4) != 0 && memcmp(p, "Info", 4) != 0)) {
+          return false;
+        }
+        const uint32_t flags = (static_cast<uint32_t>(p[4]) << 24) | (p[5] << 16) | (p[6] << 8) | p[7];
+        int lame = 8 + ((flags & 1) ? 4 : 0) + ((flags & 2) ? 4 : 0) + ((flags & 4) ? 100 : 0) + ((flags & 8) ? 4 : 0);
+        if (4 + sideInfo + lame + 24 <= header.length && (memcmp(p + lame, "LAME", 4) == 0 || memcmp(p + lame, "Lav", 3) == 0)) {
+          const uint8_t* gap = p + lame + 21;
+          index.encoderDelay = (gap[0] << 4) | (gap[1] >> 4);
+          index.encoderPadding = ((gap[1] & 0xF) << 8) | gap[2];
+          index.gapless = true;
+        }
+        return true;
+      }
+
+      /**
+       * @brief 扫描文件建立帧索引
+       * @details 跳过 ID3v2 标签；首个同步字需由下一帧帧头确认，避免把标签或数据中的 0xFF 误判为帧头；
+       * MP3 的 Xing/Info 帧只解析 LAME 信息，不计入索引
+       */
+      inline bool BuildAccompanyIndex(FILE* file, AccompanyIndex &index)
+      {
+        const size_t kWindow = 1 << 20;
+        /* 最长帧加上下一帧帧头 */
+        const size_t kKeep = 8192 + 16;
+        std::vector<uint8_t> buffer(kWindow);
+        size_t begin = 0;
+        size_t end = fread(&buffer[0], 1, kWindow, file);
+        int64_t base = 0;
+        bool eof = end < kWindow;
+        if (end >= 10 && memcmp(&buffer[0], "ID3", 3) == 0) {
+          const int64_t tag = 10 + ((buffer[6] & 0x7F) << 21) + ((buffer[7] & 0x7F) << 14) + ((buffer[8] & 0x7F) << 7) +
+                              (buffer[9] & 0x7F) + ((buffer[5] & 0x10) ? 10 : 0);
+          if (fseek(file, static_cast<long>(tag), SEEK_SET) != 0) {
+            return false;
+          }
+          base = tag;
+          end = fread(&buffer[0], 1, kWindow, file);
+          eof = end < kWindow;
+        }
+        bool first = true;
+        while (true) {
+          if (!eof && end - begin < kKeep) {
+            memmove(&buffer[0], &buffer[begin], end - begin);
+            base += static_cast<int64_t>(begin);
+            end -= begin;
+            begin = 0;
+            const size_t read = fread(&buffer[end], 1, kWindow - end, file);
+            end += read;
+            eof = read == 0 || end < kWindow;
+          }
+          if (end - begin < 8) {
+            break;
+          }
+          AccompanyFrameHeader header;
+          const uint8_t* p = &buffer[begin];
+          if (!ParseFrameHeader(p, index.codec, header) || (index.codec != AliEngineAudioAccompanyCodecUnknown &&
+              (header.sampleRate != index.sampleRate || header.samples != index.samplesPerFrame))) {
+            ++begin;
+            continue;
+          }
+          const size_t length = static_cast<size_t>(header.length);
+          if (length > end - begin) {
+            break;
+          }
+          /* 首帧需由下一帧帧头确认，之后只要求采样率和帧长一致 */
+          AccompanyFrameHeader next;
+          if (index.codec == AliEngineAudioAccompanyCodecUnknown && end - begin >= length + 8 &&
+              !(ParseFrameHeader(p + length, header.codec, next) && next.sampleRate == header.sampleRate)) {
+            ++begin;
+            continue;
+          }
+          if (index.codec == AliEngineAudioAccompanyCodecUnknown) {
+            index.codec = header.codec;
+            index.sampleRate = header.sampleRate;
+            index.channels = header.channels;
+            index.samplesPerFrame = header.samples;
+          }
+          if (!(first && header.codec == AliEngineAudioAccompanyCodecMp3 && ParseXingFrame(p, header, index))) {
+            index.offsets.push_back(base + static_cast<int64_t>(begin));
+            index.sizes.push_back(static_cast<uint16_t>(length));
+          }
+          first = false;
+          begin += length;
+        }
+        return !index.offsets.empty();
+      }
+    }
+
+    /**
+     * @brief 带帧索引和后台预读的伴奏读取器
+     * @details 配合 {@link IAliEngineMediaEngine::PushExternalAudioStreamRawData} 在业务层播放长时间的 MP3/AAC 伴奏，
+     * 语义与 StartAudioAccompany / SetAudioAccompanyPosition / GetAudioAccompanyCurrentPosition 一致：
+     *  - 首次打开时扫描文件建立帧索引（每帧的偏移和长度），并按 路径 + 修改时间 + 大小 缓存到 indexCacheDir，之后打开不再扫描
+     *  - 预读线程按 readAheadMs 提前解码，数据以帧为单位放入预分配的块中，通过无锁队列交给读取线程；Read 不分配内存，
+     *    只在预读线程等待空闲块时短暂加锁唤醒它，预读线程不轮询
+     *  - 跳转时二分查找目标帧，从目标帧前 1~2 帧开始解码作为预热（MP3 位池、AAC 重叠），再丢弃帧内偏移，位置精确到采样；
+     *    跳转前已预读的数据按序号丢弃，跳转后的第一块数据不会被误丢
+     *  - 循环播放由预读线程直接接到文件开头，读取端无间隙；MP3 带 LAME 无缝播放信息时裁剪编码器时延和尾部补齐
+     * @note Read 只能在一个线程调用（通常为推流线程），且不可与 Open/Close 并发；其他接口线程安全。输出为文件原始采样率和声道数，
+     * 可通过 {@link AliEngineAudioResampler} 转换
+     */
+    class AliEngineAudioAccompanyReader {
+    public:
+      /**
+       * @param decoder 解码器，需在读取器销毁前保持有效
+       * @param config 预读配置
+       */
+      explicit AliEngineAudioAccompanyReader(IAliEngineAudioAccompanyDecoder* decoder,
+                                             const AliEngineAudioAccompanyReaderConfig &config = AliEngineAudioAccompanyReaderConfig())
+        : decoder_(decoder), config_(Validate(config)), ready_(MaxChunks(config_)), free_(MaxChunks(config_))
+      {
+        config_.mp3DecoderDelay = config_.mp3DecoderDelay > 0 ? config_.mp3DecoderDelay : 0;
+        if (config_.indexCacheDir && config_.indexCacheDir[0]) {
+          cacheDir_ = config_.indexCacheDir;
+        }
+        config_.indexCacheDir = nullptr;
+        seekGen_.store(0, std::memory_order_relaxed);
+        position_.store(0, std::memory_order_relaxed);
+        ended_.store(false, std::memory_order_relaxed);
+        underruns_.store(0, std::memory_order_relaxed);
+      }
+
+      ~AliEngineAudioAccompanyReader()
+      {
+        Close();
+      }
+
+      /**
+       * @brief 只建立并缓存帧索引，可在下载完成后提前调用
+       * @return 0: 成功；AliEngineAudioAccompanyOpenFailed: 文件无法打开或不是支持的格式
+       */
+      int PrepareIndex(const char* filePath)
+      {
+        internal::AccompanyIndex index;
+        bool fromCache = false;
+        return LoadIndex(filePath, index, fromCache) ? 0 : AliEngineAudioAccompanyOpenFailed;
+      }
+
+      /**
+       * @brief 打开伴奏文件并启动预读
+       * @param filePath 文件路径
+       * @param config 使用其中的 loopCycles 和 startPosMs
+       * @return 0: 成功；AliEngineAudioAccompanyOpenFailed: 打开失败；AliEngineAudioAccompanyDecodeFailed: 解码器不支持
+       */
+      int Open(const char* filePath, const AliEngineAudioAccompanyConfig &config)
+      {
+        Close();
+        const auto start = std::chrono::steady_clock::now();
+        bool fromCache = false;
+        if (!LoadIndex(filePath, index_, fromCache) || !(file_ = fopen(filePath, "rb"))) {
+          index_ = internal::AccompanyIndex();
+          return AliEngineAudioAccompanyOpenFailed;
+        }
+        if (!decoder_ || !decoder_->OpenDecoder(index_.codec, index_.sampleRate, index_.channels)) {
+          fclose(file_);
+          file_ = nullptr;
+          index_ = internal::AccompanyIndex();
+          return AliEngineAudioAccompanyDecodeFailed;
+        }
+        stats_ = AliEngineAudioAccompanyReaderStats();
+        stats_.frames = static_cast<int>(index_.offsets.size());
+        stats_.indexFromCache = fromCache;
+        stats_.indexUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        const long long decoded = static_cast<long long>(index_.offsets.size()) * index_.samplesPerFrame;
+        startTrim_ = index_.gapless ? index_.encoderDelay + config_.mp3DecoderDelay : 0;
+        totalFrames_ = index_.gapless ? decoded - index_.encoderDelay - index_.encoderPadding : decoded;
+        totalFrames_ = totalFrames_ > 0 ? totalFrames_ : decoded;
+        loopsLeft_ = config.loopCycles == -1 || config.loopCycles > 0 ? config.loopCycles : 1;
+
+        /* 每块存放一帧的解码结果，容量留出余量以容纳解码器输出的抖动 */
+        chunkCapacity_ = index_.samplesPerFrame * 2;
+        const int chunks = static_cast<int>(std::min<long long>(static_cast<long long>(config_.readAheadMs) * index_.sampleRate /
+                                                                (1000LL * index_.samplesPerFrame) + 2, MaxChunks(config_)));
+        chunks_.assign(chunks, Chunk());
+        samples_.assign(static_cast<size_t>(chunks) * chunkCapacity_ * index_.channels, 0);
+        for (int i = 0; i < chunks; ++i) {
+          chunks_[i].samples = &samples_[static_cast<size_t>(i) * chunkCapacity_ * index_.channels];
+          free_.TryPush(i);
+        }
+        current_ = -1;
+        consumerGen_ = 0;
+        ended_.store(false, std::memory_order_relaxed);
+        underruns_.store(0, std::memory_order_relaxed);
+        readBuffer_.resize(65536);
+
+        SeekLocked(FramesFromMs(config.startPosMs));
+        running_ = true;
+        thread_ = std::thread(&AliEngineAudioAccompanyReader::ReadAheadLoop, this);
+        return 0;
+      }
+
+      /**
+       * @brief 停止预读并关闭文件
+       */
+      void Close()
+      {
+        {
+          std::lock_guard<std::mutex> guard(lock_);
+          running_ = false;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) {
+          thread_.join();
+          decoder_->CloseDecoder();
+        }
+        if (file_) {
+          fclose(file_);
+          file_ = nullptr;
+        }
+        int slot = -1;
+        while (ready_.TryPop(slot) || free_.TryPop(slot)) {
+        }
+        current_ = -1;
+      }
+
+      /**
+       * @brief 读取下一段数据，预读不足或播放结束时补零
+       * @param pcm int16 交错数据，容量 frames * Channels()
+       * @param frames 采样数（单声道）
+       * @return 有效采样数（单声道），播放结束后返回0
+       */
+      int Read(int16_t* pcm, int frames)
+      {
+        if (chunks_.empty() || !pcm || frames <= 0) {
+          return 0;
+        }
+        const int channels = index_.channels;
+        const unsigned gen = seekGen_.load(std::memory_order_acquire);
+        if (gen != consumerGen_) {
+          /* 跳转后丢弃旧序号的数据 */
+          if (current_ >= 0) {
+            ReleaseChunk(current_);
+            current_ = -1;
+          }
+          consumerGen_ = gen;
+          ended_.store(false, std::memory_order_relaxed);
+        }
+        int done = 0;
+        while (done < frames && !ended_.load(std::memory_order_relaxed)) {
+          if (current_ < 0) {
+            int next = -1;
+            if (!ready_.TryPop(next)) {
+              underruns_.fetch_add(1, std::memory_order_relaxed);
+              break;
+            }
+            if (chunks_[next].gen != consumerGen_) {
+              /* 本次调用开始后又发生了跳转：只丢弃早于最新跳转的块，最新序号的块直接使用 */
+              const unsigned latest = seekGen_.load(std::memory_order_acquire);
+              if (chunks_[next].gen != latest) {
+                ReleaseChunk(next);
+                continue;
+              }
+              consumerGen_ = latest;
+              ended_.store(false, std::memory_order_relaxed);
+            }
+            current_ = next;
+            if (chunks_[next].end) {
+              ended_.store(true, std::memory_order_relaxed);
+              ReleaseChunk(current_);
+              current_ = -1;
+              break;
+            }
+          }
+          Chunk &chunk = chunks_[current_];
+          const int count = std::min(frames - done, chunk.frames - chunk.offset);
+          memcpy(pcm + static_cast<size_t>(done) * channels, chunk.samples + static_cast<size_t>(chunk.offset) * channels,
+                 static_cast<size_t>(count) * channels * sizeof(int16_t));
+          done += count;
+          chunk.offset += count;
+          position_.store(chunk.position + chunk.offset, std::memory_order_relaxed);
+          if (chunk.offset >= chunk.frames) {
+            ReleaseChunk(current_);
+            current_ = -1;
+          }
+        }
+        memset(pcm + static_cast<size_t>(done) * channels, 0, static_cast<size_t>(frames - done) * channels * sizeof(int16_t));
+        return done;
+      }
+
+      /**
+       * @brief 设置播放位置，与 SetAudioAccompanyPosition 一致
+       * @param posMs 位置，单位：ms
+       * @return 0: 成功；-1: 未打开
+       */
+      int SetPosition(int posMs)
+      {
+        {
+          std::lock_guard<std::mutex> guard(lock_);
+          if (!running_) {
+            return -1;
+          }
+          SeekLocked(FramesFromMs(posMs));
+        }
+        wake_.notify_all();
+        return 0;
+      }
+
+      /**
+       * @brief 当前播放位置，单位：ms
+       */
+      int GetCurrentPosition() const
+      {
+        return index_.sampleRate > 0 ? static_cast<int>(position_.load(std::memory_order_relaxed) * 1000 / index_.sampleRate) : 0;
+      }
+
+      /**
+       * @brief 文件时长，单位：ms，未打开时返回 -1
+       */
+      int GetDuration() const
+      {
+        return index_.sampleRate > 0 ? static_cast<int>(totalFrames_ * 1000 / index_.sampleRate) : -1;
+      }
+
+      int SampleRate() const { return index_.sampleRate; }
+      int Channels() const { return index_.channels; }
+      AliEngineAudioAccompanyCodec Codec() const { return index_.codec; }
+
+      /**
+       * @brief 是否已播放完全部循环
+       */
+      bool IsEnded() const
+      {
+        return ended_.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief 获取统计信息
+       */
+      AliEngineAudioAccompanyReaderStats GetStats()
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        AliEngineAudioAccompanyReaderStats stats = stats_;
+        stats.underruns = underruns_.load(std::memory_order_relaxed);
+        return stats;
+      }
+
+    private:
+      AliEngineAudioAccompanyReader(const AliEngineAudioAccompanyReader&);
+      AliEngineAudioAccompanyReader& operator=(const AliEngineAudioAccompanyReader&);
+
+      static AliEngineAudioAccompanyReaderConfig Validate(AliEngineAudioAccompanyReaderConfig config)
+      {
+        config.readAheadMs = config.readAheadMs > 0 ? config.readAheadMs : 500;
+        return config;
+      }
+
+      /* 队列按最短的帧（约10ms）预留容量，打开任何文件都不需要重新分配 */
+      static size_t MaxChunks(const AliEngineAudioAccompanyReaderConfig &config)
+      {
+        return static_cast<size_t>(config.readAheadMs / kMinFrameMs + 2);
+      }
+
+      struct Chunk {
+        int16_t* samples = nullptr;
+        /* 第一个采样在输出时间轴上的位置 */
+        long long position = 0;
+        int frames = 0;
+        /* 读取端已消费的采样数 */
+        int offset = 0;
+        unsigned gen = 0;
+        bool end = false;
+      };
+
+      /* 索引缓存文件头，偏移和长度数组紧随其后 */
+      struct IndexHeader {
+        uint32_t magic;
+        uint32_t version;
+        int64_t mtime;
+        int64_t size;
+        int32_t codec;
+        int32_t sampleRate;
+        int32_t channels;
+        int32_t samplesPerFrame;
+        int32_t encoderDelay;
+        int32_t encoderPadding;
+        int32_t gapless;
+        int32_t frames;
+      };
+
+      enum {
+        kIndexMagic = 0x58444941, /* "AIDX" */
+        kIndexVersion = 1,
+        /* MP3 位池最多引用前一帧之前的数据，需预热两帧 */
+        kMp3PrerollFrames = 2,
+        kAacPrerollFrames = 1,
+        kMinFrameMs = 10,
+      };
+
+      long long FramesFromMs(long long ms) const
+      {
+        const long long frames = ms * index_.sampleRate / 1000;
+        return frames > 0 ? (frames < totalFrames_ ? frames : totalFrames_) : 0;
+      }
+
+      /*
+       * 读取端归还空闲块。预读线程只在等待空闲块时置位 slotWaiting_，此时加锁唤醒；
+       * 两侧在队列操作与标志访问之间各有一个 seq_cst 栅栏，预读线程要么在等待前取到该块，要么被唤醒
+       */
+      void ReleaseChunk(int slot)
+      {
+        free_.TryPush(slot);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (slotWaiting_.load(std::memory_order_relaxed)) {
+          std::lock_guard<std::mutex> guard(lock_);
+          wake_.notify_all();
+        }
+      }
+
+      /* 在 lock_ 内调用，由预读线程执行 */
+      void SeekLocked(long long position)
+      {
+        seekTarget_ = position;
+        seekPending_ = true;
+        seekStart_ = std::chrono::steady_clock::now();
+        seekGen_.fetch_add(1, std::memory_order_release);
+        position_.store(position, std::memory_order_relaxed);
+      }
+
+      /*
+       * 跳转后由预读线程把 ready_ 中旧序号的块直接放回 free_，不必等读取端逐块丢弃后才有空闲块解码新位置，
+       * 跳转后的第一次 Read 即可取到数据。此时尚未产出新序号的块，队列中全是旧块；与读取端并发出队时双方各自归还
+       */
+      void ReclaimStaleChunks()
+      {
+        int stale = -1;
+        while (ready_.TryPop(stale)) {
+          free_.TryPush(stale);
+        }
+      }
+
+      void ReadAheadLoop()
+      {
+        unsigned gen = 0;
+        /* 下一个要解码的帧、需丢弃的解码采样数、下一个输出采样的位置 */
+        size_t frame = 0;
+        long long discard = 0;
+        long long position = 0;
+        bool finished = false;
+        bool measure = false;
+        std::chrono::steady_clock::time_point seekStart;
+        int slot = -1;
+        while (true) {
+          if (slot < 0) {
+            free_.TryPop(slot);
+          }
+          {
+            std::unique_lock<std::mutex> guard(lock_);
+            /* 播放结束时等待跳转或关闭；缺少空闲块时等待读取端归还（见 ReleaseChunk） */
+            if (!seekPending_ && running_ && (finished || slot < 0)) {
+              slotWaiting_.store(!finished, std::memory_order_relaxed);
+              std::atomic_thread_fence(std::memory_order_seq_cst);
+              wake_.wait(guard, [this, &finished, &slot]() {
+                return seekPending_ || !running_ || (!finished && (slot >= 0 || free_.TryPop(slot)));
+              });
+              slotWaiting_.store(false, std::memory_order_relaxed);
+            }
+            if (!running_) {
+              break;
+            }
+            if (seekPending_) {
+              seekPending_ = false;
+              gen = seekGen_.load(std::memory_order_relaxed);
+              seekStart = seekStart_;
+              measure = true;
+              finished = false;
+              position = seekTarget_;
+              StartAt(position, frame, discard);
+              ReclaimStaleChunks();
+            }
+          }
+          if (slot < 0 || finished) {
+            continue;
+          }
+          Chunk &chunk = chunks_[slot];
+          chunk.gen = gen;
+          chunk.offset = 0;
+          chunk.end = false;
+          chunk.frames = 0;
+          if (frame >= index_.offsets.size() || position >= totalFrames_) {
+            if (loopsLeft_ > 0) {
+              --loopsLeft_;
+            }
+            if (loopsLeft_ == 0) {
+              chunk.end = true;
+              finished = true;
+              ready_.TryPush(slot);
+              slot = -1;
+              continue;
+            }
+            /* 循环：直接接到文件开头继续解码 */
+            position = 0;
+            StartAt(0, frame, discard);
+          }
+          int decoded = DecodeAt(frame++, chunk.samples);
+          const int skip = static_cast<int>(std::min<long long>(discard, decoded));
+          discard -= skip;
+          decoded = static_cast<int>(std::min<long long>(decoded - skip, totalFrames_ - position));
+          if (decoded <= 0) {
+            continue;
+          }
+          if (skip > 0) {
+            memmove(chunk.samples, chunk.samples + static_cast<size_t>(skip) * index_.channels,
+                    static_cast<size_t>(decoded) * index_.channels * sizeof(int16_t));
+          }
+          chunk.position = position;
+          chunk.frames = decoded;
+          position += decoded;
+          ready_.TryPush(slot);
+          slot = -1;
+          if (measure) {
+            measure = false;
+            std::lock_guard<std::mutex> guard(lock_);
+            stats_.lastSeekUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - seekStart).count();
+          }
+        }
+        if (slot >= 0) {
+          free_.TryPush(slot);
+        }
+      }
+
+      /* 定位到输出时间轴上的 position：从目标帧前的预热帧开始解码，并记录需丢弃的采样数 */
+      void StartAt(long long position, size_t &frame, long long &discard)
+      {
+        const long long decoded = position + startTrim_;
+        const size_t target = static_cast<size_t>(decoded / index_.samplesPerFrame);
+        const size_t preroll = index_.codec == AliEngineAudioAccompanyCodecMp3 ? kMp3PrerollFrames : kAacPrerollFrames;
+        frame = target > preroll ? target - preroll : 0;
+        discard = decoded - static_cast<long long>(frame) * index_.samplesPerFrame;
+        decoder_->ResetDecoder();
+      }
+
+      int DecodeAt(size_t frame, int16_t* pcm)
+      {
+        const int64_t offset = index_.offsets[frame];
+        const size_t size = index_.sizes[frame];
+        if (offset != filePos_ && fseek(file_, static_cast<long>(offset), SEEK_SET) != 0) {
+          filePos_ = -1;
+        } else if (fread(&readBuffer_[0], 1, size, file_) == size) {
+          filePos_ = offset + static_cast<int64_t>(size);
+          const int decoded = decoder_->DecodeFrame(&readBuffer_[0], static_cast<int>(size), pcm, chunkCapacity_);
+          if (decoded >= 0) {
+            return std::min(decoded, chunkCapacity_);
+          }
+        } else {
+          filePos_ = -1;
+        }
+        std::lock_guard<std::mutex> guard(lock_);
+        ++stats_.decodeErrors;
+        memset(pcm, 0, static_cast<size_t>(index_.samplesPerFrame) * index_.channels * sizeof(int16_t));
+        return index_.samplesPerFrame;
+      }
+
+      bool LoadIndex(const char* filePath, internal::AccompanyIndex &index, bool &fromCache)
+      {
+        struct stat st;
+        if (!filePath || stat(filePath, &st) != 0) {
+          return false;
+        }
+        const long long mtime = static_cast<long long>(st.st_mtime);
+        const long long size = static_cast<long long>(st.st_size);
+        const std::string cachePath = CachePath(filePath);
+        if (!cachePath.empty() && ReadCache(cachePath, mtime, size, index)) {
+          fromCache = true;
+          return true;
+        }
+        FILE* file = fopen(filePath, "rb");
+        if (!file) {
+          return false;
+        }
+        index = internal::AccompanyIndex();
+        const bool ok = internal::BuildAccompanyIndex(file, index);
+        fclose(file);
+        if (ok && !cachePath.empty()) {
+          WriteCache(cachePath, mtime, size, index);
+        }
+        return ok;
+      }
+
+      std::string CachePath(const char* filePath) const
+      {
+        if (cacheDir_.empty()) {
+          return std::string();
+        }
+        unsigned long long hash = 1469598103934665603ULL;
+        for (const char* p = filePath; *p; ++p) {
+          hash = (hash ^ static_cast<unsigned char>(*p)) * 1099511628211ULL;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.aidx", hash);
+        return cacheDir_ + "/" + name;
+      }
+
+      static bool ReadCache(const std::string &path, long long mtime, long long size, internal::AccompanyIndex &index)
+      {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+          return false;
+        }
+        IndexHeader header;
+        bool ok = fread(&header, sizeof(header), 1, file) == 1 && header.magic == kIndexMagic &&
+                  header.version == kIndexVersion && header.mtime == mtime && header.size == size &&
+                  header.frames > 0 && header.sampleRate > 0 && header.channels > 0 && header.samplesPerFrame > 0;
+        if (ok) {
+          index.codec = static_cast<AliEngineAudioAccompanyCodec>(header.codec);
+          index.sampleRate = header.sampleRate;
+          index.channels = header.channels;
+          index.samplesPerFrame = header.samplesPerFrame;
+          index.encoderDelay = header.encoderDelay;
+          index.encoderPadding = header.encoderPadding;
+          index.gapless = header.gapless != 0;
+          index.offsets.resize(header.frames);
+          index.sizes.resize(header.frames);
+          ok = fread(&index.offsets[0], sizeof(int64_t), header.frames, file) == static_cast<size_t>(header.frames) &&
+               fread(&index.sizes[0], sizeof(uint16_t), header.frames, file) == static_cast<size_t>(header.frames);
+        }
+        fclose(file);
+        return ok;
+      }
+
+      /*
+       * 先写临时文件再重命名，其他进程不会读到不完整的索引。
+       * 临时文件名包含进程内计数、线程和时间戳，并以独占方式创建，多个线程或进程同时建立同一文件的索引时互不覆盖
+       */
+      static void WriteCache(const std::string &path, long long mtime, long long size, const internal::AccompanyIndex &index)
+      {
+        static std::atomic<unsigned> counter(0);
+        char suffix[96];
+        snprintf(suffix, sizeof(suffix), ".%x.%zx.%llx.tmp", counter.fetch_add(1, std::memory_order_relaxed),
+                 std::hash<std::thread::id>()(std::this_thread::get_id()),
+                 static_cast<unsigned long long>(std::chrono::system_clock::now().time_since_epoch().count()));
+        const std::string temp = path + suffix;
+        FILE* file = fopen(temp.c_str(), "wbx");
+        if (!file) {
+          return;
+        }
+        IndexHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = kIndexMagic;
+        header.version = kIndexVersion;
+        header.mtime = mtime;
+        header.size = size;
+        header.codec = index.codec;
+        header.sampleRate = index.sampleRate;
+        header.channels = index.channels;
+        header.samplesPerFrame = index.samplesPerFrame;
+        header.encoderDelay = index.encoderDelay;
+        header.encoderPadding = index.encoderPadding;
+        header.gapless = index.gapless ? 1 : 0;
+        header.frames = static_cast<int32_t>(index.offsets.size());
+        const size_t frames = index.offsets.size();
+        const bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                        fwrite(&index.offsets[0], sizeof(int64_t), frames, file) == frames &&
+                        fwrite(&index.sizes[0], sizeof(uint16_t), frames, file) == frames;
+        if (fclose(file) != 0 || !ok || rename(temp.c_str(), path.c_str()) != 0) {
+          remove(temp.c_str());
+        }
+      }
+
+      IAliEngineAudioAccompanyDecoder* decoder_;
+      AliEngineAudioAccompanyReaderConfig config_;
+      std::string cacheDir_;
+      internal::AccompanyIndex index_;
+      FILE* file_ = nullptr;
+      int64_t filePos_ = -1;
+      std::vector<uint8_t> readBuffer_;
+      long long startTrim_ = 0;
+      long long totalFrames_ = 0;
+      int loopsLeft_ = 1;
+
+      std::vector<Chunk> chunks_;
+      std::vector<int16_t> samples_;
+      int chunkCapacity_ = 0;
+      /* 已解码的块和空闲块，预读线程与读取线程之间只通过这两个队列交换块 */
+      internal::BoundedMpmcQueue<int> ready_;
+      internal::BoundedMpmcQueue<int> free_;
+      int current_ = -1;
+      unsigned consumerGen_ = 0;
+
+      std::mutex lock_;
+      std::condition_variable wake_;
+      std::thread thread_;
+      bool running_ = false;
+      bool seekPending_ = false;
+      /* 预读线程正在等待空闲块 */
+      std::atomic<bool> slotWaiting_{false};
+      long long seekTarget_ = 0;
+      std::chrono::steady_clock::time_point seekStart_;
+      std::atomic<unsigned> seekGen_;
+      std::atomic<long long> position_;
+      std::atomic<bool> ended_;
+      std::atomic<unsigned long long> underruns_;
+      AliEngineAudioAccompanyReaderStats stats_;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_accompany_reader_h */
@@ -0,0 +1,402 @@
+#ifndef ali_rtc_engine_audio_active_speaker_h
+#define ali_rtc_engine_audio_active_speaker_h
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "engine_interface.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 说话人检测配置
+     */
+    typedef struct AliEngineActiveSpeakerConfig {
+      /** 最大用户数，默认值：1024 */
+      int maxUsers = 1024;
+      /** 主要说话人个数，默认值：4 */
+      int topK = 4;
+      /** 音量平滑的时间常数，单位：ms，默认值：600 */
+      int smoothMs = 600;
+      /** 进入说话人列表的最低平滑音量，取值范围[0, 255]，默认值：20 */
+      int minVolume = 20;
+      /** 迟滞量：新用户的平滑音量需超过已在列表中的用户这么多才能替换，取值范围[0, 255]，默认值：12 */
+      int hysteresis = 12;
+      /** 保持时间：进入列表后至少保留的时长，单位：ms，默认值：1500 */
+      int holdMs = 1500;
+      /** 只累计 speechState 为1的音量，需开启 reportVad，默认值：true */
+      bool useVad = true;
+    } AliEngineActiveSpeakerConfig;
+
+    /**
+     * @brief 主要说话人信息
+     */
+    typedef struct AliEngineActiveSpeakerInfo {
+      /** 用户ID，在该用户被移除前有效 */
+      const char* uid = nullptr;
+      /** 平滑音量，取值范围[0, 255] */
+      int volume = 0;
+    } AliEngineActiveSpeakerInfo;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @addtogroup AliEngineCallback 回调及监听
+     * AliEngine 回调及监听
+     * @{
+     */
+
+    /**
+     * @brief 主要说话人列表变化监听
+     */
+    class IAliEngineActiveSpeakerObserver {
+    public:
+      virtual ~IAliEngineActiveSpeakerObserver() {}
+
+      /**
+       * @brief 主要说话人列表的成员发生变化，可据此调整订阅的视频流；仅顺序变化时不回调
+       * @param speakers 按平滑音量从高到低排列
+       * @param count 个数，不超过 topK
+       */
+      virtual void OnTopSpeakersChanged(const AliEngineActiveSpeakerInfo* speakers, int count) {}
+    };
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 主要说话人检测
+     * @details 由 {@link AliEngineEventListener::OnAudioVolumeCallback} 的结果推导 {@link AliEngineEventListener::OnActiveSpeaker}，
+     * 同时给出前 topK 个说话人，用于在大房间中选择订阅的视频流：
+     *  - 每个用户的平滑音量以首次音量为初值按时间常数做指数平滑，更新为 O(1)；uid 通过开放寻址哈希表查找，查找不分配内存
+     *  - 每次评估用大小为 topK 的最小堆扫描全部用户，O(N log K)；未更新的用户按时间衰减
+     *  - 已在列表中的用户评估时加上 hysteresis，且进入列表后 holdMs 内不会被替换，避免说话人在音量相近的用户间反复切换
+     * 当前说话人（topK 中第一名）按同样规则单独保持，变化时回调 OnActiveSpeaker
+     * @note 线程安全；回调在调用 OnVolume/Evaluate 的线程触发，回调中不可调用本类接口。
+     * uid 为 "1" 的远端混音音量不参与统计
+     */
+    class AliEngineActiveSpeakerTracker {
+    public:
+      explicit AliEngineActiveSpeakerTracker(const AliEngineActiveSpeakerConfig &config = AliEngineActiveSpeakerConfig())
+        : config_(config)
+      {
+        config_.maxUsers = config_.maxUsers > 0 ? config_.maxUsers : 1;
+        config_.topK = config_.topK > 0 ? config_.topK : 1;
+        config_.smoothMs = config_.smoothMs > 0 ? config_.smoothMs : 1;
+        users_.resize(config_.maxUsers);
+        free_.reserve(config_.maxUsers);
+        for (int i = config_.maxUsers - 1; i >= 0; --i) {
+          free_.push_back(i);
+        }
+        size_t buckets = 16;
+        while (buckets < static_cast<size_t>(config_.maxUsers) * 2) {
+          buckets <<= 1;
+        }
+        table_.assign(buckets, -1);
+        heap_.reserve(config_.topK + 1);
+        top_.resize(config_.topK);
+        previous_.assign(config_.topK, -1);
+        order_.resize(config_.topK);
+      }
+
+      void SetListener(AliEngineEventListener* listener)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        listener_ = listener;
+      }
+
+      void SetObserver(IAliEngineActiveSpeakerObserver* observer)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        observer_ = observer;
+      }
+
+      /**
+       * @brief 用户离开时调用，释放其状态
+       */
+      void RemoveUser(const char* uid)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        const size_t mask = table_.size() - 1;
+        size_t bucket = 0;
+        const int index = Find(uid, bucket);
+        if (index < 0) {
+          return;
+        }
+        /* 线性探测的后移删除，不留墓碑 */
+        size_t hole = bucket;
+        for (size_t next = (hole + 1) & mask; table_[next] >= 0; next = (next + 1) & mask) {
+          const size_t home = users_[table_[next]].hash & mask;
+          if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table_[hole] = table_[next];
+            hole = next;
+          }
+        }
+        table_[hole] = -1;
+        for (int i = 0; i < config_.topK; ++i) {
+          previous_[i] = previous_[i] == index ? -1 : previous_[i];
+        }
+        if (active_ == index) {
+          active_ = -1;
+        }
+        users_[index] = User();
+        free_.push_back(index);
+      }
+
+      /**
+       * @brief 输入一次音量回调结果并评估
+       * @param infos {@link AliEngineEventListener::OnAudioVolumeCallback} 的参数
+       * @param count 个数
+       * @param nowMs 当前时间，单位：ms，单调递增，可用 {@link NowMs}
+       */
+      void OnVolume(const AliEngineUserVolumeInfo* infos, int count, long long nowMs)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        for (int i = 0; i < count; ++i) {
+          const char* uid = infos[i].uid.c_str();
+          if (!uid || strcmp(uid, "1") == 0) {
+            continue;
+          }
+          const int volume = config_.useVad && !infos[i].speechState ? 0 : infos[i].volume;
+          UpdateLocked(uid, volume, nowMs);
+        }
+        EvaluateLocked(nowMs);
+      }
+
+      /**
+       * @brief 单独更新一个用户的音量，不触发评估
+       */
+      void Update(const char* uid, int volume, long long nowMs)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (uid) {
+          UpdateLocked(uid, volume, nowMs);
+        }
+      }
+
+      /**
+       * @brief 重新评估主要说话人，变化时回调
+       */
+      void Evaluate(long long nowMs)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        EvaluateLocked(nowMs);
+      }
+
+      /**
+       * @brief 最近一次评估的主要说话人
+       * @param speakers 输出数组
+       * @param maxCount 数组长度
+       * @return 个数
+       */
+      int GetTopSpeakers(AliEngineActiveSpeakerInfo* speakers, int maxCount) const
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        const int count = topCount_ < maxCount ? topCount_ : maxCount;
+        for (int i = 0; i < count; ++i) {
+          speakers[i] = top_[i];
+        }
+        return count;
+      }
+
+      /**
+       * @brief 当前说话人，没有时返回 nullptr
+       */
+      const char* GetActiveSpeaker() const
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        return active_ >= 0 ? users_[active_].uid.c_str() : nullptr;
+      }
+
+      static long long NowMs()
+      {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+    private:
+      AliEngineActiveSpeakerTracker(const AliEngineActiveSpeakerTracker&);
+      AliEngineActiveSpeakerTracker& operator=(const AliEngineActiveSpeakerTracker&);
+
+      struct User {
+        std::string uid;
+        unsigned hash = 0;
+        bool used = false;
+        float volume = 0.0f;
+        long long updateMs = 0;
+        /* 进入 topK 列表的时间，-1 表示不在列表中 */
+        long long memberSince = -1;
+      };
+
+      struct Candidate {
+        float score;
+        int index;
+        bool operator>(const Candidate &other) const { return score > other.score || (score == other.score && index < other.index); }
+      };
+
+      static unsigned Hash(const char* uid)
+      {
+        unsigned h = 2166136261u;
+        for (const unsigned char* p = reinterpret_cast<const unsigned char*>(uid); *p; ++p) {
+          h = (h ^ *p) * 16777619u;
+        }
+        return h;
+      }
+
+      int Find(const char* uid, size_t &bucket) const
+      {
+        const size_t mask = table_.size() - 1;
+        for (bucket = Hash(uid) & mask; table_[bucket] >= 0; bucket = (bucket + 1) & mask) {
+          if (strcmp(users_[table_[bucket]].uid.c_str(), uid) == 0) {
+            return table_[bucket];
+          }
+        }
+        return -1;
+      }
+
+      void UpdateLocked(const char* uid, int volume, long long nowMs)
+      {
+        size_t bucket = 0;
+        int index = Find(uid, bucket);
+        if (index < 0) {
+          if (free_.empty()) {
+            return;
+          }
+          index = free_.back();
+          free_.pop_back();
+          User &user = users_[index];
+          user.uid = uid;
+          user.hash = Hash(uid);
+          user.used = true;
+          user.volume = static_cast<float>(volume);
+          user.updateMs = nowMs;
+          table_[bucket] = index;
+          return;
+        }
+        User &user = users_[index];
+        const float decay = Decay(user, nowMs);
+        user.volume = volume + (user.volume - volume) * decay;
+        user.updateMs = nowMs;
+      }
+
+      float Decay(const User &user, long long nowMs) const
+      {
+        const long long elapsed = nowMs > user.updateMs ? nowMs - user.updateMs : 0;
+        return static_cast<float>(exp(-static_cast<double>(elapsed) / config_.smoothMs));
+      }
+
+      /* 已在列表中的用户加上迟滞量，保持期内视为无穷大 */
+      float Score(float volume, long long memberSince, long long nowMs) const
+      {
+        if (memberSince < 0) {
+          return volume >= config_.minVolume ? volume : -1.0f;
+        }
+        if (nowMs - memberSince < config_.holdMs) {
+          return 1e9f + volume;
+        }
+        return volume + config_.hysteresis >= config_.minVolume ? volume + config_.hysteresis : -1.0f;
+      }
+
+      void EvaluateLocked(long long nowMs)
+      {
+        heap_.clear();
+        Candidate best = { -1.0f, -1 };
+        for (int i = 0; i < config_.maxUsers; ++i) {
+          const User &user = users_[i];
+          if (!user.used) {
+            continue;
+          }
+          const float volume = user.volume * Decay(user, nowMs);
+          const float score = Score(volume, user.memberSince, nowMs);
+          if (score >= 0.0f) {
+            const Candidate candidate = { score, i };
+            if (static_cast<int>(heap_.size()) < config_.topK) {
+              heap_.push_back(candidate);
+              std::push_heap(heap_.begin(), heap_.end(), std::greater<Candidate>());
+            } else if (candidate > heap_.front()) {
+              std::pop_heap(heap_.begin(), heap_.end(), std::greater<Candidate>());
+              heap_.back() = candidate;
+              std::push_heap(heap_.begin(), heap_.end(), std::greater<Candidate>());
+            }
+          }
+          /* 当前说话人单独按同样的迟滞和保持规则选择 */
+          const float activeScore = Score(volume, i == active_ ? activeSince_ : -1, nowMs);
+          const Candidate active = { activeScore, i };
+          if (activeScore >= 0.0f && active > best) {
+            best = active;
+          }
+        }
+
+        /* 最小堆按分数从高到低排序输出，并更新列表成员的进入时间 */
+        std::sort_heap(heap_.begin(), heap_.end(), std::greater<Candidate>());
+        const int count = static_cast<int>(heap_.size());
+        bool changed = count != topCount_;
+        for (int i = 0; i < count; ++i) {
+          order_[i] = heap_[i].index;
+        }
+        for (int i = 0; i < topCount_; ++i) {
+          const int index = previous_[i];
+          if (index >= 0 && std::find(order_.begin(), order_.begin() + count, index) == order_.begin() + count) {
+            users_[index].memberSince = -1;
+            changed = true;
+          }
+        }
+        for (int i = 0; i < count; ++i) {
+          User &user = users_[order_[i]];
+          if (user.memberSince < 0) {
+            user.memberSince = nowMs;
+            changed = true;
+          }
+          previous_[i] = order_[i];
+          top_[i].uid = user.uid.c_str();
+          top_[i].volume = static_cast<int>(user.volume * Decay(user, nowMs) + 0.5f);
+        }
+        topCount_ = count;
+
+        if (best.index != active_) {
+          active_ = best.index;
+          activeSince_ = nowMs;
+          if (listener_ && active_ >= 0) {
+            listener_->OnActiveSpeaker(users_[active_].uid.c_str());
+          }
+        }
+        if (changed && observer_) {
+          observer_->OnTopSpeakersChanged(count > 0 ? &top_[0] : nullptr, count);
+        }
+      }
+
+      AliEngineActiveSpeakerConfig config_;
+      mutable std::mutex lock_;
+      AliEngineEventListener* listener_ = nullptr;
+      IAliEngineActiveSpeakerObserver* observer_ = nullptr;
+      std::vector<User> users_;
+      std::vector<int> free_;
+      /* 开放寻址哈希表，存放 users_ 下标，-1 为空 */
+      std::vector<int> table_;
+      std::vector<Candidate> heap_;
+      std::vector<AliEngineActiveSpeakerInfo> top_;
+      std::vector<int> previous_;
+      std::vector<int> order_;
+      int topCount_ = 0;
+      int active_ = -1;
+      long long activeSince_ = 0;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_active_speaker_h */
@@ -0,0 +1,353 @@
+#ifndef ali_rtc_engine_audio_ear_monitor_h
+#define ali_rtc_engine_audio_ear_monitor_h
+
+#include <atomic>
+#include <chrono>
+
+#include "engine_audio_equalizer.h"
+#include "engine_audio_observer_chain.h"
+#include "engine_audio_reverb.h"
+#include "engine_lockfree_queue.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 耳返配置
+     */
+    typedef struct AliEngineAudioEarMonitorConfig {
+      /** 采集和播放回调的采样率，需与 enableAudioFrameObserver 设置一致，默认值：48000 */
+      int sampleRate = 48000;
+      /** 最大缓冲时长，超出部分丢弃最早的数据以限制时延，单位：ms，默认值：20 */
+      int maxBufferMs = 20;
+      /** 设备输入和输出时延之和，计入统计的时延，单位：ms，iOS 可取 AVAudioSession 的 inputLatency + outputLatency，默认值：0 */
+      int deviceLatencyMs = 0;
+    } AliEngineAudioEarMonitorConfig;
+
+    /**
+     * @brief 耳返统计信息
+     */
+    typedef struct AliEngineAudioEarMonitorStats {
+      /** 最近一帧的采集到播放时延，单位：us，包含 deviceLatencyMs */
+      int latencyUs = 0;
+      /** 平滑时延，单位：us */
+      int avgLatencyUs = 0;
+      /** 最大时延，单位：us */
+      int maxLatencyUs = 0;
+      /** 当前缓冲时长，单位：ms */
+      int bufferedMs = 0;
+      /** 播放时数据不足的次数 */
+      unsigned long long underruns = 0;
+      /** 为限制时延丢弃的采样数 */
+      unsigned long long droppedSamples = 0;
+      /** 采样率与配置不一致而跳过的帧数 */
+      unsigned long long formatMismatches = 0;
+      /** 混入播放的帧数 */
+      unsigned long long frames = 0;
+    } AliEngineAudioEarMonitorStats;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 低时延耳返
+     * @details 替代 {@link AliEngine::EnableEarBack} / {@link AliEngine::SetEarBackVolume}，作为 {@link IAliEngineAudioProcessStage}
+     * 同时加入 {@link AliEngineAudioFrameObserverChain} 的 AliEngineAudioSourceCaptured 和 AliEngineAudioSourcePlayback 两条链：
+     *  - 采集回调只拷贝麦克风数据（不修改推流数据），下混为单声道后依次经过均衡器和混响（未开启时直接跳过），写入无锁环形缓冲
+     *  - 播放回调从缓冲取出数据按耳返音量混入本地播放数据，不经过网络侧的混音和抖动缓冲
+     *  - 缓冲超过 maxBufferMs 时丢弃最早的数据；约50帧内始终未用到的积压（超出1ms的部分）也会被丢弃，
+     *    时延不随启动时的回调抖动和两端时钟漂移累积
+     *  - 采集回调记录每帧的时间戳和采样序号，播放时按被播放的第一个采样计算采集到播放的时延
+     * @note 使用前请关闭SDK耳返，两个数据源需以读写模式、相同采样率开启；Equalizer/Reverb 的参数可在任意线程设置
+     */
+    class AliEngineAudioEarMonitor : public IAliEngineAudioProcessStage {
+    public:
+      explicit AliEngineAudioEarMonitor(const AliEngineAudioEarMonitorConfig &config = AliEngineAudioEarMonitorConfig())
+        : config_(Validate(config)),
+          ring_(static_cast<size_t>(config_.sampleRate / 10)),
+          marks_(kMarks),
+          equalizer_(config_.sampleRate, 1),
+          reverb_(config_.sampleRate, 1)
+      {
+        enabled_.store(false, std::memory_order_relaxed);
+        volume_.store(100, std::memory_order_relaxed);
+        written_.store(0, std::memory_order_relaxed);
+        latencyUs_.store(0, std::memory_order_relaxed);
+        avgLatencyUs_.store(0, std::memory_order_relaxed);
+        maxLatencyUs_.store(0, std::memory_order_relaxed);
+        underruns_.store(0, std::memory_order_relaxed);
+        droppedSamples_.store(0, std::memory_order_relaxed);
+        formatMismatches_.store(0, std::memory_order_relaxed);
+        frames_.store(0, std::memory_order_relaxed);
+        maxBuffer_ = static_cast<int>(static_cast<long long>(config_.maxBufferMs) * config_.sampleRate / 1000);
+      }
+
+      /**
+       * @brief 启用耳返
+       * @param enable true: 开启；false: 关闭，默认关闭
+       */
+      void Enable(bool enable)
+      {
+        enabled_.store(enable, std::memory_order_relaxed);
+      }
+
+      bool IsEnabled() const
+      {
+        return enabled_.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief 设置耳返音量
+       * @param volume 取值范围[0, 100]，默认值：100
+       * @return 0: 成功；-1: 参数错误
+       */
+      int SetVolume(int volume)
+      {
+        if (volume < 0 || volume > 100) {
+          return -1;
+        }
+        volume_.store(volume, std::memory_order_relaxed);
+        return 0;
+      }
+
+      /**
+       * @brief 耳返均衡器，默认所有频段0dB，不参与处理
+       */
+      AliEngineAudioEqualizer &Equalizer() { return equalizer_; }
+
+      /**
+       * @brief 耳返混响，默认关闭
+       */
+      AliEngineAudioReverb &Reverb() { return reverb_; }
+
+      /**
+       * @brief 获取统计信息
+       * @note 各字段分别读取，不保证彼此处于同一时刻
+       */
+      AliEngineAudioEarMonitorStats GetStats() const
+      {
+        AliEngineAudioEarMonitorStats stats;
+        stats.latencyUs = latencyUs_.load(std::memory_order_relaxed);
+        stats.avgLatencyUs = avgLatencyUs_.load(std::memory_order_relaxed);
+        stats.maxLatencyUs = maxLatencyUs_.load(std::memory_order_relaxed);
+        stats.underruns = underruns_.load(std::memory_order_relaxed);
+        stats.droppedSamples = droppedSamples_.load(std::memory_order_relaxed);
+        stats.formatMismatches = formatMismatches_.load(std::memory_order_relaxed);
+        stats.frames = frames_.load(std::memory_order_relaxed);
+        stats.bufferedMs = static_cast<int>(ring_.Size() * 1000 / config_.sampleRate);
+        return stats;
+      }
+
+      const char* GetStageName() override { return "ear_monitor"; }
+
+      AliEngineAudioStageFormat GetStageFormat() override { return AliEngineAudioStageFormatFloat; }
+
+      bool OnProcessAudioFrame(AliEngineAudioSource audioSource, const char* uid, AliEngineAudioRawData &audioRawData) override
+      {
+        if (audioRawData.bytesPerSample != 4 || audioRawData.numOfSamples <= 0 || audioRawData.numOfChannels <= 0) {
+          return true;
+        }
+        if (audioRawData.samplesPerSec != config_.sampleRate) {
+          formatMismatches_.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+        if (audioSource == AliEngineAudioSourceCaptured || audioSource == AliEngineAudioSourceProcessCaptured) {
+          Capture(static_cast<const float*>(audioRawData.dataPtr), audioRawData.numOfSamples, audioRawData.numOfChannels);
+        } else if (audioSource == AliEngineAudioSourcePlayback) {
+          Playout(static_cast<float*>(audioRawData.dataPtr), audioRawData.numOfSamples, audioRawData.numOfChannels);
+        }
+        return true;
+      }
+
+    private:
+      AliEngineAudioEarMonitor(const AliEngineAudioEarMonitor&);
+      AliEngineAudioEarMonitor& operator=(const AliEngineAudioEarMonitor&);
+
+      /* 采集帧的时间戳：end 为该帧最后一个采样之后的序号 */
+      struct Mark {
+        unsigned long long end;
+        long long timeUs;
+      };
+
+      enum {
+        kBlock = 256,
+        kMarks = 64,
+        /* 积压统计窗口，单位：播放帧 */
+        kTrimFrames = 50,
+      };
+
+      static AliEngineAudioEarMonitorConfig Validate(AliEngineAudioEarMonitorConfig config)
+      {
+        config.sampleRate = config.sampleRate > 0 ? config.sampleRate : 48000;
+        config.maxBufferMs = config.maxBufferMs > 0 ? (config.maxBufferMs < 80 ? config.maxBufferMs : 80) : 20;
+        config.deviceLatencyMs = config.deviceLatencyMs > 0 ? config.deviceLatencyMs : 0;
+        return config;
+      }
+
+      static long long NowUs()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /* 采集线程 */
+      void Capture(const float* data, int frames, int channels)
+      {
+        if (!enabled_.load(std::memory_order_relaxed)) {
+          return;
+        }
+        const long long now = NowUs();
+        unsigned long long written = written_.load(std::memory_order_relaxed);
+        float mono[kBlock];
+        const float scale = 1.0f / channels;
+        for (int offset = 0; offset < frames; offset += kBlock) {
+          const int count = frames - offset < kBlock ? frames - offset : kBlock;
+          const float* src = data + static_cast<size_t>(offset) * channels;
+          if (channels == 1) {
+            memcpy(mono, src, count * sizeof(float));
+          } else {
+            for (int i = 0; i < count; ++i) {
+              float sum = 0.0f;
+              for (int c = 0; c < channels; ++c) {
+                sum += src[i * channels + c];
+              }
+              mono[i] = sum * scale;
+            }
+          }
+          equalizer_.Process(mono, count);
+          reverb_.Process(mono, count);
+          const size_t stored = ring_.Write(mono, count);
+          written += stored;
+          if (stored < static_cast<size_t>(count)) {
+            droppedSamples_.fetch_add(count - stored, std::memory_order_relaxed);
+          }
+        }
+        const Mark mark = { written, now };
+        marks_.Write(&mark, 1);
+        written_.store(written, std::memory_order_release);
+      }
+
+      /* 播放线程 */
+      void Playout(float* data, int frames, int channels)
+      {
+        const long long now = NowUs();
+        size_t available = ring_.Size();
+        if (!enabled_.load(std::memory_order_relaxed)) {
+          /* 关闭时清空缓冲，重新开启后不会播放旧数据 */
+          ring_.Consume(available);
+          read_ += available;
+          gain_ = 0.0f;
+          return;
+        }
+        /* 播放本帧后剩余的数据不超过 maxBufferMs，且丢弃上个统计窗口内始终未用到的积压 */
+        size_t drop = trimPending_ < available ? trimPending_ : available;
+        if (available - drop > static_cast<size_t>(frames + maxBuffer_)) {
+          drop = available - frames - maxBuffer_;
+        }
+        trimPending_ = 0;
+        ring_.Consume(drop);
+        read_ += drop;
+        available -= drop;
+        const unsigned long long dropped = drop;
+        const int count = available < static_cast<size_t>(frames) ? static_cast<int>(available) : frames;
+        const size_t leftover = available - count;
+        trimMin_ = leftover < trimMin_ ? leftover : trimMin_;
+        if (++trimFrames_ >= kTrimFrames) {
+          const size_t slack = static_cast<size_t>(config_.sampleRate / 1000);
+          trimPending_ = trimMin_ > slack ? trimMin_ - slack : 0;
+          trimMin_ = static_cast<size_t>(-1);
+          trimFrames_ = 0;
+        }
+        const int latencyUs = count > 0 ? Latency(now) : -1;
+
+        /* 音量按帧线性过渡，避免调节时的咔嗒声 */
+        const float target = volume_.load(std::memory_order_relaxed) * 0.01f;
+        const float step = count > 0 ? (target - gain_) / count : 0.0f;
+        float gain = gain_;
+        float mono[kBlock];
+        for (int offset = 0; offset < count; offset += kBlock) {
+          const int n = count - offset < kBlock ? count - offset : kBlock;
+          ring_.Read(mono, n);
+          float* dst = data + static_cast<size_t>(offset) * channels;
+          for (int i = 0; i < n; ++i) {
+            gain += step;
+            const float v = mono[i] * gain;
+            for (int c = 0; c < channels; ++c) {
+              const float mixed = dst[i * channels + c] + v;
+              dst[i * channels + c] = mixed > 1.0f ? 1.0f : (mixed < -1.0f ? -1.0f : mixed);
+            }
+          }
+        }
+        read_ += count;
+        gain_ = count > 0 ? target : gain_;
+
+        if (dropped > 0) {
+          droppedSamples_.fetch_add(dropped, std::memory_order_relaxed);
+        }
+        if (count < frames && written_.load(std::memory_order_relaxed) > 0) {
+          underruns_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (latencyUs >= 0) {
+          /* 时延类字段只由播放线程写入，读-改-写无需原子操作 */
+          const int avg = frames_.fetch_add(1, std::memory_order_relaxed) == 0 ? latencyUs :
+              avgLatencyUs_.load(std::memory_order_relaxed) + (latencyUs - avgLatencyUs_.load(std::memory_order_relaxed)) / 16;
+          latencyUs_.store(latencyUs, std::memory_order_relaxed);
+          avgLatencyUs_.store(avg, std::memory_order_relaxed);
+          if (latencyUs > maxLatencyUs_.load(std::memory_order_relaxed)) {
+            maxLatencyUs_.store(latencyUs, std::memory_order_relaxed);
+          }
+        }
+      }
+
+      /* 本帧第一个播放采样（序号 read_）的采集时间到当前的时延 */
+      int Latency(long long now)
+      {
+        Mark mark;
+        while (marks_.Peek(&mark, 1) == 1 && mark.end <= read_) {
+          marks_.Consume(1);
+        }
+        if (marks_.Peek(&mark, 1) != 1) {
+          return -1;
+        }
+        const long long captured = mark.timeUs - static_cast<long long>(mark.end - read_) * 1000000 / config_.sampleRate;
+        return static_cast<int>(now - captured) + config_.deviceLatencyMs * 1000;
+      }
+
+      AliEngineAudioEarMonitorConfig config_;
+      internal::SpscRingBuffer<float> ring_;
+      internal::SpscRingBuffer<Mark> marks_;
+      AliEngineAudioEqualizer equalizer_;
+      AliEngineAudioReverb reverb_;
+      std::atomic<bool> enabled_;
+      std::atomic<int> volume_;
+      /* 采集端已写入的采样总数 */
+      std::atomic<unsigned long long> written_;
+      /* 播放端已取出（含丢弃）的采样总数，只在播放线程访问 */
+      unsigned long long read_ = 0;
+      float gain_ = 0.0f;
+      int maxBuffer_ = 0;
+      /* 统计窗口内播放后剩余数据的最小值，超出1ms的部分在下一帧丢弃 */
+      size_t trimMin_ = static_cast<size_t>(-1);
+      size_t trimPending_ = 0;
+      int trimFrames_ = 0;
+      /* 统计计数，采集线程和播放线程都可能累加丢弃数和格式不一致数，GetStats 以 relaxed 读取 */
+      std::atomic<int> latencyUs_;
+      std::atomic<int> avgLatencyUs_;
+      std::atomic<int> maxLatencyUs_;
+      std::atomic<unsigned long long> underruns_;
+      std::atomic<unsigned long long> droppedSamples_;
+      std::atomic<unsigned long long> formatMismatches_;
+      std::atomic<unsigned long long> frames_;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_ear_monitor_h */
@@ -0,0 +1,638 @@
+#ifndef ali_rtc_engine_audio_effect_cache_h
+#define ali_rtc_engine_audio_effect_cache_h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "engine_audio_resampler.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 音效PCM缓存配置
+     */
+    typedef struct AliEngineAudioEffectCacheConfig {
+      /** 缓存PCM的采样率，应与播放该音效的外部音频流一致，默认值：48000 */
+      int sampleRate = 48000;
+      /** 缓存PCM的声道数，取值范围[1-2]，默认值：1 */
+      int channels = 1;
+      /** 内存缓存上限，单位：字节，默认值：32MB */
+      long long memoryBudgetBytes = 32LL * 1024 * 1024;
+      /** 磁盘缓存目录，为空时不使用磁盘缓存；磁盘缓存通过mmap读取，Windows平台不支持，默认值：空 */
+      const char* diskCacheDir = nullptr;
+      /** 磁盘缓存上限，单位：字节，默认值：128MB */
+      long long diskBudgetBytes = 128LL * 1024 * 1024;
+      /** 重采样质量，默认值：AliEngineAudioResampleQualityMedium */
+      AliEngineAudioResampleQuality quality = AliEngineAudioResampleQualityMedium;
+    } AliEngineAudioEffectCacheConfig;
+
+    /**
+     * @brief 音效PCM缓存统计信息
+     */
+    typedef struct AliEngineAudioEffectCacheStats {
+      /** 内存命中次数 */
+      unsigned long long hits = 0;
+      /** 磁盘命中次数 */
+      unsigned long long diskHits = 0;
+      /** 未命中（需要解码）次数 */
+      unsigned long long misses = 0;
+      /** 文件修改后失效的次数 */
+      unsigned long long staleEntries = 0;
+      /** 解码失败次数 */
+      unsigned long long decodeFailures = 0;
+      /** 内存淘汰次数 */
+      unsigned long long evictions = 0;
+      /** 磁盘淘汰次数 */
+      unsigned long long diskEvictions = 0;
+      /** 内存缓存条目数 */
+      int entries = 0;
+      /** 内存缓存占用，单位：字节 */
+      long long memoryBytes = 0;
+      /** 磁盘缓存占用，单位：字节 */
+      long long diskBytes = 0;
+    } AliEngineAudioEffectCacheStats;
+
+    /**
+     * @brief 已解码的音效PCM，只读，可在多个播放实例间共享
+     */
+    typedef struct AliEngineAudioEffectPcm {
+      /** int16 交错数据 */
+      const int16_t* samples = nullptr;
+      /** 采样数（单声道） */
+      int frames = 0;
+      /** 采样率 */
+      int sampleRate = 0;
+      /** 声道数 */
+      int channels = 0;
+    } AliEngineAudioEffectPcm;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @addtogroup AliEngineCallback 回调及监听
+     * AliRtc 回调及监听
+     * @{
+     */
+
+    /**
+     * @brief 音效解码接口，由业务层基于系统或第三方解码器实现
+     */
+    class IAliEngineAudioEffectDecoder {
+    public:
+      virtual ~IAliEngineAudioEffectDecoder() {}
+
+      /**
+       * @brief 解码整个音效文件
+       * @param filePath 文件路径
+       * @param pcm 输出 int16 交错数据
+       * @param sampleRate 输出文件采样率
+       * @param channels 输出文件声道数
+       * @return true: 成功；false: 失败
+       */
+      virtual bool DecodeAudioEffect(const char* filePath, std::vector<int16_t> &pcm, int &sampleRate, int &channels) = 0;
+    };
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 已解码音效的内存/磁盘两级LRU缓存
+     * @details SDK的 {@link IAliEngineMediaEngine::PreloadAudioEffect} 在首次播放时解码，短音效（礼物、掌声）的起播时延主要来自解码。
+     * 本缓存在业务层提前解码并转换到外部音频流的采样率和声道数，播放时通过 {@link AliEngineAudioEffectVoice} 逐帧送入
+     * {@link IAliEngineMediaEngine::PushExternalAudioStreamRawData}，命中时第一帧即可送出：
+     *  - 以文件路径 + 修改时间 + 文件大小为键，文件变化后旧条目自动失效
+     *  - 内存层按 memoryBudgetBytes 做LRU淘汰；正在播放的数据由引用计数保持，淘汰不影响播放
+     *  - 可选磁盘层保存重采样后的PCM，下次启动或内存淘汰后通过mmap直接映射，不再解码；按 diskBudgetBytes 淘汰最早使用的文件
+     * @note 线程安全；解码在调用 Acquire/Preload 的线程执行，不持有缓存锁
+     */
+    class AliEngineAudioEffectCache {
+    public:
+      typedef std::shared_ptr<const AliEngineAudioEffectPcm> PcmHandle;
+
+      /**
+       * @param decoder 解码器，需在缓存销毁前保持有效
+       * @param config 缓存配置
+       */
+      explicit AliEngineAudioEffectCache(IAliEngineAudioEffectDecoder* decoder,
+                                         const AliEngineAudioEffectCacheConfig &config = AliEngineAudioEffectCacheConfig())
+        : decoder_(decoder), config_(config)
+      {
+        config_.channels = config_.channels == 2 ? 2 : 1;
+        config_.sampleRate = config_.sampleRate > 0 ? config_.sampleRate : 48000;
+#if !defined(_WIN32)
+        if (config_.diskCacheDir && config_.diskCacheDir[0]) {
+          diskDir_ = config_.diskCacheDir;
+          ScanDisk();
+        }
+#endif
+        config_.diskCacheDir = nullptr;
+      }
+
+      /**
+       * @brief 预加载，等价于 Acquire 后丢弃句柄
+       * @return 0: 成功；-1: 文件不存在或解码失败
+       */
+      int Preload(const char* filePath)
+      {
+        return Acquire(filePath) ? 0 : -1;
+      }
+
+      /**
+       * @brief 获取音效PCM，依次查找内存、磁盘，均未命中时解码
+       * @return PCM句柄，失败返回空
+       */
+      PcmHandle Acquire(const char* filePath)
+      {
+        FileKey key;
+        if (!filePath || !Stat(filePath, key)) {
+          return PcmHandle();
+        }
+        {
+          std::lock_guard<std::mutex> guard(lock_);
+          std::unordered_map<std::string, std::list<Entry>::iterator>::iterator found = index_.find(key.path);
+          if (found != index_.end()) {
+            if (found->second->key.mtime == key.mtime && found->second->key.size == key.size) {
+              lru_.splice(lru_.begin(), lru_, found->second);
+              ++stats_.hits;
+              return found->second->pcm;
+            }
+            ++stats_.staleEntries;
+            EraseLocked(found);
+          }
+        }
+        PcmHandle pcm = LoadDisk(key);
+        if (pcm) {
+          std::lock_guard<std::mutex> guard(lock_);
+          ++stats_.diskHits;
+          return InsertLocked(key, pcm);
+        }
+        pcm = Decode(key);
+        std::lock_guard<std::mutex> guard(lock_);
+        if (!pcm) {
+          ++stats_.decodeFailures;
+          return PcmHandle();
+        }
+        ++stats_.misses;
+        return InsertLocked(key, pcm);
+      }
+
+      /**
+       * @brief 移除内存中的条目，磁盘缓存保留
+       */
+      void Unload(const char* filePath)
+      {
+        if (!filePath) {
+          return;
+        }
+        std::lock_guard<std::mutex> guard(lock_);
+        std::unordered_map<std::string, std::list<Entry>::iterator>::iterator found = index_.find(filePath);
+        if (found != index_.end()) {
+          EraseLocked(found);
+        }
+      }
+
+      /**
+       * @brief 获取统计信息
+       */
+      AliEngineAudioEffectCacheStats GetStats()
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        AliEngineAudioEffectCacheStats stats = stats_;
+        stats.entries = static_cast<int>(lru_.size());
+        stats.memoryBytes = memoryBytes_;
+        stats.diskBytes = diskBytes_;
+        return stats;
+      }
+
+    private:
+      struct FileKey {
+        std::string path;
+        long long mtime = 0;
+        long long size = 0;
+      };
+
+      struct Entry {
+        FileKey key;
+        PcmHandle pcm;
+        long long bytes = 0;
+      };
+
+      struct DiskFile {
+        std::string name;
+        long long bytes = 0;
+        long long lastUse = 0;
+      };
+
+      /* 磁盘文件头，数据紧随其后 */
+      struct DiskHeader {
+        uint32_t magic;
+        uint32_t version;
+        int32_t sampleRate;
+        int32_t channels;
+        int64_t frames;
+        int64_t mtime;
+        int64_t size;
+      };
+
+      enum {
+        kDiskMagic = 0x4D435041, /* "APCM" */
+        kDiskVersion = 1,
+      };
+
+      AliEngineAudioEffectCache(const AliEngineAudioEffectCache&);
+      AliEngineAudioEffectCache& operator=(const AliEngineAudioEffectCache&);
+
+      static bool Stat(const char* filePath, FileKey &key)
+      {
+        struct stat st;
+        if (stat(filePath, &st) != 0) {
+          return false;
+        }
+        key.path = filePath;
+        key.mtime = static_cast<long long>(st.st_mtime);
+        key.size = static_cast<long long>(st.st_size);
+        return true;
+      }
+
+      PcmHandle InsertLocked(const FileKey &key, const PcmHandle &pcm)
+      {
+        std::unordered_map<std::string, std::list<Entry>::iterator>::iterator found = index_.find(key.path);
+        if (found != index_.end()) {
+          /* 并发解码同一文件时保留先插入的条目 */
+          lru_.splice(lru_.begin(), lru_, found->second);
+          return found->second->pcm;
+        }
+        Entry entry;
+        entry.key = key;
+        entry.pcm = pcm;
+        entry.bytes = static_cast<long long>(pcm->frames) * pcm->channels * sizeof(int16_t);
+        lru_.push_front(entry);
+        index_[key.path] = lru_.begin();
+        memoryBytes_ += entry.bytes;
+        while (memoryBytes_ > config_.memoryBudgetBytes && lru_.size() > 1) {
+          EraseLocked(index_.find(lru_.back().key.path));
+          ++stats_.evictions;
+        }
+        return pcm;
+      }
+
+      void EraseLocked(std::unordered_map<std::string, std::list<Entry>::iterator>::iterator found)
+      {
+        memoryBytes_ -= found->second->bytes;
+        lru_.erase(found->second);
+        index_.erase(found);
+      }
+
+      /* 解码并转换到目标声道数和采样率 */
+      PcmHandle Decode(const FileKey &key)
+      {
+        std::vector<int16_t> decoded;
+        int rate = 0;
+        int channels = 0;
+        if (!decoder_ || !decoder_->DecodeAudioEffect(key.path.c_str(), decoded, rate, channels) ||
+            rate <= 0 || channels <= 0 || decoded.size() < static_cast<size_t>(channels)) {
+          return PcmHandle();
+        }
+        const int target = config_.channels;
+        const int frames = static_cast<int>(decoded.size() / channels);
+        std::vector<int16_t> mapped(static_cast<size_t>(frames) * target);
+        for (int i = 0; i < frames; ++i) {
+          const int16_t* src = &decoded[static_cast<size_t>(i) * channels];
+          if (target == 1) {
+            int sum = 0;
+            for (int c = 0; c < channels; ++c) {
+              sum += src[c];
+            }
+            mapped[i] = static_cast<int16_t>(sum / channels);
+          } else {
+            mapped[i * 2] = src[0];
+            mapped[i * 2 + 1] = channels > 1 ? src[1] : src[0];
+          }
+        }
+        std::shared_ptr<std::vector<int16_t> > storage(new std::vector<int16_t>());
+        if (rate == config_.sampleRate) {
+          storage->swap(mapped);
+        } else {
+          AliEngineAudioResampler resampler;
+          resampler.Init(rate, config_.sampleRate, target, config_.quality);
+          /* 补足群时延长度的静音，使输出包含完整尾部，并去掉开头的群时延 */
+          const int delay = static_cast<int>(resampler.GroupDelayFrames() * rate / config_.sampleRate + 0.5) + 1;
+          mapped.resize(mapped.size() + static_cast<size_t>(delay) * target, 0);
+          const int inFrames = frames + delay;
+          storage->resize(static_cast<size_t>(resampler.MaxOutputFrames(inFrames)) * target);
+          const int produced = resampler.Process(mapped.data(), inFrames, storage->data(), resampler.MaxOutputFrames(inFrames));
+          const int skip = static_cast<int>(resampler.GroupDelayFrames() + 0.5);
+          const int wanted = static_cast<int>(static_cast<long long>(frames) * config_.sampleRate / rate);
+          const int keep = std::min(wanted, produced - skip);
+          if (keep <= 0) {
+            return PcmHandle();
+          }
+          storage->erase(storage->begin(), storage->begin() + static_cast<size_t>(skip) * target);
+          storage->resize(static_cast<size_t>(keep) * target);
+        }
+        std::shared_ptr<AliEngineAudioEffectPcm> pcm(new AliEngineAudioEffectPcm(), HeapDeleter(storage));
+        pcm->samples = storage->data();
+        pcm->frames = static_cast<int>(storage->size() / target);
+        pcm->sampleRate = config_.sampleRate;
+        pcm->channels = target;
+        StoreDisk(key, *pcm);
+        return pcm;
+      }
+
+      /* PCM句柄销毁时一并释放所引用的存储 */
+      struct HeapDeleter {
+        explicit HeapDeleter(const std::shared_ptr<std::vector<int16_t> > &samples) : storage(samples) {}
+        void operator()(AliEngineAudioEffectPcm* pcm) const { delete pcm; }
+        std::shared_ptr<std::vector<int16_t> > storage;
+      };
+
+#if !defined(_WIN32)
+      struct MapDeleter {
+        MapDeleter(void* mapped, size_t bytes) : address(mapped), length(bytes) {}
+        void operator()(AliEngineAudioEffectPcm* pcm) const
+        {
+          munmap(address, length);
+          delete pcm;
+        }
+        void* address;
+        size_t length;
+      };
+
+      /* 文件名包含路径哈希及目标格式，不同配置的缓存互不干扰 */
+      std::string DiskName(const FileKey &key) const
+      {
+        unsigned long long hash = 1469598103934665603ULL;
+        for (size_t i = 0; i < key.path.size(); ++i) {
+          hash = (hash ^ static_cast<unsigned char>(key.path[i])) * 1099511628211ULL;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "%016llx_%d_%d.apcm", hash, config_.sampleRate, config_.channels);
+        return name;
+      }
+
+      static long long NowUs()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+      }
+
+      void ScanDisk()
+      {
+        DIR* dir = opendir(diskDir_.c_str());
+        if (!dir) {
+          return;
+        }
+        struct dirent* item;
+        while ((item = readdir(dir)) != nullptr) {
+          const std::string name = item->d_name;
+          if (name.size() < 5 || name.compare(name.size() - 5, 5, ".apcm") != 0) {
+            continue;
+          }
+          struct stat st;
+          if (stat((diskDir_ + "/" + name).c_str(), &st) == 0) {
+            DiskFile file;
+            file.name = name;
+            file.bytes = static_cast<long long>(st.st_size);
+            file.lastUse = static_cast<long long>(st.st_mtime) * 1000000;
+            disk_.push_back(file);
+            diskBytes_ += file.bytes;
+          }
+        }
+        closedir(dir);
+      }
+
+      void TouchDiskLocked(const std::string &name, long long bytes)
+      {
+        for (size_t i = 0; i < disk_.size(); ++i) {
+          if (disk_[i].name == name) {
+            diskBytes_ += bytes - disk_[i].bytes;
+            disk_[i].bytes = bytes;
+            disk_[i].lastUse = NowUs();
+            return;
+          }
+        }
+        DiskFile file;
+        file.name = name;
+        file.bytes = bytes;
+        file.lastUse = NowUs();
+        disk_.push_back(file);
+        diskBytes_ += bytes;
+      }
+
+      void TrimDiskLocked(const std::string &keep)
+      {
+        while (diskBytes_ > config_.diskBudgetBytes && disk_.size() > 1) {
+          size_t oldest = disk_.size();
+          for (size_t i = 0; i < disk_.size(); ++i) {
+            if (disk_[i].name != keep && (oldest == disk_.size() || disk_[i].lastUse < disk_[oldest].lastUse)) {
+              oldest = i;
+            }
+          }
+          if (oldest == disk_.size()) {
+            return;
+          }
+          unlink((diskDir_ + "/" + disk_[oldest].name).c_str());
+          diskBytes_ -= disk_[oldest].bytes;
+          disk_.erase(disk_.begin() + oldest);
+          ++stats_.diskEvictions;
+        }
+      }
+
+      PcmHandle LoadDisk(const FileKey &key)
+      {
+        if (diskDir_.empty()) {
+          return PcmHandle();
+        }
+        const std::string name = DiskName(key);
+        const std::string path = diskDir_ + "/" + name;
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+          return PcmHandle();
+        }
+        struct stat st;
+        void* address = MAP_FAILED;
+        size_t length = 0;
+        if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(DiskHeader))) {
+          length = static_cast<size_t>(st.st_size);
+          address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (address == MAP_FAILED) {
+          return PcmHandle();
+        }
+        DiskHeader header;
+        memcpy(&header, address, sizeof(header));
+        const size_t expected = sizeof(DiskHeader) + static_cast<size_t>(header.frames) * header.channels * sizeof(int16_t);
+        if (header.magic != kDiskMagic || header.version != kDiskVersion || header.sampleRate != config_.sampleRate ||
+            header.channels != config_.channels || header.mtime != key.mtime || header.size != key.size ||
+            header.frames <= 0 || expected != length) {
+          munmap(address, length);
+          return PcmHandle();
+        }
+        std::shared_ptr<AliEngineAudioEffectPcm> pcm(new AliEngineAudioEffectPcm(), MapDeleter(address, length));
+        pcm->samples = reinterpret_cast<const int16_t*>(static_cast<const uint8_t*>(address) + sizeof(DiskHeader));
+        pcm->frames = static_cast<int>(header.frames);
+        pcm->sampleRate = header.sampleRate;
+        pcm->channels = header.channels;
+        /* 更新文件修改时间，下次启动扫描时保持使用顺序 */
+        utimes(path.c_str(), nullptr);
+        std::lock_guard<std::mutex> guard(lock_);
+        TouchDiskLocked(name, static_cast<long long>(length));
+        return pcm;
+      }
+
+      /*
+       * 先写临时文件再重命名，其他进程或下次启动不会读到不完整的文件。
+       * 临时文件由 mkstemp 生成唯一名称，多个线程或进程同时缓存同一音效时互不覆盖，最后一次重命名生效
+       */
+      void StoreDisk(const FileKey &key, const AliEngineAudioEffectPcm &pcm)
+      {
+        if (diskDir_.empty()) {
+          return;
+        }
+        const std::string name = DiskName(key);
+        const std::string path = diskDir_ + "/" + name;
+        std::vector<char> temp(path.begin(), path.end());
+        const char suffix[] = ".XXXXXX";
+        temp.insert(temp.end(), suffix, suffix + sizeof(suffix));
+        const int fd = mkstemp(temp.data());
+        if (fd < 0) {
+          return;
+        }
+        FILE* file = fdopen(fd, "wb");
+        if (!file) {
+          close(fd);
+          unlink(temp.data());
+          return;
+        }
+        DiskHeader header;
+        memset(&header, 0, sizeof(header));
+        header.magic = kDiskMagic;
+        header.version = kDiskVersion;
+        header.sampleRate = pcm.sampleRate;
+        header.channels = pcm.channels;
+        header.frames = pcm.frames;
+        header.mtime = key.mtime;
+        header.size = key.size;
+        const size_t count = static_cast<size_t>(pcm.frames) * pcm.channels;
+        const bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                        fwrite(pcm.samples, sizeof(int16_t), count, file) == count;
+        if (fclose(file) != 0 || !ok || rename(temp.data(), path.c_str()) != 0) {
+          unlink(temp.data());
+          return;
+        }
+        std::lock_guard<std::mutex> guard(lock_);
+        TouchDiskLocked(name, static_cast<long long>(sizeof(header) + count * sizeof(int16_t)));
+        TrimDiskLocked(name);
+      }
+#else
+      PcmHandle LoadDisk(const FileKey &) { return PcmHandle(); }
+      void StoreDisk(const FileKey &, const AliEngineAudioEffectPcm &) {}
+#endif
+
+      IAliEngineAudioEffectDecoder* decoder_;
+      AliEngineAudioEffectCacheConfig config_;
+      std::string diskDir_;
+      std::mutex lock_;
+      std::list<Entry> lru_;
+      std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+      std::vector<DiskFile> disk_;
+      long long memoryBytes_ = 0;
+      long long diskBytes_ = 0;
+      AliEngineAudioEffectCacheStats stats_;
+    };
+
+    /**
+     * @brief 音效播放实例，按 {@link AliEngineAudioEffectConfig} 的起播位置和循环次数逐帧读取缓存的PCM
+     * @details 读取结果可直接送入 {@link IAliEngineMediaEngine::PushExternalAudioStreamRawData}，多个实例可通过
+     * {@link AliEngineAudioMixer} 混成一路；音量请通过外部音频流或混音器设置
+     */
+    class AliEngineAudioEffectVoice {
+    public:
+      AliEngineAudioEffectVoice(const AliEngineAudioEffectCache::PcmHandle &pcm, const AliEngineAudioEffectConfig &config)
+        : pcm_(pcm), loopsLeft_(config.loopCycles)
+      {
+        if (pcm_ && pcm_->frames > 0) {
+          position_ = static_cast<int>(static_cast<long long>(config.startPosMs) * pcm_->sampleRate / 1000);
+          position_ = position_ < pcm_->frames ? (position_ > 0 ? position_ : 0) : 0;
+        }
+        if (loopsLeft_ == 0 || loopsLeft_ < -1) {
+          loopsLeft_ = 1;
+        }
+      }
+
+      /**
+       * @brief 读取下一段数据，不足部分补零
+       * @param out int16 交错数据，容量 frames * channels
+       * @param frames 采样数（单声道）
+       * @return 有效采样数（单声道），0表示播放结束
+       */
+      int Read(int16_t* out, int frames)
+      {
+        if (!pcm_ || !out || frames <= 0) {
+          return 0;
+        }
+        const int ch = pcm_->channels;
+        int done = 0;
+        while (done < frames && !Finished()) {
+          const int chunk = std::min(frames - done, pcm_->frames - position_);
+          memcpy(out + static_cast<size_t>(done) * ch, pcm_->samples + static_cast<size_t>(position_) * ch,
+                 static_cast<size_t>(chunk) * ch * sizeof(int16_t));
+          done += chunk;
+          position_ += chunk;
+          if (position_ >= pcm_->frames) {
+            position_ = 0;
+            if (loopsLeft_ > 0) {
+              --loopsLeft_;
+            }
+          }
+        }
+        memset(out + static_cast<size_t>(done) * ch, 0, static_cast<size_t>(frames - done) * ch * sizeof(int16_t));
+        return done;
+      }
+
+      /**
+       * @brief 是否播放结束
+       */
+      bool Finished() const
+      {
+        return !pcm_ || pcm_->frames <= 0 || loopsLeft_ == 0;
+      }
+
+    private:
+      AliEngineAudioEffectCache::PcmHandle pcm_;
+      int loopsLeft_ = -1;
+      int position_ = 0;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_effect_cache_h */
@@ -0,0 +1,498 @@
+#ifndef ali_rtc_engine_audio_equalizer_h
+#define ali_rtc_engine_audio_equalizer_h
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+
+#include "engine_simd_utils.h"
+#include "engine_interface.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    namespace internal
+    {
+      enum {
+        kEqualizerBands = 10,
+        /** 参数平滑和系数更新的分块大小（单声道采样数） */
+        kEqualizerBlock = 128,
+#if defined(ALI_RTC_SIMD_AVX2)
+        /** 每个向量寄存器容纳的频段数（每个频段占左右两个声道） */
+        kEqualizerBandsPerVector = 4,
+#else
+        kEqualizerBandsPerVector = 2,
+#endif
+        kEqualizerVectors = (kEqualizerBands + kEqualizerBandsPerVector - 1) / kEqualizerBandsPerVector,
+      };
+
+      /** 峰值滤波器系数（RBJ），已按 a0 归一化 */
+      struct EqualizerCoef {
+        float b0 = 1.0f;
+        float b1 = 0.0f;
+        float b2 = 0.0f;
+        float a1 = 0.0f;
+        float a2 = 0.0f;
+      };
+
+      inline EqualizerCoef EqualizerPeaking(double frequency, double gainDb, double q, int sampleRate)
+      {
+        EqualizerCoef coef;
+        const double a = pow(10.0, gainDb / 40.0);
+        const double w0 = 2.0 * 3.14159265358979323846 * frequency / sampleRate;
+        const double alpha = sin(w0) / (2.0 * q);
+        const double cosW0 = cos(w0);
+        const double a0 = 1.0 + alpha / a;
+        coef.b0 = static_cast<float>((1.0 + alpha * a) / a0);
+        coef.b1 = static_cast<float>(-2.0 * cosW0 / a0);
+        coef.b2 = static_cast<float>((1.0 - alpha * a) / a0);
+        coef.a1 = coef.b1;
+        coef.a2 = static_cast<float>((1.0 - alpha / a) / a0);
+        return coef;
+      }
+    }
+
+    /**
+     * @brief 10段均衡器
+     * @details 频段与 {@link AliEngineAudioEffectEqualizationBandFrequency} 一致（31Hz ~ 16kHz，一个倍频程带宽的峰值滤波器），
+     * 用于对外部音频或 {@link IAudioFrameObserver} 回调数据做与 {@link IAliEngine::SetAudioEffectEqualizationParam} 相同的处理：
+     *  - 级联的各频段按一个采样的错位流水线排布在同一向量中，左右声道各占一个通道（SSE4.1/NEON 每向量2段，AVX2 每向量4段），
+     *    一次遍历数据完成全部频段，每个采样只读写一次
+     *  - 增益为0dB的频段自动从流水线中移除，全部为0dB时直接返回
+     *  - 增益变化按约20ms时间常数平滑，每128个采样更新一次系数，无拉链噪声；处理过程不分配内存
+     * @note SetBandGain 可在任意线程调用；Process 需在单一音频线程调用；支持单声道和双声道交错数据
+     */
+    class AliEngineAudioEqualizer {
+    public:
+      /**
+       * @param sampleRate 采样率
+       * @param channels 声道数，取值范围[1-2]
+       */
+      explicit AliEngineAudioEqualizer(int sampleRate = 48000, int channels = 2)
+        : sampleRate_(sampleRate > 0 ? sampleRate : 48000), channels_(channels == 1 ? 1 : 2)
+      {
+        for (int b = 0; b < internal::kEqualizerBands; ++b) {
+          target_[b].store(0.0f, std::memory_order_relaxed);
+          current_[b] = 0.0f;
+        }
+        /* 每个分块的平滑系数，对应约20ms时间常数 */
+        smoothing_ = static_cast<float>(1.0 - exp(-static_cast<double>(internal::kEqualizerBlock) / (0.02 * sampleRate_)));
+        Reset();
+      }
+
+      /**
+       * @brief 设置频段增益
+       * @param band 频段
+       * @param gainDb 增益，单位：dB，取值范围[-15, 15]
+       * @return 0: 成功；-1: 参数错误
+       */
+      int SetBandGain(AliEngineAudioEffectEqualizationBandFrequency band, float gainDb)
+      {
+        const int index = static_cast<int>(band);
+        if (index < 0 || index >= internal::kEqualizerBands || !(gainDb >= -15.0f && gainDb <= 15.0f)) {
+          return -1;
+        }
+        target_[index].store(gainDb, std::memory_order_relaxed);
+        return 0;
+      }
+
+      /**
+       * @brief 获取频段的目标增益，单位：dB
+       */
+      float GetBandGain(AliEngineAudioEffectEqualizationBandFrequency band) const
+      {
+        const int index = static_cast<int>(band);
+        return index >= 0 && index < internal::kEqualizerBands ? target_[index].load(std::memory_order_relaxed) : 0.0f;
+      }
+
+      /**
+       * @brief 当前参与处理的频段数
+       */
+      int ActiveBands() const { return activeCount_; }
+
+      /**
+       * @brief 清空滤波器状态，增益立即到达目标值
+       */
+      void Reset()
+      {
+        memset(state_, 0, sizeof(state_));
+        for (int b = 0; b < internal::kEqualizerBands; ++b) {
+          current_[b] = target_[b].load(std::memory_order_relaxed);
+        }
+        UpdateCoefficients(true);
+      }
+
+      /**
+       * @brief 原地处理 float 交错数据
+       * @param samples 数据，frames * channels 个采样
+       * @param frames 采样数（单声道）
+       */
+      void Process(float* samples, int frames)
+      {
+        for (int offset = 0; offset < frames; offset += internal::kEqualizerBlock) {
+          const int count = frames - offset < internal::kEqualizerBlock ? frames - offset : internal::kEqualizerBlock;
+          UpdateCoefficients(false);
+          if (activeCount_ > 0) {
+            ProcessBlock(samples + static_cast<size_t>(offset) * channels_, count);
+          }
+        }
+      }
+
+      /**
+       * @brief 原地处理 int16 交错数据
+       */
+      void Process(int16_t* samples, int frames)
+      {
+        float block[internal::kEqualizerBlock * 2];
+        for (int offset = 0; offset < frames; offset += internal::kEqualizerBlock) {
+          const int count = frames - offset < internal::kEqualizerBlock ? frames - offset : internal::kEqualizerBlock;
+          UpdateCoefficients(false);
+          if (activeCount_ == 0) {
+            continue;
+          }
+          int16_t* data = samples + static_cast<size_t>(offset) * channels_;
+          const int n = count * channels_;
+          for (int i = 0; i < n; ++i) {
+            block[i] = data[i];
+          }
+          ProcessBlock(block, count);
+          for (int i = 0; i < n; ++i) {
+            const float v = block[i] > 32767.0f ? 32767.0f : (block[i] < -32768.0f ? -32768.0f : block[i]);
+            data[i] = static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+          }
+        }
+      }
+
+    private:
+      AliEngineAudioEqualizer(const AliEngineAudioEqualizer&);
+      AliEngineAudioEqualizer& operator=(const AliEngineAudioEqualizer&);
+
+      /* 平滑增益并重算系数，增益为0dB的频段移出流水线 */
+      void UpdateCoefficients(bool force)
+      {
+        static const double kFrequencies[internal::kEqualizerBands] = {
+          31.0, 62.0, 125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0, 16000.0
+        };
+        bool changed = force;
+        for (int b = 0; b < internal::kEqualizerBands; ++b) {
+          const float target = target_[b].load(std::memory_order_relaxed);
+          if (current_[b] == target) {
+            continue;
+          }
+          const float diff = target - current_[b];
+          current_[b] = fabsf(diff) < 0.01f ? target : current_[b] + diff * smoothing_;
+          changed = true;
+        }
+        if (!changed) {
+          return;
+        }
+        int count = 0;
+        for (int b = 0; b < internal::kEqualizerBands; ++b) {
+          /* 中心频率不低于奈奎斯特频率的频段无法实现，按直通处理 */
+          if (current_[b] == 0.0f || kFrequencies[b] * 2.0 >= sampleRate_ * 0.95) {
+            if (active_[b]) {
+              memset(state_[b], 0, sizeof(state_[b]));
+              active_[b] = false;
+            }
+            continue;
+          }
+          coef_[b] = internal::EqualizerPeaking(kFrequencies[b], current_[b], 1.41, sampleRate_);
+          active_[b] = true;
+          order_[count++] = b;
+        }
+        activeCount_ = count;
+      }
+
+      void ProcessBlock(float* x, int n)
+      {
+#if defined(ALI_RTC_SIMD_AVX2)
+        ProcessAvx2(x, n);
+#elif defined(ALI_RTC_SIMD_SSE41) || defined(ALI_RTC_SIMD_NEON)
+        Process4(x, n);
+#else
+        ProcessScalar(x, n);
+#endif
+      }
+
+      /* 逐频段处理整块数据，SIMD 路径的参考实现 */
+      void ProcessScalar(float* x, int n)
+      {
+        for (int i = 0; i < activeCount_; ++i) {
+          const int b = order_[i];
+          const internal::EqualizerCoef &c = coef_[b];
+          for (int ch = 0; ch < channels_; ++ch) {
+            float s1 = state_[b][ch][0];
+            float s2 = state_[b][ch][1];
+            for (int k = 0; k < n; ++k) {
+              const float in = x[k * channels_ + ch];
+              const float out = c.b0 * in + s1;
+              s1 = c.b1 * in - c.a1 * out + s2;
+              s2 = c.b2 * in - c.a2 * out;
+              x[k * channels_ + ch] = out;
+            }
+            state_[b][ch][0] = s1;
+            state_[b][ch][1] = s2;
+          }
+        }
+      }
+
+      /* 把第 slot 个流水线位置对应的频段系数和状态装入 lane 数组，空位填直通系数 */
+      void LoadSlot(int slot, float* b0, float* b1, float* b2, float* a1, float* a2, float* s1, float* s2) const
+      {
+        internal::EqualizerCoef identity;
+        const bool used = slot < activeCount_;
+        const internal::EqualizerCoef &c = used ? coef_[order_[slot]] : identity;
+        for (int ch = 0; ch < 2; ++ch) {
+          b0[ch] = c.b0;
+          b1[ch] = c.b1;
+          b2[ch] = c.b2;
+          a1[ch] = c.a1;
+          a2[ch] = c.a2;
+          s1[ch] = used ? state_[order_[slot]][ch][0] : 0.0f;
+          s2[ch] = used ? state_[order_[slot]][ch][1] : 0.0f;
+        }
+      }
+
+      void StoreSlot(int slot, const float* s1, const float* s2)
+      {
+        if (slot < activeCount_) {
+          for (int ch = 0; ch < 2; ++ch) {
+            state_[order_[slot]][ch][0] = s1[ch];
+            state_[order_[slot]][ch][1] = s2[ch];
+          }
+        }
+      }
+
+#if !defined(ALI_RTC_SIMD_AVX2) && (defined(ALI_RTC_SIMD_SSE41) || defined(ALI_RTC_SIMD_NEON))
+      /* 每个向量为 [段2g左, 段2g右, 段2g+1左, 段2g+1右]；第 s 步时第 b 段处理第 s - b 个采样 */
+      void Process4(float* x, int n)
+      {
+        const int vectors = (activeCount_ + 1) / 2;
+        const int depth = vectors * 2;
+        float lanes[7][internal::kEqualizerVectors][4];
+        float index[internal::kEqualizerVectors][4];
+        for (int g = 0; g < vectors; ++g) {
+          for (int half = 0; half < 2; ++half) {
+            LoadSlot(g * 2 + half, &lanes[0][g][half * 2], &lanes[1][g][half * 2], &lanes[2][g][half * 2],
+                     &lanes[3][g][half * 2], &lanes[4][g][half * 2], &lanes[5][g][half * 2], &lanes[6][g][half * 2]);
+            index[g][half * 2] = index[g][half * 2 + 1] = static_cast<float>(g * 2 + half);
+          }
+        }
+#if defined(ALI_RTC_SIMD_SSE41)
+        __m128 b0[internal::kEqualizerVectors], b1[internal::kEqualizerVectors], b2[internal::kEqualizerVectors];
+        __m128 a1[internal::kEqualizerVectors], a2[internal::kEqualizerVectors];
+        __m128 s1[internal::kEqualizerVectors], s2[internal::kEqualizerVectors], y[internal::kEqualizerVectors];
+        __m128 band[internal::kEqualizerVectors];
+        for (int g = 0; g < vectors; ++g) {
+          b0[g] = _mm_loadu_ps(lanes[0][g]);
+          b1[g] = _mm_loadu_ps(lanes[1][g]);
+          b2[g] = _mm_loadu_ps(lanes[2][g]);
+          a1[g] = _mm_loadu_ps(lanes[3][g]);
+          a2[g] = _mm_loadu_ps(lanes[4][g]);
+          s1[g] = _mm_loadu_ps(lanes[5][g]);
+          s2[g] = _mm_loadu_ps(lanes[6][g]);
+          band[g] = _mm_loadu_ps(index[g]);
+          y[g] = _mm_setzero_ps();
+        }
+        const __m128 limit = _mm_set1_ps(static_cast<float>(n));
+        const int steps = n + depth - 1;
+        for (int s = 0; s < steps; ++s) {
+          __m128 input = _mm_setzero_ps();
+          if (s < n) {
+            input = channels_ == 2 ? _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(x + s * 2))) : _mm_load_ss(x + s);
+          }
+          /* 流水线填充和排空阶段只更新处于有效采样范围内的通道的状态 */
+          const bool edge = s < depth - 1 || s >= n;
+          const __m128 step = _mm_set1_ps(static_cast<float>(s));
+          for (int g = vectors - 1; g >= 0; --g) {
+            const __m128 in = g == 0 ? _mm_movelh_ps(input, y[0]) : _mm_shuffle_ps(y[g - 1], y[g], _MM_SHUFFLE(1, 0, 3, 2));
+            const __m128 out = _mm_add_ps(_mm_mul_ps(b0[g], in), s1[g]);
+            const __m128 n1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1[g], in), _mm_mul_ps(a1[g], out)), s2[g]);
+            const __m128 n2 = _mm_sub_ps(_mm_mul_ps(b2[g], in), _mm_mul_ps(a2[g], out));
+            if (edge) {
+              const __m128 sample = _mm_sub_ps(step, band[g]);
+              const __m128 valid = _mm_and_ps(_mm_cmpge_ps(sample, _mm_setzero_ps()), _mm_cmplt_ps(sample, limit));
+              s1[g] = _mm_blendv_ps(s1[g], n1, valid);
+              s2[g] = _mm_blendv_ps(s2[g], n2, valid);
+            } else {
+              s1[g] = n1;
+              s2[g] = n2;
+            }
+            y[g] = out;
+          }
+          const int done = s - (depth - 1);
+          if (done >= 0) {
+            if (channels_ == 2) {
+              _mm_storeh_pi(reinterpret_cast<__m64*>(x + done * 2), y[vectors - 1]);
+            } else {
+              _mm_store_ss(x + done, _mm_movehl_ps(y[vectors - 1], y[vectors - 1]));
+            }
+          }
+        }
+        for (int g = 0; g < vectors; ++g) {
+          _mm_storeu_ps(lanes[5][g], s1[g]);
+          _mm_storeu_ps(lanes[6][g], s2[g]);
+        }
+#else
+        float32x4_t b0[internal::kEqualizerVectors], b1[internal::kEqualizerVectors], b2[internal::kEqualizerVectors];
+        float32x4_t a1[internal::kEqualizerVectors], a2[internal::kEqualizerVectors];
+        float32x4_t s1[internal::kEqualizerVectors], s2[internal::kEqualizerVectors], y[internal::kEqualizerVectors];
+        float32x4_t band[internal::kEqualizerVectors];
+        for (int g = 0; g < vectors; ++g) {
+          b0[g] = vld1q_f32(lanes[0][g]);
+          b1[g] = vld1q_f32(lanes[1][g]);
+          b2[g] = vld1q_f32(lanes[2][g]);
+          a1[g] = vld1q_f32(lanes[3][g]);
+          a2[g] = vld1q_f32(lanes[4][g]);
+          s1[g] = vld1q_f32(lanes[5][g]);
+          s2[g] = vld1q_f32(lanes[6][g]);
+          band[g] = vld1q_f32(index[g]);
+          y[g] = vdupq_n_f32(0.0f);
+        }
+        const float32x4_t limit = vdupq_n_f32(static_cast<float>(n));
+        const int steps = n + depth - 1;
+        for (int s = 0; s < steps; ++s) {
+          float32x2_t input = vdup_n_f32(0.0f);
+          if (s < n) {
+            input = channels_ == 2 ? vld1_f32(x + s * 2) : vset_lane_f32(x[s], input, 0);
+          }
+          const bool edge = s < depth - 1 || s >= n;
+          const float32x4_t step = vdupq_n_f32(static_cast<float>(s));
+          for (int g = vectors - 1; g >= 0; --g) {
+            const float32x4_t in = g == 0 ? vcombine_f32(input, vget_low_f32(y[0]))
+                                          : vcombine_f32(vget_high_f32(y[g - 1]), vget_low_f32(y[g]));
+            const float32x4_t out = vaddq_f32(vmulq_f32(b0[g], in), s1[g]);
+            const float32x4_t n1 = vaddq_f32(vsubq_f32(vmulq_f32(b1[g], in), vmulq_f32(a1[g], out)), s2[g]);
+            const float32x4_t n2 = vsubq_f32(vmulq_f32(b2[g], in), vmulq_f32(a2[g], out));
+            if (edge) {
+              const float32x4_t sample = vsubq_f32(step, band[g]);
+              const uint32x4_t valid = vandq_u32(vcgeq_f32(sample, vdupq_n_f32(0.0f)), vcltq_f32(sample, limit));
+              s1[g] = vbslq_f32(valid, n1, s1[g]);
+              s2[g] = vbslq_f32(valid, n2, s2[g]);
+            } else {
+              s1[g] = n1;
+              s2[g] = n2;
+            }
+            y[g] = out;
+          }
+          const int done = s - (depth - 1);
+          if (done >= 0) {
+            const float32x2_t last = vget_high_f32(y[vectors - 1]);
+            if (channels_ == 2) {
+              vst1_f32(x + done * 2, last);
+            } else {
+              x[done] = vget_lane_f32(last, 0);
+            }
+          }
+        }
+        for (int g = 0; g < vectors; ++g) {
+          vst1q_f32(lanes[5][g], s1[g]);
+          vst1q_f32(lanes[6][g], s2[g]);
+        }
+#endif
+        for (int g = 0; g < vectors; ++g) {
+          for (int half = 0; half < 2; ++half) {
+            StoreSlot(g * 2 + half, &lanes[5][g][half * 2], &lanes[6][g][half * 2]);
+          }
+        }
+      }
+#endif
+
+#if defined(ALI_RTC_SIMD_AVX2)
+      /* 每个向量为4个频段的左右声道，跨向量的错位通过 permute + blend 完成 */
+      void ProcessAvx2(float* x, int n)
+      {
+        const int vectors = (activeCount_ + 3) / 4;
+        const int depth = vectors * 4;
+        float lanes[7][internal::kEqualizerVectors][8];
+        float index[internal::kEqualizerVectors][8];
+        for (int g = 0; g < vectors; ++g) {
+          for (int q = 0; q < 4; ++q) {
+            LoadSlot(g * 4 + q, &lanes[0][g][q * 2], &lanes[1][g][q * 2], &lanes[2][g][q * 2],
+                     &lanes[3][g][q * 2], &lanes[4][g][q * 2], &lanes[5][g][q * 2], &lanes[6][g][q * 2]);
+            index[g][q * 2] = index[g][q * 2 + 1] = static_cast<float>(g * 4 + q);
+          }
+        }
+        __m256 b0[internal::kEqualizerVectors], b1[internal::kEqualizerVectors], b2[internal::kEqualizerVectors];
+        __m256 a1[internal::kEqualizerVectors], a2[internal::kEqualizerVectors];
+        __m256 s1[internal::kEqualizerVectors], s2[internal::kEqualizerVectors], y[internal::kEqualizerVectors];
+        __m256 band[internal::kEqualizerVectors];
+        for (int g = 0; g < vectors; ++g) {
+          b0[g] = _mm256_loadu_ps(lanes[0][g]);
+          b1[g] = _mm256_loadu_ps(lanes[1][g]);
+          b2[g] = _mm256_loadu_ps(lanes[2][g]);
+          a1[g] = _mm256_loadu_ps(lanes[3][g]);
+          a2[g] = _mm256_loadu_ps(lanes[4][g]);
+          s1[g] = _mm256_loadu_ps(lanes[5][g]);
+          s2[g] = _mm256_loadu_ps(lanes[6][g]);
+          band[g] = _mm256_loadu_ps(index[g]);
+          y[g] = _mm256_setzero_ps();
+        }
+        const __m256i rotate = _mm256_setr_epi32(6, 7, 0, 1, 2, 3, 4, 5);
+        const __m256 limit = _mm256_set1_ps(static_cast<float>(n));
+        const int steps = n + depth - 1;
+        for (int s = 0; s < steps; ++s) {
+          __m128 input = _mm_setzero_ps();
+          if (s < n) {
+            input = channels_ == 2 ? _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(x + s * 2))) : _mm_load_ss(x + s);
+          }
+          const bool edge = s < depth - 1 || s >= n;
+          const __m256 step = _mm256_set1_ps(static_cast<float>(s));
+          for (int g = vectors - 1; g >= 0; --g) {
+            const __m256 shifted = _mm256_permutevar8x32_ps(y[g], rotate);
+            const __m256 carry = g == 0 ? _mm256_castps128_ps256(input) : _mm256_permutevar8x32_ps(y[g - 1], rotate);
+            const __m256 in = _mm256_blend_ps(shifted, carry, 0x03);
+            const __m256 out = _mm256_add_ps(_mm256_mul_ps(b0[g], in), s1[g]);
+            const __m256 n1 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(b1[g], in), _mm256_mul_ps(a1[g], out)), s2[g]);
+            const __m256 n2 = _mm256_sub_ps(_mm256_mul_ps(b2[g], in), _mm256_mul_ps(a2[g], out));
+            if (edge) {
+              const __m256 sample = _mm256_sub_ps(step, band[g]);
+              const __m256 valid = _mm256_and_ps(_mm256_cmp_ps(sample, _mm256_setzero_ps(), _CMP_GE_OQ),
+                                                 _mm256_cmp_ps(sample, limit, _CMP_LT_OQ));
+              s1[g] = _mm256_blendv_ps(s1[g], n1, valid);
+              s2[g] = _mm256_blendv_ps(s2[g], n2, valid);
+            } else {
+              s1[g] = n1;
+              s2[g] = n2;
+            }
+            y[g] = out;
+          }
+          const int done = s - (depth - 1);
+          if (done >= 0) {
+            const __m128 high = _mm256_extractf128_ps(y[vectors - 1], 1);
+            if (channels_ == 2) {
+              _mm_storeh_pi(reinterpret_cast<__m64*>(x + done * 2), high);
+            } else {
+              _mm_store_ss(x + done, _mm_movehl_ps(high, high));
+            }
+          }
+        }
+        for (int g = 0; g < vectors; ++g) {
+          _mm256_storeu_ps(lanes[5][g], s1[g]);
+          _mm256_storeu_ps(lanes[6][g], s2[g]);
+        }
+        for (int g = 0; g < vectors; ++g) {
+          for (int q = 0; q < 4; ++q) {
+            StoreSlot(g * 4 + q, &lanes[5][g][q * 2], &lanes[6][g][q * 2]);
+          }
+        }
+      }
+#endif
+
+      const int sampleRate_;
+      const int channels_;
+      float smoothing_ = 1.0f;
+      std::atomic<float> target_[internal::kEqualizerBands];
+      float current_[internal::kEqualizerBands];
+      bool active_[internal::kEqualizerBands] = {};
+      int order_[internal::kEqualizerBands] = {};
+      int activeCount_ = 0;
+      internal::EqualizerCoef coef_[internal::kEqualizerBands];
+      /* 每个频段、每个声道的转置直接II型状态 */
+      float state_[internal::kEqualizerBands][2][2];
+    };
+}
+
+#endif /* ali_rtc_engine_audio_equalizer_h */
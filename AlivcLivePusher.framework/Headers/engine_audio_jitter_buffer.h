@@ -0,0 +1,581 @@
+#ifndef ali_rtc_engine_audio_jitter_buffer_h
+#define ali_rtc_engine_audio_jitter_buffer_h
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "engine_interface.h"
+#include "engine_lockfree_queue.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 外部音频播放抖动缓冲配置
+     */
+    typedef struct AliEngineAudioJitterConfig {
+      /** 采样率，默认值：48000 */
+      int sampleRate = 48000;
+      /** 声道数，默认值：1 */
+      int channels = 1;
+      /** 每次投递给SDK的时长，单位：ms，默认值：10 */
+      int frameMs = 10;
+      /** 缓冲容量，单位：ms，默认值：1000 */
+      int capacityMs = 1000;
+      /** 目标缓冲时长下限，单位：ms，默认值：40 */
+      int minTargetMs = 40;
+      /** 目标缓冲时长上限，单位：ms，默认值：400 */
+      int maxTargetMs = 400;
+      /** 欠载时丢包补偿的最长时长，超过后静音并重新缓冲，单位：ms，默认值：60 */
+      int maxConcealMs = 60;
+      /** 统计回调间隔，单位：ms，0表示不回调，默认值：2000 */
+      int statsIntervalMs = 2000;
+    } AliEngineAudioJitterConfig;
+
+    /**
+     * @brief 外部音频播放抖动缓冲统计信息
+     */
+    typedef struct AliEngineAudioJitterStats {
+      /** 当前缓冲时长，单位：ms */
+      int bufferedMs = 0;
+      /** 当前目标缓冲时长，单位：ms */
+      int targetMs = 0;
+      /** 到达抖动估计，单位：ms */
+      int jitterMs = 0;
+      /** 写入采样数（单声道） */
+      unsigned long long writtenSamples = 0;
+      /** 投递采样数（单声道），包含补偿和静音 */
+      unsigned long long renderedSamples = 0;
+      /** 欠载次数 */
+      unsigned long long underruns = 0;
+      /** 丢包补偿采样数（单声道） */
+      unsigned long long concealedSamples = 0;
+      /** 补偿超时后重新缓冲的次数 */
+      unsigned long long rebuffers = 0;
+      /** 缓冲满导致写入不完整的次数 */
+      unsigned long long overruns = 0;
+      /** 缓冲满丢弃的采样数（单声道） */
+      unsigned long long droppedSamples = 0;
+      /** 为消化积压通过时间压缩去掉的采样数（单声道） */
+      unsigned long long stretchedSamples = 0;
+      /** SDK返回 AliEngineErrorAudioBufferFull 后的重试次数 */
+      unsigned long long sinkRetries = 0;
+    } AliEngineAudioJitterStats;
+
+    /**
+     * @brief 投递函数，返回值语义与 {@link IAliEngineMediaEngine::PushExternalAudioRenderRawData} 一致
+     * @param samples int16 交错数据
+     * @param frames 采样数（单声道）
+     */
+    typedef int (*AliEngineAudioRenderSink)(void* opaque, const int16_t* samples, int frames, int sampleRate, int channels, long long timestamp);
+
+    /**
+     * @brief 通过 {@link IAliEngineMediaEngine::PushExternalAudioRenderRawData} 投递，opaque 为 IAliEngineMediaEngine*，
+     * sampleLength 按buffer字节数传入
+     */
+    inline int AliEngineAudioRenderSinkMediaEngine(void* opaque, const int16_t* samples, int frames, int sampleRate, int channels, long long timestamp)
+    {
+      IAliEngineMediaEngine* engine = static_cast<IAliEngineMediaEngine*>(opaque);
+      if (!engine) {
+        return AliEngineErrorInvaildArgument;
+      }
+      return engine->PushExternalAudioRenderRawData(samples, static_cast<unsigned int>(frames * channels * sizeof(int16_t)),
+                                                    static_cast<unsigned int>(sampleRate), static_cast<unsigned int>(channels), timestamp);
+    }
+
+    /**
+     * @}
+     */
+
+    /**
+     * @addtogroup AliEngineCallback 回调及监听
+     * AliRtc 回调及监听
+     * @{
+     */
+
+    /**
+     * @brief 抖动缓冲统计监听接口
+     */
+    class IAliEngineAudioJitterObserver {
+    public:
+      virtual ~IAliEngineAudioJitterObserver() {}
+
+      /**
+       * @brief 抖动缓冲统计，按 statsIntervalMs 在读取线程回调
+       * @param stats 统计信息
+       */
+      virtual void OnAudioRenderJitterStats(const AliEngineAudioJitterStats &stats) {}
+    };
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      /**
+       * @brief 在 [minLag, maxLag] 内查找与 ref 最相似的位置，比较 ref 与 ref + sign * lag 开始的 window 个采样（只用第一个声道）
+       */
+      inline int JitterBestLag(const int16_t* ref, int channels, int window, int minLag, int maxLag, int sign)
+      {
+        int best = minLag;
+        double bestScore = -1e300;
+        for (int lag = minLag; lag <= maxLag; ++lag) {
+          const int16_t* cand = ref + sign * lag * channels;
+          long long xy = 0;
+          long long yy = 0;
+          for (int i = 0; i < window; ++i) {
+            const int a = ref[i * channels];
+            const int b = cand[i * channels];
+            xy += a * b;
+            yy += b * b;
+          }
+          const double score = yy > 0 ? xy / sqrt(static_cast<double>(yy)) : 0.0;
+          if (score > bestScore) {
+            bestScore = score;
+            best = lag;
+          }
+        }
+        return best;
+      }
+    }
+
+    /**
+     * @brief 外部音频播放抖动缓冲
+     * @details 位于 {@link IAliEngineMediaEngine::PushExternalAudioRenderRawData} 之前的单生产者单消费者无锁环形缓冲：
+     *  - 网络线程调用 Write 只做无锁拷贝，不加锁、不分配内存；读取端的工作缓冲在构造时按帧长和最大基音周期分配
+     *  - 目标缓冲时长按到达抖动（相对最小传输时延的峰值）自适应，每次欠载后临时加大，随后缓慢回落
+     *  - 欠载时按最近输出的基音周期重复并渐弱做丢包补偿，数据恢复时交叉淡入；补偿超过 maxConcealMs 后静音并重新缓冲
+     *  - 积压超过目标时按波形相似度去掉一个周期并交叉淡化（WSOLA），每帧最多压缩一半，不丢弃整段数据
+     *  - 统计信息通过 {@link IAliEngineAudioJitterObserver} 定期回调，也可随时调用 GetStats
+     * 读取端可以由内部投递线程按 frameMs 节拍驱动（Start），也可以由调用方在自己的播放回调中调用 Read
+     * @note Write 和 Read 各自只能在一个线程调用
+     */
+    class AliEngineAudioRenderJitterBuffer {
+    public:
+      /**
+       * @param config 配置
+       * @param observer 统计监听，可为空，需在缓冲销毁前保持有效
+       */
+      explicit AliEngineAudioRenderJitterBuffer(const AliEngineAudioJitterConfig &config = AliEngineAudioJitterConfig(),
+                                                IAliEngineAudioJitterObserver* observer = nullptr)
+        : config_(Normalize(config)), observer_(observer),
+          ring_(static_cast<size_t>(config_.sampleRate) * config_.capacityMs / 1000 * config_.channels)
+      {
+        const int rate = config_.sampleRate;
+        frameFrames_ = MsToFrames(config_.frameMs);
+        minLag_ = rate / 400;
+        maxLag_ = rate * 15 / 1000;
+        window_ = rate / 200;
+        fadeFrames_ = rate / 400;
+        historyFrames_ = maxLag_ + window_;
+        history_.assign(static_cast<size_t>(historyFrames_) * config_.channels, 0);
+        /* 每次读取只压缩开头的 compressFrames_ 个采样，压缩与淡入的缓冲在此一次分配，读取路径不再分配内存 */
+        compressFrames_ = frameFrames_ > window_ * 2 ? frameFrames_ : window_ * 2;
+        scratch_.assign(static_cast<size_t>(compressFrames_ + maxLag_) * config_.channels, 0);
+        fade_.assign(static_cast<size_t>(fadeFrames_) * config_.channels, 0);
+        targetMs_.store(config_.minTargetMs, std::memory_order_relaxed);
+      }
+
+      ~AliEngineAudioRenderJitterBuffer()
+      {
+        Stop();
+      }
+
+      /**
+       * @brief 写入数据，在网络线程调用
+       * @param samples int16 交错数据，声道数与采样率需与配置一致
+       * @param frames 采样数（单声道）
+       * @return 实际写入的采样数（单声道），缓冲满时小于 frames
+       */
+      int Write(const int16_t* samples, int frames)
+      {
+        if (!samples || frames <= 0) {
+          return 0;
+        }
+        const int ch = config_.channels;
+        UpdateJitter(frames);
+        /* 只写入整帧，避免多声道数据错位 */
+        const int space = static_cast<int>((ring_.Capacity() - ring_.Size()) / ch);
+        const int accepted = frames < space ? frames : space;
+        const int written = static_cast<int>(ring_.Write(samples, static_cast<size_t>(accepted) * ch) / ch);
+        written_.fetch_add(written, std::memory_order_relaxed);
+        if (written < frames) {
+          overruns_.fetch_add(1, std::memory_order_relaxed);
+          dropped_.fetch_add(frames - written, std::memory_order_relaxed);
+        }
+        return written;
+      }
+
+      /**
+       * @brief 读取数据，在播放线程调用；数据不足时输出补偿数据或静音
+       * @param out int16 交错数据，容量 frames * channels
+       * @param frames 采样数（单声道）
+       * @return 其中来自实际数据的采样数（单声道）
+       */
+      int Read(int16_t* out, int frames)
+      {
+        if (!out || frames <= 0) {
+          return 0;
+        }
+        const int ch = config_.channels;
+        const int target = UpdateTarget(frames);
+        const int targetFrames = MsToFrames(target);
+        const int available = static_cast<int>(ring_.Size() / ch);
+        int real = 0;
+        rendered_.fetch_add(frames, std::memory_order_relaxed);
+
+        if (state_ == kBuffering && available >= targetFrames + frames) {
+          state_ = kPlaying;
+        }
+        if (state_ == kBuffering) {
+          memset(out, 0, static_cast<size_t>(frames) * ch * sizeof(int16_t));
+        } else if (available >= frames + (state_ == kConcealing ? frameFrames_ : 0)) {
+          const int excess = TrackBacklog(available - frames, targetFrames);
+          const int span = frames < compressFrames_ ? frames : compressFrames_;
+          const int maxLag = excess < span / 2 ? excess : span / 2;
+          if (maxLag >= minLag_ && span >= window_) {
+            compressBudget_ -= Compress(out, span, maxLag < maxLag_ ? maxLag : maxLag_);
+            ring_.Read(out + static_cast<size_t>(span) * ch, static_cast<size_t>(frames - span) * ch);
+          } else {
+            ring_.Read(out, static_cast<size_t>(frames) * ch);
+          }
+          if (state_ == kConcealing) {
+            FadeFromConcealment(out, frames);
+          }
+          state_ = kPlaying;
+          PushHistory(out, frames);
+          real = frames;
+        } else {
+          if (state_ == kPlaying) {
+            underruns_.fetch_add(1, std::memory_order_relaxed);
+            boostMs_ = boostMs_ + 2.0f * config_.frameMs;
+            const int limit = config_.maxTargetMs;
+            boostMs_ = boostMs_ > limit ? limit : boostMs_;
+            period_ = internal::JitterBestLag(&history_[static_cast<size_t>(historyFrames_ - window_) * ch], ch, window_, minLag_, maxLag_, -1);
+            concealPos_ = 0;
+            state_ = kConcealing;
+          }
+          const int concealFrames = MsToFrames(config_.maxConcealMs);
+          Conceal(out, frames, concealPos_);
+          concealPos_ += frames;
+          concealed_.fetch_add(frames, std::memory_order_relaxed);
+          if (concealPos_ >= concealFrames) {
+            rebuffers_.fetch_add(1, std::memory_order_relaxed);
+            state_ = kBuffering;
+          }
+        }
+        MaybeReportStats();
+        return real;
+      }
+
+      /**
+       * @brief 启动内部投递线程，按 frameMs 节拍读取并投递
+       * @param sink 投递函数，详见 {@link AliEngineAudioRenderSinkMediaEngine}
+       * @param opaque 投递函数的用户数据
+       */
+      void Start(AliEngineAudioRenderSink sink, void* opaque)
+      {
+        std::lock_guard<std::mutex> guard(threadLock_);
+        if (worker_.joinable() || !sink) {
+          return;
+        }
+        sink_ = sink;
+        opaque_ = opaque;
+        running_.store(true, std::memory_order_release);
+        worker_ = std::thread(&AliEngineAudioRenderJitterBuffer::Run, this);
+      }
+
+      /**
+       * @brief 停止内部投递线程
+       */
+      void Stop()
+      {
+        std::lock_guard<std::mutex> guard(threadLock_);
+        {
+          std::lock_guard<std::mutex> waitGuard(waitLock_);
+          running_.store(false, std::memory_order_release);
+        }
+        waitCv_.notify_all();
+        if (worker_.joinable()) {
+          worker_.join();
+        }
+      }
+
+      /**
+       * @brief 获取统计信息
+       */
+      AliEngineAudioJitterStats GetStats() const
+      {
+        AliEngineAudioJitterStats stats;
+        stats.bufferedMs = static_cast<int>(ring_.Size() / config_.channels * 1000 / config_.sampleRate);
+        stats.targetMs = targetMs_.load(std::memory_order_relaxed);
+        stats.jitterMs = jitterUs_.load(std::memory_order_relaxed) / 1000;
+        stats.writtenSamples = written_.load(std::memory_order_relaxed);
+        stats.renderedSamples = rendered_.load(std::memory_order_relaxed);
+        stats.underruns = underruns_.load(std::memory_order_relaxed);
+        stats.concealedSamples = concealed_.load(std::memory_order_relaxed);
+        stats.rebuffers = rebuffers_.load(std::memory_order_relaxed);
+        stats.overruns = overruns_.load(std::memory_order_relaxed);
+        stats.droppedSamples = dropped_.load(std::memory_order_relaxed);
+        stats.stretchedSamples = stretched_.load(std::memory_order_relaxed);
+        stats.sinkRetries = retries_.load(std::memory_order_relaxed);
+        return stats;
+      }
+
+    private:
+      enum {
+        kBuffering = 0,
+        kPlaying = 1,
+        kConcealing = 2,
+      };
+
+      AliEngineAudioRenderJitterBuffer(const AliEngineAudioRenderJitterBuffer&);
+      AliEngineAudioRenderJitterBuffer& operator=(const AliEngineAudioRenderJitterBuffer&);
+
+      static AliEngineAudioJitterConfig Normalize(AliEngineAudioJitterConfig config)
+      {
+        config.sampleRate = config.sampleRate >= 8000 ? config.sampleRate : 8000;
+        config.channels = config.channels > 0 ? config.channels : 1;
+        config.frameMs = config.frameMs > 0 ? config.frameMs : 10;
+        config.minTargetMs = config.minTargetMs > config.frameMs ? config.minTargetMs : config.frameMs;
+        config.maxTargetMs = config.maxTargetMs > config.minTargetMs ? config.maxTargetMs : config.minTargetMs;
+        const int minCapacity = config.maxTargetMs + 4 * config.frameMs;
+        config.capacityMs = config.capacityMs > minCapacity ? config.capacityMs : minCapacity;
+        config.maxConcealMs = config.maxConcealMs > 0 ? config.maxConcealMs : config.frameMs;
+        return config;
+      }
+
+      int MsToFrames(int ms) const
+      {
+        return static_cast<int>(static_cast<long long>(config_.sampleRate) * ms / 1000);
+      }
+
+      static long long NowUs()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /* 写入线程：传输时延 = 到达时刻 - 媒体时刻，抖动取相对最小传输时延的峰值并缓慢衰减 */
+      void UpdateJitter(int frames)
+      {
+        const long long now = NowUs();
+        const long long transit = now - mediaUs_;
+        mediaUs_ += static_cast<long long>(frames) * 1000000 / config_.sampleRate;
+        if (!hasTransit_ || transit < minTransitUs_ || transit - minTransitUs_ > 2000000) {
+          /* 首次写入或长时间中断后重新建立基准 */
+          minTransitUs_ = transit;
+          hasTransit_ = true;
+        } else {
+          /* 允许基准缓慢上移，吸收两端时钟漂移 */
+          minTransitUs_ += (transit - minTransitUs_) / 1000;
+        }
+        const double delay = static_cast<double>(transit - minTransitUs_);
+        jitterPeakUs_ = delay > jitterPeakUs_ ? delay : jitterPeakUs_ * 0.9995;
+        jitterUs_.store(static_cast<int>(jitterPeakUs_), std::memory_order_relaxed);
+      }
+
+      /* 读取线程：目标 = 抖动 + 一帧 + 欠载补偿量，补偿量每秒回落 frameMs */
+      int UpdateTarget(int frames)
+      {
+        boostMs_ -= static_cast<float>(config_.frameMs) * frames / config_.sampleRate;
+        boostMs_ = boostMs_ > 0 ? boostMs_ : 0;
+        int target = jitterUs_.load(std::memory_order_relaxed) / 1000 + config_.frameMs + static_cast<int>(boostMs_);
+        target = target < config_.minTargetMs ? config_.minTargetMs : (target > config_.maxTargetMs ? config_.maxTargetMs : target);
+        targetMs_.store(target, std::memory_order_relaxed);
+        return target;
+      }
+
+      /* 只压缩持续存在的积压：统计每秒内读取后的最低缓冲量，超过目标一帧以上的部分作为下一秒的压缩额度，
+       * 突发到达造成的瞬时积压会被随后的迟到抵消，不做压缩 */
+      int TrackBacklog(int remaining, int targetFrames)
+      {
+        lowWater_ = remaining < lowWater_ ? remaining : lowWater_;
+        windowFrames_ += frameFrames_;
+        if (windowFrames_ >= config_.sampleRate) {
+          const int standing = lowWater_ - targetFrames - frameFrames_;
+          compressBudget_ = standing > 0 ? standing : 0;
+          lowWater_ = remaining;
+          windowFrames_ = 0;
+        }
+        const int excess = remaining - targetFrames;
+        return excess < compressBudget_ ? excess : compressBudget_;
+      }
+
+      /* 读取 frames + lag 个采样输出 frames 个：前 lag 个采样由 x[i] 过渡到 x[i + lag]，返回 lag。frames 不超过 compressFrames_ */
+      int Compress(int16_t* out, int frames, int maxLag)
+      {
+        const int ch = config_.channels;
+        ring_.Peek(scratch_.data(), static_cast<size_t>(frames + maxLag) * ch);
+        const int lag = internal::JitterBestLag(scratch_.data(), ch, window_, minLag_, maxLag, 1);
+        for (int i = 0; i < lag; ++i) {
+          const float w = (i + 0.5f) / lag;
+          for (int c = 0; c < ch; ++c) {
+            const float v = scratch_[i * ch + c] * (1.0f - w) + scratch_[(i + lag) * ch + c] * w;
+            out[i * ch + c] = static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+          }
+        }
+        memcpy(out + static_cast<size_t>(lag) * ch, &scratch_[static_cast<size_t>(2 * lag) * ch],
+               static_cast<size_t>(frames - lag) * ch * sizeof(int16_t));
+        ring_.Consume(static_cast<size_t>(frames + lag) * ch);
+        stretched_.fetch_add(lag, std::memory_order_relaxed);
+        return lag;
+      }
+
+      /* 循环重复历史末尾的一个基音周期，增益在 maxConcealMs 内线性降到0 */
+      void Conceal(int16_t* out, int frames, int position) const
+      {
+        const int ch = config_.channels;
+        const int total = MsToFrames(config_.maxConcealMs);
+        const int16_t* base = &history_[static_cast<size_t>(historyFrames_ - period_) * ch];
+        for (int i = 0; i < frames; ++i) {
+          const int pos = position + i;
+          const float gain = pos < total ? 1.0f - static_cast<float>(pos) / total : 0.0f;
+          const int16_t* src = base + static_cast<size_t>(pos % period_) * ch;
+          for (int c = 0; c < ch; ++c) {
+            out[i * ch + c] = static_cast<int16_t>(src[c] * gain);
+          }
+        }
+      }
+
+      void FadeFromConcealment(int16_t* out, int frames)
+      {
+        const int ch = config_.channels;
+        const int fade = fadeFrames_ < frames ? fadeFrames_ : frames;
+        Conceal(fade_.data(), fade, concealPos_);
+        for (int i = 0; i < fade; ++i) {
+          const float w = (i + 0.5f) / fade;
+          for (int c = 0; c < ch; ++c) {
+            const float v = fade_[i * ch + c] * (1.0f - w) + out[i * ch + c] * w;
+            out[i * ch + c] = static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+          }
+        }
+      }
+
+      void PushHistory(const int16_t* out, int frames)
+      {
+        const int ch = config_.channels;
+        if (frames >= historyFrames_) {
+          memcpy(history_.data(), out + static_cast<size_t>(frames - historyFrames_) * ch, history_.size() * sizeof(int16_t));
+          return;
+        }
+        const size_t keep = static_cast<size_t>(historyFrames_ - frames) * ch;
+        memmove(history_.data(), history_.data() + static_cast<size_t>(frames) * ch, keep * sizeof(int16_t));
+        memcpy(history_.data() + keep, out, static_cast<size_t>(frames) * ch * sizeof(int16_t));
+      }
+
+      void MaybeReportStats()
+      {
+        if (!observer_ || config_.statsIntervalMs <= 0) {
+          return;
+        }
+        const long long now = NowUs();
+        if (lastStatsUs_ == 0) {
+          lastStatsUs_ = now;
+        } else if (now - lastStatsUs_ >= config_.statsIntervalMs * 1000LL) {
+          lastStatsUs_ = now;
+          observer_->OnAudioRenderJitterStats(GetStats());
+        }
+      }
+
+      void Run()
+      {
+        const int ch = config_.channels;
+        std::vector<int16_t> frame(static_cast<size_t>(frameFrames_) * ch);
+        bool pending = false;
+        long long timestamp = 0;
+        long long next = NowUs();
+        while (running_.load(std::memory_order_acquire)) {
+          if (!pending) {
+            Read(frame.data(), frameFrames_);
+            pending = true;
+          }
+          long long interval = config_.frameMs * 1000LL;
+          const int result = sink_(opaque_, frame.data(), frameFrames_, config_.sampleRate, ch, timestamp);
+          if (result == AliEngineErrorAudioBufferFull) {
+            /* SDK内部缓冲已满，按接口说明等待20ms后重投当前帧，期间积压由时间压缩消化 */
+            retries_.fetch_add(1, std::memory_order_relaxed);
+            interval = 20000;
+          } else {
+            pending = false;
+            timestamp += config_.frameMs;
+          }
+          next += interval;
+          const long long now = NowUs();
+          if (next < now - 100000) {
+            next = now;
+          }
+          std::unique_lock<std::mutex> guard(waitLock_);
+          waitCv_.wait_for(guard, std::chrono::microseconds(next > now ? next - now : 0),
+                           [this] { return !running_.load(std::memory_order_acquire); });
+        }
+      }
+
+      const AliEngineAudioJitterConfig config_;
+      IAliEngineAudioJitterObserver* observer_;
+      internal::SpscRingBuffer<int16_t> ring_;
+      int frameFrames_ = 0;
+      int minLag_ = 0;
+      int maxLag_ = 0;
+      int window_ = 0;
+      int fadeFrames_ = 0;
+      int historyFrames_ = 0;
+      int compressFrames_ = 0;
+
+      /* 写入线程 */
+      long long mediaUs_ = 0;
+      long long minTransitUs_ = 0;
+      bool hasTransit_ = false;
+      double jitterPeakUs_ = 0;
+
+      /* 读取线程 */
+      int state_ = kBuffering;
+      float boostMs_ = 0;
+      int period_ = 1;
+      int concealPos_ = 0;
+      int lowWater_ = 0x7FFFFFFF;
+      int windowFrames_ = 0;
+      int compressBudget_ = 0;
+      long long lastStatsUs_ = 0;
+      std::vector<int16_t> history_;
+      std::vector<int16_t> scratch_;
+      std::vector<int16_t> fade_;
+
+      std::atomic<int> jitterUs_{0};
+      std::atomic<int> targetMs_{0};
+      std::atomic<unsigned long long> written_{0};
+      std::atomic<unsigned long long> rendered_{0};
+      std::atomic<unsigned long long> underruns_{0};
+      std::atomic<unsigned long long> concealed_{0};
+      std::atomic<unsigned long long> rebuffers_{0};
+      std::atomic<unsigned long long> overruns_{0};
+      std::atomic<unsigned long long> dropped_{0};
+      std::atomic<unsigned long long> stretched_{0};
+      std::atomic<unsigned long long> retries_{0};
+
+      AliEngineAudioRenderSink sink_ = nullptr;
+      void* opaque_ = nullptr;
+      std::mutex threadLock_;
+      std::mutex waitLock_;
+      std::condition_variable waitCv_;
+      std::atomic<bool> running_{false};
+      std::thread worker_;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_jitter_buffer_h */
@@ -0,0 +1,385 @@
+#ifndef ali_rtc_engine_audio_mixer_h
+#define ali_rtc_engine_audio_mixer_h
+
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_media_engine.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 混音器配置
+     */
+    typedef struct AliEngineAudioMixerConfig {
+      /** 采样率，所有输入流需一致，默认值：48000 */
+      int sampleRate = 48000;
+      /** 声道数，所有输入流需一致，默认值：1 */
+      int channels = 1;
+      /** 最大输入流数，默认值：32 */
+      int maxStreams = 32;
+      /** 增益变化的过渡时长，单位：ms，默认值：10 */
+      int rampMs = 10;
+      /** 输出采样格式，2: int16，4: float，默认值：2 */
+      int outputBytesPerSample = 2;
+    } AliEngineAudioMixerConfig;
+
+    /**
+     * @brief 单路混音输入
+     */
+    typedef struct AliEngineAudioMixerInput {
+      /** {@link AliEngineAudioMixer::AddStream} 返回的流ID */
+      int streamId = -1;
+      /** 音频数据，bytesPerSample 为2（int16）或4（float，取值范围[-1, 1]） */
+      const AliEngineAudioRawData* data = nullptr;
+    } AliEngineAudioMixerInput;
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      /** acc[i] += src[i] * gain，src 为 int16 */
+      inline void MixAccumulateS16(float* ALI_RTC_RESTRICT acc, const int16_t* ALI_RTC_RESTRICT src, float gain, int count)
+      {
+        const float scale = gain * (1.0f / 32768.0f);
+        int i = 0;
+#if defined(ALI_RTC_SIMD_AVX2)
+        const __m256 g8 = _mm256_set1_ps(scale);
+        for (; i + 8 <= count; i += 8) {
+          const __m256 x = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+          _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(x, g8)));
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        const __m128 g4 = _mm_set1_ps(scale);
+        for (; i + 8 <= count; i += 8) {
+          const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+          const __m128 lo = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(s));
+          const __m128 hi = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(s, 8)));
+          _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(lo, g4)));
+          _mm_storeu_ps(acc + i + 4, _mm_add_ps(_mm_loadu_ps(acc + i + 4), _mm_mul_ps(hi, g4)));
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        for (; i + 8 <= count; i += 8) {
+          const int16x8_t s = vld1q_s16(src + i);
+          const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+          const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+          vst1q_f32(acc + i, vmlaq_n_f32(vld1q_f32(acc + i), lo, scale));
+          vst1q_f32(acc + i + 4, vmlaq_n_f32(vld1q_f32(acc + i + 4), hi, scale));
+        }
+#endif
+        for (; i < count; ++i) {
+          acc[i] += src[i] * scale;
+        }
+      }
+
+      /** acc[i] += src[i] * gain，src 为 float */
+      inline void MixAccumulateF32(float* ALI_RTC_RESTRICT acc, const float* ALI_RTC_RESTRICT src, float gain, int count)
+      {
+        int i = 0;
+#if defined(ALI_RTC_SIMD_AVX2)
+        const __m256 g8 = _mm256_set1_ps(gain);
+        for (; i + 8 <= count; i += 8) {
+          _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g8)));
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        const __m128 g4 = _mm_set1_ps(gain);
+        for (; i + 4 <= count; i += 4) {
+          _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(src + i), g4)));
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        for (; i + 4 <= count; i += 4) {
+          vst1q_f32(acc + i, vmlaq_n_f32(vld1q_f32(acc + i), vld1q_f32(src + i), gain));
+        }
+#endif
+        for (; i < count; ++i) {
+          acc[i] += src[i] * gain;
+        }
+      }
+
+      /** src[i] *= gains[i]，用于增益过渡 */
+      inline void MixApplyGainRamp(float* ALI_RTC_RESTRICT samples, const float* ALI_RTC_RESTRICT gains, int count)
+      {
+        int i = 0;
+#if defined(ALI_RTC_SIMD_SSE41)
+        for (; i + 4 <= count; i += 4) {
+          _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), _mm_loadu_ps(gains + i)));
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        for (; i + 4 <= count; i += 4) {
+          vst1q_f32(samples + i, vmulq_f32(vld1q_f32(samples + i), vld1q_f32(gains + i)));
+        }
+#endif
+        for (; i < count; ++i) {
+          samples[i] *= gains[i];
+        }
+      }
+
+      /**
+       * float -> int16，四舍五入（0.5 远离零）并饱和
+       * SIMD 路径加上与符号相同的 0.5 后截断，与标量路径逐采样一致
+       */
+      inline void MixStoreS16(const float* ALI_RTC_RESTRICT acc, int16_t* ALI_RTC_RESTRICT dst, int count)
+      {
+        int i = 0;
+#if defined(ALI_RTC_SIMD_SSE41)
+        const __m128 k = _mm_set1_ps(32768.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        /* cvttps 溢出时返回 0x80000000，先钳位到 int16 范围外一点再转换，由 packs 饱和 */
+        const __m128 hi = _mm_set1_ps(65536.0f);
+        const __m128 lo = _mm_set1_ps(-65536.0f);
+        for (; i + 8 <= count; i += 8) {
+          __m128 a = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(acc + i), k), hi), lo);
+          __m128 b = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_loadu_ps(acc + i + 4), k), hi), lo);
+          a = _mm_add_ps(a, _mm_or_ps(half, _mm_and_ps(a, sign)));
+          b = _mm_add_ps(b, _mm_or_ps(half, _mm_and_ps(b, sign)));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b)));
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        const uint32x4_t half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+        const uint32x4_t sign = vdupq_n_u32(0x80000000u);
+        for (; i + 8 <= count; i += 8) {
+          /* vcvtq 向零截断且溢出时饱和，由 vqmovn 饱和到 int16 */
+          const float32x4_t fa = vmulq_n_f32(vld1q_f32(acc + i), 32768.0f);
+          const float32x4_t fb = vmulq_n_f32(vld1q_f32(acc + i + 4), 32768.0f);
+          const int32x4_t a = vcvtq_s32_f32(vaddq_f32(fa, vreinterpretq_f32_u32(vorrq_u32(half, vandq_u32(vreinterpretq_u32_f32(fa), sign)))));
+          const int32x4_t b = vcvtq_s32_f32(vaddq_f32(fb, vreinterpretq_f32_u32(vorrq_u32(half, vandq_u32(vreinterpretq_u32_f32(fb), sign)))));
+          vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+        }
+#endif
+        for (; i < count; ++i) {
+          float v = acc[i] * 32768.0f;
+          v = v > 32767.0f ? 32767.0f : (v < -32768.0f ? -32768.0f : v);
+          dst[i] = static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+        }
+      }
+
+      /** float 钳位到 [-1, 1] */
+      inline void MixStoreF32(const float* ALI_RTC_RESTRICT acc, float* ALI_RTC_RESTRICT dst, int count)
+      {
+        int i = 0;
+#if defined(ALI_RTC_SIMD_SSE41)
+        const __m128 hi = _mm_set1_ps(1.0f);
+        const __m128 lo = _mm_set1_ps(-1.0f);
+        for (; i + 4 <= count; i += 4) {
+          _mm_storeu_ps(dst + i, _mm_max_ps(_mm_min_ps(_mm_loadu_ps(acc + i), hi), lo));
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        for (; i + 4 <= count; i += 4) {
+          vst1q_f32(dst + i, vmaxq_f32(vminq_f32(vld1q_f32(acc + i), vdupq_n_f32(1.0f)), vdupq_n_f32(-1.0f)));
+        }
+#endif
+        for (; i < count; ++i) {
+          dst[i] = acc[i] > 1.0f ? 1.0f : (acc[i] < -1.0f ? -1.0f : acc[i]);
+        }
+      }
+    }
+
+    /**
+     * @brief 多路音频混音器
+     * @details 用于在送入 {@link IAliEngineMediaEngine::PushExternalAudioStreamRawData} 前，把音乐、音效、TTS、连麦等多路
+     * 外部音频混成一路：
+     *  - 各路以 float 累加（SSE4.1/AVX2/NEON），最后统一四舍五入（0.5 远离零，各指令集一致）并饱和到 int16，中间结果不截断，与输入顺序无关
+     *  - 增益变化在 rampMs 内逐采样线性过渡，调节音量时无拉链噪声
+     *  - 每路每采样只有一次乘加，开销随路数线性增长
+     * 推流与播放需要不同音量时，使用两个混音器分别按 publishVolume、playoutVolume 设置增益；
+     * 需要与麦克风混音时（参考 {@link IAliEngineMediaEngine::SetMixedWithMic}），可把麦克风数据作为其中一路输入
+     * @note 增益可在任意线程设置；Mix 需在单一音频线程调用；AddStream/RemoveStream 不可与 Mix 使用同一流ID并发
+     */
+    class AliEngineAudioMixer {
+    public:
+      explicit AliEngineAudioMixer(const AliEngineAudioMixerConfig &config = AliEngineAudioMixerConfig())
+        : config_(config), streams_(config.maxStreams > 0 ? config.maxStreams : 1) {
+        if (config_.channels <= 0) {
+          config_.channels = 1;
+        }
+      }
+
+      /**
+       * @brief 添加一路输入
+       * @param gain 初始线性增益，1.0为原始音量
+       * @return 流ID；超过最大路数返回-1
+       */
+      int AddStream(float gain = 1.0f)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        for (size_t i = 0; i < streams_.size(); ++i) {
+          Stream &stream = streams_[i];
+          if (!stream.active.load(std::memory_order_relaxed)) {
+            stream.target.store(gain, std::memory_order_relaxed);
+            stream.current = gain;
+            stream.rampTarget = gain;
+            stream.rampRemaining = 0;
+            stream.active.store(true, std::memory_order_release);
+            return static_cast<int>(i);
+          }
+        }
+        return -1;
+      }
+
+      /**
+       * @brief 移除一路输入
+       */
+      void RemoveStream(int streamId)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (streamId >= 0 && streamId < static_cast<int>(streams_.size())) {
+          streams_[streamId].active.store(false, std::memory_order_release);
+        }
+      }
+
+      /**
+       * @brief 设置一路输入的线性增益，在下一次 Mix 中平滑过渡
+       * @param streamId 流ID
+       * @param gain 线性增益，1.0为原始音量
+       */
+      void SetStreamGain(int streamId, float gain)
+      {
+        if (streamId >= 0 && streamId < static_cast<int>(streams_.size())) {
+          streams_[streamId].target.store(gain < 0 ? 0 : gain, std::memory_order_relaxed);
+        }
+      }
+
+      /**
+       * @brief 按SDK音量设置增益
+       * @param streamId 流ID
+       * @param volume 音量，取值范围[0-100]，与 {@link AliEngineExternalAudioStreamConfig} 一致，50为原始音量
+       */
+      void SetStreamVolume(int streamId, int volume)
+      {
+        SetStreamGain(streamId, (volume < 0 ? 0 : (volume > 100 ? 100 : volume)) / 50.0f);
+      }
+
+      /**
+       * @brief 混音
+       * @param inputs 本帧各路输入，未出现在其中的流视为静音
+       * @param count 输入数
+       * @param output 混音结果，指向内部缓冲，下次调用前有效；采样数取各路输入的最大值，较短的输入在末尾补零
+       * @return 输出采样数（单声道）；参数错误返回-1
+       */
+      int Mix(const AliEngineAudioMixerInput* inputs, int count, AliEngineAudioRawData &output)
+      {
+        const int channels = config_.channels;
+        int frames = 0;
+        for (int i = 0; i < count; ++i) {
+          const AliEngineAudioRawData* data = inputs[i].data;
+          if (!data || !data->dataPtr || data->numOfChannels != channels ||
+              (data->bytesPerSample != 2 && data->bytesPerSample != 4)) {
+            return -1;
+          }
+          frames = data->numOfSamples > frames ? data->numOfSamples : frames;
+        }
+        const size_t samples = static_cast<size_t>(frames) * channels;
+        if (accumulator_.size() < samples) {
+          accumulator_.resize(samples);
+          scratch_.resize(samples);
+          ramp_.resize(samples);
+          output_.resize(samples * 4);
+        }
+        float* acc = accumulator_.data();
+        memset(acc, 0, samples * sizeof(float));
+        for (int i = 0; i < count; ++i) {
+          const int id = inputs[i].streamId;
+          if (id < 0 || id >= static_cast<int>(streams_.size()) || !streams_[id].active.load(std::memory_order_acquire)) {
+            continue;
+          }
+          Accumulate(streams_[id], *inputs[i].data, acc);
+        }
+        output.numOfSamples = frames;
+        output.numOfChannels = channels;
+        output.samplesPerSec = config_.sampleRate;
+        output.bytesPerSample = config_.outputBytesPerSample == 4 ? 4 : 2;
+        output.dataPtr = output_.data();
+        if (output.bytesPerSample == 4) {
+          internal::MixStoreF32(acc, reinterpret_cast<float*>(output_.data()), static_cast<int>(samples));
+        } else {
+          internal::MixStoreS16(acc, reinterpret_cast<int16_t*>(output_.data()), static_cast<int>(samples));
+        }
+        return frames;
+      }
+
+    private:
+      struct Stream {
+        std::atomic<bool> active{false};
+        std::atomic<float> target{1.0f};
+        /* 以下仅音频线程访问 */
+        float current = 1.0f;
+        /* 当前过渡的目标、每帧步长与剩余帧数，目标变化时重新计算，过渡跨越多次 Mix 时保持线性 */
+        float rampTarget = 1.0f;
+        float rampStep = 0.0f;
+        int rampRemaining = 0;
+      };
+
+      AliEngineAudioMixer(const AliEngineAudioMixer&);
+      AliEngineAudioMixer& operator=(const AliEngineAudioMixer&);
+
+      void Accumulate(Stream &stream, const AliEngineAudioRawData &data, float* acc)
+      {
+        const int channels = config_.channels;
+        const int n = data.numOfSamples * channels;
+        const float target = stream.target.load(std::memory_order_relaxed);
+        if (target != stream.rampTarget) {
+          const int rampFrames = config_.sampleRate * (config_.rampMs > 0 ? config_.rampMs : 1) / 1000;
+          stream.rampTarget = target;
+          stream.rampRemaining = rampFrames > 0 ? rampFrames : 1;
+          stream.rampStep = (target - stream.current) / stream.rampRemaining;
+        }
+        if (stream.rampRemaining == 0) {
+          if (target == 0.0f) {
+            return;
+          }
+          if (data.bytesPerSample == 2) {
+            internal::MixAccumulateS16(acc, static_cast<const int16_t*>(data.dataPtr), target, n);
+          } else {
+            internal::MixAccumulateF32(acc, static_cast<const float*>(data.dataPtr), target, n);
+          }
+          return;
+        }
+        /* 增益过渡：按帧线性插值，同一帧内各声道增益相同，最后一帧精确落在目标值 */
+        float gain = stream.current;
+        float* gains = ramp_.data();
+        for (int f = 0; f < data.numOfSamples; ++f) {
+          if (stream.rampRemaining > 0) {
+            gain = --stream.rampRemaining > 0 ? gain + stream.rampStep : target;
+          }
+          for (int c = 0; c < channels; ++c) {
+            gains[f * channels + c] = gain;
+          }
+        }
+        stream.current = gain;
+        float* samples = scratch_.data();
+        memset(samples, 0, n * sizeof(float));
+        if (data.bytesPerSample == 2) {
+          internal::MixAccumulateS16(samples, static_cast<const int16_t*>(data.dataPtr), 1.0f, n);
+        } else {
+          internal::MixAccumulateF32(samples, static_cast<const float*>(data.dataPtr), 1.0f, n);
+        }
+        internal::MixApplyGainRamp(samples, gains, n);
+        internal::MixAccumulateF32(acc, samples, 1.0f, n);
+      }
+
+      AliEngineAudioMixerConfig config_;
+      std::vector<Stream> streams_;
+      std::mutex lock_;
+      std::vector<float> accumulator_;
+      std::vector<float> scratch_;
+      std::vector<float> ramp_;
+      std::vector<uint8_t> output_;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_mixer_h */
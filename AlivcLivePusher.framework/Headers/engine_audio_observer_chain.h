@@ -0,0 +1,504 @@
+#ifndef ali_rtc_engine_audio_observer_chain_h
+#define ali_rtc_engine_audio_observer_chain_h
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "engine_media_engine.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 处理节点要求的采样格式
+     */
+    typedef enum {
+      /** int16，与SDK回调数据一致 */
+      AliEngineAudioStageFormatInt16 = 0,
+      /** float，取值范围[-1, 1] */
+      AliEngineAudioStageFormatFloat = 1,
+    } AliEngineAudioStageFormat;
+
+    /**
+     * @brief 处理链配置
+     */
+    typedef struct AliEngineAudioChainConfig {
+      /** 连续超出时间预算多少帧后暂停该节点，0表示只统计不暂停，默认值：0 */
+      int bypassAfterOverruns = 0;
+      /** 暂停的帧数，之后重新尝试，默认值：100 */
+      int bypassFrames = 100;
+      /** 单帧最大采样数（每声道采样数 x 声道数），格式转换缓冲按此预分配；超过时需要转换的节点跳过该帧，默认值：1920（48kHz 双声道 20ms） */
+      int maxFrameSamples = 1920;
+      /** 同时回调的远端用户数上限，每个远端用户的回调使用独立的转换缓冲；超过时需要转换的节点跳过该帧，默认值：16 */
+      int maxRemoteUsers = 16;
+    } AliEngineAudioChainConfig;
+
+    /**
+     * @brief 处理节点统计信息
+     */
+    typedef struct AliEngineAudioStageStats {
+      /** 节点名称 */
+      const char* name = nullptr;
+      /** 时间预算，单位：us，0表示不限制 */
+      int budgetUs = 0;
+      /** 最近一帧耗时，单位：us */
+      int lastCostUs = 0;
+      /** 平滑耗时，单位：us */
+      int avgCostUs = 0;
+      /** 最大耗时，单位：us */
+      int maxCostUs = 0;
+      /** 处理帧数 */
+      unsigned long long frames = 0;
+      /** 超出预算的帧数 */
+      unsigned long long overBudgetFrames = 0;
+      /** 因超出预算、或没有可用的格式转换缓冲被跳过的帧数 */
+      unsigned long long bypassedFrames = 0;
+    } AliEngineAudioStageStats;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @addtogroup AliEngineCallback 回调及监听
+     * AliRtc 回调及监听
+     * @{
+     */
+
+    /**
+     * @brief 音频处理节点接口
+     */
+    class IAliEngineAudioProcessStage {
+    public:
+      virtual ~IAliEngineAudioProcessStage() {}
+
+      /**
+       * @brief 节点名称，用于统计
+       */
+      virtual const char* GetStageName() { return ""; }
+
+      /**
+       * @brief 节点要求的采样格式，相邻节点格式相同时不做转换
+       */
+      virtual AliEngineAudioStageFormat GetStageFormat() { return AliEngineAudioStageFormatInt16; }
+
+      /**
+       * @brief 原地处理一帧音频
+       * @param audioSource 音频数据源
+       * @param uid 远端用户ID，仅 AliEngineAudioSourceRemoteUser 有效，其他为空
+       * @param audioRawData 音频数据，dataPtr 指向SDK缓冲或链内转换缓冲，可直接修改，不可改变采样数和格式
+       * @return true: 继续执行后续节点；false: 本帧不再执行后续节点
+       */
+      virtual bool OnProcessAudioFrame(AliEngineAudioSource audioSource, const char* uid, AliEngineAudioRawData &audioRawData) = 0;
+    };
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      inline void AudioS16ToFloat(const int16_t* src, float* dst, int count)
+      {
+        for (int i = 0; i < count; ++i) {
+          dst[i] = src[i] * (1.0f / 32768.0f);
+        }
+      }
+
+      inline void AudioFloatToS16(const float* src, int16_t* dst, int count)
+      {
+        for (int i = 0; i < count; ++i) {
+          float v = src[i] * 32768.0f;
+          v = v > 32767.0f ? 32767.0f : (v < -32768.0f ? -32768.0f : v);
+          dst[i] = static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+        }
+      }
+    }
+
+    /**
+     * @brief 有序音频处理链
+     * @details 作为 {@link IAudioFrameObserver} 注册到SDK，按添加顺序在同一帧上依次执行各节点：
+     *  - 节点直接在SDK回调的缓冲上原地修改（{@link AliEngineAudioFrameObserverOperationModeReadWrite}），节点之间不拷贝
+     *  - 只在相邻节点格式不同时转换一次：连续的 float 节点共用一个转换缓冲，链结束时若当前为 float 再写回 int16；
+     *    转换缓冲在构造时按 maxFrameSamples 预分配，每个数据源一份，远端用户按 uid 各自占用一份，互不覆盖
+     *  - 每个节点单独计时，超出预算的帧数计入统计；配置 bypassAfterOverruns 后连续超预算的节点会被暂时跳过，避免拖垮音频线程
+     *  - 每个数据源的节点列表为不可变快照，增删节点时整体替换；回调中不加锁、不分配，统计为原子计数
+     * AliEngineAudioSourcePub 只支持只读模式，其上的节点修改数据不会生效；其余数据源（包括 AliEngineAudioSourceMixedAll）支持读写
+     * @note AddStage/RemoveStage 会等待该数据源正在执行的回调结束后才释放旧快照，RemoveStage 返回后被移除的节点不再被调用
+     */
+    class AliEngineAudioFrameObserverChain : public IAudioFrameObserver {
+    public:
+      /**
+       * @param config 处理链配置
+       * @param forward 其他音频数据回调的透传对象，在链执行后回调，可为空
+       */
+      explicit AliEngineAudioFrameObserverChain(const AliEngineAudioChainConfig &config = AliEngineAudioChainConfig(),
+                                                IAudioFrameObserver* forward = nullptr)
+        : config_(config), forward_(forward),
+          remoteSlots_(config.maxRemoteUsers > 0 ? config.maxRemoteUsers : 1),
+          slots_(AliEngineAudioSourceRemoteUser + remoteSlots_)
+      {
+        const size_t samples = static_cast<size_t>(config_.maxFrameSamples > 0 ? config_.maxFrameSamples : 0);
+        for (size_t i = 0; i < slots_.size(); ++i) {
+          slots_[i].floats.assign(samples, 0.0f);
+          slots_[i].int16s.assign(samples, 0);
+          slots_[i].busy.store(0, std::memory_order_relaxed);
+        }
+        for (int i = 0; i < kSourceCount; ++i) {
+          chains_[i].store(nullptr, std::memory_order_relaxed);
+          epochs_[i].store(0, std::memory_order_relaxed);
+          readers_[i][0].store(0, std::memory_order_relaxed);
+          readers_[i][1].store(0, std::memory_order_relaxed);
+        }
+      }
+
+      ~AliEngineAudioFrameObserverChain()
+      {
+        for (int i = 0; i < kSourceCount; ++i) {
+          const StageList* chain = chains_[i].load(std::memory_order_relaxed);
+          if (chain) {
+            for (size_t k = 0; k < chain->size(); ++k) {
+              delete (*chain)[k];
+            }
+            delete chain;
+          }
+        }
+      }
+
+      /**
+       * @brief 在指定数据源的链尾添加节点
+       * @param audioSource 音频数据源
+       * @param stage 处理节点，需在移除前保持有效
+       * @param budgetUs 单帧时间预算，单位：us，0表示不限制
+       * @return 0: 成功；-1: 参数错误
+       */
+      int AddStage(AliEngineAudioSource audioSource, IAliEngineAudioProcessStage* stage, int budgetUs = 0)
+      {
+        if (!stage || !IsValidSource(audioSource)) {
+          return -1;
+        }
+        Stage* entry = new Stage(stage->GetStageName(), budgetUs, stage);
+        std::lock_guard<std::mutex> guard(lock_);
+        const StageList* old = chains_[audioSource].load(std::memory_order_relaxed);
+        StageList* chain = old ? new StageList(*old) : new StageList();
+        chain->push_back(entry);
+        Publish(audioSource, chain, nullptr);
+        return 0;
+      }
+
+      /**
+       * @brief 移除节点
+       * @return 0: 成功；-1: 节点不存在
+       */
+      int RemoveStage(AliEngineAudioSource audioSource, IAliEngineAudioProcessStage* stage)
+      {
+        if (!IsValidSource(audioSource)) {
+          return -1;
+        }
+        std::lock_guard<std::mutex> guard(lock_);
+        const StageList* old = chains_[audioSource].load(std::memory_order_relaxed);
+        if (!old) {
+          return -1;
+        }
+        for (size_t i = 0; i < old->size(); ++i) {
+          if ((*old)[i]->stage == stage) {
+            StageList* chain = new StageList(*old);
+            chain->erase(chain->begin() + i);
+            Publish(audioSource, chain, (*old)[i]);
+            return 0;
+          }
+        }
+        return -1;
+      }
+
+      /**
+       * @brief 获取指定数据源各节点的统计信息，按链中顺序排列
+       * @details 不与音频回调互斥，各计数分别读取，同一节点的不同字段之间可能相差一帧
+       */
+      std::vector<AliEngineAudioStageStats> GetStageStats(AliEngineAudioSource audioSource)
+      {
+        std::vector<AliEngineAudioStageStats> stats;
+        if (!IsValidSource(audioSource)) {
+          return stats;
+        }
+        /* lock_ 只与增删节点互斥，保证读取期间快照不被释放 */
+        std::lock_guard<std::mutex> guard(lock_);
+        const StageList* chain = chains_[audioSource].load(std::memory_order_relaxed);
+        if (!chain) {
+          return stats;
+        }
+        stats.resize(chain->size());
+        for (size_t i = 0; i < chain->size(); ++i) {
+          const Stage &entry = *(*chain)[i];
+          stats[i].name = entry.name;
+          stats[i].budgetUs = entry.budgetUs;
+          stats[i].lastCostUs = entry.lastCostUs.load(std::memory_order_relaxed);
+          stats[i].avgCostUs = entry.avgCostUs.load(std::memory_order_relaxed);
+          stats[i].maxCostUs = entry.maxCostUs.load(std::memory_order_relaxed);
+          stats[i].frames = entry.frames.load(std::memory_order_relaxed);
+          stats[i].overBudgetFrames = entry.overBudgetFrames.load(std::memory_order_relaxed);
+          stats[i].bypassedFrames = entry.bypassedFrames.load(std::memory_order_relaxed);
+        }
+        return stats;
+      }
+
+      bool OnCapturedAudioFrame(AliEngineAudioRawData audioRawData) override
+      {
+        Dispatch(AliEngineAudioSourceCaptured, nullptr, audioRawData);
+        return forward_ ? forward_->OnCapturedAudioFrame(audioRawData) : true;
+      }
+
+      bool OnProcessCapturedAudioFrame(AliEngineAudioRawData audioRawData) override
+      {
+        Dispatch(AliEngineAudioSourceProcessCaptured, nullptr, audioRawData);
+        return forward_ ? forward_->OnProcessCapturedAudioFrame(audioRawData) : true;
+      }
+
+      bool OnPublishAudioFrame(AliEngineAudioRawData audioRawData) override
+      {
+        Dispatch(AliEngineAudioSourcePub, nullptr, audioRawData);
+        return forward_ ? forward_->OnPublishAudioFrame(audioRawData) : true;
+      }
+
+      bool OnPlaybackAudioFrame(AliEngineAudioRawData audioRawData) override
+      {
+        Dispatch(AliEngineAudioSourcePlayback, nullptr, audioRawData);
+        return forward_ ? forward_->OnPlaybackAudioFrame(audioRawData) : true;
+      }
+
+      bool OnMixedAllAudioFrame(AliEngineAudioRawData audioRawData) override
+      {
+        Dispatch(AliEngineAudioSourceMixedAll, nullptr, audioRawData);
+        return forward_ ? forward_->OnMixedAllAudioFrame(audioRawData) : true;
+      }
+
+      bool OnRemoteUserAudioFrame(const char *uid, AliEngineAudioRawData audioRawData) override
+      {
+        Dispatch(AliEngineAudioSourceRemoteUser, uid, audioRawData);
+        return forward_ ? forward_->OnRemoteUserAudioFrame(uid, audioRawData) : true;
+      }
+
+    private:
+      enum {
+        kSourceCount = AliEngineAudioSourceRemoteUser + 1,
+      };
+
+      /* 节点在快照之间共享，统计随节点保留；只有 name、budgetUs、stage 在构造后只读 */
+      struct Stage {
+        const char* name;
+        int budgetUs;
+        IAliEngineAudioProcessStage* stage;
+        std::atomic<int> lastCostUs{0};
+        std::atomic<int> avgCostUs{0};
+        std::atomic<int> maxCostUs{0};
+        std::atomic<unsigned long long> frames{0};
+        std::atomic<unsigned long long> overBudgetFrames{0};
+        std::atomic<unsigned long long> bypassedFrames{0};
+        std::atomic<int> consecutiveOverruns{0};
+        std::atomic<int> bypassRemaining{0};
+
+        Stage(const char* stageName, int budget, IAliEngineAudioProcessStage* processStage)
+          : name(stageName), budgetUs(budget), stage(processStage) {}
+      };
+
+      typedef std::vector<Stage*> StageList;
+
+      /* 格式转换缓冲；远端用户的缓冲由 busy 标记独占，其他数据源各自只有一个回调线程 */
+      struct ConvertSlot {
+        std::vector<float> floats;
+        std::vector<int16_t> int16s;
+        std::atomic<int> busy{0};
+      };
+
+      AliEngineAudioFrameObserverChain(const AliEngineAudioFrameObserverChain&);
+      AliEngineAudioFrameObserverChain& operator=(const AliEngineAudioFrameObserverChain&);
+
+      static bool IsValidSource(AliEngineAudioSource audioSource)
+      {
+        return static_cast<int>(audioSource) >= 0 && static_cast<int>(audioSource) < static_cast<int>(kSourceCount);
+      }
+
+      static long long NowUs()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /*
+       * 在 lock_ 内调用：替换快照后翻转 epoch，只等待翻转前进入的回调结束，再释放旧快照和被移除的节点。
+       * 翻转后进入的回调计入另一个计数且必然读到新快照，因此回调连续不断时也不会饿死增删操作
+       */
+      void Publish(AliEngineAudioSource audioSource, StageList* chain, Stage* removed)
+      {
+        const StageList* old = chains_[audioSource].exchange(chain, std::memory_order_seq_cst);
+        const unsigned previous = epochs_[audioSource].fetch_add(1, std::memory_order_seq_cst) & 1;
+        while (readers_[audioSource][previous].load(std::memory_order_seq_cst) > 0) {
+          std::this_thread::yield();
+        }
+        delete old;
+        delete removed;
+      }
+
+      void Dispatch(AliEngineAudioSource audioSource, const char* uid, AliEngineAudioRawData &frame)
+      {
+        if (!frame.dataPtr || frame.numOfSamples <= 0 || frame.numOfChannels <= 0 ||
+            (frame.bytesPerSample != 2 && frame.bytesPerSample != 4)) {
+          return;
+        }
+        /* 计入当前 epoch；计数期间 epoch 被翻转则改计入新的 epoch，保证 Publish 等待的计数只减不增 */
+        unsigned epoch = epochs_[audioSource].load(std::memory_order_seq_cst) & 1;
+        for (;;) {
+          readers_[audioSource][epoch].fetch_add(1, std::memory_order_seq_cst);
+          const unsigned current = epochs_[audioSource].load(std::memory_order_seq_cst) & 1;
+          if (current == epoch) {
+            break;
+          }
+          readers_[audioSource][epoch].fetch_sub(1, std::memory_order_release);
+          epoch = current;
+        }
+        const StageList* chain = chains_[audioSource].load(std::memory_order_seq_cst);
+        if (chain && !chain->empty()) {
+          Run(*chain, audioSource, uid, frame);
+        }
+        readers_[audioSource][epoch].fetch_sub(1, std::memory_order_release);
+      }
+
+      void Run(const StageList &chain, AliEngineAudioSource audioSource, const char* uid, AliEngineAudioRawData &frame)
+      {
+        const int count = frame.numOfSamples * frame.numOfChannels;
+        const AliEngineAudioStageFormat native = frame.bytesPerSample == 4 ? AliEngineAudioStageFormatFloat
+                                                                          : AliEngineAudioStageFormatInt16;
+        /* 当前有效数据所在：SDK缓冲（native）或转换缓冲（另一格式） */
+        AliEngineAudioStageFormat current = native;
+        AliEngineAudioRawData converted = frame;
+        ConvertSlot* slot = nullptr;
+        for (size_t i = 0; i < chain.size(); ++i) {
+          Stage &entry = *chain[i];
+          if (entry.bypassRemaining.load(std::memory_order_relaxed) > 0) {
+            entry.bypassRemaining.fetch_sub(1, std::memory_order_relaxed);
+            entry.bypassedFrames.fetch_add(1, std::memory_order_relaxed);
+            continue;
+          }
+          const AliEngineAudioStageFormat wanted = entry.stage->GetStageFormat();
+          if (wanted != current) {
+            if (!slot) {
+              slot = AcquireSlot(audioSource, uid, count);
+            }
+            if (!slot) {
+              entry.bypassedFrames.fetch_add(1, std::memory_order_relaxed);
+              continue;
+            }
+            Convert(*slot, frame, converted, native, wanted, count);
+            current = wanted;
+          }
+          AliEngineAudioRawData &data = current == native ? frame : converted;
+          const long long begin = NowUs();
+          const bool next = entry.stage->OnProcessAudioFrame(audioSource, uid, data);
+          Record(entry, static_cast<int>(NowUs() - begin));
+          if (!next) {
+            break;
+          }
+        }
+        if (current != native) {
+          Convert(*slot, frame, converted, native, native, count);
+        }
+        if (slot && audioSource == AliEngineAudioSourceRemoteUser) {
+          slot->busy.store(0, std::memory_order_release);
+        }
+      }
+
+      /*
+       * 取本帧使用的转换缓冲，帧长超过预分配大小时返回空。远端用户从 uid 的哈希位置开始探测空闲缓冲，
+       * 同一 uid 通常落在同一份缓冲上；不同 uid 的回调并发时各自独占一份，全部占用时返回空
+       */
+      ConvertSlot* AcquireSlot(AliEngineAudioSource audioSource, const char* uid, int count)
+      {
+        if (count > config_.maxFrameSamples) {
+          return nullptr;
+        }
+        if (audioSource != AliEngineAudioSourceRemoteUser) {
+          return &slots_[audioSource];
+        }
+        unsigned hash = 2166136261u;
+        for (const char* c = uid ? uid : ""; *c; ++c) {
+          hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+        }
+        for (int k = 0; k < remoteSlots_; ++k) {
+          ConvertSlot &slot = slots_[AliEngineAudioSourceRemoteUser + (hash + k) % remoteSlots_];
+          int expected = 0;
+          if (slot.busy.load(std::memory_order_relaxed) == 0 &&
+              slot.busy.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return &slot;
+          }
+        }
+        return nullptr;
+      }
+
+      /* 在SDK缓冲与转换缓冲之间转换，wanted 为转换后要使用的格式 */
+      void Convert(ConvertSlot &slot, AliEngineAudioRawData &frame, AliEngineAudioRawData &converted,
+                   AliEngineAudioStageFormat native, AliEngineAudioStageFormat wanted, int count)
+      {
+        if (wanted != native) {
+          if (native == AliEngineAudioStageFormatInt16) {
+            internal::AudioS16ToFloat(static_cast<const int16_t*>(frame.dataPtr), slot.floats.data(), count);
+            converted.dataPtr = slot.floats.data();
+            converted.bytesPerSample = 4;
+          } else {
+            internal::AudioFloatToS16(static_cast<const float*>(frame.dataPtr), slot.int16s.data(), count);
+            converted.dataPtr = slot.int16s.data();
+            converted.bytesPerSample = 2;
+          }
+        } else if (native == AliEngineAudioStageFormatInt16) {
+          internal::AudioFloatToS16(static_cast<const float*>(converted.dataPtr), static_cast<int16_t*>(frame.dataPtr), count);
+        } else {
+          internal::AudioS16ToFloat(static_cast<const int16_t*>(converted.dataPtr), static_cast<float*>(frame.dataPtr), count);
+        }
+      }
+
+      void Record(Stage &entry, int costUs)
+      {
+        entry.lastCostUs.store(costUs, std::memory_order_relaxed);
+        const int avg = entry.avgCostUs.load(std::memory_order_relaxed);
+        const unsigned long long frames = entry.frames.fetch_add(1, std::memory_order_relaxed);
+        entry.avgCostUs.store(frames == 0 ? costUs : avg + (costUs - avg) / 16, std::memory_order_relaxed);
+        if (costUs > entry.maxCostUs.load(std::memory_order_relaxed)) {
+          entry.maxCostUs.store(costUs, std::memory_order_relaxed);
+        }
+        if (entry.budgetUs <= 0 || costUs <= entry.budgetUs) {
+          entry.consecutiveOverruns.store(0, std::memory_order_relaxed);
+          return;
+        }
+        entry.overBudgetFrames.fetch_add(1, std::memory_order_relaxed);
+        if (config_.bypassAfterOverruns > 0 &&
+            entry.consecutiveOverruns.fetch_add(1, std::memory_order_relaxed) + 1 >= config_.bypassAfterOverruns) {
+          entry.consecutiveOverruns.store(0, std::memory_order_relaxed);
+          entry.bypassRemaining.store(config_.bypassFrames, std::memory_order_relaxed);
+        }
+      }
+
+      AliEngineAudioChainConfig config_;
+      IAudioFrameObserver* forward_;
+      /* 只用于串行化增删节点，音频回调不获取 */
+      std::mutex lock_;
+      std::atomic<const StageList*> chains_[kSourceCount];
+      /* 每次替换快照翻转一次，readers_ 按 epoch 奇偶分别记录正在使用快照的回调数 */
+      std::atomic<unsigned> epochs_[kSourceCount];
+      std::atomic<int> readers_[kSourceCount][2];
+      const int remoteSlots_;
+      /* 前 AliEngineAudioSourceRemoteUser 个对应其他数据源，其后 remoteSlots_ 个供远端用户轮流占用 */
+      std::vector<ConvertSlot> slots_;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_observer_chain_h */
@@ -0,0 +1,593 @@
+#ifndef ali_rtc_engine_audio_pitch_shifter_h
+#define ali_rtc_engine_audio_pitch_shifter_h
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_audio_resampler.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 变调算法
+     */
+    typedef enum {
+        /** 低延迟：时域 WSOLA，按波形相似度选择拼接点并交叉淡化，延迟不超过20ms，适合连麦 */
+        AliEngineAudioPitchShiftLowLatency = 0,
+        /** 高音质：相位声码器，约40ms分析窗，4倍重叠，适合K歌等对延迟不敏感的场景 */
+        AliEngineAudioPitchShiftHighQuality = 1,
+    } AliEngineAudioPitchShiftMode;
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      enum {
+        kPitchMaxChannels = 2,
+        /** 相位声码器的重叠倍数 */
+        kPitchOversample = 4,
+      };
+
+      /**
+       * @brief 基2复数 FFT
+       * @details 实部虚部分开存放，蝶形按级向量化（SSE4.1/NEON 每次4个，AVX2 每次8个）；逆变换不做 1/N 归一化
+       */
+      class PitchFft {
+      public:
+        void Init(int size)
+        {
+          size_ = size;
+          bitReverse_.resize(size);
+          int bits = 0;
+          while ((1 << bits) < size) {
+            ++bits;
+          }
+          for (int i = 0; i < size; ++i) {
+            int r = 0;
+            for (int b = 0; b < bits; ++b) {
+              r |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            bitReverse_[i] = r;
+          }
+          /* 第 half 级的旋转因子存放在 [half, 2 * half) */
+          twRe_.assign(size, 0.0f);
+          twIm_.assign(size, 0.0f);
+          for (int half = 1; half < size; half <<= 1) {
+            for (int j = 0; j < half; ++j) {
+              const double angle = -3.14159265358979323846 * j / half;
+              twRe_[half + j] = static_cast<float>(cos(angle));
+              twIm_[half + j] = static_cast<float>(sin(angle));
+            }
+          }
+        }
+
+        void Forward(float* re, float* im) const { Transform(re, im); }
+
+        /** 交换实部虚部后做正变换即为逆变换 */
+        void Inverse(float* re, float* im) const { Transform(im, re); }
+
+      private:
+        void Transform(float* re, float* im) const
+        {
+          for (int i = 0; i < size_; ++i) {
+            const int j = bitReverse_[i];
+            if (i < j) {
+              const float tr = re[i];
+              const float ti = im[i];
+              re[i] = re[j];
+              im[i] = im[j];
+              re[j] = tr;
+              im[j] = ti;
+            }
+          }
+          for (int half = 1; half < size_; half <<= 1) {
+            const float* wr = &twRe_[half];
+            const float* wi = &twIm_[half];
+            for (int k = 0; k < size_; k += half * 2) {
+              float* ar = re + k;
+              float* ai = im + k;
+              float* br = re + k + half;
+              float* bi = im + k + half;
+              int j = 0;
+#if defined(ALI_RTC_SIMD_AVX2)
+              for (; j + 8 <= half; j += 8) {
+                const __m256 xr = _mm256_loadu_ps(br + j);
+                const __m256 xi = _mm256_loadu_ps(bi + j);
+                const __m256 cr = _mm256_loadu_ps(wr + j);
+                const __m256 ci = _mm256_loadu_ps(wi + j);
+                const __m256 tr = _mm256_sub_ps(_mm256_mul_ps(xr, cr), _mm256_mul_ps(xi, ci));
+                const __m256 ti = _mm256_add_ps(_mm256_mul_ps(xr, ci), _mm256_mul_ps(xi, cr));
+                const __m256 yr = _mm256_loadu_ps(ar + j);
+                const __m256 yi = _mm256_loadu_ps(ai + j);
+                _mm256_storeu_ps(br + j, _mm256_sub_ps(yr, tr));
+                _mm256_storeu_ps(bi + j, _mm256_sub_ps(yi, ti));
+                _mm256_storeu_ps(ar + j, _mm256_add_ps(yr, tr));
+                _mm256_storeu_ps(ai + j, _mm256_add_ps(yi, ti));
+              }
+#elif defined(ALI_RTC_SIMD_SSE41)
+              for (; j + 4 <= half; j += 4) {
+                const __m128 xr = _mm_loadu_ps(br + j);
+                const __m128 xi = _mm_loadu_ps(bi + j);
+                const __m128 cr = _mm_loadu_ps(wr + j);
+                const __m128 ci = _mm_loadu_ps(wi + j);
+                const __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+                const __m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+                const __m128 yr = _mm_loadu_ps(ar + j);
+                const __m128 yi = _mm_loadu_ps(ai + j);
+                _mm_storeu_ps(br + j, _mm_sub_ps(yr, tr));
+                _mm_storeu_ps(bi + j, _mm_sub_ps(yi, ti));
+                _mm_storeu_ps(ar + j, _mm_add_ps(yr, tr));
+                _mm_storeu_ps(ai + j, _mm_add_ps(yi, ti));
+              }
+#elif defined(ALI_RTC_SIMD_NEON)
+              for (; j + 4 <= half; j += 4) {
+                const float32x4_t xr = vld1q_f32(br + j);
+                const float32x4_t xi = vld1q_f32(bi + j);
+                const float32x4_t cr = vld1q_f32(wr + j);
+                const float32x4_t ci = vld1q_f32(wi + j);
+                const float32x4_t tr = vsubq_f32(vmulq_f32(xr, cr), vmulq_f32(xi, ci));
+                const float32x4_t ti = vaddq_f32(vmulq_f32(xr, ci), vmulq_f32(xi, cr));
+                const float32x4_t yr = vld1q_f32(ar + j);
+                const float32x4_t yi = vld1q_f32(ai + j);
+                vst1q_f32(br + j, vsubq_f32(yr, tr));
+                vst1q_f32(bi + j, vsubq_f32(yi, ti));
+                vst1q_f32(ar + j, vaddq_f32(yr, tr));
+                vst1q_f32(ai + j, vaddq_f32(yi, ti));
+              }
+#endif
+              for (; j < half; ++j) {
+                const float tr = br[j] * wr[j] - bi[j] * wi[j];
+                const float ti = br[j] * wi[j] + bi[j] * wr[j];
+                br[j] = ar[j] - tr;
+                bi[j] = ai[j] - ti;
+                ar[j] += tr;
+                ai[j] += ti;
+              }
+            }
+          }
+        }
+
+        int size_ = 0;
+        std::vector<int> bitReverse_;
+        std::vector<float> twRe_;
+        std::vector<float> twIm_;
+      };
+    }
+
+    /**
+     * @brief 变调器
+     * @details 变调参数与 {@link IAliEngine::SetAudioEffectPitchValue} 一致（[0.5, 2.0]），用于对外部音频或
+     * {@link IAudioFrameObserver} 回调数据变调，并给出算法延迟供音画同步补偿：
+     *  - 低延迟模式（{@link AliEngineAudioPitchShiftLowLatency}）：读指针以 pitch 倍速读取环形缓冲，读写距离越界时在
+     *    5~13ms 范围内按归一化互相关选取与当前波形同相的拼接点，4ms 交叉淡化；延迟在 4~17ms 之间变化，最大不超过19ms
+     *  - 高音质模式（{@link AliEngineAudioPitchShiftHighQuality}）：加窗 FFT 后以谱峰划分区域，按谱峰真实频率的 pitch 倍整块搬移并锁定区域内相对相位
+     *    （每个谱峰只需一次 atan2 和 sin/cos），逆变换后重叠相加；延迟固定为一个窗长（48kHz 下约43ms）
+     *  - FFT 蝶形、互相关均为 SIMD 实现；全部缓冲在构造时分配，处理过程不分配内存
+     * @note SetPitch 可在任意线程调用；Process 需在单一音频线程调用；支持单声道和双声道交错数据
+     */
+    class AliEngineAudioPitchShifter {
+    public:
+      /**
+       * @param sampleRate 采样率
+       * @param channels 声道数，取值范围[1-2]
+       * @param mode 变调算法
+       */
+      explicit AliEngineAudioPitchShifter(int sampleRate = 48000, int channels = 1,
+                                          AliEngineAudioPitchShiftMode mode = AliEngineAudioPitchShiftLowLatency)
+        : sampleRate_(sampleRate > 0 ? sampleRate : 48000), channels_(channels == 2 ? 2 : 1), mode_(mode)
+      {
+        pitch_.store(1.0f, std::memory_order_relaxed);
+        if (mode_ == AliEngineAudioPitchShiftHighQuality) {
+          fftSize_ = 256;
+          while (fftSize_ < sampleRate_ / 25) {
+            fftSize_ <<= 1;
+          }
+          hop_ = fftSize_ / internal::kPitchOversample;
+          fft_.Init(fftSize_);
+          const int bins = fftSize_ / 2 + 1;
+          window_.resize(fftSize_);
+          for (int i = 0; i < fftSize_; ++i) {
+            window_[i] = static_cast<float>(0.5 - 0.5 * cos(2.0 * 3.14159265358979323846 * i / fftSize_));
+          }
+          re_.resize(fftSize_);
+          im_.resize(fftSize_);
+          synRe_.resize(fftSize_);
+          synIm_.resize(fftSize_);
+          power_.resize(bins);
+          peaks_.resize(bins);
+          for (int ch = 0; ch < channels_; ++ch) {
+            Vocoder &v = vocoder_[ch];
+            v.inFifo.resize(fftSize_);
+            v.outFifo.resize(fftSize_);
+            v.accum.resize(fftSize_ * 2);
+            v.prevRe.resize(bins);
+            v.prevIm.resize(bins);
+            v.sumPhase.resize(bins);
+          }
+        } else {
+          fadeFrames_ = sampleRate_ / 250;
+          /* 互相关窗长取8的倍数，不超过淡化长度 */
+          window8_ = fadeFrames_ / 8 * 8;
+          minDelay_ = fadeFrames_ + 2;
+          minSplice_ = sampleRate_ / 200;
+          maxSplice_ = sampleRate_ * 13 / 1000;
+          maxDelay_ = minDelay_ + maxSplice_;
+          ringSize_ = 64;
+          while (ringSize_ < maxDelay_ + fadeFrames_ * 2 + window8_) {
+            ringSize_ <<= 1;
+          }
+          ring_.resize(static_cast<size_t>(ringSize_) * channels_);
+          search_.resize(static_cast<size_t>(maxSplice_ + window8_ * 2 + 8));
+          energy_.resize(search_.size() + 1);
+        }
+        Reset();
+      }
+
+      /**
+       * @brief 设置变调参数
+       * @param value 取值范围[0.5, 2.0]，1.0表示音调不变
+       * @return 0: 成功；-1: 参数错误
+       */
+      int SetPitch(double value)
+      {
+        if (!(value >= 0.5 && value <= 2.0)) {
+          return -1;
+        }
+        pitch_.store(static_cast<float>(value), std::memory_order_relaxed);
+        return 0;
+      }
+
+      double GetPitch() const { return pitch_.load(std::memory_order_relaxed); }
+
+      AliEngineAudioPitchShiftMode GetMode() const { return mode_; }
+
+      /**
+       * @brief 算法延迟，单位：采样数（单声道）
+       * @details 高音质模式为固定值；低延迟模式为拼接范围的中点，实际延迟在 [minDelay, maxDelay] 之间随拼接变化
+       */
+      int LatencyFrames() const
+      {
+        return mode_ == AliEngineAudioPitchShiftHighQuality ? fftSize_ : (minDelay_ + maxDelay_) / 2;
+      }
+
+      /**
+       * @brief 算法延迟，单位：us
+       */
+      long long LatencyUs() const
+      {
+        return static_cast<long long>(LatencyFrames() * 1000000.0 / sampleRate_ + 0.5);
+      }
+
+      /**
+       * @brief 最大算法延迟，单位：us
+       */
+      long long MaxLatencyUs() const
+      {
+        const int frames = mode_ == AliEngineAudioPitchShiftHighQuality ? fftSize_ : maxDelay_ + fadeFrames_ / 2;
+        return static_cast<long long>(frames * 1000000.0 / sampleRate_ + 0.5);
+      }
+
+      /**
+       * @brief 清空历史数据
+       */
+      void Reset()
+      {
+        if (mode_ == AliEngineAudioPitchShiftHighQuality) {
+          for (int ch = 0; ch < channels_; ++ch) {
+            Vocoder &v = vocoder_[ch];
+            memset(&v.inFifo[0], 0, v.inFifo.size() * sizeof(float));
+            memset(&v.outFifo[0], 0, v.outFifo.size() * sizeof(float));
+            memset(&v.accum[0], 0, v.accum.size() * sizeof(float));
+            memset(&v.prevRe[0], 0, v.prevRe.size() * sizeof(float));
+            memset(&v.prevIm[0], 0, v.prevIm.size() * sizeof(float));
+            memset(&v.sumPhase[0], 0, v.sumPhase.size() * sizeof(float));
+          }
+          rover_ = fftSize_ - hop_;
+        } else {
+          memset(&ring_[0], 0, ring_.size() * sizeof(float));
+          writePos_ = 0;
+          delay_ = LatencyFrames();
+          oldDelay_ = 0.0;
+          fade_ = 0;
+        }
+      }
+
+      /**
+       * @brief 原地处理 float 交错数据
+       * @param samples 数据，frames * channels 个采样
+       * @param frames 采样数（单声道）
+       */
+      void Process(float* samples, int frames)
+      {
+        const float pitch = pitch_.load(std::memory_order_relaxed);
+        if (mode_ == AliEngineAudioPitchShiftHighQuality) {
+          ProcessVocoder(samples, frames, pitch);
+        } else {
+          ProcessWsola(samples, frames, pitch);
+        }
+      }
+
+      /**
+       * @brief 原地处理 int16 交错数据
+       */
+      void Process(int16_t* samples, int frames)
+      {
+        float block[kConvertFrames * internal::kPitchMaxChannels];
+        for (int offset = 0; offset < frames; offset += kConvertFrames) {
+          const int count = frames - offset < kConvertFrames ? frames - offset : kConvertFrames;
+          int16_t* data = samples + static_cast<size_t>(offset) * channels_;
+          const int n = count * channels_;
+          for (int i = 0; i < n; ++i) {
+            block[i] = data[i];
+          }
+          Process(block, count);
+          for (int i = 0; i < n; ++i) {
+            const float v = block[i] > 32767.0f ? 32767.0f : (block[i] < -32768.0f ? -32768.0f : block[i]);
+            data[i] = static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+          }
+        }
+      }
+
+    private:
+      AliEngineAudioPitchShifter(const AliEngineAudioPitchShifter&);
+      AliEngineAudioPitchShifter& operator=(const AliEngineAudioPitchShifter&);
+
+      enum { kConvertFrames = 256 };
+
+      struct Vocoder {
+        std::vector<float> inFifo;
+        std::vector<float> outFifo;
+        std::vector<float> accum;
+        std::vector<float> prevRe;
+        std::vector<float> prevIm;
+        std::vector<float> sumPhase;
+      };
+
+      /* 线性插值读取延迟 delay 处的采样，delay >= 1 */
+      float Tap(int ch, double delay) const
+      {
+        const double pos = static_cast<double>(writePos_) - delay;
+        const double base = floor(pos);
+        const float frac = static_cast<float>(pos - base);
+        const unsigned mask = static_cast<unsigned>(ringSize_ - 1);
+        const unsigned index = static_cast<unsigned>(static_cast<long long>(base));
+        const float* ring = &ring_[static_cast<size_t>(ch) * ringSize_];
+        const float a = ring[index & mask];
+        const float b = ring[(index + 1) & mask];
+        return a + (b - a) * frac;
+      }
+
+      /* 在 [minSplice_, maxSplice_] 内找与当前读位置之后波形最相似的跳转距离，direction 为 +1 时向更早的数据跳转 */
+      int SearchSplice(double delay, int direction)
+      {
+        const unsigned mask = static_cast<unsigned>(ringSize_ - 1);
+        const long long ref = static_cast<long long>(writePos_) - static_cast<long long>(delay + 0.5);
+        /* 把参考段和全部候选段覆盖的范围混成单声道拷贝到连续内存 */
+        const long long first = direction > 0 ? ref - maxSplice_ : ref;
+        const int span = maxSplice_ + window8_;
+        for (int i = 0; i < span; ++i) {
+          const unsigned index = static_cast<unsigned>(first + i) & mask;
+          float sum = 0.0f;
+          for (int ch = 0; ch < channels_; ++ch) {
+            sum += ring_[static_cast<size_t>(ch) * ringSize_ + index];
+          }
+          search_[i] = sum;
+        }
+        energy_[0] = 0.0;
+        for (int i = 0; i < span; ++i) {
+          energy_[i + 1] = energy_[i] + static_cast<double>(search_[i]) * search_[i];
+        }
+        const float* reference = &search_[ref - first];
+        int best = minSplice_;
+        double bestScore = -1e300;
+        for (int splice = minSplice_; splice <= maxSplice_; ++splice) {
+          const int start = static_cast<int>(ref - first) - direction * splice;
+          const double e = energy_[start + window8_] - energy_[start];
+          const double score = e > 1e-9 ? internal::ResamplerDot(reference, &search_[start], window8_) / sqrt(e) : 0.0;
+          if (score > bestScore) {
+            bestScore = score;
+            best = splice;
+          }
+        }
+        return best;
+      }
+
+      void ProcessWsola(float* x, int frames, float pitch)
+      {
+        const unsigned mask = static_cast<unsigned>(ringSize_ - 1);
+        const double rate = 1.0 - pitch;
+        for (int t = 0; t < frames; ++t) {
+          for (int ch = 0; ch < channels_; ++ch) {
+            ring_[static_cast<size_t>(ch) * ringSize_ + (writePos_ & mask)] = x[t * channels_ + ch];
+          }
+          if (fade_ > 0) {
+            const float gain = static_cast<float>(fadeFrames_ - fade_ + 1) / (fadeFrames_ + 1);
+            for (int ch = 0; ch < channels_; ++ch) {
+              x[t * channels_ + ch] = Tap(ch, delay_) * gain + Tap(ch, oldDelay_) * (1.0f - gain);
+            }
+            oldDelay_ += rate;
+            --fade_;
+          } else {
+            for (int ch = 0; ch < channels_; ++ch) {
+              x[t * channels_ + ch] = Tap(ch, delay_);
+            }
+          }
+          delay_ += rate;
+          ++writePos_;
+          if (fade_ == 0) {
+            /* 升调时读指针追上写指针，向更早的数据跳转；降调时反之 */
+            if (delay_ < minDelay_) {
+              oldDelay_ = delay_;
+              delay_ += SearchSplice(delay_, 1);
+              fade_ = fadeFrames_;
+            } else if (delay_ > maxDelay_) {
+              oldDelay_ = delay_;
+              delay_ -= SearchSplice(delay_, -1);
+              fade_ = fadeFrames_;
+            }
+          }
+        }
+      }
+
+      void ProcessVocoder(float* x, int frames, float pitch)
+      {
+        const int latency = fftSize_ - hop_;
+        for (int t = 0; t < frames; ++t) {
+          for (int ch = 0; ch < channels_; ++ch) {
+            Vocoder &v = vocoder_[ch];
+            v.inFifo[rover_] = x[t * channels_ + ch];
+            x[t * channels_ + ch] = v.outFifo[rover_ - latency];
+          }
+          if (++rover_ < fftSize_) {
+            continue;
+          }
+          rover_ = latency;
+          for (int ch = 0; ch < channels_; ++ch) {
+            AnalyzeAndSynthesize(vocoder_[ch], pitch);
+          }
+        }
+      }
+
+      void AnalyzeAndSynthesize(Vocoder &v, float pitch)
+      {
+        const double kPi = 3.14159265358979323846;
+        const int bins = fftSize_ / 2 + 1;
+        /* 相邻帧之间每个频点的理论相位增量 */
+        const double expected = 2.0 * kPi * hop_ / fftSize_;
+        for (int i = 0; i < fftSize_; ++i) {
+          re_[i] = v.inFifo[i] * window_[i];
+          im_[i] = 0.0f;
+        }
+        fft_.Forward(&re_[0], &im_[0]);
+
+        /* 谱峰：能量大于左右各两个频点 */
+        int peaks = 0;
+        for (int k = 0; k < bins; ++k) {
+          power_[k] = re_[k] * re_[k] + im_[k] * im_[k];
+        }
+        for (int k = 2; k + 2 < bins; ++k) {
+          const float p = power_[k];
+          if (p > 1e-12f && p > power_[k - 1] && p >= power_[k + 1] && p > power_[k - 2] && p >= power_[k + 2]) {
+            peaks_[peaks++] = k;
+          }
+        }
+
+        /* 以谱峰为中心、相邻谱峰之间的谷点为界划分区域，整块搬移到 pitch 倍频率处；
+         * 谱峰的真实频率由相位差求得，合成相位按真实频率累积，区域内其他频点随谱峰做同样的旋转，保持相对相位 */
+        memset(&synRe_[0], 0, fftSize_ * sizeof(float));
+        memset(&synIm_[0], 0, fftSize_ * sizeof(float));
+        int end = 0;
+        for (int i = 0; i < peaks; ++i) {
+          const int k0 = peaks_[i];
+          const int begin = i == 0 ? 0 : end;
+          end = bins;
+          if (i + 1 < peaks) {
+            end = k0 + 1;
+            for (int k = k0 + 1; k < peaks_[i + 1]; ++k) {
+              end = power_[k] < power_[end] ? k : end;
+            }
+          }
+          const float xr = re_[k0];
+          const float xi = im_[k0];
+          const float pr = v.prevRe[k0];
+          const float pi = v.prevIm[k0];
+          double delta = atan2(static_cast<double>(xi * pr - xr * pi), static_cast<double>(xr * pr + xi * pi)) - k0 * expected;
+          delta -= 2.0 * kPi * floor(delta / (2.0 * kPi) + 0.5);
+          /* 按真实频率而不是谱峰频点计算搬移量，主瓣中心与合成频率的偏差不超过半个频点 */
+          const double analysis = k0 + delta / expected;
+          const double frequency = analysis * pitch;
+          const int shift = static_cast<int>(floor(frequency - analysis + 0.5));
+          const int target = k0 + shift;
+          if (target >= bins) {
+            continue;
+          }
+          double phase = 0.0;
+          if (pitch == 1.0f) {
+            /* 不变调时沿用分析相位，输出与输入只差固定延迟 */
+            phase = atan2(static_cast<double>(xi), static_cast<double>(xr));
+          } else {
+            phase = v.sumPhase[target] + frequency * expected;
+            phase -= 2.0 * kPi * floor(phase / (2.0 * kPi));
+          }
+          /* 旋转量 = 合成相位 - 分析相位，用单位复数表示，区域内逐点复数乘 */
+          const float norm = 1.0f / sqrtf(power_[k0]);
+          const float cr = static_cast<float>(cos(phase));
+          const float ci = static_cast<float>(sin(phase));
+          const float rr = (cr * xr + ci * xi) * norm;
+          const float ri = (ci * xr - cr * xi) * norm;
+          const int from = begin + shift < 0 ? -shift : begin;
+          const int to = end + shift > bins ? bins - shift : end;
+          for (int k = from; k < to; ++k) {
+            synRe_[k + shift] += re_[k] * rr - im_[k] * ri;
+            synIm_[k + shift] += re_[k] * ri + im_[k] * rr;
+          }
+          for (int k = from + shift; k < to + shift; ++k) {
+            v.sumPhase[k] = static_cast<float>(phase);
+          }
+        }
+        memcpy(&v.prevRe[0], &re_[0], bins * sizeof(float));
+        memcpy(&v.prevIm[0], &im_[0], bins * sizeof(float));
+        fft_.Inverse(&synRe_[0], &synIm_[0]);
+
+        /* 单边谱逆变换的实部为 N/2 倍信号，再加窗重叠相加：Hann 窗平方在4倍重叠下之和为1.5 */
+        const float scale = 2.0f / (fftSize_ * 1.5f);
+        for (int i = 0; i < fftSize_; ++i) {
+          v.accum[i] += window_[i] * synRe_[i] * scale;
+        }
+        memcpy(&v.outFifo[0], &v.accum[0], hop_ * sizeof(float));
+        memmove(&v.accum[0], &v.accum[hop_], fftSize_ * sizeof(float));
+        memmove(&v.inFifo[0], &v.inFifo[hop_], (fftSize_ - hop_) * sizeof(float));
+      }
+
+      const int sampleRate_;
+      const int channels_;
+      const AliEngineAudioPitchShiftMode mode_;
+      std::atomic<float> pitch_;
+
+      /* 低延迟模式 */
+      std::vector<float> ring_;
+      std::vector<float> search_;
+      std::vector<double> energy_;
+      int ringSize_ = 0;
+      unsigned writePos_ = 0;
+      double delay_ = 0.0;
+      double oldDelay_ = 0.0;
+      int fade_ = 0;
+      int fadeFrames_ = 0;
+      int window8_ = 0;
+      int minDelay_ = 0;
+      int maxDelay_ = 0;
+      int minSplice_ = 0;
+      int maxSplice_ = 0;
+
+      /* 高音质模式 */
+      internal::PitchFft fft_;
+      int fftSize_ = 0;
+      int hop_ = 0;
+      int rover_ = 0;
+      std::vector<float> window_;
+      std::vector<float> re_;
+      std::vector<float> im_;
+      std::vector<float> synRe_;
+      std::vector<float> synIm_;
+      std::vector<float> power_;
+      std::vector<int> peaks_;
+      Vocoder vocoder_[internal::kPitchMaxChannels];
+    };
+}
+
+#endif /* ali_rtc_engine_audio_pitch_shifter_h */
@@ -0,0 +1,385 @@
+#ifndef ali_rtc_engine_audio_resampler_h
+#define ali_rtc_engine_audio_resampler_h
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_media_engine.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 重采样质量
+     */
+    typedef enum {
+      /** 每相16抽头，适合语音 */
+      AliEngineAudioResampleQualityLow = 0,
+      /** 每相32抽头 */
+      AliEngineAudioResampleQualityMedium = 1,
+      /** 每相64抽头，适合音乐 */
+      AliEngineAudioResampleQualityHigh = 2,
+    } AliEngineAudioResampleQuality;
+
+    /**
+     * @brief 转换 {@link AliEngineAudioSampleRate} 为采样率数值
+     */
+    inline int AliEngineAudioSampleRateValue(AliEngineAudioSampleRate rate)
+    {
+      switch (rate) {
+        case AliEngineAudioSampleRate_8000: return 8000;
+        case AliEngineAudioSampleRate_11025: return 11025;
+        case AliEngineAudioSampleRate_16000: return 16000;
+        case AliEngineAudioSampleRate_22050: return 22050;
+        case AliEngineAudioSampleRate_32000: return 32000;
+        case AliEngineAudioSampleRate_44100: return 44100;
+        case AliEngineAudioSampleRate_48000: return 48000;
+        default: return 0;
+      }
+    }
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      enum {
+        /** 相位表上限，常用采样率之间的转换均不超过该值，超过时四舍五入取最近相位 */
+        kResamplerMaxPhases = 1024,
+        kResamplerMaxChannels = 8,
+      };
+
+      /** 零阶修正贝塞尔函数 */
+      inline double ResamplerBesselI0(double x)
+      {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+          term *= (x / (2.0 * k)) * (x / (2.0 * k));
+          sum += term;
+        }
+        return sum;
+      }
+
+      /** 点积，count 为8的倍数 */
+      inline float ResamplerDot(const float* ALI_RTC_RESTRICT a, const float* ALI_RTC_RESTRICT b, int count)
+      {
+#if defined(ALI_RTC_SIMD_AVX2)
+        __m256 sum = _mm256_setzero_ps();
+        for (int i = 0; i < count; i += 8) {
+          sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+#elif defined(ALI_RTC_SIMD_SSE41)
+        __m128 s0 = _mm_setzero_ps();
+        __m128 s1 = _mm_setzero_ps();
+        for (int i = 0; i < count; i += 8) {
+          s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+          s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        __m128 s = _mm_add_ps(s0, s1);
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+#elif defined(ALI_RTC_SIMD_NEON)
+        float32x4_t s0 = vdupq_n_f32(0.0f);
+        float32x4_t s1 = vdupq_n_f32(0.0f);
+        for (int i = 0; i < count; i += 8) {
+          s0 = vmlaq_f32(s0, vld1q_f32(a + i), vld1q_f32(b + i));
+          s1 = vmlaq_f32(s1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        }
+        const float32x4_t s = vaddq_f32(s0, s1);
+        const float32x2_t h = vadd_f32(vget_low_f32(s), vget_high_f32(s));
+        return vget_lane_f32(vpadd_f32(h, h), 0);
+#else
+        float s[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < count; i += 4) {
+          s[0] += a[i] * b[i];
+          s[1] += a[i + 1] * b[i + 1];
+          s[2] += a[i + 2] * b[i + 2];
+          s[3] += a[i + 3] * b[i + 3];
+        }
+        return (s[0] + s[1]) + (s[2] + s[3]);
+#endif
+      }
+    }
+
+    /**
+     * @brief 有状态多相重采样器
+     * @details 用于在 {@link AliEngineAudioFrameObserverConfig} 的采样率与外部 PCM（{@link IAliEngineMediaEngine::PushExternalAudioFrameRawData}、
+     * {@link IAliEngineMediaEngine::PushExternalAudioStreamRawData}）采样率之间转换：
+     *  - 按 inRate/outRate 约分得到 L/M，预计算 Kaiser 窗 sinc 的 L 相系数，每个输出采样只计算一次点积（SSE4.1/AVX2/NEON）
+     *  - 降采样时按 L/M 缩放截止频率并加长滤波器，避免混叠
+     *  - 每相系数归一化，直流增益为1
+     *  - 滤波器为线性相位，群时延固定，由 {@link GroupDelayUs} 给出，可用于音视频同步补偿
+     * 数据按调用顺序连续处理，分块大小任意，不同分块方式输出一致；历史和 int16 输出缓冲在 Init 时按最大输入长度分配，
+     * 不超过该长度的输入在处理过程中不分配内存
+     * @note 非线程安全；声道数上限为8
+     */
+    class AliEngineAudioResampler {
+    public:
+      AliEngineAudioResampler() {}
+
+      /**
+       * @brief 初始化，会清空历史数据
+       * @param inRate 输入采样率
+       * @param outRate 输出采样率
+       * @param channels 声道数，取值范围[1-8]
+       * @param quality 重采样质量
+       * @param maxInputFrames 单次 Process 的最大输入采样数（单声道），用于预分配缓冲，小于等于0时取10ms，
+       * 超过时首次处理会扩容
+       * @return 0: 成功；-1: 参数错误
+       */
+      int Init(int inRate, int outRate, int channels, AliEngineAudioResampleQuality quality = AliEngineAudioResampleQualityMedium,
+               int maxInputFrames = 0)
+      {
+        if (inRate <= 0 || outRate <= 0 || channels <= 0 || channels > internal::kResamplerMaxChannels) {
+          return -1;
+        }
+        int a = inRate;
+        int b = outRate;
+        while (b != 0) {
+          const int t = a % b;
+          a = b;
+          b = t;
+        }
+        up_ = outRate / a;
+        down_ = inRate / a;
+        inRate_ = inRate;
+        outRate_ = outRate;
+        channels_ = channels;
+        phases_ = up_ < internal::kResamplerMaxPhases ? up_ : internal::kResamplerMaxPhases;
+
+        int baseTaps;
+        double rolloff;
+        double beta;
+        switch (quality) {
+          case AliEngineAudioResampleQualityLow: baseTaps = 16; rolloff = 0.90; beta = 6.0; break;
+          case AliEngineAudioResampleQualityHigh: baseTaps = 64; rolloff = 0.96; beta = 10.0; break;
+          default: baseTaps = 32; rolloff = 0.94; beta = 8.5; break;
+        }
+        double cutoff = rolloff;
+        taps_ = baseTaps;
+        if (down_ > up_) {
+          cutoff = rolloff * up_ / down_;
+          taps_ = static_cast<int>(ceil(baseTaps * static_cast<double>(down_) / up_));
+          taps_ = taps_ > 256 ? 256 : taps_;
+        }
+        taps_ = (taps_ + 7) & ~7;
+
+        /* coef_[p][j] 作用于窗口 x[i - taps + 1 + j]，输出时刻位于 x[i] 之后 p/phases 个输入采样；
+         * 相位数受限时四舍五入可能取到 p == phases，多存一相 */
+        const int rows = phases_ < up_ ? phases_ + 1 : phases_;
+        coef_.assign(static_cast<size_t>(rows) * taps_, 0.0f);
+        const double center = (taps_ - 1) / 2.0;
+        const double i0Beta = internal::ResamplerBesselI0(beta);
+        for (int p = 0; p < rows; ++p) {
+          float* c = &coef_[static_cast<size_t>(p) * taps_];
+          const double frac = static_cast<double>(p) / phases_;
+          double sum = 0.0;
+          for (int j = 0; j < taps_; ++j) {
+            const double t = j - (taps_ - 1) - frac + center;
+            const double w = t / (center + 1.0);
+            const double window = fabs(w) >= 1.0 ? 0.0 : internal::ResamplerBesselI0(beta * sqrt(1.0 - w * w)) / i0Beta;
+            const double x = 3.14159265358979323846 * cutoff * t;
+            const double sinc = fabs(x) < 1e-9 ? 1.0 : sin(x) / x;
+            c[j] = static_cast<float>(sinc * window);
+            sum += c[j];
+          }
+          for (int j = 0; j < taps_; ++j) {
+            c[j] = static_cast<float>(c[j] / sum);
+          }
+        }
+        maxInputFrames_ = maxInputFrames > 0 ? maxInputFrames : (inRate + 99) / 100;
+        output_.assign(static_cast<size_t>(MaxOutputFrames(maxInputFrames_)) * channels_, 0.0f);
+        Reset();
+        return 0;
+      }
+
+      /**
+       * @brief 清空历史数据，下一次输入从零状态开始
+       */
+      void Reset()
+      {
+        history_.assign(static_cast<size_t>(channels_) * (taps_ > 0 ? taps_ + maxInputFrames_ : 1), 0.0f);
+        stride_ = static_cast<int>(history_.size() / (channels_ > 0 ? channels_ : 1));
+        count_ = taps_ > 0 ? taps_ - 1 : 0;
+        cursor_ = count_;
+        phase_ = 0;
+      }
+
+      /**
+       * @brief 群时延，单位：输出采样
+       */
+      double GroupDelayFrames() const
+      {
+        return inRate_ > 0 ? (taps_ - 1) / 2.0 * outRate_ / inRate_ : 0.0;
+      }
+
+      /**
+       * @brief 群时延，单位：us
+       */
+      long long GroupDelayUs() const
+      {
+        return inRate_ > 0 ? static_cast<long long>((taps_ - 1) * 500000.0 / inRate_ + 0.5) : 0;
+      }
+
+      /**
+       * @brief 输入 inFrames 个采样时输出采样数的上限，用于分配输出缓冲
+       */
+      int MaxOutputFrames(int inFrames) const
+      {
+        return down_ > 0 ? static_cast<int>((static_cast<long long>(inFrames) * up_ + down_ - 1) / down_) + 1 : 0;
+      }
+
+      /**
+       * @brief 每相抽头数
+       */
+      int Taps() const { return taps_; }
+
+      /**
+       * @brief 重采样 float 交错数据
+       * @param in 输入，inFrames * channels 个采样
+       * @param inFrames 输入采样数（单声道）
+       * @param out 输出，容量 outCapacity * channels 个采样
+       * @param outCapacity 输出容量（单声道），不足时剩余输入保留到下一次调用
+       * @return 输出采样数（单声道）；未初始化返回-1
+       */
+      int Process(const float* in, int inFrames, float* out, int outCapacity)
+      {
+        if (taps_ <= 0) {
+          return -1;
+        }
+        Append(in, inFrames, 1.0f);
+        const int frames = Produce(out, outCapacity);
+        Compact();
+        return frames;
+      }
+
+      /**
+       * @brief 重采样 int16 交错数据
+       * @return 输出采样数（单声道）；未初始化返回-1
+       */
+      int Process(const int16_t* in, int inFrames, int16_t* out, int outCapacity)
+      {
+        if (taps_ <= 0) {
+          return -1;
+        }
+        Append(in, inFrames, 1.0f / 32768.0f);
+        /* 按预分配的 float 缓冲分段输出再转换，输出容量大于缓冲时不扩容 */
+        const int chunk = static_cast<int>(output_.size() / channels_);
+        int frames = 0;
+        while (frames < outCapacity) {
+          const int request = outCapacity - frames < chunk ? outCapacity - frames : chunk;
+          const int produced = Produce(output_.data(), request);
+          const int n = produced * channels_;
+          int16_t* dst = out + static_cast<size_t>(frames) * channels_;
+          for (int i = 0; i < n; ++i) {
+            float v = output_[i] * 32768.0f;
+            v = v > 32767.0f ? 32767.0f : (v < -32768.0f ? -32768.0f : v);
+            dst[i] = static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+          }
+          frames += produced;
+          if (produced < request) {
+            break;
+          }
+        }
+        Compact();
+        return frames;
+      }
+
+    private:
+      AliEngineAudioResampler(const AliEngineAudioResampler&);
+      AliEngineAudioResampler& operator=(const AliEngineAudioResampler&);
+
+      /* 历史数据按声道分开存放，每声道 stride_ 个采样 */
+      template <typename T>
+      void Append(const T* in, int inFrames, float scale)
+      {
+        if (!in || inFrames <= 0) {
+          return;
+        }
+        if (count_ + inFrames > stride_) {
+          const int stride = (count_ + inFrames) * 2;
+          std::vector<float> grown(static_cast<size_t>(stride) * channels_);
+          for (int c = 0; c < channels_; ++c) {
+            memcpy(&grown[static_cast<size_t>(c) * stride], &history_[static_cast<size_t>(c) * stride_], count_ * sizeof(float));
+          }
+          history_.swap(grown);
+          stride_ = stride;
+        }
+        for (int c = 0; c < channels_; ++c) {
+          float* dst = &history_[static_cast<size_t>(c) * stride_ + count_];
+          for (int i = 0; i < inFrames; ++i) {
+            dst[i] = in[i * channels_ + c] * scale;
+          }
+        }
+        count_ += inFrames;
+      }
+
+      int Produce(float* out, int outCapacity)
+      {
+        int frames = 0;
+        while (cursor_ < count_ && frames < outCapacity) {
+          const int p = phases_ == up_ ? phase_ : static_cast<int>((static_cast<long long>(phase_) * phases_ + up_ / 2) / up_);
+          const float* c = &coef_[static_cast<size_t>(p) * taps_];
+          for (int ch = 0; ch < channels_; ++ch) {
+            const float* x = &history_[static_cast<size_t>(ch) * stride_ + cursor_ - taps_ + 1];
+            out[frames * channels_ + ch] = internal::ResamplerDot(c, x, taps_);
+          }
+          ++frames;
+          phase_ += down_;
+          cursor_ += phase_ / up_;
+          phase_ %= up_;
+        }
+        return frames;
+      }
+
+      /* 丢弃不再需要的历史，保留 taps - 1 个；每次 Process 只做一次，分段输出时不重复搬移 */
+      void Compact()
+      {
+        int drop = cursor_ - (taps_ - 1);
+        drop = drop > count_ ? count_ : drop;
+        if (drop > 0) {
+          for (int ch = 0; ch < channels_; ++ch) {
+            float* h = &history_[static_cast<size_t>(ch) * stride_];
+            memmove(h, h + drop, (count_ - drop) * sizeof(float));
+          }
+          count_ -= drop;
+          cursor_ -= drop;
+        }
+      }
+
+      int inRate_ = 0;
+      int outRate_ = 0;
+      int channels_ = 0;
+      int up_ = 1;
+      int down_ = 1;
+      int phases_ = 1;
+      int taps_ = 0;
+      int maxInputFrames_ = 0;
+      std::vector<float> coef_;
+      std::vector<float> history_;
+      std::vector<float> output_;
+      int stride_ = 0;
+      int count_ = 0;
+      int cursor_ = 0;
+      int phase_ = 0;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_resampler_h */
@@ -0,0 +1,422 @@
+#ifndef ali_rtc_engine_audio_reverb_h
+#define ali_rtc_engine_audio_reverb_h
+
+#include <math.h>
+#include <string.h>
+#include <atomic>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_interface.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    namespace internal
+    {
+      enum {
+        /** 反馈延迟网络的延迟线数 */
+        kReverbLines = 8,
+        /** 处理分块大小（单声道采样数），不超过最短延迟线长度，块内延迟线读写互不重叠 */
+        kReverbBlock = 32,
+        kReverbParams = 8,
+      };
+
+      /** 房间尺寸为100时各延迟线的长度（ms），互质以避免共振峰叠加 */
+      inline const double* ReverbLineMs()
+      {
+        static const double kLineMs[kReverbLines] = { 29.7, 37.1, 41.1, 43.7, 53.1, 59.3, 67.9, 73.3 };
+        return kLineMs;
+      }
+
+      /** 预设参数，按 AliEngineAudioEffectReverbMode 减1索引，参数顺序同 AliEngineAudioEffectReverbParamType */
+      inline const float* ReverbPreset(int mode)
+      {
+        static const float kPresets[][kReverbParams] = {
+          { 60.0f, 10.0f, 50.0f, 40.0f, 100.0f, 80.0f, 0.0f, -6.0f },   /* Vocal_I */
+          { 70.0f, 20.0f, 60.0f, 50.0f, 100.0f, 70.0f, 0.0f, -4.0f },   /* Vocal_II */
+          { 20.0f, 0.0f, 55.0f, 20.0f, 100.0f, 100.0f, 0.0f, -3.0f },   /* Bathroom */
+          { 30.0f, 5.0f, 40.0f, 10.0f, 80.0f, 100.0f, 0.0f, -6.0f },    /* SmallRoomBright */
+          { 30.0f, 5.0f, 40.0f, 70.0f, 100.0f, 50.0f, 0.0f, -6.0f },    /* SmallRoomDark */
+          { 55.0f, 15.0f, 50.0f, 40.0f, 100.0f, 80.0f, 0.0f, -6.0f },   /* MediumRoom */
+          { 85.0f, 30.0f, 65.0f, 45.0f, 100.0f, 75.0f, 0.0f, -5.0f },   /* LargeRoom */
+          { 100.0f, 50.0f, 90.0f, 55.0f, 100.0f, 70.0f, -2.0f, -3.0f }, /* ChurchHall */
+        };
+        return kPresets[mode - 1];
+      }
+
+      /** a[i], b[i] = a[i] + b[i], a[i] - b[i] */
+      inline void ReverbButterfly(float* ALI_RTC_RESTRICT a, float* ALI_RTC_RESTRICT b, int count)
+      {
+        int i = 0;
+#if defined(ALI_RTC_SIMD_AVX2)
+        for (; i + 8 <= count; i += 8) {
+          const __m256 x = _mm256_loadu_ps(a + i);
+          const __m256 y = _mm256_loadu_ps(b + i);
+          _mm256_storeu_ps(a + i, _mm256_add_ps(x, y));
+          _mm256_storeu_ps(b + i, _mm256_sub_ps(x, y));
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        for (; i + 4 <= count; i += 4) {
+          const __m128 x = _mm_loadu_ps(a + i);
+          const __m128 y = _mm_loadu_ps(b + i);
+          _mm_storeu_ps(a + i, _mm_add_ps(x, y));
+          _mm_storeu_ps(b + i, _mm_sub_ps(x, y));
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        for (; i + 4 <= count; i += 4) {
+          const float32x4_t x = vld1q_f32(a + i);
+          const float32x4_t y = vld1q_f32(b + i);
+          vst1q_f32(a + i, vaddq_f32(x, y));
+          vst1q_f32(b + i, vsubq_f32(x, y));
+        }
+#endif
+        for (; i < count; ++i) {
+          const float x = a[i];
+          a[i] = x + b[i];
+          b[i] = x - b[i];
+        }
+      }
+
+      /** dst[i] += src[i] */
+      inline void ReverbAccumulate(float* ALI_RTC_RESTRICT dst, const float* ALI_RTC_RESTRICT src, int count)
+      {
+        int i = 0;
+#if defined(ALI_RTC_SIMD_AVX2)
+        for (; i + 8 <= count; i += 8) {
+          _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        for (; i + 4 <= count; i += 4) {
+          _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        for (; i + 4 <= count; i += 4) {
+          vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+        }
+#endif
+        for (; i < count; ++i) {
+          dst[i] += src[i];
+        }
+      }
+    }
+
+    /**
+     * @brief 反馈延迟网络（FDN）混响
+     * @details 参数与 {@link AliEngineAudioEffectReverbParamType}、预设与 {@link AliEngineAudioEffectReverbMode} 一致，
+     * 用于对外部音频或 {@link IAudioFrameObserver} 回调数据做混响处理：
+     *  - 8条延迟线 + Hadamard 反馈矩阵，每条延迟线带高频阻尼；按32个采样分块，延迟线以连续内存块读写，
+     *    反馈矩阵和输出求和在时间方向上向量化
+     *  - 延迟线和预延时缓冲在构造时按最大房间尺寸一次性分配在同一块内存中，处理过程不分配内存
+     *  - 任何预设和参数下的计算量相同（关闭混响时直接返回）；反馈路径注入极小直流偏置，静音时不会出现非规格化浮点数导致的 CPU 尖峰
+     * @note SetReverbMode/SetReverbParam 可在任意线程调用，在下一个处理分块生效；房间尺寸变化会改变延迟线长度，
+     * 可能产生轻微的瞬态。Process 需在单一音频线程调用；支持单声道和双声道交错数据
+     */
+    class AliEngineAudioReverb {
+    public:
+      /**
+       * @param sampleRate 采样率
+       * @param channels 声道数，取值范围[1-2]
+       */
+      explicit AliEngineAudioReverb(int sampleRate = 48000, int channels = 2)
+        : sampleRate_(sampleRate > 0 ? sampleRate : 48000), channels_(channels == 1 ? 1 : 2)
+      {
+        const int maxLine = static_cast<int>(ceil(internal::ReverbLineMs()[internal::kReverbLines - 1] * 0.001 * sampleRate_)) + internal::kReverbBlock;
+        lineSize_ = PowerOfTwo(maxLine);
+        preDelaySize_ = PowerOfTwo(static_cast<int>(0.2 * sampleRate_) + internal::kReverbBlock);
+        arena_.assign(static_cast<size_t>(lineSize_) * internal::kReverbLines + preDelaySize_, 0.0f);
+        for (int i = 0; i < internal::kReverbParams; ++i) {
+          params_[i].store(0.0f, std::memory_order_relaxed);
+        }
+        mode_.store(AliEngineAudioEffectReverbOff, std::memory_order_relaxed);
+        version_.store(1, std::memory_order_relaxed);
+        Reset();
+      }
+
+      /**
+       * @brief 设置混响预设，同时把全部参数重置为预设值
+       * @return 0: 成功；-1: 参数错误
+       */
+      int SetReverbMode(AliEngineAudioEffectReverbMode mode)
+      {
+        const int index = static_cast<int>(mode);
+        if (index < AliEngineAudioEffectReverbOff || index > AliEngineAudioEffectReverbChurchHall) {
+          return -1;
+        }
+        if (index != AliEngineAudioEffectReverbOff) {
+          for (int i = 0; i < internal::kReverbParams; ++i) {
+            params_[i].store(internal::ReverbPreset(index)[i], std::memory_order_relaxed);
+          }
+        }
+        mode_.store(index, std::memory_order_relaxed);
+        version_.fetch_add(1, std::memory_order_release);
+        return 0;
+      }
+
+      /**
+       * @brief 设置单个混响参数，需在 SetReverbMode 设置非关闭模式之后调用
+       * @param type 参数类型
+       * @param value 参数值，取值范围参考 {@link AliEngineAudioEffectReverbParamType}
+       * @return 0: 成功；-1: 参数错误或混响未开启
+       */
+      int SetReverbParam(AliEngineAudioEffectReverbParamType type, float value)
+      {
+        const int index = static_cast<int>(type);
+        if (index < 0 || index >= internal::kReverbParams || mode_.load(std::memory_order_relaxed) == AliEngineAudioEffectReverbOff) {
+          return -1;
+        }
+        const float low = index == AliEngineAudioEffectReverbDryGain || index == AliEngineAudioEffectReverbWetGain ? -20.0f : 0.0f;
+        const float high = index == AliEngineAudioEffectReverbPreDelay ? 200.0f :
+                           (index == AliEngineAudioEffectReverbDryGain || index == AliEngineAudioEffectReverbWetGain ? 10.0f : 100.0f);
+        if (!(value >= low && value <= high)) {
+          return -1;
+        }
+        params_[index].store(value, std::memory_order_relaxed);
+        version_.fetch_add(1, std::memory_order_release);
+        return 0;
+      }
+
+      float GetReverbParam(AliEngineAudioEffectReverbParamType type) const
+      {
+        const int index = static_cast<int>(type);
+        return index >= 0 && index < internal::kReverbParams ? params_[index].load(std::memory_order_relaxed) : 0.0f;
+      }
+
+      /**
+       * @brief 清空混响尾音
+       */
+      void Reset()
+      {
+        memset(&arena_[0], 0, arena_.size() * sizeof(float));
+        memset(damp_, 0, sizeof(damp_));
+        tone_ = 0.0f;
+        writePos_ = 0;
+        appliedVersion_ = 0;
+        dry_ = 1.0f;
+        wet_ = 0.0f;
+      }
+
+      /**
+       * @brief 原地处理 float 交错数据
+       * @param samples 数据，frames * channels 个采样
+       * @param frames 采样数（单声道）
+       */
+      void Process(float* samples, int frames)
+      {
+        float block[internal::kReverbBlock * 2];
+        for (int offset = 0; offset < frames; offset += internal::kReverbBlock) {
+          const int count = frames - offset < internal::kReverbBlock ? frames - offset : internal::kReverbBlock;
+          if (!UpdateParams()) {
+            continue;
+          }
+          float* data = samples + static_cast<size_t>(offset) * channels_;
+          memcpy(block, data, static_cast<size_t>(count) * channels_ * sizeof(float));
+          ProcessBlock(block, count);
+          memcpy(data, block, static_cast<size_t>(count) * channels_ * sizeof(float));
+        }
+      }
+
+      /**
+       * @brief 原地处理 int16 交错数据
+       */
+      void Process(int16_t* samples, int frames)
+      {
+        float block[internal::kReverbBlock * 2];
+        for (int offset = 0; offset < frames; offset += internal::kReverbBlock) {
+          const int count = frames - offset < internal::kReverbBlock ? frames - offset : internal::kReverbBlock;
+          if (!UpdateParams()) {
+            continue;
+          }
+          int16_t* data = samples + static_cast<size_t>(offset) * channels_;
+          const int n = count * channels_;
+          for (int i = 0; i < n; ++i) {
+            block[i] = data[i];
+          }
+          ProcessBlock(block, count);
+          for (int i = 0; i < n; ++i) {
+            const float v = block[i] > 32767.0f ? 32767.0f : (block[i] < -32768.0f ? -32768.0f : block[i]);
+            data[i] = static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+          }
+        }
+      }
+
+    private:
+      AliEngineAudioReverb(const AliEngineAudioReverb&);
+      AliEngineAudioReverb& operator=(const AliEngineAudioReverb&);
+
+      static int PowerOfTwo(int value)
+      {
+        int size = 64;
+        while (size < value) {
+          size <<= 1;
+        }
+        return size;
+      }
+
+      /* 参数有变化时重算延迟长度和系数，返回 false 表示混响关闭 */
+      bool UpdateParams()
+      {
+        const unsigned version = version_.load(std::memory_order_acquire);
+        if (version == appliedVersion_) {
+          return enabled_;
+        }
+        appliedVersion_ = version;
+        const bool enabled = mode_.load(std::memory_order_relaxed) != AliEngineAudioEffectReverbOff;
+        if (enabled && !enabled_) {
+          /* 重新开启时不带出上次关闭前的尾音 */
+          memset(&arena_[0], 0, arena_.size() * sizeof(float));
+          memset(damp_, 0, sizeof(damp_));
+          tone_ = 0.0f;
+          dry_ = 1.0f;
+          wet_ = 0.0f;
+        }
+        enabled_ = enabled;
+        if (!enabled_) {
+          return false;
+        }
+        float p[internal::kReverbParams];
+        for (int i = 0; i < internal::kReverbParams; ++i) {
+          p[i] = params_[i].load(std::memory_order_relaxed);
+        }
+        const double room = p[AliEngineAudioEffectReverbRoomSize] / 100.0;
+        const double rt60 = (0.2 + 0.04 * p[AliEngineAudioEffectReverbReverberance]) * (0.4 + 0.6 * room);
+        /* Hadamard 矩阵的 1/sqrt(8) 归一化并入反馈增益 */
+        const double norm = 1.0 / sqrt(static_cast<double>(internal::kReverbLines));
+        for (int i = 0; i < internal::kReverbLines; ++i) {
+          int length = static_cast<int>(internal::ReverbLineMs()[i] * (0.3 + 0.7 * room) * 0.001 * sampleRate_);
+          length = length < internal::kReverbBlock ? internal::kReverbBlock : length;
+          lineLength_[i] = length;
+          feedback_[i] = static_cast<float>(pow(10.0, -3.0 * length / (rt60 * sampleRate_)) * norm);
+        }
+        dampCoef_ = p[AliEngineAudioEffectReverbHfDamping] / 100.0f * 0.85f;
+        preDelay_ = static_cast<int>(p[AliEngineAudioEffectReverbPreDelay] * 0.001f * sampleRate_);
+        /* 音调：以约500Hz为界分别调整湿信号的低频和高频 */
+        toneCoef_ = static_cast<float>(1.0 - exp(-2.0 * 3.14159265358979323846 * 500.0 / sampleRate_));
+        toneLow_ = p[AliEngineAudioEffectReverbToneLow] / 100.0f;
+        toneHigh_ = p[AliEngineAudioEffectReverbToneHigh] / 100.0f;
+        dryTarget_ = powf(10.0f, p[AliEngineAudioEffectReverbDryGain] / 20.0f);
+        /* 8条延迟线按奇偶分到左右声道，各4条求和 */
+        wetTarget_ = powf(10.0f, p[AliEngineAudioEffectReverbWetGain] / 20.0f) * 0.5f;
+        return true;
+      }
+
+      void ReadRing(const float* ring, int size, unsigned pos, float* dst, int count) const
+      {
+        const int index = static_cast<int>(pos & static_cast<unsigned>(size - 1));
+        const int first = count < size - index ? count : size - index;
+        memcpy(dst, ring + index, static_cast<size_t>(first) * sizeof(float));
+        memcpy(dst + first, ring, static_cast<size_t>(count - first) * sizeof(float));
+      }
+
+      void WriteRing(float* ring, int size, unsigned pos, const float* src, int count)
+      {
+        const int index = static_cast<int>(pos & static_cast<unsigned>(size - 1));
+        const int first = count < size - index ? count : size - index;
+        memcpy(ring + index, src, static_cast<size_t>(first) * sizeof(float));
+        memcpy(ring, src + first, static_cast<size_t>(count - first) * sizeof(float));
+      }
+
+      void ProcessBlock(float* x, int n)
+      {
+        float input[internal::kReverbBlock];
+        float taps[internal::kReverbLines][internal::kReverbBlock];
+        float left[internal::kReverbBlock];
+        float right[internal::kReverbBlock];
+        float* preDelay = &arena_[static_cast<size_t>(lineSize_) * internal::kReverbLines];
+
+        for (int t = 0; t < n; ++t) {
+          input[t] = channels_ == 2 ? (x[t * 2] + x[t * 2 + 1]) * 0.5f : x[t];
+        }
+        WriteRing(preDelay, preDelaySize_, writePos_, input, n);
+        ReadRing(preDelay, preDelaySize_, writePos_ - static_cast<unsigned>(preDelay_), input, n);
+        for (int t = 0; t < n; ++t) {
+          const float in = input[t] + 1e-20f;
+          tone_ += toneCoef_ * (in - tone_);
+          input[t] = tone_ * toneLow_ + (in - tone_) * toneHigh_;
+        }
+
+        /* 延迟线长度不小于分块大小，整块读出的都是之前写入的数据 */
+        for (int i = 0; i < internal::kReverbLines; ++i) {
+          ReadRing(&arena_[static_cast<size_t>(lineSize_) * i], lineSize_, writePos_ - static_cast<unsigned>(lineLength_[i]), taps[i], n);
+        }
+        /* 高频阻尼是逐采样递归，8条延迟线交错计算以隐藏依赖链延迟 */
+        float state[internal::kReverbLines];
+        memcpy(state, damp_, sizeof(state));
+        const float coef = dampCoef_;
+        for (int t = 0; t < n; ++t) {
+          for (int i = 0; i < internal::kReverbLines; ++i) {
+            state[i] = taps[i][t] + coef * (state[i] - taps[i][t]);
+            taps[i][t] = state[i] * feedback_[i];
+          }
+        }
+        memcpy(damp_, state, sizeof(state));
+        memcpy(left, taps[0], static_cast<size_t>(n) * sizeof(float));
+        memcpy(right, taps[1], static_cast<size_t>(n) * sizeof(float));
+        for (int i = 2; i < internal::kReverbLines; i += 2) {
+          internal::ReverbAccumulate(left, taps[i], n);
+          internal::ReverbAccumulate(right, taps[i + 1], n);
+        }
+
+        for (int span = 1; span < internal::kReverbLines; span <<= 1) {
+          for (int i = 0; i < internal::kReverbLines; i += span * 2) {
+            for (int j = i; j < i + span; ++j) {
+              internal::ReverbButterfly(taps[j], taps[j + span], n);
+            }
+          }
+        }
+        for (int i = 0; i < internal::kReverbLines; ++i) {
+          internal::ReverbAccumulate(taps[i], input, n);
+          WriteRing(&arena_[static_cast<size_t>(lineSize_) * i], lineSize_, writePos_, taps[i], n);
+        }
+        writePos_ += static_cast<unsigned>(n);
+
+        /* 干湿增益在分块内线性过渡 */
+        const float dryStep = (dryTarget_ - dry_) / n;
+        const float wetStep = (wetTarget_ - wet_) / n;
+        for (int t = 0; t < n; ++t) {
+          dry_ += dryStep;
+          wet_ += wetStep;
+          if (channels_ == 2) {
+            x[t * 2] = x[t * 2] * dry_ + left[t] * wet_;
+            x[t * 2 + 1] = x[t * 2 + 1] * dry_ + right[t] * wet_;
+          } else {
+            x[t] = x[t] * dry_ + (left[t] + right[t]) * 0.5f * wet_;
+          }
+        }
+        dry_ = dryTarget_;
+        wet_ = wetTarget_;
+      }
+
+      const int sampleRate_;
+      const int channels_;
+      std::atomic<float> params_[internal::kReverbParams];
+      std::atomic<int> mode_;
+      std::atomic<unsigned> version_;
+      unsigned appliedVersion_ = 0;
+      bool enabled_ = false;
+
+      /** 延迟线与预延时共用的预分配内存：kReverbLines 条 lineSize_ 长的延迟线，之后是预延时环形缓冲 */
+      std::vector<float> arena_;
+      int lineSize_ = 0;
+      int preDelaySize_ = 0;
+      /** 无符号计数，长时间运行回绕后按2的幂取模仍然正确 */
+      unsigned writePos_ = 0;
+      int lineLength_[internal::kReverbLines] = {};
+      float feedback_[internal::kReverbLines] = {};
+      float damp_[internal::kReverbLines] = {};
+      float dampCoef_ = 0.0f;
+      int preDelay_ = 0;
+      float tone_ = 0.0f;
+      float toneCoef_ = 0.0f;
+      float toneLow_ = 1.0f;
+      float toneHigh_ = 1.0f;
+      float dry_ = 1.0f;
+      float wet_ = 0.0f;
+      float dryTarget_ = 1.0f;
+      float wetTarget_ = 0.0f;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_reverb_h */
@@ -0,0 +1,471 @@
+#ifndef ali_rtc_engine_audio_volume_meter_h
+#define ali_rtc_engine_audio_volume_meter_h
+
+#include <math.h>
+#include <mutex>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_interface.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 音量提示配置，含义与 {@link IAliEngine::EnableAudioVolumeIndication} 一致
+     */
+    typedef struct AliEngineAudioVolumeIndicationConfig {
+      /** 回调间隔，单位：ms，最小值10，默认值：300 */
+      int interval = 300;
+      /** 平滑系数，取值范围[0, 9]，数值越大平滑程度越高，默认值：3 */
+      int smooth = 3;
+      /** 是否进行说话人检测，默认值：true */
+      bool reportVad = true;
+      /** 最大流数，默认值：64 */
+      int maxStreams = 64;
+    } AliEngineAudioVolumeIndicationConfig;
+
+    /**
+     * @brief 单路音量检测输入
+     */
+    typedef struct AliEngineAudioVolumeMeterInput {
+      /** {@link AliEngineAudioVolumeMeter::AddStream} 返回的流ID */
+      int streamId = -1;
+      /** 音频数据，bytesPerSample 为2（int16）或4（float，取值范围[-1, 1]） */
+      const AliEngineAudioRawData* data = nullptr;
+    } AliEngineAudioVolumeMeterInput;
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      /** 单路一帧的测量结果，采样归一化到[-1, 1] */
+      struct VolumeMeasure {
+        float sumSquares = 0.0f;
+        float peak = 0.0f;
+        int samples = 0;
+      };
+
+      /** int16 平方和与峰值 */
+      inline void VolumeMeasureS16(const int16_t* ALI_RTC_RESTRICT src, int count, VolumeMeasure &out)
+      {
+        int i = 0;
+        float sum = 0.0f;
+        int peak = 0;
+#if defined(ALI_RTC_SIMD_AVX2)
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        __m256i hi = _mm256_setzero_si256();
+        __m256i lo = _mm256_setzero_si256();
+        for (; i + 16 <= count; i += 16) {
+          const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+          hi = _mm256_max_epi16(hi, s);
+          lo = _mm256_min_epi16(lo, s);
+          const __m256 a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(s)));
+          const __m256 b = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(s, 1)));
+          acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(a, a));
+          acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(b, b));
+        }
+        float lanes[8];
+        _mm256_storeu_ps(lanes, _mm256_add_ps(acc0, acc1));
+        sum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+        int16_t h[16];
+        int16_t l[16];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(h), hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(l), lo);
+        for (int k = 0; k < 16; ++k) {
+          peak = h[k] > peak ? h[k] : peak;
+          peak = -l[k] > peak ? -l[k] : peak;
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        __m128i hi = _mm_setzero_si128();
+        __m128i lo = _mm_setzero_si128();
+        for (; i + 8 <= count; i += 8) {
+          const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+          hi = _mm_max_epi16(hi, s);
+          lo = _mm_min_epi16(lo, s);
+          const __m128 a = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(s));
+          const __m128 b = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(s, 8)));
+          acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+          acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        int16_t h[8];
+        int16_t l[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(h), hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(l), lo);
+        for (int k = 0; k < 8; ++k) {
+          peak = h[k] > peak ? h[k] : peak;
+          peak = -l[k] > peak ? -l[k] : peak;
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        int16x8_t hi = vdupq_n_s16(0);
+        int16x8_t lo = vdupq_n_s16(0);
+        for (; i + 8 <= count; i += 8) {
+          const int16x8_t s = vld1q_s16(src + i);
+          hi = vmaxq_s16(hi, s);
+          lo = vminq_s16(lo, s);
+          const float32x4_t a = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+          const float32x4_t b = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+          acc0 = vmlaq_f32(acc0, a, a);
+          acc1 = vmlaq_f32(acc1, b, b);
+        }
+        float lanes[4];
+        vst1q_f32(lanes, vaddq_f32(acc0, acc1));
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        int16_t h[8];
+        int16_t l[8];
+        vst1q_s16(h, hi);
+        vst1q_s16(l, lo);
+        for (int k = 0; k < 8; ++k) {
+          peak = h[k] > peak ? h[k] : peak;
+          peak = -l[k] > peak ? -l[k] : peak;
+        }
+#endif
+        for (; i < count; ++i) {
+          const int v = src[i];
+          sum += static_cast<float>(v * v);
+          peak = v > peak ? v : (-v > peak ? -v : peak);
+        }
+        const float scale = 1.0f / 32768.0f;
+        out.sumSquares = sum * scale * scale;
+        out.peak = peak * scale;
+        out.samples = count;
+      }
+
+      /** float 平方和与峰值 */
+      inline void VolumeMeasureF32(const float* ALI_RTC_RESTRICT src, int count, VolumeMeasure &out)
+      {
+        int i = 0;
+        float sum = 0.0f;
+        float peak = 0.0f;
+#if defined(ALI_RTC_SIMD_AVX2)
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+        __m256 acc = _mm256_setzero_ps();
+        __m256 top = _mm256_setzero_ps();
+        for (; i + 8 <= count; i += 8) {
+          const __m256 s = _mm256_loadu_ps(src + i);
+          acc = _mm256_add_ps(acc, _mm256_mul_ps(s, s));
+          top = _mm256_max_ps(top, _mm256_andnot_ps(sign, s));
+        }
+        float lanes[8];
+        float tops[8];
+        _mm256_storeu_ps(lanes, acc);
+        _mm256_storeu_ps(tops, top);
+        for (int k = 0; k < 8; ++k) {
+          sum += lanes[k];
+          peak = tops[k] > peak ? tops[k] : peak;
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        __m128 acc = _mm_setzero_ps();
+        __m128 top = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+          const __m128 s = _mm_loadu_ps(src + i);
+          acc = _mm_add_ps(acc, _mm_mul_ps(s, s));
+          top = _mm_max_ps(top, _mm_andnot_ps(sign, s));
+        }
+        float lanes[4];
+        float tops[4];
+        _mm_storeu_ps(lanes, acc);
+        _mm_storeu_ps(tops, top);
+        for (int k = 0; k < 4; ++k) {
+          sum += lanes[k];
+          peak = tops[k] > peak ? tops[k] : peak;
+        }
+#elif defined(ALI_RTC_SIMD_NEON)
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        float32x4_t top = vdupq_n_f32(0.0f);
+        for (; i + 4 <= count; i += 4) {
+          const float32x4_t s = vld1q_f32(src + i);
+          acc = vmlaq_f32(acc, s, s);
+          top = vmaxq_f32(top, vabsq_f32(s));
+        }
+        float lanes[4];
+        float tops[4];
+        vst1q_f32(lanes, acc);
+        vst1q_f32(tops, top);
+        for (int k = 0; k < 4; ++k) {
+          sum += lanes[k];
+          peak = tops[k] > peak ? tops[k] : peak;
+        }
+#endif
+        for (; i < count; ++i) {
+          sum += src[i] * src[i];
+          const float a = fabsf(src[i]);
+          peak = a > peak ? a : peak;
+        }
+        out.sumSquares = sum;
+        out.peak = peak;
+        out.samples = count;
+      }
+
+      /** 一次测量本帧全部输入，结果按输入顺序写入 out */
+      inline void VolumeMeasureBatch(const AliEngineAudioVolumeMeterInput* inputs, int count, VolumeMeasure* out)
+      {
+        for (int i = 0; i < count; ++i) {
+          const AliEngineAudioRawData* data = inputs[i].data;
+          out[i] = VolumeMeasure();
+          if (!data || !data->dataPtr || data->numOfSamples <= 0) {
+            continue;
+          }
+          const int n = data->numOfSamples * (data->numOfChannels > 0 ? data->numOfChannels : 1);
+          if (data->bytesPerSample == 2) {
+            VolumeMeasureS16(static_cast<const int16_t*>(data->dataPtr), n, out[i]);
+          } else if (data->bytesPerSample == 4) {
+            VolumeMeasureF32(static_cast<const float*>(data->dataPtr), n, out[i]);
+          }
+        }
+      }
+    }
+
+    /**
+     * @brief 批量音量与说话人检测
+     * @details 对应 {@link IAliEngine::EnableAudioVolumeIndication} 与 {@link AliEngineEventListener::OnAudioVolumeCallback}，
+     * 用于在多人语聊房中对自行解码或混音的多路音频做音量提示：
+     *  - 每个音频周期一次调用测量全部流的能量和峰值（SSE4.1/AVX2/NEON），每路每采样一次乘加
+     *  - 说话人检测按能量相对自适应噪声底的高度判断，带200ms拖尾，不受恒定背景噪声影响
+     *  - 结果数组按 maxStreams 在构造时分配，uid 只在 AddStream 时拷贝一次，之后每个周期原地更新，回调时不分配内存
+     * volume 为回调周期内各帧音量的最大值按 smooth 平滑，sumVolume 为周期内各帧音量的平均值；音量按 [-60, 0]dBFS 线性映射到[0, 255]。
+     * totalVolume 按各路能量之和计算，等价于各路不相关时混音后的音量
+     * @note Process 需在单一音频线程调用，回调在 Process 所在线程触发；回调中不可调用 AddStream/RemoveStream
+     */
+    class AliEngineAudioVolumeMeter {
+    public:
+      explicit AliEngineAudioVolumeMeter(const AliEngineAudioVolumeIndicationConfig &config = AliEngineAudioVolumeIndicationConfig())
+        : config_(config)
+      {
+        config_.interval = config_.interval < 10 ? 10 : config_.interval;
+        config_.smooth = config_.smooth < 0 ? 0 : (config_.smooth > 9 ? 9 : config_.smooth);
+        config_.maxStreams = config_.maxStreams > 0 ? config_.maxStreams : 1;
+        results_.resize(config_.maxStreams);
+        states_.resize(config_.maxStreams);
+        slots_.assign(config_.maxStreams, -1);
+        ids_.assign(config_.maxStreams, -1);
+        measures_.resize(config_.maxStreams);
+        seen_.assign(config_.maxStreams, 0);
+      }
+
+      /**
+       * @brief 设置回调对象，为空时只更新结果不回调
+       */
+      void SetListener(AliEngineEventListener* listener)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        listener_ = listener;
+      }
+
+      /**
+       * @brief 添加一路流
+       * @param uid 用户ID，回调中原样返回
+       * @return 流ID；超过最大路数返回-1
+       */
+      int AddStream(const char* uid)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        for (int id = 0; id < config_.maxStreams; ++id) {
+          if (slots_[id] < 0) {
+            const int position = count_++;
+            slots_[id] = position;
+            ids_[position] = id;
+            results_[position].uid = uid;
+            results_[position].speechState = false;
+            results_[position].volume = 0;
+            results_[position].sumVolume = 0;
+            states_[position] = StreamState();
+            return id;
+          }
+        }
+        return -1;
+      }
+
+      /**
+       * @brief 移除一路流，最后一路移到空出的位置
+       */
+      void RemoveStream(int streamId)
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (streamId < 0 || streamId >= config_.maxStreams || slots_[streamId] < 0) {
+          return;
+        }
+        const int position = slots_[streamId];
+        const int last = --count_;
+        if (position != last) {
+          results_[position] = results_[last];
+          states_[position] = states_[last];
+          ids_[position] = ids_[last];
+          slots_[ids_[position]] = position;
+        }
+        slots_[streamId] = -1;
+        ids_[last] = -1;
+      }
+
+      /**
+       * @brief 处理一个音频周期
+       * @param inputs 本周期各路数据，未出现在其中的流本周期按静音计
+       * @param count 输入数
+       * @return 0: 成功；1: 本次触发了回调；-1: 参数错误
+       */
+      int Process(const AliEngineAudioVolumeMeterInput* inputs, int count)
+      {
+        if (count < 0 || count > config_.maxStreams || (count > 0 && !inputs)) {
+          return -1;
+        }
+        internal::VolumeMeasureBatch(inputs, count, &measures_[0]);
+        std::lock_guard<std::mutex> guard(lock_);
+        double frameMs = 0.0;
+        double total = 0.0;
+        ++cycle_;
+        for (int i = 0; i < count; ++i) {
+          const int id = inputs[i].streamId;
+          const internal::VolumeMeasure &m = measures_[i];
+          if (id < 0 || id >= config_.maxStreams || slots_[id] < 0 || m.samples == 0) {
+            continue;
+          }
+          const AliEngineAudioRawData* data = inputs[i].data;
+          if (data->samplesPerSec > 0) {
+            const double ms = data->numOfSamples * 1000.0 / data->samplesPerSec;
+            frameMs = ms > frameMs ? ms : frameMs;
+          }
+          const double energy = m.sumSquares / m.samples;
+          total += energy;
+          Update(states_[slots_[id]], 10.0 * log10(energy + 1e-10));
+          seen_[slots_[id]] = cycle_;
+        }
+        /* 本周期未送入数据的流按静音更新，拖尾照常递减 */
+        for (int position = 0; position < count_; ++position) {
+          if (seen_[position] != cycle_) {
+            Update(states_[position], kSilenceDb);
+          }
+        }
+        totalEnergy_ += total;
+        ++frames_;
+        elapsedMs_ += frameMs > 0.0 ? frameMs : 10.0;
+        if (elapsedMs_ < config_.interval) {
+          return 0;
+        }
+        Report();
+        return 1;
+      }
+
+      /**
+       * @brief 最近一次回调的结果，下次 Process 触发回调前有效
+       * @param count 流数
+       */
+      const AliEngineUserVolumeInfo* GetVolumeInfo(int &count, int &totalVolume) const
+      {
+        count = reportedCount_;
+        totalVolume = totalVolume_;
+        return results_.empty() ? nullptr : &results_[0];
+      }
+
+    private:
+      AliEngineAudioVolumeMeter(const AliEngineAudioVolumeMeter&);
+      AliEngineAudioVolumeMeter& operator=(const AliEngineAudioVolumeMeter&);
+
+      enum {
+        /** 说话判决后的保持帧数（10ms 帧约200ms） */
+        kHangoverFrames = 20,
+        /** 未送入数据的流按该电平计，单位：dBFS */
+        kSilenceDb = -100,
+      };
+
+      struct StreamState {
+        float noiseFloorDb = -70.0f;
+        int hangover = 0;
+        int maxVolume = 0;
+        int sumVolume = 0;
+        int frames = 0;
+        float smoothed = 0.0f;
+      };
+
+      static int LevelToVolume(double levelDb)
+      {
+        const double v = (levelDb + 60.0) * (255.0 / 60.0);
+        return v <= 0.0 ? 0 : (v >= 255.0 ? 255 : static_cast<int>(v + 0.5));
+      }
+
+      void Update(StreamState &state, double levelDb)
+      {
+        const int volume = LevelToVolume(levelDb);
+        state.maxVolume = volume > state.maxVolume ? volume : state.maxVolume;
+        state.sumVolume += volume;
+        ++state.frames;
+        /* 噪声底快降慢升：低于噪声底时立即跟随，否则每帧上升0.05dB（约5dB/s）；
+           数字静音和未送入数据不代表背景噪声，不更新噪声底，避免恢复输入后长时间误判为说话 */
+        if (levelDb > kSilenceDb) {
+          if (levelDb < state.noiseFloorDb) {
+            state.noiseFloorDb = static_cast<float>(levelDb);
+          } else {
+            state.noiseFloorDb += 0.05f;
+          }
+        }
+        if (levelDb > state.noiseFloorDb + 10.0 && levelDb > -55.0) {
+          state.hangover = kHangoverFrames;
+        } else if (state.hangover > 0) {
+          --state.hangover;
+        }
+      }
+
+      void Report()
+      {
+        const float keep = config_.smooth / (config_.smooth + 1.0f);
+        for (int i = 0; i < count_; ++i) {
+          StreamState &state = states_[i];
+          AliEngineUserVolumeInfo &info = results_[i];
+          state.smoothed = state.smoothed * keep + state.maxVolume * (1.0f - keep);
+          info.volume = static_cast<int>(state.smoothed + 0.5f);
+          info.sumVolume = state.frames > 0 ? state.sumVolume / state.frames : 0;
+          info.speechState = config_.reportVad && state.hangover > 0;
+          state.maxVolume = 0;
+          state.sumVolume = 0;
+          state.frames = 0;
+        }
+        totalVolume_ = LevelToVolume(10.0 * log10(totalEnergy_ / (frames_ > 0 ? frames_ : 1) + 1e-10));
+        reportedCount_ = count_;
+        totalEnergy_ = 0.0;
+        frames_ = 0;
+        elapsedMs_ = 0.0;
+        if (listener_) {
+          listener_->OnAudioVolumeCallback(count_ > 0 ? &results_[0] : nullptr, count_, totalVolume_);
+        }
+      }
+
+      AliEngineAudioVolumeIndicationConfig config_;
+      std::mutex lock_;
+      AliEngineEventListener* listener_ = nullptr;
+      /* 按位置紧凑排列，[0, count_) 有效；slots_ 由流ID映射到位置，ids_ 由位置映射回流ID */
+      std::vector<AliEngineUserVolumeInfo> results_;
+      std::vector<StreamState> states_;
+      std::vector<int> slots_;
+      std::vector<int> ids_;
+      std::vector<internal::VolumeMeasure> measures_;
+      /* 按位置记录最近一次送入数据的 Process 序号 */
+      std::vector<unsigned> seen_;
+      unsigned cycle_ = 0;
+      int count_ = 0;
+      int reportedCount_ = 0;
+      int totalVolume_ = 0;
+      double totalEnergy_ = 0.0;
+      int frames_ = 0;
+      double elapsedMs_ = 0.0;
+    };
+}
+
+#endif /* ali_rtc_engine_audio_volume_meter_h */
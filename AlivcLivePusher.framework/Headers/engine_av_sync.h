@@ -0,0 +1,489 @@
+#ifndef ali_rtc_engine_av_sync_h
+#define ali_rtc_engine_av_sync_h
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "engine_media_engine.h"
+#include "engine_simd_utils.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 音视频同步配置
+     */
+    typedef struct AliEngineAvSyncConfig {
+      /** 时钟恢复的观测窗口时长，单位：ms，默认值：30000 */
+      int windowMs = 30000;
+      /** 观测窗口划分的分段数，每段保留到达最早的一个样本，默认值：128 */
+      int windowSize = 128;
+      /** 开始信任斜率估计所需的最短观测时长，单位：ms，默认值：2000 */
+      int minRegressionSpanMs = 2000;
+      /** 允许的最大时钟漂移，单位：ppm，默认值：1000 */
+      int maxDriftPpm = 1000;
+      /** 时钟映射的平滑系数，取值范围(0-1]，越小越平滑，默认值：0.05 */
+      float smoothing = 0.05f;
+      /** 时钟映射每次更新的最大修正量，单位：us，默认值：2000 */
+      int maxSlewUs = 2000;
+      /** 偏差超过该值时视为时间戳不连续，重新建立映射，单位：ms，默认值：500 */
+      int resyncThresholdMs = 500;
+      /** 视频输出帧间隔，0表示不做补帧/丢帧、仅映射时间戳，单位：us，默认值：0 */
+      int videoFrameIntervalUs = 0;
+      /** 单帧最多重复次数，默认值：3 */
+      int maxVideoRepeat = 3;
+      /** 音频漂移修正的比例增益，单位：ppm/ms，默认值：20 */
+      float audioCorrectionGain = 20.0f;
+    } AliEngineAvSyncConfig;
+
+    /**
+     * @brief 视频帧同步处理结果
+     */
+    typedef enum {
+      /** 送出该帧 */
+      AliEngineAvSyncVideoSend = 0,
+      /** 丢弃该帧 */
+      AliEngineAvSyncVideoDrop = 1,
+      /** 先重复送出上一帧 repeatCount 次，再送出该帧 */
+      AliEngineAvSyncVideoRepeat = 2,
+    } AliEngineAvSyncVideoAction;
+
+    /**
+     * @brief 音视频同步统计信息
+     */
+    typedef struct AliEngineAvSyncStats {
+      /** 视频源时钟相对引擎时钟的漂移，单位：ppm */
+      double videoDriftPpm = 0;
+      /** 音频源时钟相对引擎时钟的漂移，单位：ppm */
+      double audioDriftPpm = 0;
+      /** 当前音频重采样比例（输出/输入） */
+      double audioResampleRatio = 1.0;
+      /** 音频已输出位置与映射时间的偏差，正值表示音频输出落后，单位：us */
+      long long audioErrorUs = 0;
+      /** 最近一帧视频输出时间戳与映射时间的偏差，单位：us */
+      long long videoErrorUs = 0;
+      /** 丢弃的视频帧数 */
+      unsigned long long droppedVideoFrames = 0;
+      /** 重复的视频帧数 */
+      unsigned long long repeatedVideoFrames = 0;
+      /** 时间戳不连续导致的重新同步次数 */
+      unsigned long long resyncCount = 0;
+    } AliEngineAvSyncStats;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 时钟恢复滤波器，把源时钟时间戳映射到引擎时钟
+     * @details 观测窗口按源时间等分为若干段，每段只保留到达最早（抖动最小）的样本，对这些下包络样本做线性回归得到漂移斜率，
+     * 再取残差最小值作为偏移，滤除调度和传输带来的正向抖动；映射结果以一阶锁相环方式逐步修正，单次修正量受限，
+     * 输出时间戳连续不跳变。每次更新的计算量与分段数成正比，与输入帧率无关
+     * @note 非线程安全
+     */
+    class AliEngineClockRecovery {
+    public:
+      explicit AliEngineClockRecovery(const AliEngineAvSyncConfig &config = AliEngineAvSyncConfig())
+        : config_(config),
+          window_(config.windowSize > 8 ? config.windowSize : 8),
+          bucketUs_((config.windowMs > 0 ? config.windowMs : 1000) * 1000.0 / window_.size()) {}
+
+      /**
+       * @brief 输入一个样本并返回映射后的引擎时间
+       * @param sourceUs 源时间戳，单位：us
+       * @param arrivalUs 到达时的引擎时钟，单位：us
+       * @return 映射后的引擎时间，单位：us
+       */
+      long long Update(long long sourceUs, long long arrivalUs)
+      {
+        if (count_ > 0) {
+          const long long predicted = Map(sourceUs);
+          const long long resync = static_cast<long long>(config_.resyncThresholdMs) * 1000;
+          if (sourceUs <= lastSourceUs_ || llabs(arrivalUs - predicted) > resync) {
+            Reset();
+            ++resyncCount_;
+          }
+        }
+        Sample sample;
+        if (count_ == 0) {
+          originSourceUs_ = sourceUs;
+          originArrivalUs_ = arrivalUs;
+          baseSourceUs_ = sourceUs;
+          baseEngineUs_ = static_cast<double>(arrivalUs);
+          slope_ = 1.0;
+          sample.x = 0;
+          sample.y = 0;
+          bucketEnd_ = bucketUs_;
+          window_[0] = sample;
+          head_ = 1;
+          count_ = 1;
+        } else {
+          sample.x = static_cast<double>(sourceUs - originSourceUs_);
+          sample.y = static_cast<double>(arrivalUs - originArrivalUs_);
+          if (sample.x >= bucketEnd_) {
+            /* 进入新的分段 */
+            while (bucketEnd_ <= sample.x) {
+              bucketEnd_ += bucketUs_;
+            }
+            window_[head_] = sample;
+            head_ = (head_ + 1) % window_.size();
+            if (count_ < window_.size()) {
+              ++count_;
+            }
+          } else {
+            Sample &current = window_[(head_ + window_.size() - 1) % window_.size()];
+            if (sample.y - sample.x < current.y - current.x) {
+              current = sample;
+            }
+          }
+        }
+        lastSourceUs_ = sourceUs;
+        Fit(sourceUs);
+        return Map(sourceUs);
+      }
+
+      /**
+       * @brief 按当前映射换算源时间戳，不更新滤波器
+       */
+      long long Map(long long sourceUs) const
+      {
+        return static_cast<long long>(llround(baseEngineUs_ + slope_ * static_cast<double>(sourceUs - baseSourceUs_)));
+      }
+
+      /**
+       * @brief 清空观测样本，下一个样本重新建立映射
+       */
+      void Reset()
+      {
+        count_ = 0;
+        head_ = 0;
+      }
+
+      /**
+       * @brief 源时钟相对引擎时钟的漂移，单位：ppm
+       */
+      double DriftPpm() const { return (slope_ - 1.0) * 1e6; }
+
+      /**
+       * @brief 重新同步次数
+       */
+      unsigned long long ResyncCount() const { return resyncCount_; }
+
+    private:
+      struct Sample {
+        double x = 0;
+        double y = 0;
+      };
+
+      void Fit(long long sourceUs)
+      {
+        const size_t n = count_;
+        const size_t first = (head_ + window_.size() - n) % window_.size();
+        /* 以窗口首个样本为原点，避免长时间运行后数值精度下降 */
+        const double x0 = window_[first].x;
+        const double y0 = window_[first].y;
+        double sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (size_t i = 0; i < n; ++i) {
+          const Sample &s = window_[(first + i) % window_.size()];
+          const double x = s.x - x0;
+          const double y = s.y - y0;
+          sx += x;
+          sy += y;
+          sxx += x * x;
+          sxy += x * y;
+        }
+        const double last = static_cast<double>(sourceUs - originSourceUs_) - x0;
+        const double span = window_[(head_ + window_.size() - 1) % window_.size()].x - x0;
+        double slope = 1.0;
+        const double den = n * sxx - sx * sx;
+        if (n >= 8 && span >= config_.minRegressionSpanMs * 1000.0 && den > 0) {
+          const double maxDrift = config_.maxDriftPpm * 1e-6;
+          slope = (n * sxy - sx * sy) / den;
+          slope = slope < 1.0 - maxDrift ? 1.0 - maxDrift : (slope > 1.0 + maxDrift ? 1.0 + maxDrift : slope);
+        }
+        /* 残差下包络：到达时间只会因抖动变晚，取最小残差作为无抖动的偏移 */
+        double minResidual = 0;
+        for (size_t i = 0; i < n; ++i) {
+          const Sample &s = window_[(first + i) % window_.size()];
+          const double residual = (s.y - y0) - slope * (s.x - x0);
+          if (i == 0 || residual < minResidual) {
+            minResidual = residual;
+          }
+        }
+        const double target = static_cast<double>(originArrivalUs_) + y0 + slope * last + minResidual;
+        if (n == 1) {
+          baseEngineUs_ = target;
+        } else {
+          const double predicted = baseEngineUs_ + slope_ * static_cast<double>(sourceUs - baseSourceUs_);
+          double correction = (target - predicted) * config_.smoothing;
+          const double maxSlew = static_cast<double>(config_.maxSlewUs);
+          correction = correction < -maxSlew ? -maxSlew : (correction > maxSlew ? maxSlew : correction);
+          baseEngineUs_ = predicted + correction;
+        }
+        baseSourceUs_ = sourceUs;
+        slope_ = slope;
+      }
+
+      AliEngineAvSyncConfig config_;
+      std::vector<Sample> window_;
+      double bucketUs_;
+      double bucketEnd_ = 0;
+      size_t head_ = 0;
+      size_t count_ = 0;
+      long long originSourceUs_ = 0;
+      long long originArrivalUs_ = 0;
+      long long lastSourceUs_ = 0;
+      long long baseSourceUs_ = 0;
+      double baseEngineUs_ = 0;
+      double slope_ = 1.0;
+      unsigned long long resyncCount_ = 0;
+    };
+
+    /**
+     * @brief 音频微调重采样器
+     * @details 对交错排列的16bit PCM做线性插值重采样，比例只在 1±0.1% 范围内微调，用于吸收时钟漂移，听感上无音调变化；
+     * 跨调用保持插值相位，输出连续
+     * @note 非线程安全
+     */
+    class AliEngineAudioDriftResampler {
+    public:
+      /**
+       * @brief 重采样一段音频
+       * @param input 输入数据，bytesPerSample 必须为2
+       * @param ratio 输出采样数与输入采样数之比
+       * @param output 输出数据，指向内部缓冲，下次调用前有效
+       * @return true: 成功；false: 参数不支持
+       */
+      bool Process(const AliEngineAudioRawData &input, double ratio, AliEngineAudioRawData &output)
+      {
+        const int channels = input.numOfChannels;
+        if (!input.dataPtr || input.bytesPerSample != 2 || channels <= 0 || channels > kMaxChannels ||
+            input.numOfSamples <= 0 || ratio <= 0) {
+          return false;
+        }
+        if (channels != channels_) {
+          channels_ = channels;
+          position_ = 0;
+          memset(previous_, 0, sizeof(previous_));
+        }
+        const int16_t* in = static_cast<const int16_t*>(input.dataPtr);
+        const int n = input.numOfSamples;
+        const double step = 1.0 / ratio;
+        buffer_.resize((static_cast<size_t>(n * ratio) + 2) * channels);
+        int16_t* out = buffer_.data();
+        int produced = 0;
+        /* position_ 为相对本次输入首个采样的位置，-1 对应上一段的最后一个采样 */
+        double pos = position_;
+        while (pos < n - 1) {
+          const int i = static_cast<int>(floor(pos));
+          const float frac = static_cast<float>(pos - i);
+          for (int c = 0; c < channels; ++c) {
+            const float a = i < 0 ? previous_[c] : in[i * channels + c];
+            const float b = in[(i + 1) * channels + c];
+            out[produced * channels + c] = internal::ClampS16(static_cast<int>(lrintf(a + (b - a) * frac)));
+          }
+          ++produced;
+          pos += step;
+        }
+        position_ = pos - n;
+        for (int c = 0; c < channels; ++c) {
+          previous_[c] = in[(n - 1) * channels + c];
+        }
+        output = input;
+        output.dataPtr = out;
+        output.numOfSamples = produced;
+        return true;
+      }
+
+      /**
+       * @brief 清空插值状态
+       */
+      void Reset()
+      {
+        position_ = 0;
+        memset(previous_, 0, sizeof(previous_));
+      }
+
+    private:
+      enum { kMaxChannels = 8 };
+
+      std::vector<int16_t> buffer_;
+      double position_ = 0;
+      int channels_ = 0;
+      int16_t previous_[kMaxChannels] = {0};
+    };
+
+    /**
+     * @brief 外部音视频输入同步器
+     * @details 放在 {@link IAliEngineMediaEngine::PushExternalVideoFrame} 与
+     * {@link IAliEngineMediaEngine::PushExternalAudioStreamRawData} 之前，音频和视频时间戳分别来自不同时钟时：
+     *  - 各自经 {@link AliEngineClockRecovery} 映射到引擎时钟（steady clock），消除抖动并估计漂移
+     *  - 音频以输出采样数累计的时间线为准，按与映射时间的偏差微调重采样比例，长时间运行不累积误差
+     *  - 视频按固定帧间隔输出，源帧率因漂移偏快时丢帧、偏慢时重复上一帧，输出时间戳与映射时间偏差不超过半个帧间隔
+     * 音视频两路时间线都锁定到引擎时钟，多小时推流后唇音偏差仍保持在 ±20ms 以内，无需重置PTS
+     * @note 音频和视频接口可在不同线程调用，但同一路只能在单一线程调用
+     */
+    class AliEngineAvSynchronizer {
+    public:
+      explicit AliEngineAvSynchronizer(const AliEngineAvSyncConfig &config = AliEngineAvSyncConfig())
+        : config_(config), audioClock_(config), videoClock_(config) {}
+
+      /**
+       * @brief 处理一段外部音频
+       * @param input 输入音频，bytesPerSample 必须为2
+       * @param sourceTimestampUs 源时间戳，单位：us
+       * @param arrivalUs 到达时的引擎时钟，单位：us，可用 {@link AliEngineAvSynchronizer::NowUs}
+       * @param output 修正后的音频，指向内部缓冲，下次调用前有效
+       * @return true: 成功；false: 参数不支持
+       */
+      bool ProcessAudio(const AliEngineAudioRawData &input, long long sourceTimestampUs, long long arrivalUs,
+                        AliEngineAudioRawData &output)
+      {
+        if (input.samplesPerSec <= 0) {
+          return false;
+        }
+        const unsigned long long resyncs = audioClock_.ResyncCount();
+        const long long mapped = audioClock_.Update(sourceTimestampUs, arrivalUs);
+        if (!audioStarted_ || audioClock_.ResyncCount() != resyncs || input.samplesPerSec != audioRate_) {
+          audioStarted_ = true;
+          audioRate_ = input.samplesPerSec;
+          audioStartUs_ = mapped;
+          audioSamples_ = 0;
+          audioIntegral_ = 0;
+          resampler_.Reset();
+        }
+        const long long outputUs = audioStartUs_ + static_cast<long long>(audioSamples_ * 1000000.0 / audioRate_);
+        const long long error = mapped - outputUs;
+        /* PI控制：比例项追偏差，积分项追稳态漂移 */
+        const double maxDrift = config_.maxDriftPpm * 1e-6;
+        const double proportional = error * 1e-9 * config_.audioCorrectionGain;
+        /* 积分项每次累积比例项的2% */
+        audioIntegral_ = Clamp(audioIntegral_ + proportional * 0.02, maxDrift);
+        audioRatio_ = 1.0 + Clamp(proportional + audioIntegral_, maxDrift);
+        if (!resampler_.Process(input, audioRatio_, output)) {
+          return false;
+        }
+        audioSamples_ += output.numOfSamples;
+        std::lock_guard<std::mutex> guard(statsLock_);
+        stats_.audioDriftPpm = audioClock_.DriftPpm();
+        stats_.audioResampleRatio = audioRatio_;
+        stats_.audioErrorUs = error;
+        audioResyncs_ = audioClock_.ResyncCount();
+        return true;
+      }
+
+      /**
+       * @brief 处理一帧外部视频
+       * @param sourceTimestampUs 源时间戳，单位：us
+       * @param arrivalUs 到达时的引擎时钟，单位：us
+       * @param outputTimestampUs 输出时间戳（引擎时钟），写入 {@link AliEngineVideoRawData::timeStamp}
+       * @param repeatCount 返回 AliEngineAvSyncVideoRepeat 时需重复送出上一帧的次数，
+       * 重复帧的时间戳依次为 outputTimestampUs - repeatCount * videoFrameIntervalUs 起每次递增一个帧间隔
+       * @return 处理结果，详见 {@link AliEngineAvSyncVideoAction}
+       */
+      AliEngineAvSyncVideoAction ProcessVideo(long long sourceTimestampUs, long long arrivalUs,
+                                              long long &outputTimestampUs, int &repeatCount)
+      {
+        repeatCount = 0;
+        const unsigned long long resyncs = videoClock_.ResyncCount();
+        const long long mapped = videoClock_.Update(sourceTimestampUs, arrivalUs);
+        std::lock_guard<std::mutex> guard(statsLock_);
+        stats_.videoDriftPpm = videoClock_.DriftPpm();
+        videoResyncs_ = videoClock_.ResyncCount();
+        const long long interval = config_.videoFrameIntervalUs;
+        if (interval <= 0) {
+          outputTimestampUs = mapped;
+          stats_.videoErrorUs = 0;
+          return AliEngineAvSyncVideoSend;
+        }
+        if (!videoStarted_ || videoClock_.ResyncCount() != resyncs) {
+          videoStarted_ = true;
+          nextVideoUs_ = mapped;
+        }
+        const long long error = mapped - nextVideoUs_;
+        if (error < -interval / 2) {
+          ++stats_.droppedVideoFrames;
+          outputTimestampUs = nextVideoUs_ - interval;
+          return AliEngineAvSyncVideoDrop;
+        }
+        AliEngineAvSyncVideoAction action = AliEngineAvSyncVideoSend;
+        repeatCount = error > 0 ? static_cast<int>((error + interval / 2) / interval) : 0;
+        if (repeatCount > 0) {
+          if (repeatCount > config_.maxVideoRepeat) {
+            /* 源长时间断流，不补帧，直接跳到当前时间 */
+            nextVideoUs_ += static_cast<long long>(repeatCount) * interval;
+            repeatCount = 0;
+          } else {
+            stats_.repeatedVideoFrames += repeatCount;
+            nextVideoUs_ += static_cast<long long>(repeatCount) * interval;
+            action = AliEngineAvSyncVideoRepeat;
+          }
+        }
+        outputTimestampUs = nextVideoUs_;
+        stats_.videoErrorUs = mapped - nextVideoUs_;
+        nextVideoUs_ += interval;
+        return action;
+      }
+
+      /**
+       * @brief 获取统计信息
+       */
+      AliEngineAvSyncStats GetStats()
+      {
+        std::lock_guard<std::mutex> guard(statsLock_);
+        AliEngineAvSyncStats stats = stats_;
+        stats.resyncCount = audioResyncs_ + videoResyncs_;
+        return stats;
+      }
+
+      /**
+       * @brief 引擎时钟，单位：us
+       */
+      static long long NowUs()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+    private:
+      AliEngineAvSynchronizer(const AliEngineAvSynchronizer&);
+      AliEngineAvSynchronizer& operator=(const AliEngineAvSynchronizer&);
+
+      static double Clamp(double value, double limit)
+      {
+        return value < -limit ? -limit : (value > limit ? limit : value);
+      }
+
+      AliEngineAvSyncConfig config_;
+      AliEngineClockRecovery audioClock_;
+      AliEngineClockRecovery videoClock_;
+      AliEngineAudioDriftResampler resampler_;
+      std::mutex statsLock_;
+      AliEngineAvSyncStats stats_;
+      unsigned long long audioResyncs_ = 0;
+      unsigned long long videoResyncs_ = 0;
+      bool audioStarted_ = false;
+      int audioRate_ = 0;
+      long long audioStartUs_ = 0;
+      unsigned long long audioSamples_ = 0;
+      double audioIntegral_ = 0;
+      double audioRatio_ = 1.0;
+      bool videoStarted_ = false;
+      long long nextVideoUs_ = 0;
+    };
+}
+
+#endif /* ali_rtc_engine_av_sync_h */
@@ -0,0 +1,1900 @@
+#ifndef ali_rtc_engine_event_dispatcher_h
+#define ali_rtc_engine_event_dispatcher_h
+
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "engine_interface.h"
+#include "engine_lockfree_queue.h"
+#include "engine_stats_histogram.h"
+#include "engine_stats_snapshot.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 事件分发配置
+     */
+    typedef struct AliEngineEventDispatcherConfig {
+      /** 无锁队列容量，向上取整到2的幂，默认值：1024 */
+      int queueCapacity = 1024;
+      /** 队列满时暂存状态类事件的有序溢出列表容量，溢出列表也满时丢弃新投递的事件并计入 dropped，默认值：256 */
+      int spillCapacity = 256;
+    } AliEngineEventDispatcherConfig;
+
+    /**
+     * @brief 事件分发统计信息
+     */
+    typedef struct AliEngineEventDispatcherStats {
+      /** 当前队列深度（含溢出列表） */
+      int queueDepth = 0;
+      /** 最大队列深度 */
+      int maxQueueDepth = 0;
+      /** 引擎线程投递的回调次数 */
+      unsigned long long posted = 0;
+      /** 已送达监听者的回调次数 */
+      unsigned long long delivered = 0;
+      /** 被更新的值覆盖、未单独送达的统计类回调次数 */
+      unsigned long long coalesced = 0;
+      /** 队列满时进入溢出列表的次数 */
+      unsigned long long spilled = 0;
+      /** 队列与溢出列表都已满、被丢弃的回调次数 */
+      unsigned long long dropped = 0;
+    } AliEngineEventDispatcherStats;
+
+    /**
+     * @brief 单个回调的分发统计
+     */
+    typedef struct AliEngineEventCallbackStats {
+      /** 回调名称，如 "OnStats" */
+      const char* name = nullptr;
+      /** 送达次数 */
+      unsigned long long delivered = 0;
+      /** 被合并的次数 */
+      unsigned long long coalesced = 0;
+      /** 从投递到开始回调的平滑时延，单位：us */
+      int avgLatencyUs = 0;
+      /** 从投递到开始回调的最大时延，单位：us */
+      int maxLatencyUs = 0;
+      /** 监听者处理的最大耗时，单位：us */
+      int maxHandleUs = 0;
+    } AliEngineEventCallbackStats;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 非阻塞事件分发
+     * @details 代替业务监听者注册到 {@link AliEngine::SetEngineEventListener}，引擎线程上的回调只拷贝参数并投递，
+     * 由独立的分发线程调用业务监听者，慢速监听者不会阻塞引擎的媒体线程：
+     *  - 事件是按回调编号区分的定长 POD 记录，从构造时预分配的事件池取用：整数、枚举与统计结构体按值保存，
+     *    字符串与数据块拷贝到记录内嵌的缓冲，只有超出内嵌缓冲的数据（截图、长消息等）才另行分配
+     *  - 状态类回调（入会、上下线、发布订阅状态、连接状态、错误等）经有界无锁队列按序送达；队列满时进入容量固定的
+     *    有序溢出列表，同一引擎线程投递的回调保持先后顺序；溢出列表也满时丢弃新投递的回调并计入 dropped，
+     *    引擎线程既不阻塞也不无限占用内存，请按监听者的处理能力设置队列与溢出列表容量
+     *  - 高频统计类回调（OnStats、OnLocal/RemoteVideoStats、OnLocal/RemoteAudioStats、OnAudioVolumeCallback、
+     *    OnNetworkQualityChanged、OnActiveSpeaker、OnAudioDeviceRecord/PlayoutLevel）按 (回调, uid, track) 只保留最新值，
+     *    未送达前的新值覆盖旧值，队列中只占一个位置。合并槽位预先分配，入队的是槽位内嵌的令牌，不占用事件池；
+     *    送达只获取单个槽位的锁，不与其他槽位的投递竞争；远端用户下线时回收其槽位供后续用户复用
+     *  - 导出队列深度以及每个回调的送达时延和处理耗时
+     * 回调参数中的字符串、统计结构体、消息和截图数据均会拷贝，监听者收到的指针在回调返回前有效
+     * @note 监听者需在分发器销毁前保持有效；析构时送达剩余事件后退出分发线程
+     */
+    class AliEngineEventDispatcher : public AliEngineEventListener {
+    public:
+      /**
+       * @param listener 业务监听者，在分发线程回调
+       * @param config 分发配置
+       */
+      explicit AliEngineEventDispatcher(AliEngineEventListener* listener,
+                                        const AliEngineEventDispatcherConfig &config = AliEngineEventDispatcherConfig())
+        : target_(listener), queue_(config.queueCapacity > 0 ? config.queueCapacity : 1024),
+          freeEvents_(queue_.Capacity() + (config.spillCapacity > 0 ? config.spillCapacity : 0))
+      {
+        running_.store(true, std::memory_order_relaxed);
+        sleeping_.store(false, std::memory_order_relaxed);
+        spilled_.store(false, std::memory_order_relaxed);
+        snapshot_.store(nullptr, std::memory_order_relaxed);
+        histogram_.store(nullptr, std::memory_order_relaxed);
+        depth_.store(0, std::memory_order_relaxed);
+        maxDepth_.store(0, std::memory_order_relaxed);
+        posted_.store(0, std::memory_order_relaxed);
+        delivered_.store(0, std::memory_order_relaxed);
+        coalesced_.store(0, std::memory_order_relaxed);
+        spilledCount_.store(0, std::memory_order_relaxed);
+        dropped_.store(0, std::memory_order_relaxed);
+        /* 队列与溢出列表同时装满时在途的事件数，事件池取空即等价于两者都满 */
+        const size_t spillCapacity = config.spillCapacity > 0 ? static_cast<size_t>(config.spillCapacity) : 0;
+        events_.resize(queue_.Capacity() + spillCapacity);
+        for (size_t i = 0; i < events_.size(); ++i) {
+          freeEvents_.TryPush(&events_[i]);
+        }
+        /* 合并令牌不占用事件池，溢出列表也会暂存令牌，按预分配槽位数留出余量 */
+        spill_.resize(spillCapacity + kPresizedSlots);
+        draining_.reserve(spill_.size());
+        spillHead_ = 0;
+        spillSize_ = 0;
+        slotIndex_.reserve(kPresizedSlots);
+        for (int i = 0; i < kPresizedSlots; ++i) {
+          slots_.emplace_back();
+          freeSlots_.push_back(&slots_.back());
+        }
+        thread_ = std::thread(&AliEngineEventDispatcher::DeliveryLoop, this);
+      }
+
+      ~AliEngineEventDispatcher()
+      {
+        {
+          std::lock_guard<std::mutex> guard(wakeLock_);
+          running_.store(false, std::memory_order_relaxed);
+        }
+        wake_.notify_all();
+        thread_.join();
+        /* 令牌被丢弃的槽位可能仍保留未送达的值 */
+        for (std::deque<Slot>::iterator it = slots_.begin(); it != slots_.end(); ++it) {
+          it->latest.Release();
+        }
+      }
+
+      /**
+       * @brief 设置统计快照
+       * @details 统计类回调在引擎线程上先写入快照再合并投递，监控模块拉取的值不受监听者处理速度影响；
+       * 远端用户下线时同步标记离线
+       * @param snapshot 统计快照，传nullptr取消
+       */
+      void SetStatsSnapshot(AliEngineStatsSnapshot* snapshot)
+      {
+        snapshot_.store(snapshot, std::memory_order_release);
+      }
+
+      /**
+       * @brief 设置分位数直方图
+       * @details 在引擎线程上记录 lastmileDelay、探测rtt、远端 jitterBufferDelay/networkTransportDelay 与视频卡顿时长，
+       * 合并投递不会丢失样本；远端用户下线时同步标记
+       * @param histogram 分位数直方图，传nullptr取消
+       */
+      void SetStatsHistogram(AliEngineStatsHistogram* histogram)
+      {
+        histogram_.store(histogram, std::memory_order_release);
+      }
+
+      /**
+       * @brief 获取分发统计信息
+       */
+      AliEngineEventDispatcherStats GetStats()
+      {
+        AliEngineEventDispatcherStats stats;
+        stats.queueDepth = depth_.load(std::memory_order_relaxed);
+        stats.maxQueueDepth = maxDepth_.load(std::memory_order_relaxed);
+        stats.posted = posted_.load(std::memory_order_relaxed);
+        stats.delivered = delivered_.load(std::memory_order_relaxed);
+        stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+        stats.spilled = spilledCount_.load(std::memory_order_relaxed);
+        stats.dropped = dropped_.load(std::memory_order_relaxed);
+        return stats;
+      }
+
+      /**
+       * @brief 获取各回调的分发统计，按首次送达顺序排列
+       */
+      std::vector<AliEngineEventCallbackStats> GetCallbackStats()
+      {
+        std::lock_guard<std::mutex> guard(statsLock_);
+        return callbacks_;
+      }
+
+      void OnJoinChannelResult(int result, const char *channel, int elapsed) override
+      {
+        if (Event* event = Acquire(kEventJoinChannelResult, "OnJoinChannelResult")) {
+          event->ints[0] = result;
+          event->ints[1] = elapsed;
+          event->SetText(0, channel);
+          Post(event);
+        }
+      }
+
+      void OnJoinChannelResult(int result, const char *channel, const char *userId, int elapsed) override
+      {
+        if (Event* event = Acquire(kEventJoinChannelResultWithUser, "OnJoinChannelResult")) {
+          event->ints[0] = result;
+          event->ints[1] = elapsed;
+          event->SetText(0, channel);
+          event->SetText(1, userId);
+          Post(event);
+        }
+      }
+
+      void OnLeaveChannelResult(int result, AliEngineStats stats) override
+      {
+        if (Event* event = Acquire(kEventLeaveChannelResult, "OnLeaveChannelResult")) {
+          event->ints[0] = result;
+          event->SetArgs(stats);
+          Post(event);
+        }
+      }
+
+      void OnRemoteUserOnLineNotify(const char *uid, int elapsed) override
+      {
+        if (Event* event = Acquire(kEventRemoteUserOnLineNotify, "OnRemoteUserOnLineNotify")) {
+          event->ints[0] = elapsed;
+          event->SetText(0, uid);
+          Post(event);
+        }
+      }
+
+      void OnRemoteUserOffLineNotify(const char *uid, AliEngineUserOfflineReason reason) override
+      {
+        if (AliEngineStatsSnapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+          snapshot->RemoveUser(uid);
+        }
+        if (AliEngineStatsHistogram* histogram = histogram_.load(std::memory_order_acquire)) {
+          histogram->RemoveUser(uid);
+        }
+        ReleaseSlots(uid);
+        if (Event* event = Acquire(kEventRemoteUserOffLineNotify, "OnRemoteUserOffLineNotify")) {
+          event->ints[0] = reason;
+          event->SetText(0, uid);
+          Post(event);
+        }
+      }
+
+      void OnAudioPublishStateChanged(AliEnginePublishState oldState, AliEnginePublishState newState,
+                                      int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventAudioPublishStateChanged, "OnAudioPublishStateChanged", nullptr, 0,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+      void OnAudioPublishStateChanged(AliEngineAudioTrack audioTrack, AliEnginePublishState oldState, AliEnginePublishState newState,
+                                      int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventAudioPublishStateChangedWithTrack, "OnAudioPublishStateChanged", nullptr, audioTrack,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+      void OnVideoPublishStateChanged(AliEnginePublishState oldState, AliEnginePublishState newState,
+                                      int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventVideoPublishStateChanged, "OnVideoPublishStateChanged", nullptr, 0,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+      void OnDualStreamPublishStateChanged(AliEnginePublishState oldState, AliEnginePublishState newState,
+                                           int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventDualStreamPublishStateChanged, "OnDualStreamPublishStateChanged", nullptr, 0,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+      void OnScreenSharePublishStateChanged(AliEnginePublishState oldState, AliEnginePublishState newState,
+                                            int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventScreenSharePublishStateChanged, "OnScreenSharePublishStateChanged", nullptr, 0,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+#if (defined(__APPLE__) && TARGET_OS_MAC && !TARGET_OS_IPHONE) || defined(_WIN32)
+      void OnScreenSharePublishStateChangedWithInfo(AliEnginePublishState oldState, AliEnginePublishState newState,
+                                                    int elapseSinceLastState, const char *channel,
+                                                    AliEngineScreenShareInfo& screenShareInfo) override
+      {
+        if (Event* event = Acquire(kEventScreenSharePublishStateChangedWithInfo, "OnScreenSharePublishStateChangedWithInfo")) {
+          event->ints[0] = oldState;
+          event->ints[1] = newState;
+          event->ints[2] = elapseSinceLastState;
+          event->SetText(0, channel);
+          event->SetArgs(screenShareInfo);
+          Post(event);
+        }
+      }
+#endif
+
+      void OnPublishStreamByRtsUrlResult(const char* rts_url, int result) override
+      {
+        PostTextInt(kEventPublishStreamByRtsUrlResult, "OnPublishStreamByRtsUrlResult", rts_url, result);
+      }
+
+      void OnStopPublishStreamByRtsUrlResult(const char* rts_url, int result) override
+      {
+        PostTextInt(kEventStopPublishStreamByRtsUrlResult, "OnStopPublishStreamByRtsUrlResult", rts_url, result);
+      }
+
+      void OnSubscribeStreamByRtsUrlResult(const char* uid, int result) override
+      {
+        PostTextInt(kEventSubscribeStreamByRtsUrlResult, "OnSubscribeStreamByRtsUrlResult", uid, result);
+      }
+
+      void OnStopSubscribeStreamByRtsUrlResult(const char* uid, int result) override
+      {
+        PostTextInt(kEventStopSubscribeStreamByRtsUrlResult, "OnStopSubscribeStreamByRtsUrlResult", uid, result);
+      }
+
+      void OnSubscribedRtsStreamBeyondLimit(const char* uid, const char* url) override
+      {
+        if (Event* event = Acquire(kEventSubscribedRtsStreamBeyondLimit, "OnSubscribedRtsStreamBeyondLimit")) {
+          event->SetText(0, uid);
+          event->SetText(1, url);
+          Post(event);
+        }
+      }
+
+      void OnPauseRtsStreamResult(const char* uid, int result) override
+      {
+        PostTextInt(kEventPauseRtsStreamResult, "OnPauseRtsStreamResult", uid, result);
+      }
+
+      void OnResumeRtsStreamResult(const char* uid, int result) override
+      {
+        PostTextInt(kEventResumeRtsStreamResult, "OnResumeRtsStreamResult", uid, result);
+      }
+
+      void OnRemoteTrackAvailableNotify(const char *uid, AliEngineAudioTrack audioTrack, AliEngineVideoTrack videoTrack) override
+      {
+        if (Event* event = Acquire(kEventRemoteTrackAvailableNotify, "OnRemoteTrackAvailableNotify")) {
+          event->ints[0] = audioTrack;
+          event->ints[1] = videoTrack;
+          event->SetText(0, uid);
+          Post(event);
+        }
+      }
+
+      void OnAudioSubscribeStateChanged(const char *uid, AliEngineSubscribeState oldState, AliEngineSubscribeState newState,
+                                        int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventAudioSubscribeStateChanged, "OnAudioSubscribeStateChanged", uid, 0,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+      void OnAudioSubscribeStateChanged(const char *uid, AliEngineAudioTrack audioTrack, AliEngineSubscribeState oldState,
+                                        AliEngineSubscribeState newState, int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventAudioSubscribeStateChangedWithTrack, "OnAudioSubscribeStateChanged", uid, audioTrack,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+      void OnVideoSubscribeStateChanged(const char *uid, AliEngineSubscribeState oldState, AliEngineSubscribeState newState,
+                                        int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventVideoSubscribeStateChanged, "OnVideoSubscribeStateChanged", uid, 0,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+      void OnScreenShareSubscribeStateChanged(const char *uid, AliEngineSubscribeState oldState, AliEngineSubscribeState newState,
+                                              int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventScreenShareSubscribeStateChanged, "OnScreenShareSubscribeStateChanged", uid, 0,
+                         oldState, newState, elapseSinceLastState, channel);
+      }
+
+      void OnSubscribeStreamTypeChanged(const char *uid, AliEngineVideoStreamType oldStreamType, AliEngineVideoStreamType newStreamType,
+                                        int elapseSinceLastState, const char *channel) override
+      {
+        PostStateChanged(kEventSubscribeStreamTypeChanged, "OnSubscribeStreamTypeChanged", uid, 0,
+                         oldStreamType, newStreamType, elapseSinceLastState, channel);
+      }
+
+      void OnNetworkQualityChanged(const char *uid, AliEngineNetworkQuality upQuality, AliEngineNetworkQuality downQuality) override
+      {
+        Event event;
+        event.Reset(kEventNetworkQualityChanged, "OnNetworkQualityChanged");
+        event.ints[0] = upQuality;
+        event.ints[1] = downQuality;
+        event.SetText(0, uid);
+        Coalesce(event, uid, 0);
+      }
+
+      void OnPublishStaticVideoFrame(AliEngineVideoTrack trackType, bool isStaticFrame) override
+      {
+        PostInts(kEventPublishStaticVideoFrame, "OnPublishStaticVideoFrame", trackType, isStaticFrame);
+      }
+
+      void OnBye(int code) override
+      {
+        PostInts(kEventBye, "OnBye", code);
+      }
+
+      void OnOccurWarning(int warn, const char *msg) override
+      {
+        PostTextInt(kEventOccurWarning, "OnOccurWarning", msg, warn);
+      }
+
+      void OnOccurError(int error, const char *msg) override
+      {
+        PostTextInt(kEventOccurError, "OnOccurError", msg, error);
+      }
+
+      void OnPerformanceLow() override
+      {
+        PostInts(kEventPerformanceLow, "OnPerformanceLow");
+      }
+
+      void OnPerformanceRecovery() override
+      {
+        PostInts(kEventPerformanceRecovery, "OnPerformanceRecovery");
+      }
+
+      void OnFirstRemoteVideoFrameDrawn(const char *uid, AliEngineVideoTrack videoTrack, int width, int height, int elapsed) override
+      {
+        PostTextInts(kEventFirstRemoteVideoFrameDrawn, "OnFirstRemoteVideoFrameDrawn", uid, videoTrack, width, height, elapsed);
+      }
+
+      void OnFirstLocalVideoFrameDrawn(int width, int height, int elapsed) override
+      {
+        PostInts(kEventFirstLocalVideoFrameDrawn, "OnFirstLocalVideoFrameDrawn", width, height, elapsed);
+      }
+
+      void OnFirstAudioPacketSend(int timeCost) override
+      {
+        PostInts(kEventFirstAudioPacketSend, "OnFirstAudioPacketSend", timeCost);
+      }
+
+      void OnFirstAudioPacketSend(AliEngineAudioTrack audioTrack, int timeCost) override
+      {
+        PostInts(kEventFirstAudioPacketSendWithTrack, "OnFirstAudioPacketSend", audioTrack, timeCost);
+      }
+
+      void OnFirstAudioPacketReceived(const char* uid, int timeCost) override
+      {
+        PostTextInts(kEventFirstAudioPacketReceived, "OnFirstAudioPacketReceived", uid, timeCost);
+      }
+
+      void OnFirstAudioPacketReceived(const char* uid, AliEngineAudioTrack audioTrack, int timeCost) override
+      {
+        PostTextInts(kEventFirstAudioPacketReceivedWithTrack, "OnFirstAudioPacketReceived", uid, audioTrack, timeCost);
+      }
+
+      void OnFirstRemoteAudioDecoded(const char* uid, int elapsed) override
+      {
+        PostTextInts(kEventFirstRemoteAudioDecoded, "OnFirstRemoteAudioDecoded", uid, elapsed);
+      }
+
+      void OnFirstRemoteAudioDecoded(const char* uid, AliEngineAudioTrack audioTrack, int elapsed) override
+      {
+        PostTextInts(kEventFirstRemoteAudioDecodedWithTrack, "OnFirstRemoteAudioDecoded", uid, audioTrack, elapsed);
+      }
+
+      void OnFirstVideoPacketSend(AliEngineVideoTrack videoTrack, int timeCost) override
+      {
+        PostInts(kEventFirstVideoPacketSend, "OnFirstVideoPacketSend", videoTrack, timeCost);
+      }
+
+      void OnFirstVideoPacketReceived(const char* uid, AliEngineVideoTrack videoTrack, int timeCost) override
+      {
+        PostTextInts(kEventFirstVideoPacketReceived, "OnFirstVideoPacketReceived", uid, videoTrack, timeCost);
+      }
+
+      void OnFirstVideoFrameReceived(const char* uid, AliEngineVideoTrack videoTrack, int timeCost) override
+      {
+        PostTextInts(kEventFirstVideoFrameReceived, "OnFirstVideoFrameReceived", uid, videoTrack, timeCost);
+      }
+
+      void OnConnectionLost() override
+      {
+        PostInts(kEventConnectionLost, "OnConnectionLost");
+      }
+
+      void OnTryToReconnect() override
+      {
+        PostInts(kEventTryToReconnect, "OnTryToReconnect");
+      }
+
+      void OnConnectionRecovery() override
+      {
+        PostInts(kEventConnectionRecovery, "OnConnectionRecovery");
+      }
+
+      void OnConnectionStatusChange(int status, int reason) override
+      {
+        PostInts(kEventConnectionStatusChange, "OnConnectionStatusChange", status, reason);
+      }
+
+      void OnUserAudioMuted(const char* uid, bool isMute) override
+      {
+        PostTextInts(kEventUserAudioMuted, "OnUserAudioMuted", uid, isMute);
+      }
+
+      void OnUserVideoMuted(const char* uid, bool isMute) override
+      {
+        PostTextInts(kEventUserVideoMuted, "OnUserVideoMuted", uid, isMute);
+      }
+
+      void OnUserVideoEnabled(const char* uid, bool isEnable) override
+      {
+        PostTextInts(kEventUserVideoEnabled, "OnUserVideoEnabled", uid, isEnable);
+      }
+
+      void OnUserAudioInterruptedBegin(const char* uid) override
+      {
+        PostTextInts(kEventUserAudioInterruptedBegin, "OnUserAudioInterruptedBegin", uid);
+      }
+
+      void OnUserAudioInterruptedEnded(const char* uid) override
+      {
+        PostTextInts(kEventUserAudioInterruptedEnded, "OnUserAudioInterruptedEnded", uid);
+      }
+
+      void OnRemoteAudioAccompanyStarted(const char* uid) override
+      {
+        PostTextInts(kEventRemoteAudioAccompanyStarted, "OnRemoteAudioAccompanyStarted", uid);
+      }
+
+      void OnRemoteAudioAccompanyFinished(const char* uid) override
+      {
+        PostTextInts(kEventRemoteAudioAccompanyFinished, "OnRemoteAudioAccompanyFinished", uid);
+      }
+
+      void OnUserWillResignActive(const char* uid) override
+      {
+        PostTextInts(kEventUserWillResignActive, "OnUserWillResignActive", uid);
+      }
+
+      void OnUserWillBecomeActive(const char* uid) override
+      {
+        PostTextInts(kEventUserWillBecomeActive, "OnUserWillBecomeActive", uid);
+      }
+
+      void OnUpdateRoleNotify(const AliEngineClientRole oldRole, const AliEngineClientRole newRole) override
+      {
+        PostInts(kEventUpdateRoleNotify, "OnUpdateRoleNotify", oldRole, newRole);
+      }
+
+      void OnAudioVolumeCallback(const AliEngineUserVolumeInfo* volumeInfo, int volumeInfoCount, int totalVolume) override
+      {
+        Event event;
+        event.Reset(kEventAudioVolumeCallback, "OnAudioVolumeCallback");
+        event.ints[1] = totalVolume;
+        /* 逐个写入 VolumeEntry 及其后的 uid，内嵌缓冲写满时才另行分配 */
+        const int count = volumeInfo && volumeInfoCount > 0 ? volumeInfoCount : 0;
+        int written = 0;
+        event.blob = static_cast<int>(event.used);
+        for (; written < count; ++written) {
+          const char* uid = volumeInfo[written].uid.c_str();
+          VolumeEntry entry;
+          entry.speechState = volumeInfo[written].speechState ? 1 : 0;
+          entry.volume = volumeInfo[written].volume;
+          entry.sumVolume = volumeInfo[written].sumVolume;
+          entry.uidBytes = static_cast<int>(strlen(uid) + 1);
+          if (event.Append(&entry, sizeof(entry)) < 0 || event.Append(uid, entry.uidBytes) < 0) {
+            break;
+          }
+        }
+        event.ints[0] = written;
+        Coalesce(event, nullptr, 0);
+      }
+
+      void OnActiveSpeaker(const char *uid) override
+      {
+        Event event;
+        event.Reset(kEventActiveSpeaker, "OnActiveSpeaker");
+        event.SetText(0, uid);
+        Coalesce(event, nullptr, 0);
+      }
+
+      void OnAudioAccompanyStateChanged(AliEngineAudioAccompanyStateCode playState, AliEngineAudioAccompanyErrorCode errorCode) override
+      {
+        PostInts(kEventAudioAccompanyStateChanged, "OnAudioAccompanyStateChanged", playState, errorCode);
+      }
+
+      void OnAudioFileInfo(AliEngineAudioFileInfo info, AliEngineAudioAccompanyErrorCode errorCode) override
+      {
+        if (Event* event = Acquire(kEventAudioFileInfo, "OnAudioFileInfo")) {
+          event->ints[0] = errorCode;
+          event->SetText(0, info.filePath);
+          event->SetArgs(info);
+          Post(event);
+        }
+      }
+
+      void OnAudioEffectFinished(int soundId) override
+      {
+        PostInts(kEventAudioEffectFinished, "OnAudioEffectFinished", soundId);
+      }
+
+      void OnLastmileDetectResultWithQuality(AliEngineNetworkQuality networkQuality) override
+      {
+        PostInts(kEventLastmileDetectResultWithQuality, "OnLastmileDetectResultWithQuality", networkQuality);
+      }
+
+      void OnLastmileDetectResultWithBandWidth(int code, AliRTCSdk::AliEngineNetworkProbeResult networkQuality) override
+      {
+        AliEngineStatsHistogram* histogram = histogram_.load(std::memory_order_acquire);
+        if (histogram && code == 0) {
+          histogram->Update(networkQuality);
+        }
+        if (Event* event = Acquire(kEventLastmileDetectResultWithBandWidth, "OnLastmileDetectResultWithBandWidth")) {
+          event->ints[0] = code;
+          event->SetArgs(networkQuality);
+          Post(event);
+        }
+      }
+
+      void OnAudioDeviceRecordLevel(int level) override
+      {
+        Event event;
+        event.Reset(kEventAudioDeviceRecordLevel, "OnAudioDeviceRecordLevel");
+        event.ints[0] = level;
+        Coalesce(event, nullptr, 0);
+      }
+
+      void OnAudioDevicePlayoutLevel(int level) override
+      {
+        Event event;
+        event.Reset(kEventAudioDevicePlayoutLevel, "OnAudioDevicePlayoutLevel");
+        event.ints[0] = level;
+        Coalesce(event, nullptr, 0);
+      }
+
+      void OnAudioDevicePlayoutEnd() override
+      {
+        PostInts(kEventAudioDevicePlayoutEnd, "OnAudioDevicePlayoutEnd");
+      }
+
+      void OnMediaRecordEvent(int event, const char* filePath) override
+      {
+        PostTextInt(kEventMediaRecordEvent, "OnMediaRecordEvent", filePath, event);
+      }
+
+      void OnStats(const AliEngineStats& stats) override
+      {
+        if (AliEngineStatsSnapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+          snapshot->Update(stats);
+        }
+        if (AliEngineStatsHistogram* histogram = histogram_.load(std::memory_order_acquire)) {
+          histogram->Update(stats);
+        }
+        Event event;
+        event.Reset(kEventStats, "OnStats");
+        event.SetArgs(stats);
+        Coalesce(event, nullptr, 0);
+      }
+
+      void OnLocalVideoStats(const AliEngineLocalVideoStats& localVideoStats) override
+      {
+        if (AliEngineStatsSnapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+          snapshot->Update(localVideoStats);
+        }
+        Event event;
+        event.Reset(kEventLocalVideoStats, "OnLocalVideoStats");
+        event.SetArgs(localVideoStats);
+        Coalesce(event, nullptr, localVideoStats.track);
+      }
+
+      void OnRemoteVideoStats(const AliEngineRemoteVideoStats& remoteVideoStats) override
+      {
+        if (AliEngineStatsSnapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+          snapshot->Update(remoteVideoStats);
+        }
+        if (AliEngineStatsHistogram* histogram = histogram_.load(std::memory_order_acquire)) {
+          histogram->Update(remoteVideoStats);
+        }
+        Event event;
+        event.Reset(kEventRemoteVideoStats, "OnRemoteVideoStats");
+        event.SetText(0, remoteVideoStats.userId);
+        event.SetArgs(remoteVideoStats);
+        Coalesce(event, remoteVideoStats.userId, remoteVideoStats.track);
+      }
+
+      void OnLocalAudioStats(const AliEngineLocalAudioStats& localAudioStats) override
+      {
+        if (AliEngineStatsSnapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+          snapshot->Update(localAudioStats);
+        }
+        Event event;
+        event.Reset(kEventLocalAudioStats, "OnLocalAudioStats");
+        event.SetArgs(localAudioStats);
+        Coalesce(event, nullptr, localAudioStats.track);
+      }
+
+      void OnRemoteAudioStats(const AliEngineRemoteAudioStats& remoteAudioStats) override
+      {
+        if (AliEngineStatsSnapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+          snapshot->Update(remoteAudioStats);
+        }
+        if (AliEngineStatsHistogram* histogram = histogram_.load(std::memory_order_acquire)) {
+          histogram->Update(remoteAudioStats);
+        }
+        Event event;
+        event.Reset(kEventRemoteAudioStats, "OnRemoteAudioStats");
+        event.SetText(0, remoteAudioStats.userId);
+        event.SetArgs(remoteAudioStats);
+        Coalesce(event, remoteAudioStats.userId, remoteAudioStats.track);
+      }
+
+      void OnStartLiveStreamingResult(int result) override
+      {
+        PostInts(kEventStartLiveStreamingResult, "OnStartLiveStreamingResult", result);
+      }
+
+      void OnMediaExtensionMsgReceived(const char* uid, const uint8_t payloadType, const int8_t * message, uint32_t size) override
+      {
+        if (Event* event = Acquire(kEventMediaExtensionMsgReceived, "OnMediaExtensionMsgReceived")) {
+          event->ints[0] = payloadType;
+          event->SetText(0, uid);
+          event->SetBlob(message, size);
+          Post(event);
+        }
+      }
+
+      void OnAudioDeviceStateChanged(const AliEngineDeviceInfo& deviceInfo, AliEngineExternalDeviceType deviceType,
+                                     AliEngineExternalDeviceState deviceState) override
+      {
+        PostDeviceStateChanged(kEventAudioDeviceStateChanged, "OnAudioDeviceStateChanged", deviceInfo, deviceType, deviceState);
+      }
+
+      void OnAudioFocusChanged(AliEngineAudioFocusType audioFocus) override
+      {
+        PostInts(kEventAudioFocusChanged, "OnAudioFocusChanged", audioFocus);
+      }
+
+      void OnVideoDeviceStateChanged(const AliEngineDeviceInfo& deviceInfo, AliEngineExternalDeviceType deviceType,
+                                     AliEngineExternalDeviceState deviceState) override
+      {
+        PostDeviceStateChanged(kEventVideoDeviceStateChanged, "OnVideoDeviceStateChanged", deviceInfo, deviceType, deviceState);
+      }
+
+      void OnDownlinkMessageNotify(const AliEngineMessage &messageInfo) override
+      {
+        if (Event* event = Acquire(kEventDownlinkMessageNotify, "OnDownlinkMessageNotify")) {
+          event->SetText(0, messageInfo.tID.c_str());
+          event->SetText(1, messageInfo.contentType.c_str());
+          event->SetText(2, messageInfo.content.c_str());
+          Post(event);
+        }
+      }
+
+      void OnUplinkMessageResponse(const AliEngineMessageResponse &resultInfo) override
+      {
+        if (Event* event = Acquire(kEventUplinkMessageResponse, "OnUplinkMessageResponse")) {
+          event->ints[0] = resultInfo.result;
+          event->SetText(0, resultInfo.contentType.c_str());
+          event->SetText(1, resultInfo.content.c_str());
+          Post(event);
+        }
+      }
+
+#if (defined(__APPLE__) && TARGET_OS_IOS)
+      void OnAudioRouteChanged(const AliEngineAudioRouteType routing) override
+      {
+        PostInts(kEventAudioRouteChanged, "OnAudioRouteChanged", routing);
+      }
+#endif
+
+      void OnVideoResolutionChanged(const char* uid, AliEngineVideoTrack track, int width, int height) override
+      {
+        PostTextInts(kEventVideoResolutionChanged, "OnVideoResolutionChanged", uid, track, width, height);
+      }
+
+      void OnSnapshotComplete(const char* userId, AliEngineVideoTrack videoTrack, void* buffer, int width, int height, bool success) override
+      {
+        if (Event* event = Acquire(kEventSnapshotComplete, "OnSnapshotComplete")) {
+          event->ints[0] = videoTrack;
+          event->ints[1] = width;
+          event->ints[2] = height;
+          event->ints[3] = success;
+          event->SetText(0, userId);
+          event->SetBlob(buffer, buffer && width > 0 && height > 0 ? static_cast<size_t>(width) * height * 4 : 0);
+          Post(event);
+        }
+      }
+
+      void OnPublishLiveStreamStateChanged(const char* streamUrl, AliEngineLiveTranscodingState state,
+                                           AliEngineLiveTranscodingErrorCode errCode) override
+      {
+        PostTextInts(kEventPublishLiveStreamStateChanged, "OnPublishLiveStreamStateChanged", streamUrl, state, errCode);
+      }
+
+      void OnPublishLiveStreamStateChangedWithTaskId(const char* taskId, AliEngineLiveTranscodingState state,
+                                                     AliEngineLiveTranscodingErrorCode errCode) override
+      {
+        PostTextInts(kEventPublishLiveStreamStateChangedWithTaskId, "OnPublishLiveStreamStateChangedWithTaskId", taskId, state, errCode);
+      }
+
+      void OnPublishTaskStateChanged(const char* streamUrl, AliEngineTrascodingPublishTaskStatus state) override
+      {
+        PostTextInts(kEventPublishTaskStateChanged, "OnPublishTaskStateChanged", streamUrl, state);
+      }
+
+      void OnPublishTaskStateChangedWithTaskId(const char* taskId, AliEngineTrascodingPublishTaskStatus state) override
+      {
+        PostTextInts(kEventPublishTaskStateChangedWithTaskId, "OnPublishTaskStateChangedWithTaskId", taskId, state);
+      }
+
+      void OnChannelRelayStateChanged(int state, int code, const char* msg) override
+      {
+        PostTextInts(kEventChannelRelayStateChanged, "OnChannelRelayStateChanged", msg, state, code);
+      }
+
+      void OnChannelRelayEvent(int state) override
+      {
+        PostInts(kEventChannelRelayEvent, "OnChannelRelayEvent", state);
+      }
+
+      void OnRemoteVideoChanged(const char* uid, AliEngineVideoTrack trackType, const AliEngineVideoState state,
+                                const AliEngineVideoReason reason) override
+      {
+        PostTextInts(kEventRemoteVideoChanged, "OnRemoteVideoChanged", uid, trackType, state, reason);
+      }
+
+      void OnAuthInfoWillExpire() override
+      {
+        PostInts(kEventAuthInfoWillExpire, "OnAuthInfoWillExpire");
+      }
+
+      void OnAuthInfoExpired() override
+      {
+        PostInts(kEventAuthInfoExpired, "OnAuthInfoExpired");
+      }
+
+      void OnRequestVideoExternalEncoderParameter(AliEngineVideoTrack trackType, const AliEngineVideoExternalEncoderParameter& paramter) override
+      {
+        if (Event* event = Acquire(kEventRequestVideoExternalEncoderParameter, "OnRequestVideoExternalEncoderParameter")) {
+          event->ints[0] = trackType;
+          event->SetArgs(paramter);
+          Post(event);
+        }
+      }
+
+      void OnRequestVideoExternalEncoderFrame(AliEngineVideoTrack trackType, AliEngineVideoEncodedFrameType frame_type) override
+      {
+        PostInts(kEventRequestVideoExternalEncoderFrame, "OnRequestVideoExternalEncoderFrame", trackType, frame_type);
+      }
+
+      void OnCalledApiExecuted(int error, const char *api, const char *result) override
+      {
+        if (Event* event = Acquire(kEventCalledApiExecuted, "OnCalledApiExecuted")) {
+          event->ints[0] = error;
+          event->SetText(0, api);
+          event->SetText(1, result);
+          Post(event);
+        }
+      }
+
+      void OnVideoEncoderNotify(const AliEngineEncoderNotifyInfo& encoderNotifyInfo) override
+      {
+        if (Event* event = Acquire(kEventVideoEncoderNotify, "OnVideoEncoderNotify")) {
+          event->SetArgs(encoderNotifyInfo);
+          Post(event);
+        }
+      }
+
+      void OnVideoDecoderNotify(const AliEngineDecoderNotifyInfo& decoderNotifyInfo) override
+      {
+        if (Event* event = Acquire(kEventVideoDecoderNotify, "OnVideoDecoderNotify")) {
+          event->SetText(0, decoderNotifyInfo.uid);
+          event->SetArgs(decoderNotifyInfo);
+          Post(event);
+        }
+      }
+
+      void OnLocalDeviceException(AliEngineLocalDeviceType deviceType, AliEngineLocalDeviceExceptionType exceptionType, const char* msg) override
+      {
+        PostTextInts(kEventLocalDeviceException, "OnLocalDeviceException", msg, deviceType, exceptionType);
+      }
+
+      void OnLocalAudioStateChange(AliEngineLocalAudioStateType state, const char* msg) override
+      {
+        PostTextInts(kEventLocalAudioStateChange, "OnLocalAudioStateChange", msg, state);
+      }
+
+      void onLocalVideoStateChanged(AliEngineLocalVideoStateType state, const char* msg) override
+      {
+        PostTextInts(kEventLocalVideoStateChanged, "onLocalVideoStateChanged", msg, state);
+      }
+
+      void OnDataChannelMessage(const char* uid, const AliEngineDataChannelMsg& msg) override
+      {
+        if (Event* event = Acquire(kEventDataChannelMessage, "OnDataChannelMessage")) {
+          event->SetText(0, uid);
+          event->SetBlob(msg.data, msg.data && msg.dataLen > 0 ? static_cast<size_t>(msg.dataLen) : 0);
+          event->SetArgs(msg);
+          Post(event);
+        }
+      }
+
+    private:
+      AliEngineEventDispatcher(const AliEngineEventDispatcher&);
+      AliEngineEventDispatcher& operator=(const AliEngineEventDispatcher&);
+
+      enum {
+        /* 预先分配的合并槽位数，覆盖常见的 (回调, uid, track) 组合，超出时再增加 */
+        kPresizedSlots = 64,
+        /* 事件中的整数参数个数，枚举与布尔参数也按整数保存 */
+        kEventInts = 4,
+        /* 事件中的字符串参数个数 */
+        kEventTexts = 3,
+        /* 结构体参数按值保存的最大字节数，覆盖 AliEngineStats */
+        kEventArgBytes = 128,
+        /* 字符串与数据块的内嵌缓冲，容纳常见的 uid、频道名与提示信息 */
+        kEventInlineBytes = 256,
+      };
+
+      /* 回调编号，重载的回调各占一个编号 */
+      enum {
+        kEventJoinChannelResult,
+        kEventJoinChannelResultWithUser,
+        kEventLeaveChannelResult,
+        kEventRemoteUserOnLineNotify,
+        kEventRemoteUserOffLineNotify,
+        kEventAudioPublishStateChanged,
+        kEventAudioPublishStateChangedWithTrack,
+        kEventVideoPublishStateChanged,
+        kEventDualStreamPublishStateChanged,
+        kEventScreenSharePublishStateChanged,
+        kEventScreenSharePublishStateChangedWithInfo,
+        kEventPublishStreamByRtsUrlResult,
+        kEventStopPublishStreamByRtsUrlResult,
+        kEventSubscribeStreamByRtsUrlResult,
+        kEventStopSubscribeStreamByRtsUrlResult,
+        kEventSubscribedRtsStreamBeyondLimit,
+        kEventPauseRtsStreamResult,
+        kEventResumeRtsStreamResult,
+        kEventRemoteTrackAvailableNotify,
+        kEventAudioSubscribeStateChanged,
+        kEventAudioSubscribeStateChangedWithTrack,
+        kEventVideoSubscribeStateChanged,
+        kEventScreenShareSubscribeStateChanged,
+        kEventSubscribeStreamTypeChanged,
+        kEventNetworkQualityChanged,
+        kEventPublishStaticVideoFrame,
+        kEventBye,
+        kEventOccurWarning,
+        kEventOccurError,
+        kEventPerformanceLow,
+        kEventPerformanceRecovery,
+        kEventFirstRemoteVideoFrameDrawn,
+        kEventFirstLocalVideoFrameDrawn,
+        kEventFirstAudioPacketSend,
+        kEventFirstAudioPacketSendWithTrack,
+        kEventFirstAudioPacketReceived,
+        kEventFirstAudioPacketReceivedWithTrack,
+        kEventFirstRemoteAudioDecoded,
+        kEventFirstRemoteAudioDecodedWithTrack,
+        kEventFirstVideoPacketSend,
+        kEventFirstVideoPacketReceived,
+        kEventFirstVideoFrameReceived,
+        kEventConnectionLost,
+        kEventTryToReconnect,
+        kEventConnectionRecovery,
+        kEventConnectionStatusChange,
+        kEventUserAudioMuted,
+        kEventUserVideoMuted,
+        kEventUserVideoEnabled,
+        kEventUserAudioInterruptedBegin,
+        kEventUserAudioInterruptedEnded,
+        kEventRemoteAudioAccompanyStarted,
+        kEventRemoteAudioAccompanyFinished,
+        kEventUserWillResignActive,
+        kEventUserWillBecomeActive,
+        kEventUpdateRoleNotify,
+        kEventAudioVolumeCallback,
+        kEventActiveSpeaker,
+        kEventAudioAccompanyStateChanged,
+        kEventAudioFileInfo,
+        kEventAudioEffectFinished,
+        kEventLastmileDetectResultWithQuality,
+        kEventLastmileDetectResultWithBandWidth,
+        kEventAudioDeviceRecordLevel,
+        kEventAudioDevicePlayoutLevel,
+        kEventAudioDevicePlayoutEnd,
+        kEventMediaRecordEvent,
+        kEventStats,
+        kEventLocalVideoStats,
+        kEventRemoteVideoStats,
+        kEventLocalAudioStats,
+        kEventRemoteAudioStats,
+        kEventStartLiveStreamingResult,
+        kEventMediaExtensionMsgReceived,
+        kEventAudioDeviceStateChanged,
+        kEventAudioFocusChanged,
+        kEventVideoDeviceStateChanged,
+        kEventDownlinkMessageNotify,
+        kEventUplinkMessageResponse,
+        kEventAudioRouteChanged,
+        kEventVideoResolutionChanged,
+        kEventSnapshotComplete,
+        kEventPublishLiveStreamStateChanged,
+        kEventPublishLiveStreamStateChangedWithTaskId,
+        kEventPublishTaskStateChanged,
+        kEventPublishTaskStateChangedWithTaskId,
+        kEventChannelRelayStateChanged,
+        kEventChannelRelayEvent,
+        kEventRemoteVideoChanged,
+        kEventAuthInfoWillExpire,
+        kEventAuthInfoExpired,
+        kEventRequestVideoExternalEncoderParameter,
+        kEventRequestVideoExternalEncoderFrame,
+        kEventCalledApiExecuted,
+        kEventVideoEncoderNotify,
+        kEventVideoDecoderNotify,
+        kEventLocalDeviceException,
+        kEventLocalAudioStateChange,
+        kEventLocalVideoStateChanged,
+        kEventDataChannelMessage,
+      };
+
+      struct Slot;
+
+      /*
+       * 队列中的事件：kind 为回调编号，参数按编号约定存入 ints/texts/args；字符串与数据块写入 payload，
+       * 先用内嵌缓冲，写满后换成 heap。slot 非空时为合并槽位内嵌的令牌，参数取自槽位中的最新值
+       */
+      struct Event {
+        int kind;
+        const char* name;
+        Slot* slot;
+        long long postUs;
+        long long ints[kEventInts];
+        /* payload 中的偏移，-1 表示空指针 */
+        int texts[kEventTexts];
+        int blob;
+        int blobLength;
+        size_t used;
+        size_t heapCapacity;
+        char* heap;
+        alignas(8) unsigned char args[kEventArgBytes];
+        char inlineBytes[kEventInlineBytes];
+
+        void Reset(int eventKind, const char* eventName)
+        {
+          kind = eventKind;
+          name = eventName;
+          slot = nullptr;
+          postUs = 0;
+          for (int i = 0; i < kEventInts; ++i) {
+            ints[i] = 0;
+          }
+          for (int i = 0; i < kEventTexts; ++i) {
+            texts[i] = -1;
+          }
+          blob = -1;
+          blobLength = 0;
+          used = 0;
+          heapCapacity = 0;
+          heap = nullptr;
+        }
+
+        void Release()
+        {
+          free(heap);
+          heap = nullptr;
+          heapCapacity = 0;
+          used = 0;
+        }
+
+        char* Payload() { return heap ? heap : inlineBytes; }
+        const char* Payload() const { return heap ? heap : inlineBytes; }
+
+        /* 追加到 payload，返回偏移；分配失败返回 -1 */
+        int Append(const void* data, size_t size)
+        {
+          const size_t capacity = heap ? heapCapacity : sizeof(inlineBytes);
+          if (used + size > capacity) {
+            size_t grown = capacity * 2;
+            while (grown < used + size) {
+              grown *= 2;
+            }
+            char* buffer = static_cast<char*>(malloc(grown));
+            if (!buffer) {
+              return -1;
+            }
+            memcpy(buffer, Payload(), used);
+            free(heap);
+            heap = buffer;
+            heapCapacity = grown;
+          }
+          const int offset = static_cast<int>(used);
+          memcpy(Payload() + used, data, size);
+          used += size;
+          return offset;
+        }
+
+        void SetText(int index, const char* text)
+        {
+          texts[index] = text ? Append(text, strlen(text) + 1) : -1;
+        }
+
+        const char* Text(int index) const
+        {
+          return texts[index] < 0 ? nullptr : Payload() + texts[index];
+        }
+
+        void SetBlob(const void* data, size_t size)
+        {
+          blob = data && size > 0 ? Append(data, size) : -1;
+          blobLength = blob < 0 ? 0 : static_cast<int>(size);
+        }
+
+        const char* Blob() const
+        {
+          return blob < 0 ? nullptr : Payload() + blob;
+        }
+
+        /* 结构体参数按字节保存，T 需可按字节拷贝 */
+        template <typename T>
+        void SetArgs(const T &value)
+        {
+          static_assert(sizeof(T) <= kEventArgBytes, "event argument too large");
+          memcpy(args, static_cast<const void*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        T Args() const
+        {
+          T value;
+          memcpy(static_cast<void*>(&value), args, sizeof(T));
+          return value;
+        }
+
+        template <typename T>
+        T Int(int index) const
+        {
+          return static_cast<T>(ints[index]);
+        }
+      };
+
+      /* OnAudioVolumeCallback 的每个用户在 payload 中的记录，其后紧跟 uidBytes 字节的 uid */
+      struct VolumeEntry {
+        int speechState;
+        int volume;
+        int sumVolume;
+        int uidBytes;
+      };
+
+      /* 槽位地址在 slots_ 中保持不变；lock 保护除 token.slot 以外的字段 */
+      struct Slot {
+        std::mutex lock;
+        /* 最新值，heap 由槽位持有，送达时转交给分发线程 */
+        Event latest = Event();
+        bool pending = false;
+        /* 所属用户已下线，送达后回收 */
+        bool retired = false;
+        unsigned long long coalesced = 0;
+        Event token = Event();
+      };
+
+      static long long NowUs()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /* 从事件池取一个事件；池已取空说明队列与溢出列表都已满，丢弃本次回调 */
+      Event* Acquire(int kind, const char* name)
+      {
+        Event* event = nullptr;
+        if (!freeEvents_.TryPop(event)) {
+          posted_.fetch_add(1, std::memory_order_relaxed);
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+          return nullptr;
+        }
+        event->Reset(kind, name);
+        return event;
+      }
+
+      void Recycle(Event* event)
+      {
+        event->Release();
+        freeEvents_.TryPush(event);
+      }
+
+      /* 状态类回调：按序送达，入队失败时归还事件池 */
+      void Post(Event* event)
+      {
+        event->postUs = NowUs();
+        if (!Enqueue(event)) {
+          Recycle(event);
+        }
+      }
+
+      void PostInts(int kind, const char* name, long long a = 0, long long b = 0, long long c = 0)
+      {
+        if (Event* event = Acquire(kind, name)) {
+          event->ints[0] = a;
+          event->ints[1] = b;
+          event->ints[2] = c;
+          Post(event);
+        }
+      }
+
+      void PostTextInt(int kind, const char* name, const char* text, long long value)
+      {
+        PostTextInts(kind, name, text, value);
+      }
+
+      void PostTextInts(int kind, const char* name, const char* text, long long a = 0, long long b = 0, long long c = 0,
+                        long long d = 0)
+      {
+        if (Event* event = Acquire(kind, name)) {
+          event->ints[0] = a;
+          event->ints[1] = b;
+          event->ints[2] = c;
+          event->ints[3] = d;
+          event->SetText(0, text);
+          Post(event);
+        }
+      }
+
+      /* 发布/订阅状态变化：uid 为 texts[0]、channel 为 texts[1]；ints 依次为 track、旧状态、新状态、间隔 */
+      void PostStateChanged(int kind, const char* name, const char* uid, int track, int oldState, int newState,
+                            int elapseSinceLastState, const char* channel)
+      {
+        if (Event* event = Acquire(kind, name)) {
+          event->ints[0] = track;
+          event->ints[1] = oldState;
+          event->ints[2] = newState;
+          event->ints[3] = elapseSinceLastState;
+          event->SetText(0, uid);
+          event->SetText(1, channel);
+          Post(event);
+        }
+      }
+
+      void PostDeviceStateChanged(int kind, const char* name, const AliEngineDeviceInfo &deviceInfo,
+                                  AliEngineExternalDeviceType deviceType, AliEngineExternalDeviceState deviceState)
+      {
+        if (Event* event = Acquire(kind, name)) {
+          event->ints[0] = deviceInfo.deviceTransportType;
+          event->ints[1] = deviceType;
+          event->ints[2] = deviceState;
+          event->SetText(0, deviceInfo.deviceName.c_str());
+          event->SetText(1, deviceInfo.deviceID.c_str());
+          Post(event);
+        }
+      }
+
+      /* 统计类回调：同一 (回调, uid, track) 只保留最新值，未送达时不重复入队；event 的 heap 转交给槽位 */
+      void Coalesce(Event &event, const char* uid, int track)
+      {
+        Event* token = nullptr;
+        Slot* slot = nullptr;
+        {
+          std::lock_guard<std::mutex> guard(slotLock_);
+          /* 复用键的缓冲区，已有槽位的查找不分配内存 */
+          slotKey_.assign(event.name);
+          slotKey_ += '\n';
+          slotKey_ += uid ? uid : "";
+          slotKey_ += '\n';
+          slotKey_ += static_cast<char>('0' + (track & 0x3F));
+          std::unordered_map<std::string, Slot*>::iterator found = slotIndex_.find(slotKey_);
+          if (found == slotIndex_.end()) {
+            slot = AcquireSlotLocked();
+            slotIndex_.insert(std::make_pair(slotKey_, slot));
+          } else {
+            slot = found->second;
+          }
+          std::lock_guard<std::mutex> slotGuard(slot->lock);
+          slot->latest.Release();
+          slot->latest = event;
+          if (slot->pending) {
+            ++slot->coalesced;
+            posted_.fetch_add(1, std::memory_order_relaxed);
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            return;
+          }
+          slot->pending = true;
+          slot->token.name = event.name;
+          slot->token.postUs = NowUs();
+          token = &slot->token;
+        }
+        if (!Enqueue(token)) {
+          /* 令牌未入队，最新值留在槽位中，下一次投递时再入队 */
+          std::lock_guard<std::mutex> slotGuard(slot->lock);
+          slot->pending = false;
+        }
+      }
+
+      /* 在 slotLock_ 内调用 */
+      Slot* AcquireSlotLocked()
+      {
+        if (freeSlots_.empty()) {
+          slots_.emplace_back();
+          freeSlots_.push_back(&slots_.back());
+        }
+        Slot* slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        slot->token.slot = slot;
+        return slot;
+      }
+
+      /* 远端用户下线：移除其全部槽位，未送达的槽位在送达后回收 */
+      void ReleaseSlots(const char* uid)
+      {
+        if (!uid || !uid[0]) {
+          return;
+        }
+        const size_t length = strlen(uid);
+        std::lock_guard<std::mutex> guard(slotLock_);
+        std::unordered_map<std::string, Slot*>::iterator it = slotIndex_.begin();
+        while (it != slotIndex_.end()) {
+          const std::string &key = it->first;
+          const size_t begin = key.find('\n') + 1;
+          const size_t end = key.rfind('\n');
+          if (end - begin != length || key.compare(begin, length, uid) != 0) {
+            ++it;
+            continue;
+          }
+          Slot* slot = it->second;
+          {
+            std::lock_guard<std::mutex> slotGuard(slot->lock);
+            if (slot->pending) {
+              slot->retired = true;
+            } else {
+              slot->latest.Release();
+              slot->coalesced = 0;
+              freeSlots_.push_back(slot);
+            }
+          }
+          it = slotIndex_.erase(it);
+        }
+      }
+
+      /* 入队失败（队列与溢出列表都已满）时计入 dropped 并返回 false，由调用方回收事件 */
+      bool Enqueue(Event* event)
+      {
+        const int depth = depth_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        if (spilled_.load(std::memory_order_acquire) || !queue_.TryPush(event)) {
+          std::lock_guard<std::mutex> guard(spillLock_);
+          if (spillSize_ == spill_.size()) {
+            depth_.fetch_sub(1, std::memory_order_relaxed);
+            posted_.fetch_add(1, std::memory_order_relaxed);
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+          }
+          spill_[(spillHead_ + spillSize_) % spill_.size()] = event;
+          ++spillSize_;
+          spilled_.store(true, std::memory_order_release);
+          spilledCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+        posted_.fetch_add(1, std::memory_order_relaxed);
+        int maxDepth = maxDepth_.load(std::memory_order_relaxed);
+        while (depth > maxDepth && !maxDepth_.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed)) {
+        }
+        if (sleeping_.load(std::memory_order_seq_cst)) {
+          std::lock_guard<std::mutex> guard(wakeLock_);
+          wake_.notify_one();
+        }
+        return true;
+      }
+
+      void DeliveryLoop()
+      {
+        while (true) {
+          Event* event = nullptr;
+          if (queue_.TryPop(event)) {
+            Deliver(event);
+            continue;
+          }
+          /* 队列已空，再按序送达溢出列表；溢出期间的新事件都在列表中，顺序不变 */
+          if (spilled_.load(std::memory_order_acquire)) {
+            {
+              std::lock_guard<std::mutex> guard(spillLock_);
+              for (; spillSize_ > 0; --spillSize_) {
+                draining_.push_back(spill_[spillHead_]);
+                spillHead_ = (spillHead_ + 1) % spill_.size();
+              }
+              spilled_.store(false, std::memory_order_release);
+            }
+            for (size_t i = 0; i < draining_.size(); ++i) {
+              Deliver(draining_[i]);
+            }
+            draining_.clear();
+            continue;
+          }
+          if (!running_.load(std::memory_order_relaxed)) {
+            break;
+          }
+          std::unique_lock<std::mutex> guard(wakeLock_);
+          sleeping_.store(true, std::memory_order_seq_cst);
+          if (depth_.load(std::memory_order_seq_cst) == 0 && running_.load(std::memory_order_relaxed)) {
+            wake_.wait_for(guard, std::chrono::milliseconds(50));
+          }
+          sleeping_.store(false, std::memory_order_relaxed);
+        }
+      }
+
+      void Deliver(Event* event)
+      {
+        Slot* const slot = event->slot;
+        unsigned long long coalesced = 0;
+        long long postUs = 0;
+        Event local;
+        const Event* args = event;
+        if (slot) {
+          bool retired = false;
+          {
+            /* 令牌在 pending 清除后即可被引擎线程重新入队，字段须在槽位锁内取出 */
+            std::lock_guard<std::mutex> guard(slot->lock);
+            local = slot->latest;
+            slot->latest.heap = nullptr;
+            slot->latest.Release();
+            postUs = slot->token.postUs;
+            coalesced = slot->coalesced;
+            slot->coalesced = 0;
+            slot->pending = false;
+            retired = slot->retired;
+            slot->retired = false;
+          }
+          if (retired) {
+            std::lock_guard<std::mutex> guard(slotLock_);
+            freeSlots_.push_back(slot);
+          }
+          args = &local;
+        } else {
+          postUs = event->postUs;
+        }
+        const long long start = NowUs();
+        if (target_) {
+          Dispatch(*args);
+        }
+        const long long end = NowUs();
+        depth_.fetch_sub(1, std::memory_order_relaxed);
+        Record(args->name, static_cast<int>(start - postUs), static_cast<int>(end - start), coalesced);
+        if (slot) {
+          local.Release();
+        } else {
+          Recycle(event);
+        }
+      }
+
+      /* 按回调编号还原参数并调用监听者 */
+      void Dispatch(const Event &e)
+      {
+        switch (e.kind) {
+          case kEventJoinChannelResult:
+            target_->OnJoinChannelResult(e.Int<int>(0), e.Text(0), e.Int<int>(1));
+            break;
+          case kEventJoinChannelResultWithUser:
+            target_->OnJoinChannelResult(e.Int<int>(0), e.Text(0), e.Text(1), e.Int<int>(1));
+            break;
+          case kEventLeaveChannelResult:
+            target_->OnLeaveChannelResult(e.Int<int>(0), e.Args<AliEngineStats>());
+            break;
+          case kEventRemoteUserOnLineNotify:
+            target_->OnRemoteUserOnLineNotify(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventRemoteUserOffLineNotify:
+            target_->OnRemoteUserOffLineNotify(e.Text(0), e.Int<AliEngineUserOfflineReason>(0));
+            break;
+          case kEventAudioPublishStateChanged:
+            target_->OnAudioPublishStateChanged(e.Int<AliEnginePublishState>(1), e.Int<AliEnginePublishState>(2),
+                                                e.Int<int>(3), e.Text(1));
+            break;
+          case kEventAudioPublishStateChangedWithTrack:
+            target_->OnAudioPublishStateChanged(e.Int<AliEngineAudioTrack>(0), e.Int<AliEnginePublishState>(1),
+                                                e.Int<AliEnginePublishState>(2), e.Int<int>(3), e.Text(1));
+            break;
+          case kEventVideoPublishStateChanged:
+            target_->OnVideoPublishStateChanged(e.Int<AliEnginePublishState>(1), e.Int<AliEnginePublishState>(2),
+                                                e.Int<int>(3), e.Text(1));
+            break;
+          case kEventDualStreamPublishStateChanged:
+            target_->OnDualStreamPublishStateChanged(e.Int<AliEnginePublishState>(1), e.Int<AliEnginePublishState>(2),
+                                                     e.Int<int>(3), e.Text(1));
+            break;
+          case kEventScreenSharePublishStateChanged:
+            target_->OnScreenSharePublishStateChanged(e.Int<AliEnginePublishState>(1), e.Int<AliEnginePublishState>(2),
+                                                      e.Int<int>(3), e.Text(1));
+            break;
+#if (defined(__APPLE__) && TARGET_OS_MAC && !TARGET_OS_IPHONE) || defined(_WIN32)
+          case kEventScreenSharePublishStateChangedWithInfo: {
+            AliEngineScreenShareInfo info = e.Args<AliEngineScreenShareInfo>();
+            target_->OnScreenSharePublishStateChangedWithInfo(e.Int<AliEnginePublishState>(0), e.Int<AliEnginePublishState>(1),
+                                                              e.Int<int>(2), e.Text(0), info);
+            break;
+          }
+#endif
+          case kEventPublishStreamByRtsUrlResult:
+            target_->OnPublishStreamByRtsUrlResult(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventStopPublishStreamByRtsUrlResult:
+            target_->OnStopPublishStreamByRtsUrlResult(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventSubscribeStreamByRtsUrlResult:
+            target_->OnSubscribeStreamByRtsUrlResult(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventStopSubscribeStreamByRtsUrlResult:
+            target_->OnStopSubscribeStreamByRtsUrlResult(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventSubscribedRtsStreamBeyondLimit:
+            target_->OnSubscribedRtsStreamBeyondLimit(e.Text(0), e.Text(1));
+            break;
+          case kEventPauseRtsStreamResult:
+            target_->OnPauseRtsStreamResult(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventResumeRtsStreamResult:
+            target_->OnResumeRtsStreamResult(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventRemoteTrackAvailableNotify:
+            target_->OnRemoteTrackAvailableNotify(e.Text(0), e.Int<AliEngineAudioTrack>(0), e.Int<AliEngineVideoTrack>(1));
+            break;
+          case kEventAudioSubscribeStateChanged:
+            target_->OnAudioSubscribeStateChanged(e.Text(0), e.Int<AliEngineSubscribeState>(1), e.Int<AliEngineSubscribeState>(2),
+                                                  e.Int<int>(3), e.Text(1));
+            break;
+          case kEventAudioSubscribeStateChangedWithTrack:
+            target_->OnAudioSubscribeStateChanged(e.Text(0), e.Int<AliEngineAudioTrack>(0), e.Int<AliEngineSubscribeState>(1),
+                                                  e.Int<AliEngineSubscribeState>(2), e.Int<int>(3), e.Text(1));
+            break;
+          case kEventVideoSubscribeStateChanged:
+            target_->OnVideoSubscribeStateChanged(e.Text(0), e.Int<AliEngineSubscribeState>(1), e.Int<AliEngineSubscribeState>(2),
+                                                  e.Int<int>(3), e.Text(1));
+            break;
+          case kEventScreenShareSubscribeStateChanged:
+            target_->OnScreenShareSubscribeStateChanged(e.Text(0), e.Int<AliEngineSubscribeState>(1),
+                                                        e.Int<AliEngineSubscribeState>(2), e.Int<int>(3), e.Text(1));
+            break;
+          case kEventSubscribeStreamTypeChanged:
+            target_->OnSubscribeStreamTypeChanged(e.Text(0), e.Int<AliEngineVideoStreamType>(1), e.Int<AliEngineVideoStreamType>(2),
+                                                  e.Int<int>(3), e.Text(1));
+            break;
+          case kEventNetworkQualityChanged:
+            target_->OnNetworkQualityChanged(e.Text(0), e.Int<AliEngineNetworkQuality>(0), e.Int<AliEngineNetworkQuality>(1));
+            break;
+          case kEventPublishStaticVideoFrame:
+            target_->OnPublishStaticVideoFrame(e.Int<AliEngineVideoTrack>(0), e.Int<bool>(1));
+            break;
+          case kEventBye:
+            target_->OnBye(e.Int<int>(0));
+            break;
+          case kEventOccurWarning:
+            target_->OnOccurWarning(e.Int<int>(0), e.Text(0));
+            break;
+          case kEventOccurError:
+            target_->OnOccurError(e.Int<int>(0), e.Text(0));
+            break;
+          case kEventPerformanceLow:
+            target_->OnPerformanceLow();
+            break;
+          case kEventPerformanceRecovery:
+            target_->OnPerformanceRecovery();
+            break;
+          case kEventFirstRemoteVideoFrameDrawn:
+            target_->OnFirstRemoteVideoFrameDrawn(e.Text(0), e.Int<AliEngineVideoTrack>(0), e.Int<int>(1), e.Int<int>(2), e.Int<int>(3));
+            break;
+          case kEventFirstLocalVideoFrameDrawn:
+            target_->OnFirstLocalVideoFrameDrawn(e.Int<int>(0), e.Int<int>(1), e.Int<int>(2));
+            break;
+          case kEventFirstAudioPacketSend:
+            target_->OnFirstAudioPacketSend(e.Int<int>(0));
+            break;
+          case kEventFirstAudioPacketSendWithTrack:
+            target_->OnFirstAudioPacketSend(e.Int<AliEngineAudioTrack>(0), e.Int<int>(1));
+            break;
+          case kEventFirstAudioPacketReceived:
+            target_->OnFirstAudioPacketReceived(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventFirstAudioPacketReceivedWithTrack:
+            target_->OnFirstAudioPacketReceived(e.Text(0), e.Int<AliEngineAudioTrack>(0), e.Int<int>(1));
+            break;
+          case kEventFirstRemoteAudioDecoded:
+            target_->OnFirstRemoteAudioDecoded(e.Text(0), e.Int<int>(0));
+            break;
+          case kEventFirstRemoteAudioDecodedWithTrack:
+            target_->OnFirstRemoteAudioDecoded(e.Text(0), e.Int<AliEngineAudioTrack>(0), e.Int<int>(1));
+            break;
+          case kEventFirstVideoPacketSend:
+            target_->OnFirstVideoPacketSend(e.Int<AliEngineVideoTrack>(0), e.Int<int>(1));
+            break;
+          case kEventFirstVideoPacketReceived:
+            target_->OnFirstVideoPacketReceived(e.Text(0), e.Int<AliEngineVideoTrack>(0), e.Int<int>(1));
+            break;
+          case kEventFirstVideoFrameReceived:
+            target_->OnFirstVideoFrameReceived(e.Text(0), e.Int<AliEngineVideoTrack>(0), e.Int<int>(1));
+            break;
+          case kEventConnectionLost:
+            target_->OnConnectionLost();
+            break;
+          case kEventTryToReconnect:
+            target_->OnTryToReconnect();
+            break;
+          case kEventConnectionRecovery:
+            target_->OnConnectionRecovery();
+            break;
+          case kEventConnectionStatusChange:
+            target_->OnConnectionStatusChange(e.Int<int>(0), e.Int<int>(1));
+            break;
+          case kEventUserAudioMuted:
+            target_->OnUserAudioMuted(e.Text(0), e.Int<bool>(0));
+            break;
+          case kEventUserVideoMuted:
+            target_->OnUserVideoMuted(e.Text(0), e.Int<bool>(0));
+            break;
+          case kEventUserVideoEnabled:
+            target_->OnUserVideoEnabled(e.Text(0), e.Int<bool>(0));
+            break;
+          case kEventUserAudioInterruptedBegin:
+            target_->OnUserAudioInterruptedBegin(e.Text(0));
+            break;
+          case kEventUserAudioInterruptedEnded:
+            target_->OnUserAudioInterruptedEnded(e.Text(0));
+            break;
+          case kEventRemoteAudioAccompanyStarted:
+            target_->OnRemoteAudioAccompanyStarted(e.Text(0));
+            break;
+          case kEventRemoteAudioAccompanyFinished:
+            target_->OnRemoteAudioAccompanyFinished(e.Text(0));
+            break;
+          case kEventUserWillResignActive:
+            target_->OnUserWillResignActive(e.Text(0));
+            break;
+          case kEventUserWillBecomeActive:
+            target_->OnUserWillBecomeActive(e.Text(0));
+            break;
+          case kEventUpdateRoleNotify:
+            target_->OnUpdateRoleNotify(e.Int<AliEngineClientRole>(0), e.Int<AliEngineClientRole>(1));
+            break;
+          case kEventAudioVolumeCallback: {
+            /* 监听者需要 String 形式的 uid，在分发线程上还原 */
+            std::vector<AliEngineUserVolumeInfo> infos(e.Int<size_t>(0));
+            const char* p = e.Blob();
+            for (size_t i = 0; i < infos.size(); ++i) {
+              VolumeEntry entry;
+              memcpy(&entry, p, sizeof(entry));
+              p += sizeof(entry);
+              infos[i].uid = p;
+              infos[i].speechState = entry.speechState != 0;
+              infos[i].volume = entry.volume;
+              infos[i].sumVolume = entry.sumVolume;
+              p += entry.uidBytes;
+            }
+            target_->OnAudioVolumeCallback(infos.empty() ? nullptr : &infos[0], static_cast<int>(infos.size()), e.Int<int>(1));
+            break;
+          }
+          case kEventActiveSpeaker:
+            target_->OnActiveSpeaker(e.Text(0));
+            break;
+          case kEventAudioAccompanyStateChanged:
+            target_->OnAudioAccompanyStateChanged(e.Int<AliEngineAudioAccompanyStateCode>(0), e.Int<AliEngineAudioAccompanyErrorCode>(1));
+            break;
+          case kEventAudioFileInfo: {
+            AliEngineAudioFileInfo info = e.Args<AliEngineAudioFileInfo>();
+            info.filePath = e.Text(0);
+            target_->OnAudioFileInfo(info, e.Int<AliEngineAudioAccompanyErrorCode>(0));
+            break;
+          }
+          case kEventAudioEffectFinished:
+            target_->OnAudioEffectFinished(e.Int<int>(0));
+            break;
+          case kEventLastmileDetectResultWithQuality:
+            target_->OnLastmileDetectResultWithQuality(e.Int<AliEngineNetworkQuality>(0));
+            break;
+          case kEventLastmileDetectResultWithBandWidth:
+            target_->OnLastmileDetectResultWithBandWidth(e.Int<int>(0), e.Args<AliEngineNetworkProbeResult>());
+            break;
+          case kEventAudioDeviceRecordLevel:
+            target_->OnAudioDeviceRecordLevel(e.Int<int>(0));
+            break;
+          case kEventAudioDevicePlayoutLevel:
+            target_->OnAudioDevicePlayoutLevel(e.Int<int>(0));
+            break;
+          case kEventAudioDevicePlayoutEnd:
+            target_->OnAudioDevicePlayoutEnd();
+            break;
+          case kEventMediaRecordEvent:
+            target_->OnMediaRecordEvent(e.Int<int>(0), e.Text(0));
+            break;
+          case kEventStats:
+            target_->OnStats(e.Args<AliEngineStats>());
+            break;
+          case kEventLocalVideoStats:
+            target_->OnLocalVideoStats(e.Args<AliEngineLocalVideoStats>());
+            break;
+          case kEventRemoteVideoStats: {
+            AliEngineRemoteVideoStats stats = e.Args<AliEngineRemoteVideoStats>();
+            stats.userId = e.Text(0);
+            target_->OnRemoteVideoStats(stats);
+            break;
+          }
+          case kEventLocalAudioStats:
+            target_->OnLocalAudioStats(e.Args<AliEngineLocalAudioStats>());
+            break;
+          case kEventRemoteAudioStats: {
+            AliEngineRemoteAudioStats stats = e.Args<AliEngineRemoteAudioStats>();
+            stats.userId = e.Text(0);
+            target_->OnRemoteAudioStats(stats);
+            break;
+          }
+          case kEventStartLiveStreamingResult:
+            target_->OnStartLiveStreamingResult(e.Int<int>(0));
+            break;
+          case kEventMediaExtensionMsgReceived:
+            target_->OnMediaExtensionMsgReceived(e.Text(0), e.Int<uint8_t>(0), reinterpret_cast<const int8_t*>(e.Blob()),
+                                                 static_cast<uint32_t>(e.blobLength));
+            break;
+          case kEventAudioDeviceStateChanged:
+          case kEventVideoDeviceStateChanged: {
+            AliEngineDeviceInfo info;
+            info.deviceName = e.Text(0);
+            info.deviceID = e.Text(1);
+            info.deviceTransportType = e.Int<AliEngineDeviceTransportType>(0);
+            if (e.kind == kEventAudioDeviceStateChanged) {
+              target_->OnAudioDeviceStateChanged(info, e.Int<AliEngineExternalDeviceType>(1), e.Int<AliEngineExternalDeviceState>(2));
+            } else {
+              target_->OnVideoDeviceStateChanged(info, e.Int<AliEngineExternalDeviceType>(1), e.Int<AliEngineExternalDeviceState>(2));
+            }
+            break;
+          }
+          case kEventAudioFocusChanged:
+            target_->OnAudioFocusChanged(e.Int<AliEngineAudioFocusType>(0));
+            break;
+          case kEventDownlinkMessageNotify: {
+            AliEngineMessage message;
+            message.tID = e.Text(0);
+            message.contentType = e.Text(1);
+            message.content = e.Text(2);
+            target_->OnDownlinkMessageNotify(message);
+            break;
+          }
+          case kEventUplinkMessageResponse: {
+            AliEngineMessageResponse response;
+            response.result = e.Int<int>(0);
+            response.contentType = e.Text(0);
+            response.content = e.Text(1);
+            target_->OnUplinkMessageResponse(response);
+            break;
+          }
+#if (defined(__APPLE__) && TARGET_OS_IOS)
+          case kEventAudioRouteChanged:
+            target_->OnAudioRouteChanged(e.Int<AliEngineAudioRouteType>(0));
+            break;
+#endif
+          case kEventVideoResolutionChanged:
+            target_->OnVideoResolutionChanged(e.Text(0), e.Int<AliEngineVideoTrack>(0), e.Int<int>(1), e.Int<int>(2));
+            break;
+          case kEventSnapshotComplete:
+            target_->OnSnapshotComplete(e.Text(0), e.Int<AliEngineVideoTrack>(0), const_cast<char*>(e.Blob()),
+                                        e.Int<int>(1), e.Int<int>(2), e.Int<bool>(3));
+            break;
+          case kEventPublishLiveStreamStateChanged:
+            target_->OnPublishLiveStreamStateChanged(e.Text(0), e.Int<AliEngineLiveTranscodingState>(0),
+                                                     e.Int<AliEngineLiveTranscodingErrorCode>(1));
+            break;
+          case kEventPublishLiveStreamStateChangedWithTaskId:
+            target_->OnPublishLiveStreamStateChangedWithTaskId(e.Text(0), e.Int<AliEngineLiveTranscodingState>(0),
+                                                               e.Int<AliEngineLiveTranscodingErrorCode>(1));
+            break;
+          case kEventPublishTaskStateChanged:
+            target_->OnPublishTaskStateChanged(e.Text(0), e.Int<AliEngineTrascodingPublishTaskStatus>(0));
+            break;
+          case kEventPublishTaskStateChangedWithTaskId:
+            target_->OnPublishTaskStateChangedWithTaskId(e.Text(0), e.Int<AliEngineTrascodingPublishTaskStatus>(0));
+            break;
+          case kEventChannelRelayStateChanged:
+            target_->OnChannelRelayStateChanged(e.Int<int>(0), e.Int<int>(1), e.Text(0));
+            break;
+          case kEventChannelRelayEvent:
+            target_->OnChannelRelayEvent(e.Int<int>(0));
+            break;
+          case kEventRemoteVideoChanged:
+            target_->OnRemoteVideoChanged(e.Text(0), e.Int<AliEngineVideoTrack>(0), e.Int<AliEngineVideoState>(1),
+                                          e.Int<AliEngineVideoReason>(2));
+            break;
+          case kEventAuthInfoWillExpire:
+            target_->OnAuthInfoWillExpire();
+            break;
+          case kEventAuthInfoExpired:
+            target_->OnAuthInfoExpired();
+            break;
+          case kEventRequestVideoExternalEncoderParameter:
+            target_->OnRequestVideoExternalEncoderParameter(e.Int<AliEngineVideoTrack>(0),
+                                                            e.Args<AliEngineVideoExternalEncoderParameter>());
+            break;
+          case kEventRequestVideoExternalEncoderFrame:
+            target_->OnRequestVideoExternalEncoderFrame(e.Int<AliEngineVideoTrack>(0), e.Int<AliEngineVideoEncodedFrameType>(1));
+            break;
+          case kEventCalledApiExecuted:
+            target_->OnCalledApiExecuted(e.Int<int>(0), e.Text(0), e.Text(1));
+            break;
+          case kEventVideoEncoderNotify:
+            target_->OnVideoEncoderNotify(e.Args<AliEngineEncoderNotifyInfo>());
+            break;
+          case kEventVideoDecoderNotify: {
+            AliEngineDecoderNotifyInfo info = e.Args<AliEngineDecoderNotifyInfo>();
+            info.uid = e.Text(0);
+            target_->OnVideoDecoderNotify(info);
+            break;
+          }
+          case kEventLocalDeviceException:
+            target_->OnLocalDeviceException(e.Int<AliEngineLocalDeviceType>(0), e.Int<AliEngineLocalDeviceExceptionType>(1), e.Text(0));
+            break;
+          case kEventLocalAudioStateChange:
+            target_->OnLocalAudioStateChange(e.Int<AliEngineLocalAudioStateType>(0), e.Text(0));
+            break;
+          case kEventLocalVideoStateChanged:
+            target_->onLocalVideoStateChanged(e.Int<AliEngineLocalVideoStateType>(0), e.Text(0));
+            break;
+          case kEventDataChannelMessage: {
+            AliEngineDataChannelMsg msg = e.Args<AliEngineDataChannelMsg>();
+            msg.data = const_cast<char*>(e.Blob());
+            msg.dataLen = e.blobLength;
+            target_->OnDataChannelMessage(e.Text(0), msg);
+            break;
+          }
+          default:
+            break;
+        }
+      }
+
+      void Record(const char* name, int latencyUs, int handleUs, unsigned long long coalesced)
+      {
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> guard(statsLock_);
+        AliEngineEventCallbackStats* stats = nullptr;
+        for (size_t i = 0; i < callbacks_.size(); ++i) {
+          if (callbacks_[i].name == name || strcmp(callbacks_[i].name, name) == 0) {
+            stats = &callbacks_[i];
+            break;
+          }
+        }
+        if (!stats) {
+          callbacks_.push_back(AliEngineEventCallbackStats());
+          stats = &callbacks_.back();
+          stats->name = name;
+        }
+        stats->avgLatencyUs = stats->delivered == 0 ? latencyUs : stats->avgLatencyUs + (latencyUs - stats->avgLatencyUs) / 16;
+        stats->maxLatencyUs = latencyUs > stats->maxLatencyUs ? latencyUs : stats->maxLatencyUs;
+        stats->maxHandleUs = handleUs > stats->maxHandleUs ? handleUs : stats->maxHandleUs;
+        stats->coalesced += coalesced;
+        ++stats->delivered;
+      }
+
+      AliEngineEventListener* target_;
+      internal::BoundedMpmcQueue<Event*> queue_;
+      /* 事件池：events_ 在构造时分配，空闲事件的指针存放在 freeEvents_ */
+      internal::BoundedMpmcQueue<Event*> freeEvents_;
+      std::vector<Event> events_;
+      std::atomic<bool> running_;
+      std::atomic<bool> sleeping_;
+      /* 溢出列表非空时新事件都进入溢出列表，保证先后顺序 */
+      std::atomic<bool> spilled_;
+      std::atomic<AliEngineStatsSnapshot*> snapshot_;
+      std::atomic<AliEngineStatsHistogram*> histogram_;
+      std::atomic<int> depth_;
+      std::atomic<int> maxDepth_;
+      std::atomic<unsigned long long> posted_;
+      std::atomic<unsigned long long> delivered_;
+      std::atomic<unsigned long long> coalesced_;
+      std::atomic<unsigned long long> spilledCount_;
+      std::atomic<unsigned long long> dropped_;
+      /* 溢出列表为构造时分配的环形缓冲，spillLock_ 保护 spillHead_ 与 spillSize_ */
+      std::mutex spillLock_;
+      std::vector<Event*> spill_;
+      size_t spillHead_;
+      size_t spillSize_;
+      /* 分发线程取出的溢出事件，容量预留为溢出列表大小 */
+      std::vector<Event*> draining_;
+      /* 保护槽位的查找、分配与回收，送达时只在回收已下线用户的槽位时获取 */
+      std::mutex slotLock_;
+      std::deque<Slot> slots_;
+      std::vector<Slot*> freeSlots_;
+      std::unordered_map<std::string, Slot*> slotIndex_;
+      std::string slotKey_;
+      std::mutex wakeLock_;
+      std::condition_variable wake_;
+      /* 仅保护各回调的统计，引擎线程投递时不获取 */
+      std::mutex statsLock_;
+      std::vector<AliEngineEventCallbackStats> callbacks_;
+      std::thread thread_;
+    };
+}
+
+#endif /* ali_rtc_engine_event_dispatcher_h */
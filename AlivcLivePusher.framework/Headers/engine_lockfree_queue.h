@@ -0,0 +1,210 @@
+#ifndef ali_rtc_engine_lockfree_queue_h
+#define ali_rtc_engine_lockfree_queue_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <vector>
+
+#include "engine_define.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+  namespace internal
+  {
+    /**
+     * @brief 有界无锁队列（多生产者多消费者）
+     * @details 基于每个槽位的序号实现，入队出队只使用CAS，不加锁、不分配内存；
+     * 队列满或空时立即返回 false，由调用方决定丢弃或等待
+     * @note 容量会向上取整到2的幂
+     */
+    template <typename T>
+    class BoundedMpmcQueue {
+    public:
+      explicit BoundedMpmcQueue(size_t capacity)
+      {
+        size_t size = 2;
+        while (size < capacity) {
+          size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_ = std::vector<Cell>(size);
+        for (size_t i = 0; i < size; ++i) {
+          cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        enqueuePos_.store(0, std::memory_order_relaxed);
+        dequeuePos_.store(0, std::memory_order_relaxed);
+      }
+
+      bool TryPush(const T &item)
+      {
+        Cell* cell = nullptr;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+          cell = &cells_[pos & mask_];
+          const size_t seq = cell->seq.load(std::memory_order_acquire);
+          const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+          if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+              break;
+            }
+          } else if (diff < 0) {
+            return false;
+          } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+          }
+        }
+        cell->item = item;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+
+      bool TryPop(T &item)
+      {
+        Cell* cell = nullptr;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+          cell = &cells_[pos & mask_];
+          const size_t seq = cell->seq.load(std::memory_order_acquire);
+          const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+          if (diff == 0) {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+              break;
+            }
+          } else if (diff < 0) {
+            return false;
+          } else {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+          }
+        }
+        item = cell->item;
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+      }
+
+      /** 近似深度，仅用于统计 */
+      size_t SizeApprox() const
+      {
+        const size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        const size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+      }
+
+      size_t Capacity() const { return mask_ + 1; }
+
+    private:
+      struct Cell {
+        std::atomic<size_t> seq;
+        T item;
+        Cell() : seq(0), item() {}
+        Cell(const Cell &other) : seq(other.seq.load(std::memory_order_relaxed)), item(other.item) {}
+      };
+
+      BoundedMpmcQueue(const BoundedMpmcQueue&);
+      BoundedMpmcQueue& operator=(const BoundedMpmcQueue&);
+
+      std::vector<Cell> cells_;
+      size_t mask_ = 0;
+      alignas(64) std::atomic<size_t> enqueuePos_;
+      alignas(64) std::atomic<size_t> dequeuePos_;
+    };
+
+    /**
+     * @brief 有界无锁环形缓冲（单生产者单消费者）
+     * @details 按元素批量读写，写入和读取各自只修改一个位置计数，适合连续的音频采样；
+     * 空间不足时只写入能容纳的部分，由调用方统计丢弃量
+     * @note 容量会向上取整到2的幂；T 需可按字节拷贝
+     */
+    template <typename T>
+    class SpscRingBuffer {
+    public:
+      explicit SpscRingBuffer(size_t capacity)
+      {
+        size_t size = 2;
+        while (size < capacity) {
+          size <<= 1;
+        }
+        mask_ = size - 1;
+        buffer_.resize(size);
+        writePos_.store(0, std::memory_order_relaxed);
+        readPos_.store(0, std::memory_order_relaxed);
+      }
+
+      /** 生产者调用，返回实际写入的元素数 */
+      size_t Write(const T* data, size_t count)
+      {
+        const size_t write = writePos_.load(std::memory_order_relaxed);
+        const size_t read = readPos_.load(std::memory_order_acquire);
+        const size_t space = Capacity() - (write - read);
+        count = count < space ? count : space;
+        CopyIn(write & mask_, data, count);
+        writePos_.store(write + count, std::memory_order_release);
+        return count;
+      }
+
+      /** 消费者调用，拷贝最多 count 个元素但不移除，返回拷贝数 */
+      size_t Peek(T* data, size_t count) const
+      {
+        const size_t read = readPos_.load(std::memory_order_relaxed);
+        const size_t write = writePos_.load(std::memory_order_acquire);
+        const size_t size = write - read;
+        count = count < size ? count : size;
+        CopyOut(read & mask_, data, count);
+        return count;
+      }
+
+      /** 消费者调用，移除 count 个元素，count 不可超过 Size() */
+      void Consume(size_t count)
+      {
+        readPos_.store(readPos_.load(std::memory_order_relaxed) + count, std::memory_order_release);
+      }
+
+      /** 消费者调用，读取并移除最多 count 个元素 */
+      size_t Read(T* data, size_t count)
+      {
+        count = Peek(data, count);
+        Consume(count);
+        return count;
+      }
+
+      /** 当前元素数，在生产者或消费者线程调用时为准确值的下界或上界 */
+      size_t Size() const
+      {
+        const size_t read = readPos_.load(std::memory_order_acquire);
+        const size_t write = writePos_.load(std::memory_order_acquire);
+        return write - read;
+      }
+
+      size_t Capacity() const { return mask_ + 1; }
+
+    private:
+      SpscRingBuffer(const SpscRingBuffer&);
+      SpscRingBuffer& operator=(const SpscRingBuffer&);
+
+      void CopyIn(size_t offset, const T* data, size_t count)
+      {
+        const size_t first = count < Capacity() - offset ? count : Capacity() - offset;
+        memcpy(&buffer_[offset], data, first * sizeof(T));
+        memcpy(&buffer_[0], data + first, (count - first) * sizeof(T));
+      }
+
+      void CopyOut(size_t offset, T* data, size_t count) const
+      {
+        const size_t first = count < Capacity() - offset ? count : Capacity() - offset;
+        memcpy(data, &buffer_[offset], first * sizeof(T));
+        memcpy(data + first, &buffer_[0], (count - first) * sizeof(T));
+      }
+
+      std::vector<T> buffer_;
+      size_t mask_ = 0;
+      alignas(64) std::atomic<size_t> writePos_;
+      alignas(64) std::atomic<size_t> readPos_;
+    };
+  }
+}
+
+#endif /* ali_rtc_engine_lockfree_queue_h */
@@ -0,0 +1,91 @@
+#ifndef ali_rtc_engine_simd_utils_h
+#define ali_rtc_engine_simd_utils_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#include "engine_define.h"
+
+/**
+ * @brief SIMD 指令集检测
+ * @details 根据编译参数选择可用的指令集，头文件中的处理函数据此选择对应的实现：
+ *  - ALI_RTC_SIMD_NEON: arm64 / armv7 (需开启 NEON)
+ *  - ALI_RTC_SIMD_SSE41: x86 (需开启 -msse4.1)
+ *  - ALI_RTC_SIMD_AVX2: x86 (需开启 -mavx2)
+ * 定义 ALI_RTC_SIMD_DISABLE 可强制使用标量实现
+ */
+#if !defined(ALI_RTC_SIMD_DISABLE)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ALI_RTC_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#if defined(__SSE4_1__)
+#define ALI_RTC_SIMD_SSE41 1
+#include <smmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define ALI_RTC_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ALI_RTC_FORCE_INLINE inline __attribute__((always_inline))
+#define ALI_RTC_RESTRICT __restrict__
+#else
+#define ALI_RTC_FORCE_INLINE inline
+#define ALI_RTC_RESTRICT
+#endif
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+  namespace internal
+  {
+    /** 钳位到 [0, 255] */
+    ALI_RTC_FORCE_INLINE uint8_t ClampU8(int v)
+    {
+      return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+
+    /** 钳位到 int16 范围 */
+    ALI_RTC_FORCE_INLINE int16_t ClampS16(int v)
+    {
+      return static_cast<int16_t>(v < -32768 ? -32768 : (v > 32767 ? 32767 : v));
+    }
+
+    /** 向上对齐到 align（必须是2的幂） */
+    ALI_RTC_FORCE_INLINE size_t AlignUp(size_t v, size_t align)
+    {
+      return (v + align - 1) & ~(align - 1);
+    }
+
+    /** 按 align 字节对齐分配内存（align 必须是2的幂且不小于 sizeof(void*)），需用 AlignedFree 释放 */
+    inline void* AlignedMalloc(size_t size, size_t align)
+    {
+#if defined(_WIN32)
+      return _aligned_malloc(size, align);
+#else
+      void* ptr = nullptr;
+      return posix_memalign(&ptr, align, size == 0 ? align : size) == 0 ? ptr : nullptr;
+#endif
+    }
+
+    inline void AlignedFree(void* ptr)
+    {
+#if defined(_WIN32)
+      _aligned_free(ptr);
+#else
+      free(ptr);
+#endif
+    }
+  }
+}
+
+#endif /* ali_rtc_engine_simd_utils_h */
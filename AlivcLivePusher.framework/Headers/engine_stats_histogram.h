@@ -0,0 +1,504 @@
+#ifndef ali_rtc_engine_stats_histogram_h
+#define ali_rtc_engine_stats_histogram_h
+
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "engine_interface.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 直方图统计的指标
+     */
+    typedef enum {
+      /** 链路rtt，来自 AliEngineNetworkProbeResult 或 AlivcLivePushStatsInfo.rtt，单位：ms */
+      AliEngineStatsMetricRtt = 0,
+      /** 最后一公里延迟，来自 AliEngineStats，单位：ms */
+      AliEngineStatsMetricLastmileDelay = 1,
+      /** 远端音频抖动缓冲延迟，按uid统计，单位：ms */
+      AliEngineStatsMetricJitterBufferDelay = 2,
+      /** 远端音频网络传输延迟，按uid统计，单位：ms */
+      AliEngineStatsMetricNetworkTransportDelay = 3,
+      /** 远端视频每个统计周期内新增的卡顿时长，按uid统计，单位：ms */
+      AliEngineStatsMetricVideoFrozenTime = 4,
+      /** 视频从采集到上传耗时，来自 AlivcLivePushStatsInfo.videoDurationFromCaptureToUpload，单位：ms */
+      AliEngineStatsMetricCaptureToUpload = 5,
+      /** 指标数量 */
+      AliEngineStatsMetricCount = 6,
+    } AliEngineStatsMetric;
+
+    /**
+     * @brief 直方图统计配置
+     */
+    typedef struct AliEngineStatsHistogramConfig {
+      /** 滑动窗口的最大长度，单位：ms，默认值：30000 */
+      int windowMs = 30000;
+      /** 窗口切分的时间片数，查询精度为 windowMs / windowSlices，默认值：6，取值范围：[1, 60] */
+      int windowSlices = 6;
+      /** 直方图数量上限（每个指标每个uid一个），构造时一次分配，默认值：32，取值范围：[1, 1024] */
+      int maxHistograms = 32;
+    } AliEngineStatsHistogramConfig;
+
+    /**
+     * @brief 直方图查询结果
+     * @details 分位值为所在桶的上界（不超过窗口内最大值），相对误差不超过 1/16
+     */
+    typedef struct AliEngineStatsPercentiles {
+      /** 实际覆盖的窗口长度，单位：ms */
+      int windowMs = 0;
+      /** 窗口内样本数 */
+      unsigned int count = 0;
+      int p50 = 0;
+      int p95 = 0;
+      int p99 = 0;
+      /** 窗口内最大值，精确值 */
+      int max = 0;
+      /** 窗口内平均值 */
+      int mean = 0;
+    } AliEngineStatsPercentiles;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 延迟与质量指标的分位数直方图
+     * @details 按指标、按uid维护 HDR 风格的对数分桶直方图：0~31 精确分桶，之后每个二进制数量级 16 个桶，
+     * 最大可记录 65535，超出部分计入最高桶，最大值仍精确记录。
+     *  - 每个直方图按时间片组成环形滑动窗口，时间片过期后由首个写入者清零复用，查询时合并最近若干时间片
+     *  - 所有计数在构造时一次分配，内存固定为 maxHistograms * windowSlices * 208 * 4 字节
+     *  - 已有直方图的记录路径只有原子操作，不加锁、不分配；新 uid 首次记录时加锁登记；
+     *    uid 超过 63 个字符时按完整值加锁比较，不会因截断而共用直方图
+     *  - 远端用户下线后其直方图在一个窗口长度后才可被复用
+     * 在 {@link AliEngineEventListener} 的对应回调中调用 Update，或通过
+     * {@link AliEngineEventDispatcher::SetStatsHistogram} 在投递前记录
+     */
+    class AliEngineStatsHistogram {
+    public:
+      explicit AliEngineStatsHistogram(const AliEngineStatsHistogramConfig &config = AliEngineStatsHistogramConfig())
+        : config_(Validate(config)),
+          sliceMs_(config_.windowMs / config_.windowSlices),
+          histograms_(static_cast<size_t>(config_.maxHistograms)),
+          slices_(static_cast<size_t>(config_.maxHistograms) * config_.windowSlices),
+          counts_(static_cast<size_t>(config_.maxHistograms) * config_.windowSlices * kBuckets)
+      {
+        dropped_.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < counts_.size(); ++i) {
+          counts_[i].store(0, std::memory_order_relaxed);
+        }
+      }
+
+      /**
+       * @brief 记录一个样本
+       * @param metric 指标
+       * @param uid 远端用户ID，全局指标传nullptr
+       * @param value 样本值，单位：ms，负数按0记录
+       */
+      void Record(AliEngineStatsMetric metric, const char* uid, long long value)
+      {
+        const int index = Acquire(metric, uid);
+        if (index < 0) {
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        RecordAt(index, value, NowMs());
+      }
+
+      /** @brief 在 OnStats 回调中调用，记录 lastmileDelay */
+      void Update(const AliEngineStats &stats)
+      {
+        Record(AliEngineStatsMetricLastmileDelay, nullptr, stats.lastmileDelay);
+      }
+
+      /** @brief 在 OnLastmileDetectResultWithBandWidth 回调中调用，记录 rtt */
+      void Update(const AliEngineNetworkProbeResult &result)
+      {
+        Record(AliEngineStatsMetricRtt, nullptr, result.rtt);
+      }
+
+      /** @brief 在 OnRemoteAudioStats 回调中调用，记录 jitterBufferDelay 与 networkTransportDelay */
+      void Update(const AliEngineRemoteAudioStats &stats)
+      {
+        if (!stats.userId) {
+          return;
+        }
+        Record(AliEngineStatsMetricJitterBufferDelay, stats.userId, stats.jitterBufferDelay);
+        Record(AliEngineStatsMetricNetworkTransportDelay, stats.userId, stats.networkTransportDelay);
+      }
+
+      /**
+       * @brief 在 OnRemoteVideoStats 回调中调用
+       * @details videoTotalFrozenTime 为累计值，按相机流、屏幕流分别记录两次统计之间的增量
+       */
+      void Update(const AliEngineRemoteVideoStats &stats)
+      {
+        const int track = stats.track == AliEngineVideoTrackCamera ? 0 : (stats.track == AliEngineVideoTrackScreen ? 1 : -1);
+        if (!stats.userId || track < 0) {
+          return;
+        }
+        const int index = Acquire(AliEngineStatsMetricVideoFrozenTime, stats.userId);
+        if (index < 0) {
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        const long long total = stats.videoTotalFrozenTime;
+        const long long last = histograms_[index].lastTotal[track].exchange(total, std::memory_order_relaxed);
+        if (last >= 0 && total >= last) {
+          RecordAt(index, total - last, NowMs());
+        }
+      }
+
+      /**
+       * @brief 在 OnRemoteUserOffLineNotify 回调中调用
+       * @details 该用户的直方图在一个窗口长度内仍可查询，之后可被复用
+       */
+      void RemoveUser(const char* uid)
+      {
+        if (!uid || !*uid) {
+          return;
+        }
+        std::lock_guard<std::mutex> guard(registerLock_);
+        const long long now = NowMs();
+        for (size_t i = 0; i < histograms_.size(); ++i) {
+          Histogram &histogram = histograms_[i];
+          if (histogram.state.load(std::memory_order_relaxed) == kLive && Matches(histogram, static_cast<AliEngineStatsMetric>(histogram.metric), uid, true)) {
+            histogram.retiredMs = now;
+            histogram.state.store(kRetired, std::memory_order_release);
+          }
+        }
+      }
+
+      /**
+       * @brief 查询最近 windowMs 内的分位数
+       * @param metric 指标
+       * @param uid 远端用户ID，全局指标传nullptr
+       * @param windowMs 查询窗口，按时间片向上取整，不超过配置的窗口长度
+       * @param result 查询结果
+       * @return 窗口内有样本时返回 true
+       */
+      bool GetPercentiles(AliEngineStatsMetric metric, const char* uid, int windowMs, AliEngineStatsPercentiles &result) const
+      {
+        result = AliEngineStatsPercentiles();
+        const int index = Find(metric, uid, true, false);
+        if (index < 0) {
+          return false;
+        }
+        int used = (windowMs + sliceMs_ - 1) / sliceMs_;
+        used = used < 1 ? 1 : (used > config_.windowSlices ? config_.windowSlices : used);
+        const long long epoch = NowMs() / sliceMs_;
+        unsigned long long merged[kBuckets] = {0};
+        unsigned long long count = 0;
+        long long sum = 0;
+        int max = 0;
+        for (int s = 0; s < config_.windowSlices; ++s) {
+          const Slice &slice = slices_[static_cast<size_t>(index) * config_.windowSlices + s];
+          const long long sliceEpoch = slice.epoch.load(std::memory_order_acquire);
+          if (sliceEpoch < 0 || sliceEpoch > epoch || sliceEpoch <= epoch - used) {
+            continue;
+          }
+          const std::atomic<unsigned>* counts = Counts(index, s);
+          for (int b = 0; b < kBuckets; ++b) {
+            merged[b] += counts[b].load(std::memory_order_relaxed);
+          }
+          count += slice.count.load(std::memory_order_relaxed);
+          sum += slice.sum.load(std::memory_order_relaxed);
+          const int sliceMax = slice.max.load(std::memory_order_relaxed);
+          max = sliceMax > max ? sliceMax : max;
+        }
+        result.windowMs = used * sliceMs_;
+        if (count == 0) {
+          return false;
+        }
+        result.count = static_cast<unsigned int>(count);
+        result.max = max;
+        result.mean = static_cast<int>(sum / static_cast<long long>(count));
+        result.p50 = Percentile(merged, count, 50, max);
+        result.p95 = Percentile(merged, count, 95, max);
+        result.p99 = Percentile(merged, count, 99, max);
+        return true;
+      }
+
+      /** @brief 因直方图已满或时间片正在清零而未记录的样本数 */
+      unsigned long long GetDroppedCount() const
+      {
+        return dropped_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      AliEngineStatsHistogram(const AliEngineStatsHistogram&);
+      AliEngineStatsHistogram& operator=(const AliEngineStatsHistogram&);
+
+      enum {
+        kLinearBuckets = 32,
+        kSubBuckets = 16,
+        kSubBits = 4,
+        kMaxExponent = 15,
+        kBuckets = kLinearBuckets + (kMaxExponent - 4) * kSubBuckets,
+        kMaxValue = 65535,
+        kMaxSlices = 60,
+        kMaxHistograms = 1024,
+        kEmpty = 0,
+        kLive = 1,
+        kRetired = 2,
+        /* 复用前的登记中状态，记录路径不会命中 */
+        kClaiming = 3,
+      };
+
+      struct Histogram {
+        std::atomic<int> state;
+        std::atomic<unsigned long long> hash;
+        /* 以下在 registerLock_ 内写入，state 置为 kLive 后只读 */
+        int metric = 0;
+        /* uid 前 63 个字符与完整长度，无锁比较用 */
+        char uid[64] = {0};
+        size_t uidLength = 0;
+        /* 超过 63 个字符的完整 uid，只在 registerLock_ 内读写 */
+        std::string longUid;
+        long long retiredMs = 0;
+        /* 卡顿时长的上一次累计值，-1 表示尚未收到 */
+        std::atomic<long long> lastTotal[2];
+
+        Histogram() : state(kEmpty), hash(0)
+        {
+          lastTotal[0].store(-1, std::memory_order_relaxed);
+          lastTotal[1].store(-1, std::memory_order_relaxed);
+        }
+      };
+
+      /* epoch 为 -1 表示正在清零 */
+      struct Slice {
+        std::atomic<long long> epoch;
+        std::atomic<unsigned> count;
+        std::atomic<long long> sum;
+        std::atomic<int> max;
+
+        Slice() : epoch(-2), count(0), sum(0), max(0) {}
+      };
+
+      static AliEngineStatsHistogramConfig Validate(AliEngineStatsHistogramConfig config)
+      {
+        config.windowSlices = config.windowSlices < 1 ? 1 : (config.windowSlices > kMaxSlices ? kMaxSlices : config.windowSlices);
+        config.windowMs = config.windowMs < config.windowSlices ? config.windowSlices : config.windowMs;
+        config.maxHistograms = config.maxHistograms < 1 ? 1 : (config.maxHistograms > kMaxHistograms ? kMaxHistograms : config.maxHistograms);
+        return config;
+      }
+
+      static long long NowMs()
+      {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      static unsigned long long Hash(AliEngineStatsMetric metric, const char* uid)
+      {
+        unsigned long long hash = 14695981039346656037ULL ^ static_cast<unsigned long long>(metric);
+        for (const char* p = uid ? uid : ""; *p; ++p) {
+          hash = (hash ^ static_cast<unsigned char>(*p)) * 1099511628211ULL;
+        }
+        return hash ? hash : 1;
+      }
+
+      static int BucketIndex(long long value)
+      {
+        unsigned v = static_cast<unsigned>(value < 0 ? 0 : (value > static_cast<long long>(kMaxValue) ? static_cast<long long>(kMaxValue) : value));
+        if (v < kLinearBuckets) {
+          return static_cast<int>(v);
+        }
+        int exponent = 0;
+        while ((v >> (exponent + 1)) != 0) {
+          ++exponent;
+        }
+        return kLinearBuckets + (exponent - 5) * kSubBuckets + static_cast<int>((v >> (exponent - kSubBits)) - kSubBuckets);
+      }
+
+      static int BucketUpperBound(int index)
+      {
+        if (index < kLinearBuckets) {
+          return index;
+        }
+        const int exponent = 5 + (index - kLinearBuckets) / kSubBuckets;
+        const int mantissa = kSubBuckets + (index - kLinearBuckets) % kSubBuckets;
+        return ((mantissa + 1) << (exponent - kSubBits)) - 1;
+      }
+
+      static int Percentile(const unsigned long long* merged, unsigned long long count, int percentile, int max)
+      {
+        const unsigned long long rank = (count * percentile + 99) / 100;
+        unsigned long long seen = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+          seen += merged[b];
+          if (seen >= rank && merged[b] != 0) {
+            const int bound = BucketUpperBound(b);
+            return bound < max ? bound : max;
+          }
+        }
+        return max;
+      }
+
+      std::atomic<unsigned>* Counts(int index, int slice)
+      {
+        return &counts_[(static_cast<size_t>(index) * config_.windowSlices + slice) * kBuckets];
+      }
+
+      const std::atomic<unsigned>* Counts(int index, int slice) const
+      {
+        return &counts_[(static_cast<size_t>(index) * config_.windowSlices + slice) * kBuckets];
+      }
+
+      /* 无锁查找；includeRetired 为 true 时也返回已下线但尚未复用的直方图，locked 表示调用方已持有 registerLock_ */
+      int Find(AliEngineStatsMetric metric, const char* uid, bool includeRetired, bool locked) const
+      {
+        const unsigned long long hash = Hash(metric, uid);
+        const size_t size = histograms_.size();
+        for (size_t n = 0, i = hash % size; n < size; ++n, i = i + 1 == size ? 0 : i + 1) {
+          const Histogram &histogram = histograms_[i];
+          if (histogram.hash.load(std::memory_order_relaxed) != hash) {
+            continue;
+          }
+          const int state = histogram.state.load(std::memory_order_acquire);
+          if ((state == kLive || (includeRetired && state == kRetired)) &&
+              Matches(histogram, metric, uid, locked)) {
+            return static_cast<int>(i);
+          }
+        }
+        return -1;
+      }
+
+      /* 前缀与长度相同且 uid 不超过 63 个字符时直接判定；更长的 uid 需加锁比较完整值 */
+      bool Matches(const Histogram &histogram, AliEngineStatsMetric metric, const char* uid, bool locked) const
+      {
+        const char* key = uid ? uid : "";
+        const size_t length = strlen(key);
+        if (histogram.metric != metric || histogram.uidLength != length ||
+            strncmp(histogram.uid, key, sizeof(histogram.uid) - 1) != 0) {
+          return false;
+        }
+        if (length < sizeof(histogram.uid)) {
+          return true;
+        }
+        if (locked) {
+          return histogram.longUid == key;
+        }
+        std::lock_guard<std::mutex> guard(registerLock_);
+        return histogram.longUid == key;
+      }
+
+      int Acquire(AliEngineStatsMetric metric, const char* uid)
+      {
+        if (static_cast<int>(metric) < 0 || static_cast<int>(metric) >= AliEngineStatsMetricCount) {
+          return -1;
+        }
+        const int found = Find(metric, uid, false, false);
+        if (found >= 0) {
+          return found;
+        }
+        return Register(metric, uid);
+      }
+
+      /* 新 uid 登记，使用空位置或下线超过一个窗口的直方图 */
+      int Register(AliEngineStatsMetric metric, const char* uid)
+      {
+        std::lock_guard<std::mutex> guard(registerLock_);
+        const int found = Find(metric, uid, false, true);
+        if (found >= 0) {
+          return found;
+        }
+        const long long now = NowMs();
+        int index = -1;
+        const size_t size = histograms_.size();
+        for (size_t n = 0, i = Hash(metric, uid) % size; n < size; ++n, i = i + 1 == size ? 0 : i + 1) {
+          const int state = histograms_[i].state.load(std::memory_order_relaxed);
+          if (state == kEmpty) {
+            index = static_cast<int>(i);
+            break;
+          }
+          if (state == kRetired && now - histograms_[i].retiredMs >= config_.windowMs &&
+              (index < 0 || histograms_[i].retiredMs < histograms_[index].retiredMs)) {
+            index = static_cast<int>(i);
+          }
+        }
+        if (index < 0) {
+          return -1;
+        }
+        Histogram &histogram = histograms_[index];
+        histogram.state.store(kClaiming, std::memory_order_relaxed);
+        histogram.hash.store(Hash(metric, uid), std::memory_order_relaxed);
+        histogram.metric = metric;
+        const char* key = uid ? uid : "";
+        histogram.uidLength = strlen(key);
+        strncpy(histogram.uid, key, sizeof(histogram.uid) - 1);
+        histogram.uid[sizeof(histogram.uid) - 1] = '\0';
+        if (histogram.uidLength < sizeof(histogram.uid)) {
+          histogram.longUid.clear();
+        } else {
+          histogram.longUid = key;
+        }
+        histogram.lastTotal[0].store(-1, std::memory_order_relaxed);
+        histogram.lastTotal[1].store(-1, std::memory_order_relaxed);
+        for (int s = 0; s < config_.windowSlices; ++s) {
+          slices_[static_cast<size_t>(index) * config_.windowSlices + s].epoch.store(-2, std::memory_order_relaxed);
+        }
+        histogram.state.store(kLive, std::memory_order_release);
+        return index;
+      }
+
+      void RecordAt(int index, long long value, long long nowMs)
+      {
+        const long long epoch = nowMs / sliceMs_;
+        const int s = static_cast<int>(epoch % config_.windowSlices);
+        Slice &slice = slices_[static_cast<size_t>(index) * config_.windowSlices + s];
+        std::atomic<unsigned>* counts = Counts(index, s);
+        long long current = slice.epoch.load(std::memory_order_acquire);
+        if (current != epoch) {
+          /* 时间片过期：首个写入者清零，其余写入者在清零期间丢弃样本 */
+          if (current == -1 || current > epoch ||
+              !slice.epoch.compare_exchange_strong(current, -1, std::memory_order_acq_rel)) {
+            if (slice.epoch.load(std::memory_order_acquire) != epoch) {
+              dropped_.fetch_add(1, std::memory_order_relaxed);
+              return;
+            }
+          } else {
+            for (int b = 0; b < kBuckets; ++b) {
+              counts[b].store(0, std::memory_order_relaxed);
+            }
+            slice.count.store(0, std::memory_order_relaxed);
+            slice.sum.store(0, std::memory_order_relaxed);
+            slice.max.store(0, std::memory_order_relaxed);
+            slice.epoch.store(epoch, std::memory_order_release);
+          }
+        }
+        const int clamped = static_cast<int>(value < 0 ? 0 : (value > 0x7FFFFFFF ? 0x7FFFFFFF : value));
+        counts[BucketIndex(clamped)].fetch_add(1, std::memory_order_relaxed);
+        slice.count.fetch_add(1, std::memory_order_relaxed);
+        slice.sum.fetch_add(clamped, std::memory_order_relaxed);
+        int max = slice.max.load(std::memory_order_relaxed);
+        while (clamped > max && !slice.max.compare_exchange_weak(max, clamped, std::memory_order_relaxed)) {
+        }
+      }
+
+      const AliEngineStatsHistogramConfig config_;
+      const int sliceMs_;
+      std::vector<Histogram> histograms_;
+      std::vector<Slice> slices_;
+      std::vector<std::atomic<unsigned>> counts_;
+      std::atomic<unsigned long long> dropped_;
+      /* 仅用于新 uid 登记和下线，记录与查询路径不获取 */
+      mutable std::mutex registerLock_;
+    };
+}
+
+#endif /* ali_rtc_engine_stats_histogram_h */
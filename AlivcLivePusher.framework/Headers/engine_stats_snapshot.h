@@ -0,0 +1,408 @@
+#ifndef ali_rtc_engine_stats_snapshot_h
+#define ali_rtc_engine_stats_snapshot_h
+
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "engine_interface.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 统计快照配置
+     */
+    typedef struct AliEngineStatsSnapshotConfig {
+      /** 同时保存的远端用户数上限，下线用户的位置可复用，默认值：64，取值范围：[1, 1024] */
+      int maxRemoteUsers = 64;
+    } AliEngineStatsSnapshotConfig;
+
+    /**
+     * @brief 单个远端用户的统计快照
+     * @details 下标0为相机流/麦克风流，下标1为屏幕流/Dual流；stats 中的 userId 指向本结构体的 userId
+     */
+    typedef struct AliEngineRemoteStatsSnapshot {
+      /** 用户ID，超过63字节时截断；按uid查询和区分用户时使用完整uid */
+      char userId[64] = {0};
+      /** 是否在线，收到下线通知后为false，直到该位置被其他用户复用 */
+      bool online = false;
+      /** 对应视频流是否收到过统计 */
+      bool hasVideo[2] = {false, false};
+      /** 远端视频统计 */
+      AliEngineRemoteVideoStats video[2];
+      /** 对应音频流是否收到过统计 */
+      bool hasAudio[2] = {false, false};
+      /** 远端音频统计 */
+      AliEngineRemoteAudioStats audio[2];
+      /** 最近一次更新的时间，steady clock，单位：ms */
+      long long updateTimeMs = 0;
+    } AliEngineRemoteStatsSnapshot;
+
+    /**
+     * @}
+     */
+
+    namespace internal {
+      /**
+       * @brief 单写多读的 seqlock 存储
+       * @details 数据以原子字存放，读者不加锁、不分配内存：序号为奇数或前后不一致时重读，
+       * 重读次数有上限，写入远慢于读取时几乎总是一次读成；写者之间需由调用方串行化
+       */
+      template <typename T>
+      class SeqlockCell {
+      public:
+        SeqlockCell() : seq_(0)
+        {
+          for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(0, std::memory_order_relaxed);
+          }
+        }
+
+        void Store(const T &value)
+        {
+          unsigned long long buffer[kWords] = {0};
+          memcpy(buffer, &value, sizeof(T));
+          const unsigned seq = seq_.load(std::memory_order_relaxed);
+          seq_.store(seq + 1, std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_release);
+          for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+          }
+          seq_.store(seq + 2, std::memory_order_release);
+        }
+
+        /* 写入过且读到一致的数据时返回 true */
+        bool Load(T &value, int maxRetries = 64) const
+        {
+          unsigned long long buffer[kWords];
+          for (int attempt = 0; attempt < maxRetries; ++attempt) {
+            const unsigned before = seq_.load(std::memory_order_acquire);
+            if (before == 0) {
+              return false;
+            }
+            if (before & 1) {
+              continue;
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+              buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) {
+              memcpy(&value, buffer, sizeof(T));
+              return true;
+            }
+          }
+          return false;
+        }
+
+      private:
+        SeqlockCell(const SeqlockCell&);
+        SeqlockCell& operator=(const SeqlockCell&);
+
+        static_assert(std::is_trivially_copyable<T>::value, "SeqlockCell requires a trivially copyable type");
+        enum { kWords = (sizeof(T) + sizeof(unsigned long long) - 1) / sizeof(unsigned long long) };
+
+        std::atomic<unsigned> seq_;
+        std::atomic<unsigned long long> words_[kWords];
+      };
+    }
+
+    /**
+     * @brief 引擎统计的拉取式快照
+     * @details 引擎按固定周期通过回调推送 AliEngineStats、本地/远端音视频统计；本类保存每路最新值，
+     * 供监控模块在任意线程按自己的频率拉取：
+     *  - 每个条目（通话统计、每路本地流、每个远端用户）各有一个 seqlock，读取不加锁、不分配内存
+     *  - 远端用户表在构造时按 maxRemoteUsers 分配，之后不再分配；下线用户的位置可被新用户复用
+     *  - 写入由引擎回调线程调用，写者之间用互斥量串行化，不影响读者
+     * 在 {@link AliEngineEventListener} 的对应回调中调用 Update，或通过
+     * {@link AliEngineEventDispatcher::SetStatsSnapshot} 在投递前更新
+     */
+    class AliEngineStatsSnapshot {
+    public:
+      explicit AliEngineStatsSnapshot(const AliEngineStatsSnapshotConfig &config = AliEngineStatsSnapshotConfig())
+        : users_(static_cast<size_t>(Validate(config).maxRemoteUsers)), writer_(users_.size()), keys_(users_.size())
+      {
+      }
+
+      /** @brief 在 OnStats 回调中调用 */
+      void Update(const AliEngineStats &stats)
+      {
+        std::lock_guard<std::mutex> guard(writeLock_);
+        stats_.Store(stats);
+      }
+
+      /** @brief 在 OnLocalVideoStats 回调中调用，仅保存相机流和屏幕流 */
+      void Update(const AliEngineLocalVideoStats &stats)
+      {
+        const int index = VideoIndex(stats.track);
+        if (index < 0) {
+          return;
+        }
+        std::lock_guard<std::mutex> guard(writeLock_);
+        localVideo_[index].Store(stats);
+      }
+
+      /** @brief 在 OnLocalAudioStats 回调中调用，仅保存麦克风流和Dual流 */
+      void Update(const AliEngineLocalAudioStats &stats)
+      {
+        const int index = AudioIndex(stats.track);
+        if (index < 0) {
+          return;
+        }
+        std::lock_guard<std::mutex> guard(writeLock_);
+        localAudio_[index].Store(stats);
+      }
+
+      /** @brief 在 OnRemoteVideoStats 回调中调用；远端用户表已满时忽略 */
+      void Update(const AliEngineRemoteVideoStats &stats)
+      {
+        const int index = VideoIndex(stats.track);
+        if (index < 0 || !stats.userId) {
+          return;
+        }
+        std::lock_guard<std::mutex> guard(writeLock_);
+        const int slot = Acquire(stats.userId);
+        if (slot < 0) {
+          return;
+        }
+        AliEngineRemoteStatsSnapshot &user = writer_[slot];
+        user.video[index] = stats;
+        user.video[index].userId = nullptr;
+        user.hasVideo[index] = true;
+        Commit(slot);
+      }
+
+      /** @brief 在 OnRemoteAudioStats 回调中调用；远端用户表已满时忽略 */
+      void Update(const AliEngineRemoteAudioStats &stats)
+      {
+        const int index = AudioIndex(stats.track);
+        if (index < 0 || !stats.userId) {
+          return;
+        }
+        std::lock_guard<std::mutex> guard(writeLock_);
+        const int slot = Acquire(stats.userId);
+        if (slot < 0) {
+          return;
+        }
+        AliEngineRemoteStatsSnapshot &user = writer_[slot];
+        user.audio[index] = stats;
+        user.audio[index].userId = nullptr;
+        user.hasAudio[index] = true;
+        Commit(slot);
+      }
+
+      /**
+       * @brief 在 OnRemoteUserOffLineNotify 回调中调用
+       * @details 用户标记为离线，最后一次统计仍可读取，直到该位置被新用户复用
+       */
+      void RemoveUser(const char* uid)
+      {
+        if (!uid) {
+          return;
+        }
+        std::lock_guard<std::mutex> guard(writeLock_);
+        const int index = Find(uid);
+        if (index < 0) {
+          return;
+        }
+        writer_[index].online = false;
+        users_[index].online.store(false, std::memory_order_relaxed);
+        users_[index].cell.Store(writer_[index]);
+      }
+
+      /** @brief 读取最近一次通话统计，尚未收到时返回 false */
+      bool GetStats(AliEngineStats &stats) const
+      {
+        return stats_.Load(stats);
+      }
+
+      /** @brief 读取本地视频流统计，track 为 AliEngineVideoTrackCamera 或 AliEngineVideoTrackScreen */
+      bool GetLocalVideoStats(AliEngineVideoTrack track, AliEngineLocalVideoStats &stats) const
+      {
+        const int index = VideoIndex(track);
+        return index >= 0 && localVideo_[index].Load(stats);
+      }
+
+      /** @brief 读取本地音频流统计，track 为 AliEngineAudioTrackMic 或 AliEngineAudioTrackDual */
+      bool GetLocalAudioStats(AliEngineAudioTrack track, AliEngineLocalAudioStats &stats) const
+      {
+        const int index = AudioIndex(track);
+        return index >= 0 && localAudio_[index].Load(stats);
+      }
+
+      /** @brief 读取指定远端用户的统计，包括已下线但位置尚未复用的用户 */
+      bool GetRemoteStats(const char* uid, AliEngineRemoteStatsSnapshot &snapshot) const
+      {
+        if (!uid) {
+          return false;
+        }
+        const unsigned long long hash = Hash(uid);
+        for (size_t i = 0; i < users_.size(); ++i) {
+          if (users_[i].hash.load(std::memory_order_acquire) != hash) {
+            continue;
+          }
+          if (users_[i].cell.Load(snapshot) && MatchesStoredUid(snapshot.userId, uid)) {
+            FixUp(snapshot);
+            return true;
+          }
+        }
+        return false;
+      }
+
+      /**
+       * @brief 读取所有在线远端用户的统计
+       * @param snapshots 调用方提供的数组
+       * @param capacity 数组长度
+       * @return 写入的用户数
+       */
+      int GetRemoteStatsList(AliEngineRemoteStatsSnapshot* snapshots, int capacity) const
+      {
+        int count = 0;
+        for (size_t i = 0; i < users_.size() && count < capacity; ++i) {
+          if (!users_[i].online.load(std::memory_order_acquire)) {
+            continue;
+          }
+          if (users_[i].cell.Load(snapshots[count]) && snapshots[count].online) {
+            FixUp(snapshots[count]);
+            ++count;
+          }
+        }
+        return count;
+      }
+
+    private:
+      AliEngineStatsSnapshot(const AliEngineStatsSnapshot&);
+      AliEngineStatsSnapshot& operator=(const AliEngineStatsSnapshot&);
+
+      enum { kMaxRemoteUsers = 1024 };
+
+      struct RemoteEntry {
+        /* 读者按 uid 哈希快速筛选，0 为空位置 */
+        std::atomic<unsigned long long> hash;
+        std::atomic<bool> online;
+        internal::SeqlockCell<AliEngineRemoteStatsSnapshot> cell;
+
+        RemoteEntry() : hash(0), online(false) {}
+      };
+
+      static AliEngineStatsSnapshotConfig Validate(AliEngineStatsSnapshotConfig config)
+      {
+        config.maxRemoteUsers = config.maxRemoteUsers < 1 ? 1 : config.maxRemoteUsers;
+        config.maxRemoteUsers = config.maxRemoteUsers > kMaxRemoteUsers ? kMaxRemoteUsers : config.maxRemoteUsers;
+        return config;
+      }
+
+      static int VideoIndex(AliEngineVideoTrack track)
+      {
+        return track == AliEngineVideoTrackCamera ? 0 : (track == AliEngineVideoTrackScreen ? 1 : -1);
+      }
+
+      static int AudioIndex(AliEngineAudioTrack track)
+      {
+        return track == AliEngineAudioTrackMic ? 0 : (track == AliEngineAudioTrackDual ? 1 : -1);
+      }
+
+      static unsigned long long Hash(const char* uid)
+      {
+        unsigned long long hash = 14695981039346656037ULL;
+        for (const char* p = uid; *p; ++p) {
+          hash = (hash ^ static_cast<unsigned char>(*p)) * 1099511628211ULL;
+        }
+        return hash ? hash : 1;
+      }
+
+      static long long NowMs()
+      {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /* 快照中的 userId 是截断后的 uid，完整 uid 已由哈希区分，这里按同样方式截断后比较 */
+      static bool MatchesStoredUid(const char* stored, const char* uid)
+      {
+        const size_t limit = sizeof(AliEngineRemoteStatsSnapshot().userId) - 1;
+        return strncmp(stored, uid, limit) == 0 && strlen(stored) == strnlen(uid, limit);
+      }
+
+      static void FixUp(AliEngineRemoteStatsSnapshot &snapshot)
+      {
+        for (int i = 0; i < 2; ++i) {
+          snapshot.video[i].userId = snapshot.userId;
+          snapshot.audio[i].userId = snapshot.userId;
+        }
+      }
+
+      /* 以下均在 writeLock_ 内调用 */
+      int Find(const char* uid) const
+      {
+        const unsigned long long hash = Hash(uid);
+        for (size_t i = 0; i < users_.size(); ++i) {
+          if (users_[i].hash.load(std::memory_order_relaxed) == hash && keys_[i] == uid) {
+            return static_cast<int>(i);
+          }
+        }
+        return -1;
+      }
+
+      /* 返回用户位置，新用户占用空位置或最早下线用户的位置，已满时返回 -1 */
+      int Acquire(const char* uid)
+      {
+        int index = Find(uid);
+        if (index < 0) {
+          long long oldest = 0;
+          for (size_t i = 0; i < users_.size(); ++i) {
+            if (users_[i].hash.load(std::memory_order_relaxed) == 0) {
+              index = static_cast<int>(i);
+              break;
+            }
+            if (!writer_[i].online && (index < 0 || writer_[i].updateTimeMs < oldest)) {
+              index = static_cast<int>(i);
+              oldest = writer_[i].updateTimeMs;
+            }
+          }
+          if (index < 0) {
+            return -1;
+          }
+          writer_[index] = AliEngineRemoteStatsSnapshot();
+          strncpy(writer_[index].userId, uid, sizeof(writer_[index].userId) - 1);
+          keys_[index] = uid;
+          writer_[index].online = true;
+          users_[index].hash.store(Hash(uid), std::memory_order_release);
+        }
+        return index;
+      }
+
+      void Commit(int index)
+      {
+        writer_[index].online = true;
+        writer_[index].updateTimeMs = NowMs();
+        users_[index].cell.Store(writer_[index]);
+        users_[index].online.store(true, std::memory_order_release);
+      }
+
+      internal::SeqlockCell<AliEngineStats> stats_;
+      internal::SeqlockCell<AliEngineLocalVideoStats> localVideo_[2];
+      internal::SeqlockCell<AliEngineLocalAudioStats> localAudio_[2];
+      std::vector<RemoteEntry> users_;
+      std::mutex writeLock_;
+      /* 写者侧的每用户副本，只在 writeLock_ 内访问 */
+      std::vector<AliEngineRemoteStatsSnapshot> writer_;
+      /* 完整 uid，写者查找用，快照中的 userId 可能被截断 */
+      std::vector<std::string> keys_;
+    };
+}
+
+#endif /* ali_rtc_engine_stats_snapshot_h */
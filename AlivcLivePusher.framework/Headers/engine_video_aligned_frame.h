@@ -0,0 +1,384 @@
+#ifndef ali_rtc_engine_video_aligned_frame_h
+#define ali_rtc_engine_video_aligned_frame_h
+
+#include <string.h>
+#include <mutex>
+
+#include "engine_simd_utils.h"
+#include "engine_media_engine.h"
+#include "engine_video_convert.h"
+
+/**
+ * @brief 平面起始地址对齐字节数
+ */
+#define kAliEngineVideoPlaneBaseAlignment 64
+
+/**
+ * @brief 每个平面末尾保证可读的填充字节数
+ * @details 从平面内任意像素开始读取不超过该字节数的数据不会越界，SIMD滤波可直接整块读取行尾，无需标量收尾
+ */
+#define kAliEngineVideoPlaneTailPadding 64
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 对齐后的帧内存布局
+     */
+    typedef struct AliEngineVideoAlignedLayout {
+      /** 打包格式stride，或Y平面stride */
+      int strideY = 0;
+      /** U平面（NV12/NV21为交错色度平面）stride */
+      int strideU = 0;
+      /** V平面stride */
+      int strideV = 0;
+      /** 各平面相对起始地址的偏移 */
+      int offsetY = 0;
+      int offsetU = 0;
+      int offsetV = 0;
+      /** 总字节数，包含每个平面的尾部填充 */
+      int totalSize = 0;
+    } AliEngineVideoAlignedLayout;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 对齐方式对应的字节数
+     * @param alignment 对齐方式，详见 {@link AliEngineVideoObserAlignment}
+     * @return 1、2、4、8 或 16
+     */
+    inline int AliEngineVideoAlignmentBytes(AliEngineVideoObserAlignment alignment)
+    {
+      switch (alignment) {
+        case AliEngineAlignmentEven: return 2;
+        case AliEngineAlignment4: return 4;
+        case AliEngineAlignment8: return 8;
+        case AliEngineAlignment16: return 16;
+        default: return 1;
+      }
+    }
+
+    /**
+     * @brief 计算对齐布局
+     * @details 每个平面的起始偏移对齐到 {@link kAliEngineVideoPlaneBaseAlignment}，stride 对齐到 strideAlignment，
+     * 每个平面末尾保留 {@link kAliEngineVideoPlaneTailPadding} 字节
+     * @param format 视频格式，仅支持裸数据格式
+     * @param width 宽
+     * @param height 高
+     * @param strideAlignment stride对齐字节数，必须为2的幂
+     * @param layout 输出布局
+     * @return true: 成功；false: 参数错误或格式不支持
+     */
+    inline bool AliEngineVideoComputeAlignedLayout(AliEngineVideoFormat format, int width, int height,
+                                                   int strideAlignment, AliEngineVideoAlignedLayout &layout)
+    {
+      if (width <= 0 || height <= 0 || strideAlignment <= 0 || (strideAlignment & (strideAlignment - 1)) != 0) {
+        return false;
+      }
+      const size_t align = static_cast<size_t>(strideAlignment);
+      const size_t base = kAliEngineVideoPlaneBaseAlignment;
+      const size_t pad = kAliEngineVideoPlaneTailPadding;
+      layout = AliEngineVideoAlignedLayout();
+      const int bpp = internal::PackedBytesPerPixel(format);
+      if (bpp > 0) {
+        layout.strideY = static_cast<int>(internal::AlignUp(static_cast<size_t>(width) * bpp, align));
+        layout.totalSize = static_cast<int>(internal::AlignUp(static_cast<size_t>(layout.strideY) * height + pad, base));
+        return true;
+      }
+      if (!internal::IsYuvFormat(format)) {
+        return false;
+      }
+      const size_t cw = static_cast<size_t>(width + 1) / 2;
+      const size_t ch = format == AliEngineVideoFormatI422 ? height : (height + 1) / 2;
+      const bool semiPlanar = internal::IsSemiPlanarFormat(format);
+      layout.strideY = static_cast<int>(internal::AlignUp(width, align));
+      layout.strideU = static_cast<int>(internal::AlignUp(semiPlanar ? cw * 2 : cw, align));
+      layout.strideV = semiPlanar ? 0 : static_cast<int>(internal::AlignUp(cw, align));
+      size_t offset = internal::AlignUp(static_cast<size_t>(layout.strideY) * height + pad, base);
+      layout.offsetU = static_cast<int>(offset);
+      offset = internal::AlignUp(offset + static_cast<size_t>(layout.strideU) * ch + pad, base);
+      if (!semiPlanar) {
+        layout.offsetV = static_cast<int>(offset);
+        offset = internal::AlignUp(offset + static_cast<size_t>(layout.strideV) * ch + pad, base);
+      }
+      layout.totalSize = static_cast<int>(offset);
+      return true;
+    }
+
+    /**
+     * @brief 按对齐布局把一块内存绑定到视频裸数据上
+     * @param frame 视频裸数据
+     * @param buffer 内存地址，需按 {@link kAliEngineVideoPlaneBaseAlignment} 对齐，大小至少为 layout.totalSize
+     * @param format 视频格式
+     * @param width 宽
+     * @param height 高
+     * @param layout 由 {@link AliEngineVideoComputeAlignedLayout} 计算的布局
+     */
+    inline void AliEngineVideoFrameAttachAlignedBuffer(AliEngineVideoRawData &frame, void* buffer,
+                                                       AliEngineVideoFormat format, int width, int height,
+                                                       const AliEngineVideoAlignedLayout &layout)
+    {
+      uint8_t* base = static_cast<uint8_t*>(buffer);
+      frame.format = format;
+      frame.type = AliEngineBufferTypeRawData;
+      frame.width = width;
+      frame.height = height;
+      frame.dataLength = layout.totalSize;
+      frame.dataPtr = base;
+      frame.dataYPtr = frame.dataUPtr = frame.dataVPtr = nullptr;
+      frame.strideY = frame.strideU = frame.strideV = frame.stride = 0;
+      if (internal::PackedBytesPerPixel(format) > 0) {
+        frame.stride = layout.strideY;
+        return;
+      }
+      frame.dataYPtr = base + layout.offsetY;
+      frame.strideY = layout.strideY;
+      frame.dataUPtr = base + layout.offsetU;
+      frame.strideU = layout.strideU;
+      if (!internal::IsSemiPlanarFormat(format)) {
+        frame.dataVPtr = base + layout.offsetV;
+        frame.strideV = layout.strideV;
+      }
+    }
+
+    /**
+     * @brief 判断帧的平面起始地址和stride是否满足对齐要求
+     * @param frame 视频裸数据
+     * @param baseAlignment 起始地址对齐字节数
+     * @param strideAlignment stride对齐字节数
+     * @note 尾部填充无法从帧数据本身判断，SDK输出的帧需经 {@link AliEngineAlignedVideoFrameObserver} 处理后才保证填充
+     */
+    inline bool AliEngineVideoFrameIsAligned(const AliEngineVideoRawData &frame, int baseAlignment, int strideAlignment)
+    {
+      internal::VideoPlanes planes;
+      if (!internal::ResolveVideoPlanes(frame, planes) || baseAlignment <= 0 || strideAlignment <= 0) {
+        return false;
+      }
+      const uintptr_t ba = static_cast<uintptr_t>(baseAlignment);
+      const int sa = strideAlignment;
+      if (planes.packed) {
+        return reinterpret_cast<uintptr_t>(planes.packed) % ba == 0 && planes.stride % sa == 0;
+      }
+      bool aligned = reinterpret_cast<uintptr_t>(planes.y) % ba == 0 && planes.strideY % sa == 0 &&
+                     reinterpret_cast<uintptr_t>(planes.u) % ba == 0 && planes.strideU % sa == 0;
+      if (!internal::IsSemiPlanarFormat(frame.format)) {
+        aligned = aligned && reinterpret_cast<uintptr_t>(planes.v) % ba == 0 && planes.strideV % sa == 0;
+      }
+      return aligned;
+    }
+
+    /**
+     * @brief 对齐并带尾部填充的视频帧内存
+     * @details 内存在格式、分辨率或对齐不变时复用
+     */
+    class AliEngineAlignedVideoFrame {
+    public:
+      AliEngineAlignedVideoFrame() {}
+      ~AliEngineAlignedVideoFrame() { internal::AlignedFree(storage_); }
+
+      /**
+       * @brief 按格式和对齐要求分配（或复用）内存
+       * @return true: 成功；false: 参数错误或内存不足
+       */
+      bool Allocate(AliEngineVideoFormat format, int width, int height, int strideAlignment)
+      {
+        AliEngineVideoAlignedLayout layout;
+        if (!AliEngineVideoComputeAlignedLayout(format, width, height, strideAlignment, layout)) {
+          return false;
+        }
+        if (capacity_ < layout.totalSize) {
+          internal::AlignedFree(storage_);
+          storage_ = internal::AlignedMalloc(static_cast<size_t>(layout.totalSize), kAliEngineVideoPlaneBaseAlignment);
+          capacity_ = storage_ ? layout.totalSize : 0;
+          if (!storage_) {
+            return false;
+          }
+          /* 填充区清零，避免越界读入未初始化数据 */
+          memset(storage_, 0, static_cast<size_t>(layout.totalSize));
+        }
+        AliEngineVideoFrameAttachAlignedBuffer(frame_, storage_, format, width, height, layout);
+        return true;
+      }
+
+      /**
+       * @brief 把源帧拷贝（必要时转换）到对齐内存中
+       * @param src 源帧
+       * @param format 目标格式
+       * @param strideAlignment stride对齐字节数
+       * @return true: 成功
+       */
+      bool CopyFrom(const AliEngineVideoRawData &src, AliEngineVideoFormat format, int strideAlignment)
+      {
+        if (!Allocate(format, src.width, src.height, strideAlignment)) {
+          return false;
+        }
+        return converter_.Convert(src, frame_) == AliEngineVideoConvertOk;
+      }
+
+      /**
+       * @brief 把对齐内存中的数据写回目标帧（格式可不同）
+       * @return true: 成功
+       */
+      bool CopyTo(AliEngineVideoRawData &dst)
+      {
+        return converter_.Convert(frame_, dst) == AliEngineVideoConvertOk;
+      }
+
+      AliEngineVideoRawData &Frame() { return frame_; }
+      const AliEngineVideoRawData &Frame() const { return frame_; }
+
+    private:
+      AliEngineAlignedVideoFrame(const AliEngineAlignedVideoFrame&);
+      AliEngineAlignedVideoFrame& operator=(const AliEngineAlignedVideoFrame&);
+
+      void* storage_ = nullptr;
+      int capacity_ = 0;
+      AliEngineVideoRawData frame_;
+      AliEngineVideoFormatConverter converter_;
+    };
+
+    /**
+     * @brief 保证对齐的视频数据观测器
+     * @details 包装业务层的 {@link IVideoFrameObserver}，按其 {@link IVideoFrameObserver::GetVideoAlignment} 保证回调帧：
+     *  - 平面起始地址对齐到 {@link kAliEngineVideoPlaneBaseAlignment}（不小于请求的对齐字节数）
+     *  - stride 为请求对齐字节数的整数倍
+     *  - 每个平面末尾有 {@link kAliEngineVideoPlaneTailPadding} 字节可读填充（默认）
+     *
+     * 尾部填充无法从帧数据本身判断，默认每帧都拷贝到每个位置独立复用的对齐内存后再回调，
+     * 业务层返回 true 要求写回时，把处理结果拷贝回SDK的帧内存。
+     * 业务层的读取不会越过平面末尾时，构造时传入 guaranteeTailPadding = false，SDK输出的帧已满足起始地址和stride对齐时直接回调，不拷贝。
+     * 调用 {@link AliEngineAlignedVideoFrameObserver::FetchCaptureData} 等接口可在主动拉取模式下获得同样保证。
+     * @note 远端各路共用同一块对齐内存，回调之间串行执行，帧数据在回调返回后失效
+     */
+    class AliEngineAlignedVideoFrameObserver : public IVideoFrameObserver {
+    public:
+      /**
+       * @param observer 业务层观测器
+       * @param guaranteeTailPadding 为 true（默认）时每帧都拷贝到带尾部填充的对齐内存；为 false 时只拷贝未对齐的帧，不保证尾部填充
+       */
+      explicit AliEngineAlignedVideoFrameObserver(IVideoFrameObserver* observer, bool guaranteeTailPadding = true)
+        : observer_(observer), guaranteeTailPadding_(guaranteeTailPadding) {}
+
+      bool OnCaptureVideoSample(AliEngineVideoSource videoSource, AliEngineVideoRawData &videoRawData) override
+      {
+        AliEngineAlignedVideoFrame &aligned = capture_[videoSource == AliEngineVideoSourceScreenShare ? 1 : 0];
+        return Dispatch(videoRawData, aligned, [&](AliEngineVideoRawData &frame) {
+          return observer_->OnCaptureVideoSample(videoSource, frame);
+        });
+      }
+
+      bool OnPreEncodeVideoSample(AliEngineVideoSource videoSource, AliEngineVideoRawData &videoRawData) override
+      {
+        AliEngineAlignedVideoFrame &aligned = preEncode_[videoSource == AliEngineVideoSourceScreenShare ? 1 : 0];
+        return Dispatch(videoRawData, aligned, [&](AliEngineVideoRawData &frame) {
+          return observer_->OnPreEncodeVideoSample(videoSource, frame);
+        });
+      }
+
+      bool OnRemoteVideoSample(const char *uid, AliEngineVideoSource videoSource,
+                               AliEngineVideoRawData &videoRawData) override
+      {
+        std::lock_guard<std::mutex> guard(remoteLock_);
+        return Dispatch(videoRawData, remote_, [&](AliEngineVideoRawData &frame) {
+          return observer_->OnRemoteVideoSample(uid, videoSource, frame);
+        });
+      }
+
+      bool GetIfUserFetchObserverData() override { return observer_->GetIfUserFetchObserverData(); }
+      AliEngineVideoFormat GetVideoFormatPreference() override { return observer_->GetVideoFormatPreference(); }
+      AliEngineVideoObserAlignment GetVideoAlignment() override { return observer_->GetVideoAlignment(); }
+      uint32_t GetObservedFramePosition() override { return observer_->GetObservedFramePosition(); }
+      bool GetObserverDataMirrorApplied() override { return observer_->GetObserverDataMirrorApplied(); }
+      bool GetSmoothRenderingEnabled() override { return observer_->GetSmoothRenderingEnabled(); }
+
+      /**
+       * @brief 主动拉取采集数据并保证对齐，对应 {@link IAliEngineMediaEngine::GetVideoCaptureData}
+       * @param engine 媒体引擎
+       * @param type 视频流类型
+       * @param out 对齐后的帧内存
+       * @return true: 成功
+       */
+      bool FetchCaptureData(IAliEngineMediaEngine* engine, AliEngineVideoTrack type, AliEngineAlignedVideoFrame &out)
+      {
+        AliEngineVideoRawData raw;
+        return engine && engine->GetVideoCaptureData(type, raw) && CopyAligned(raw, out);
+      }
+
+      /**
+       * @brief 主动拉取编码前数据并保证对齐，对应 {@link IAliEngineMediaEngine::GetVideoPreEncoderData}
+       */
+      bool FetchPreEncoderData(IAliEngineMediaEngine* engine, AliEngineVideoTrack type, AliEngineAlignedVideoFrame &out)
+      {
+        AliEngineVideoRawData raw;
+        return engine && engine->GetVideoPreEncoderData(type, raw) && CopyAligned(raw, out);
+      }
+
+      /**
+       * @brief 主动拉取远端数据并保证对齐，对应 {@link IAliEngineMediaEngine::GetVideoRenderData}
+       */
+      bool FetchRenderData(IAliEngineMediaEngine* engine, const char *uid, AliEngineVideoTrack type,
+                           AliEngineAlignedVideoFrame &out)
+      {
+        AliEngineVideoRawData raw;
+        return engine && engine->GetVideoRenderData(uid, type, raw) && CopyAligned(raw, out);
+      }
+
+    private:
+      AliEngineAlignedVideoFrameObserver(const AliEngineAlignedVideoFrameObserver&);
+      AliEngineAlignedVideoFrameObserver& operator=(const AliEngineAlignedVideoFrameObserver&);
+
+      int StrideAlignment()
+      {
+        return AliEngineVideoAlignmentBytes(observer_->GetVideoAlignment());
+      }
+
+      bool CopyAligned(const AliEngineVideoRawData &raw, AliEngineAlignedVideoFrame &out)
+      {
+        if (!AliEngineVideoFormatConverter::IsConvertible(raw.format)) {
+          return false;
+        }
+        if (!out.CopyFrom(raw, raw.format, StrideAlignment())) {
+          return false;
+        }
+        out.Frame().timeStamp = raw.timeStamp;
+        out.Frame().rotation = raw.rotation;
+        return true;
+      }
+
+      template <typename Callback>
+      bool Dispatch(AliEngineVideoRawData &raw, AliEngineAlignedVideoFrame &aligned, Callback callback)
+      {
+        if (!AliEngineVideoFormatConverter::IsConvertible(raw.format) ||
+            (!guaranteeTailPadding_ && AliEngineVideoFrameIsAligned(raw, kAliEngineVideoPlaneBaseAlignment, StrideAlignment()))) {
+          return callback(raw);
+        }
+        if (!CopyAligned(raw, aligned)) {
+          return callback(raw);
+        }
+        const bool writeBack = callback(aligned.Frame());
+        if (writeBack) {
+          aligned.CopyTo(raw);
+        }
+        return writeBack;
+      }
+
+      IVideoFrameObserver* observer_;
+      bool guaranteeTailPadding_;
+      AliEngineAlignedVideoFrame capture_[2];
+      AliEngineAlignedVideoFrame preEncode_[2];
+      AliEngineAlignedVideoFrame remote_;
+      std::mutex remoteLock_;
+    };
+}
+
+#endif /* ali_rtc_engine_video_aligned_frame_h */
@@ -0,0 +1,338 @@
+#ifndef ali_rtc_engine_video_batch_observer_h
+#define ali_rtc_engine_video_batch_observer_h
+
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "engine_media_engine.h"
+#include "engine_video_convert.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 批量远端视频帧中的单路数据
+     */
+    typedef struct AliEngineRemoteVideoBatchItem {
+      /** 用户ID */
+      const char* uid = nullptr;
+      /** 视频数据源 */
+      AliEngineVideoSource videoSource = AliEngineVideoSourceCamera;
+      /** 该路最新一帧，紧凑排列，仅在回调期间有效 */
+      const AliEngineVideoRawData* frame = nullptr;
+      /** 帧时间戳，同 {@link AliEngineVideoRawData::timeStamp} */
+      long long timeStamp = 0;
+      /** 帧到达时间（steady clock），单位：us */
+      long long arrivalTimeUs = 0;
+      /** 自上一次批量回调以来是否收到新帧 */
+      bool changed = false;
+    } AliEngineRemoteVideoBatchItem;
+
+    /**
+     * @}
+     */
+
+    /**
+     * @addtogroup AliEngineCallback 回调及监听
+     * AliRtc 回调及监听
+     * @{
+     */
+
+    /**
+     * @brief 批量远端视频帧监听接口
+     */
+    class IVideoFrameBatchObserver {
+    public:
+      virtual ~IVideoFrameBatchObserver() {}
+
+      /**
+       * @brief 每个渲染周期回调一次，包含所有远端用户的最新帧
+       * @param items 各路最新帧，详见 {@link AliEngineRemoteVideoBatchItem}
+       * @param count 路数
+       * @param tickTimeUs 本次回调时间（steady clock），单位：us
+       * @note 在调用 {@link AliEngineBatchedVideoFrameObserver::Tick} 的线程回调，帧数据在回调返回后失效
+       */
+      virtual void OnRemoteVideoBatch(const AliEngineRemoteVideoBatchItem* items, int count, long long tickTimeUs) = 0;
+    };
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 按渲染周期批量输出远端视频帧的观测器
+     * @details 作为 {@link IVideoFrameObserver} 注册到SDK：
+     *  - OnRemoteVideoSample 在引擎线程把帧拷贝到该路的三缓冲中，并以一次原子交换发布，不加锁、不回调业务层
+     *  - 渲染线程每个周期调用 Tick，取每路最新帧并通过 {@link IVideoFrameBatchObserver::OnRemoteVideoBatch} 一次性回调
+     *  - 每路（uid + 视频源）独占缓冲，缓冲在分辨率变化时重新分配，稳定运行时无内存分配
+     *  - RemoveUser 后该路在下一次 Tick 时释放，位置和缓冲可被新用户复用，复用时清空旧帧
+     *  - 本地采集和编码前数据透传给可选的 forward 观测器
+     * @note 同时在线的路数上限在构造时指定，超出上限的新用户帧会被忽略
+     */
+    class AliEngineBatchedVideoFrameObserver : public IVideoFrameObserver {
+    public:
+      /**
+       * @param batchObserver 批量回调对象
+       * @param maxStreams 最大路数，默认值：32
+       * @param forward 本地数据回调和格式偏好透传的观测器，可为空
+       */
+      AliEngineBatchedVideoFrameObserver(IVideoFrameBatchObserver* batchObserver, int maxStreams = 32,
+                                         IVideoFrameObserver* forward = nullptr)
+        : batchObserver_(batchObserver), forward_(forward),
+          slots_(maxStreams > 0 ? maxStreams : 1), count_(0), rejected_(0) {
+        items_.resize(slots_.size());
+      }
+
+      bool OnCaptureVideoSample(AliEngineVideoSource videoSource, AliEngineVideoRawData &videoRawData) override
+      {
+        return forward_ ? forward_->OnCaptureVideoSample(videoSource, videoRawData) : false;
+      }
+
+      bool OnPreEncodeVideoSample(AliEngineVideoSource videoSource, AliEngineVideoRawData &videoRawData) override
+      {
+        return forward_ ? forward_->OnPreEncodeVideoSample(videoSource, videoRawData) : false;
+      }
+
+      bool OnRemoteVideoSample(const char *uid, AliEngineVideoSource videoSource,
+                               AliEngineVideoRawData &videoRawData) override
+      {
+        Slot* slot = FindOrCreate(uid, videoSource);
+        if (!slot) {
+          rejected_.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        Buffer &back = slot->buffers[slot->back];
+        if (back.Assign(videoRawData, slot->converter)) {
+          back.arrivalTimeUs = NowUs();
+          slot->back = slot->middle.exchange(static_cast<uint8_t>(slot->back | kDirty), std::memory_order_acq_rel) & kIndexMask;
+        }
+        slot->writers.fetch_sub(1, std::memory_order_release);
+        return false;
+      }
+
+      AliEngineVideoFormat GetVideoFormatPreference() override
+      {
+        return forward_ ? forward_->GetVideoFormatPreference() : AliEngineVideoFormatI420;
+      }
+
+      AliEngineVideoObserAlignment GetVideoAlignment() override
+      {
+        return forward_ ? forward_->GetVideoAlignment() : AliEngineAlignmentDefault;
+      }
+
+      uint32_t GetObservedFramePosition() override
+      {
+        const uint32_t position = forward_ ? forward_->GetObservedFramePosition() : 0;
+        return position | static_cast<uint32_t>(AliEnginePositionPreRender);
+      }
+
+      bool GetObserverDataMirrorApplied() override
+      {
+        return forward_ ? forward_->GetObserverDataMirrorApplied() : false;
+      }
+
+      /**
+       * @brief 输出一批最新帧，由渲染线程每个周期调用
+       * @return 本次回调的路数
+       * @note 只能在单一线程调用
+       */
+      int Tick()
+      {
+        const int count = count_.load(std::memory_order_acquire);
+        int n = 0;
+        for (int i = 0; i < count; ++i) {
+          Slot &slot = slots_[i];
+          const int state = slot.state.load(std::memory_order_acquire);
+          if (state == kRetired) {
+            /* Tick 线程不再访问该路，交给引擎线程复用 */
+            slot.state.store(kFree, std::memory_order_release);
+            continue;
+          }
+          if (state != kActive) {
+            continue;
+          }
+          bool changed = false;
+          if (slot.middle.load(std::memory_order_acquire) & kDirty) {
+            slot.front = slot.middle.exchange(slot.front, std::memory_order_acq_rel) & kIndexMask;
+            changed = true;
+          }
+          const Buffer &front = slot.buffers[slot.front];
+          if (!front.valid) {
+            continue;
+          }
+          AliEngineRemoteVideoBatchItem &item = items_[n++];
+          item.uid = slot.uid.c_str();
+          item.videoSource = slot.videoSource;
+          item.frame = &front.frame;
+          item.timeStamp = front.frame.timeStamp;
+          item.arrivalTimeUs = front.arrivalTimeUs;
+          item.changed = changed;
+        }
+        if (batchObserver_ && n > 0) {
+          batchObserver_->OnRemoteVideoBatch(items_.data(), n, NowUs());
+        }
+        return n;
+      }
+
+      /**
+       * @brief 用户离开或取消订阅时调用，该路不再出现在批量回调中
+       * @details 该路在下一次 Tick 时释放；用户重新加入时使用新的位置，不会收到离开前的旧帧
+       * @param uid 用户ID
+       */
+      void RemoveUser(const char *uid)
+      {
+        if (!uid) {
+          return;
+        }
+        std::lock_guard<std::mutex> guard(createLock_);
+        const int count = count_.load(std::memory_order_acquire);
+        for (int i = 0; i < count; ++i) {
+          int state = kActive;
+          if (slots_[i].uid == uid) {
+            slots_[i].state.compare_exchange_strong(state, kRetired, std::memory_order_acq_rel);
+          }
+        }
+      }
+
+      /**
+       * @brief 因路数已满而被忽略的帧数
+       */
+      unsigned long long GetRejectedFrameCount() const
+      {
+        return rejected_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      enum { kDirty = 4, kIndexMask = 3 };
+      /* 位置状态：空闲 -> 登记中 -> 使用中 -> 已移除（等待 Tick 释放）-> 空闲 */
+      enum { kFree = 0, kClaiming = 1, kActive = 2, kRetired = 3 };
+
+      struct Buffer {
+        std::vector<uint8_t> storage;
+        AliEngineVideoRawData frame;
+        long long arrivalTimeUs = 0;
+        bool valid = false;
+
+        bool Assign(const AliEngineVideoRawData &src, AliEngineVideoFormatConverter &converter)
+        {
+          const int size = AliEngineVideoFrameBufferSize(src.format, src.width, src.height);
+          if (size <= 0 || !AliEngineVideoFormatConverter::IsConvertible(src.format)) {
+            return false;
+          }
+          if (storage.size() < static_cast<size_t>(size)) {
+            storage.resize(size);
+          }
+          AliEngineVideoFrameAttachBuffer(frame, storage.data(), src.format, src.width, src.height);
+          valid = converter.Convert(src, frame) == AliEngineVideoConvertOk;
+          return valid;
+        }
+      };
+
+      struct Slot {
+        std::string uid;
+        AliEngineVideoSource videoSource = AliEngineVideoSourceCamera;
+        std::atomic<int> state{kFree};
+        /* 正在写入该路的引擎线程数，不为0时不能复用 */
+        std::atomic<int> writers{0};
+        Buffer buffers[3];
+        /* 三缓冲：back 归引擎线程，front 归 Tick 线程，middle 用于交换并携带新帧标记 */
+        uint8_t back = 0;
+        uint8_t front = 1;
+        std::atomic<uint8_t> middle{2};
+        AliEngineVideoFormatConverter converter;
+      };
+
+      AliEngineBatchedVideoFrameObserver(const AliEngineBatchedVideoFrameObserver&);
+      AliEngineBatchedVideoFrameObserver& operator=(const AliEngineBatchedVideoFrameObserver&);
+
+      static long long NowUs()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /* 返回时持有该路的 writers 计数，调用方写完后释放 */
+      Slot* FindOrCreate(const char *uid, AliEngineVideoSource videoSource)
+      {
+        if (!uid) {
+          return nullptr;
+        }
+        /* 先登记写者再确认状态：与复用时先置登记中再检查写者相对，二者至少一方能看到对方 */
+        int count = count_.load(std::memory_order_acquire);
+        for (int i = 0; i < count; ++i) {
+          Slot &slot = slots_[i];
+          if (slot.state.load(std::memory_order_acquire) != kActive) {
+            continue;
+          }
+          slot.writers.fetch_add(1, std::memory_order_seq_cst);
+          if (slot.state.load(std::memory_order_seq_cst) == kActive &&
+              slot.videoSource == videoSource && slot.uid == uid) {
+            return &slot;
+          }
+          slot.writers.fetch_sub(1, std::memory_order_release);
+        }
+        std::lock_guard<std::mutex> guard(createLock_);
+        count = count_.load(std::memory_order_acquire);
+        for (int i = 0; i < count; ++i) {
+          Slot &slot = slots_[i];
+          if (slot.state.load(std::memory_order_acquire) == kActive && slot.videoSource == videoSource && slot.uid == uid) {
+            slot.writers.fetch_add(1, std::memory_order_seq_cst);
+            return &slot;
+          }
+        }
+        int free = -1;
+        for (int i = 0; i < count && free < 0; ++i) {
+          Slot &slot = slots_[i];
+          int expected = kFree;
+          if (slot.state.compare_exchange_strong(expected, kClaiming, std::memory_order_seq_cst)) {
+            if (slot.writers.load(std::memory_order_seq_cst) == 0) {
+              free = i;
+            } else {
+              slot.state.store(kFree, std::memory_order_release);
+            }
+          }
+        }
+        if (free < 0) {
+          if (count >= static_cast<int>(slots_.size())) {
+            return nullptr;
+          }
+          free = count;
+          count_.store(count + 1, std::memory_order_release);
+        }
+        Slot &slot = slots_[free];
+        slot.uid = uid;
+        slot.videoSource = videoSource;
+        for (int b = 0; b < 3; ++b) {
+          slot.buffers[b].valid = false;
+        }
+        slot.back = 0;
+        slot.front = 1;
+        slot.middle.store(2, std::memory_order_relaxed);
+        slot.writers.fetch_add(1, std::memory_order_relaxed);
+        slot.state.store(kActive, std::memory_order_release);
+        return &slot;
+      }
+
+      IVideoFrameBatchObserver* batchObserver_;
+      IVideoFrameObserver* forward_;
+      std::vector<Slot> slots_;
+      std::atomic<int> count_;
+      std::atomic<unsigned long long> rejected_;
+      std::mutex createLock_;
+      std::vector<AliEngineRemoteVideoBatchItem> items_;
+    };
+}
+
+#endif /* ali_rtc_engine_video_batch_observer_h */
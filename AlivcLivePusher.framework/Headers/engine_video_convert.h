@@ -0,0 +1,840 @@
+#ifndef ali_rtc_engine_video_convert_h
+#define ali_rtc_engine_video_convert_h
+
+#include <string.h>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_media_engine.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 视频格式转换返回值
+     */
+    typedef enum {
+      /** 成功 */
+      AliEngineVideoConvertOk = 0,
+      /** 参数错误（空指针、宽高不一致、buffer类型不是裸数据等） */
+      AliEngineVideoConvertErrorInvalidParam = -1,
+      /** 不支持的格式（纹理、码流、文件等非裸数据格式） */
+      AliEngineVideoConvertErrorUnsupportedFormat = -2,
+    } AliEngineVideoConvertResult;
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      inline bool IsYuvFormat(AliEngineVideoFormat format)
+      {
+        return format == AliEngineVideoFormatI420 || format == AliEngineVideoFormatI422 ||
+               format == AliEngineVideoFormatNV12 || format == AliEngineVideoFormatNV21;
+      }
+
+      inline bool IsSemiPlanarFormat(AliEngineVideoFormat format)
+      {
+        return format == AliEngineVideoFormatNV12 || format == AliEngineVideoFormatNV21;
+      }
+
+      /** 打包格式每像素字节数，非打包格式返回0 */
+      inline int PackedBytesPerPixel(AliEngineVideoFormat format)
+      {
+        switch (format) {
+          case AliEngineVideoFormatBGRA:
+          case AliEngineVideoFormatRGBA:
+          case AliEngineVideoFormatARGB:
+          case AliEngineVideoFormatABGR:
+            return 4;
+          case AliEngineVideoFormatRGB24:
+          case AliEngineVideoFormatBGR24:
+            return 3;
+          case AliEngineVideoFormatRGB565:
+            return 2;
+          default:
+            return 0;
+        }
+      }
+
+      /** 4字节格式中 B、G、R、A 在内存中的位置 */
+      inline bool Packed32ChannelOrder(AliEngineVideoFormat format, uint8_t order[4])
+      {
+        switch (format) {
+          case AliEngineVideoFormatBGRA: order[0] = 0; order[1] = 1; order[2] = 2; order[3] = 3; return true;
+          case AliEngineVideoFormatRGBA: order[0] = 2; order[1] = 1; order[2] = 0; order[3] = 3; return true;
+          case AliEngineVideoFormatARGB: order[0] = 3; order[1] = 2; order[2] = 1; order[3] = 0; return true;
+          case AliEngineVideoFormatABGR: order[0] = 1; order[1] = 2; order[2] = 3; order[3] = 0; return true;
+          default: return false;
+        }
+      }
+
+      /** 帧的平面描述，统一裸数据中不同格式的指针和stride约定 */
+      struct VideoPlanes {
+        uint8_t* y = nullptr;
+        uint8_t* u = nullptr;
+        uint8_t* v = nullptr;
+        int strideY = 0;
+        int strideU = 0;
+        int strideV = 0;
+        uint8_t* packed = nullptr;
+        int stride = 0;
+      };
+
+      inline bool ResolveVideoPlanes(const AliEngineVideoRawData &frame, VideoPlanes &planes)
+      {
+        const int w = frame.width;
+        const int h = frame.height;
+        const int cw = (w + 1) / 2;
+        if (frame.type != AliEngineBufferTypeRawData || w <= 0 || h <= 0) {
+          return false;
+        }
+        const int bpp = PackedBytesPerPixel(frame.format);
+        if (bpp > 0) {
+          planes.packed = static_cast<uint8_t*>(frame.dataPtr);
+          planes.stride = frame.stride > 0 ? frame.stride : w * bpp;
+          return planes.packed != nullptr && planes.stride >= w * bpp;
+        }
+        if (!IsYuvFormat(frame.format)) {
+          return false;
+        }
+        const bool semiPlanar = IsSemiPlanarFormat(frame.format);
+        const int ch = frame.format == AliEngineVideoFormatI422 ? h : (h + 1) / 2;
+        planes.strideY = frame.strideY > 0 ? frame.strideY : w;
+        planes.strideU = frame.strideU > 0 ? frame.strideU : (semiPlanar ? cw * 2 : cw);
+        planes.strideV = frame.strideV > 0 ? frame.strideV : cw;
+        if (frame.dataYPtr) {
+          planes.y = static_cast<uint8_t*>(frame.dataYPtr);
+          planes.u = static_cast<uint8_t*>(frame.dataUPtr);
+          planes.v = static_cast<uint8_t*>(frame.dataVPtr);
+          if (semiPlanar && !planes.u) {
+            planes.u = planes.v;
+            planes.strideU = frame.strideV > 0 ? frame.strideV : planes.strideU;
+          }
+        } else if (frame.dataPtr) {
+          /* 连续内存布局：Y平面后紧跟色度平面 */
+          planes.y = static_cast<uint8_t*>(frame.dataPtr);
+          planes.u = planes.y + planes.strideY * h;
+          planes.v = semiPlanar ? nullptr : planes.u + planes.strideU * ch;
+        }
+        if (!planes.y || !planes.u || (!semiPlanar && !planes.v)) {
+          return false;
+        }
+        return planes.strideY >= w && planes.strideU >= (semiPlanar ? cw * 2 : cw) &&
+               (semiPlanar || planes.strideV >= cw);
+      }
+
+      /**
+       * BT.601 limited range，定点系数与标量/SIMD实现完全一致：
+       * R = (298C + 409E + 128) >> 8, G = (298C - 100D - 208E + 128) >> 8, B = (298C + 516D + 128) >> 8
+       */
+      inline void YuvPixelToBgra(int y, int u, int v, uint8_t* bgra)
+      {
+        const int c = y - 16;
+        const int d = u - 128;
+        const int e = v - 128;
+        bgra[0] = ClampU8((298 * c + 516 * d + 128) >> 8);
+        bgra[1] = ClampU8((298 * c - 100 * d - 208 * e + 128) >> 8);
+        bgra[2] = ClampU8((298 * c + 409 * e + 128) >> 8);
+        bgra[3] = 255;
+      }
+
+      /** Y行 + 半宽平面色度行 -> BGRA行 */
+      inline void YuvRowToBgra(const uint8_t* ALI_RTC_RESTRICT y, const uint8_t* ALI_RTC_RESTRICT u,
+                               const uint8_t* ALI_RTC_RESTRICT v, uint8_t* ALI_RTC_RESTRICT bgra, int width)
+      {
+        int x = 0;
+#if defined(ALI_RTC_SIMD_NEON)
+        const uint8x8_t k16 = vdup_n_u8(16);
+        const uint8x8_t k128 = vdup_n_u8(128);
+        const int32x4_t kRound = vdupq_n_s32(128);
+        for (; x + 8 <= width; x += 8) {
+          uint32_t u4, v4;
+          memcpy(&u4, u + x / 2, 4);
+          memcpy(&v4, v + x / 2, 4);
+          const uint8x8_t uu = vreinterpret_u8_u32(vdup_n_u32(u4));
+          const uint8x8_t vv = vreinterpret_u8_u32(vdup_n_u32(v4));
+          const int16x8_t c = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(y + x), k16));
+          const int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(vzip_u8(uu, uu).val[0], k128));
+          const int16x8_t e = vreinterpretq_s16_u16(vsubl_u8(vzip_u8(vv, vv).val[0], k128));
+          const int32x4_t cl = vmull_n_s16(vget_low_s16(c), 298);
+          const int32x4_t ch = vmull_n_s16(vget_high_s16(c), 298);
+          int32x4_t rl = vmlal_n_s16(vaddq_s32(cl, kRound), vget_low_s16(e), 409);
+          int32x4_t rh = vmlal_n_s16(vaddq_s32(ch, kRound), vget_high_s16(e), 409);
+          int32x4_t gl = vmlal_n_s16(vaddq_s32(cl, kRound), vget_low_s16(d), -100);
+          int32x4_t gh = vmlal_n_s16(vaddq_s32(ch, kRound), vget_high_s16(d), -100);
+          gl = vmlal_n_s16(gl, vget_low_s16(e), -208);
+          gh = vmlal_n_s16(gh, vget_high_s16(e), -208);
+          int32x4_t bl = vmlal_n_s16(vaddq_s32(cl, kRound), vget_low_s16(d), 516);
+          int32x4_t bh = vmlal_n_s16(vaddq_s32(ch, kRound), vget_high_s16(d), 516);
+          uint8x8x4_t px;
+          px.val[0] = vqmovun_s16(vcombine_s16(vshrn_n_s32(bl, 8), vshrn_n_s32(bh, 8)));
+          px.val[1] = vqmovun_s16(vcombine_s16(vshrn_n_s32(gl, 8), vshrn_n_s32(gh, 8)));
+          px.val[2] = vqmovun_s16(vcombine_s16(vshrn_n_s32(rl, 8), vshrn_n_s32(rh, 8)));
+          px.val[3] = vdup_n_u8(255);
+          vst4_u8(bgra + x * 4, px);
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        const __m128i k16 = _mm_set1_epi16(16);
+        const __m128i k128 = _mm_set1_epi16(128);
+        const __m128i kRound = _mm_set1_epi32(128);
+        const __m128i kCR = _mm_setr_epi16(298, 409, 298, 409, 298, 409, 298, 409);
+        const __m128i kCG = _mm_setr_epi16(298, -100, 298, -100, 298, -100, 298, -100);
+        const __m128i kEG = _mm_setr_epi16(-208, 0, -208, 0, -208, 0, -208, 0);
+        const __m128i kCB = _mm_setr_epi16(298, 516, 298, 516, 298, 516, 298, 516);
+        const __m128i kZero = _mm_setzero_si128();
+        const __m128i kAlpha = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (; x + 8 <= width; x += 8) {
+          int u4, v4;
+          memcpy(&u4, u + x / 2, 4);
+          memcpy(&v4, v + x / 2, 4);
+          __m128i uu = _mm_cvtsi32_si128(u4);
+          __m128i vv = _mm_cvtsi32_si128(v4);
+          uu = _mm_unpacklo_epi8(uu, uu);
+          vv = _mm_unpacklo_epi8(vv, vv);
+          const __m128i c = _mm_sub_epi16(_mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x))), k16);
+          const __m128i d = _mm_sub_epi16(_mm_cvtepu8_epi16(uu), k128);
+          const __m128i e = _mm_sub_epi16(_mm_cvtepu8_epi16(vv), k128);
+          const __m128i ceLo = _mm_unpacklo_epi16(c, e), ceHi = _mm_unpackhi_epi16(c, e);
+          const __m128i cdLo = _mm_unpacklo_epi16(c, d), cdHi = _mm_unpackhi_epi16(c, d);
+          const __m128i ezLo = _mm_unpacklo_epi16(e, kZero), ezHi = _mm_unpackhi_epi16(e, kZero);
+          __m128i rl = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ceLo, kCR), kRound), 8);
+          __m128i rh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ceHi, kCR), kRound), 8);
+          __m128i gl = _mm_add_epi32(_mm_madd_epi16(cdLo, kCG), _mm_madd_epi16(ezLo, kEG));
+          __m128i gh = _mm_add_epi32(_mm_madd_epi16(cdHi, kCG), _mm_madd_epi16(ezHi, kEG));
+          gl = _mm_srai_epi32(_mm_add_epi32(gl, kRound), 8);
+          gh = _mm_srai_epi32(_mm_add_epi32(gh, kRound), 8);
+          __m128i bl = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdLo, kCB), kRound), 8);
+          __m128i bh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdHi, kCB), kRound), 8);
+          const __m128i r8 = _mm_packus_epi16(_mm_packs_epi32(rl, rh), kZero);
+          const __m128i g8 = _mm_packus_epi16(_mm_packs_epi32(gl, gh), kZero);
+          const __m128i b8 = _mm_packus_epi16(_mm_packs_epi32(bl, bh), kZero);
+          const __m128i bg = _mm_unpacklo_epi8(b8, g8);
+          const __m128i ra = _mm_unpacklo_epi8(r8, kAlpha);
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + x * 4), _mm_unpacklo_epi16(bg, ra));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + x * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+        }
+#endif
+        for (; x < width; ++x) {
+          YuvPixelToBgra(y[x], u[x / 2], v[x / 2], bgra + x * 4);
+        }
+      }
+
+      /** Y = ((66R + 129G + 25B + 128) >> 8) + 16 */
+      inline void BgraRowToY(const uint8_t* ALI_RTC_RESTRICT bgra, uint8_t* ALI_RTC_RESTRICT y, int width)
+      {
+        int x = 0;
+#if defined(ALI_RTC_SIMD_NEON)
+        const uint8x8_t k16 = vdup_n_u8(16);
+        for (; x + 8 <= width; x += 8) {
+          const uint8x8x4_t px = vld4_u8(bgra + x * 4);
+          uint16x8_t acc = vmull_u8(px.val[0], vdup_n_u8(25));
+          acc = vmlal_u8(acc, px.val[1], vdup_n_u8(129));
+          acc = vmlal_u8(acc, px.val[2], vdup_n_u8(66));
+          acc = vaddq_u16(acc, vdupq_n_u16(128));
+          vst1_u8(y + x, vadd_u8(vshrn_n_u16(acc, 8), k16));
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        const __m128i kCoef = _mm_setr_epi16(25, 129, 66, 0, 25, 129, 66, 0);
+        const __m128i kRound = _mm_set1_epi32(128);
+        const __m128i k16 = _mm_set1_epi16(16);
+        for (; x + 8 <= width; x += 8) {
+          const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + x * 4));
+          const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + x * 4 + 16));
+          const __m128i m0 = _mm_madd_epi16(_mm_cvtepu8_epi16(p0), kCoef);
+          const __m128i m1 = _mm_madd_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(p0, 8)), kCoef);
+          const __m128i m2 = _mm_madd_epi16(_mm_cvtepu8_epi16(p1), kCoef);
+          const __m128i m3 = _mm_madd_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(p1, 8)), kCoef);
+          const __m128i s0 = _mm_srli_epi32(_mm_add_epi32(_mm_hadd_epi32(m0, m1), kRound), 8);
+          const __m128i s1 = _mm_srli_epi32(_mm_add_epi32(_mm_hadd_epi32(m2, m3), kRound), 8);
+          const __m128i y16 = _mm_add_epi16(_mm_packs_epi32(s0, s1), k16);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(y + x), _mm_packus_epi16(y16, y16));
+        }
+#endif
+        for (; x < width; ++x) {
+          const uint8_t* p = bgra + x * 4;
+          y[x] = static_cast<uint8_t>(((66 * p[2] + 129 * p[1] + 25 * p[0] + 128) >> 8) + 16);
+        }
+      }
+
+      /**
+       * 两行BGRA -> 半宽U/V行（2x2平均）；rowB 与 rowA 相同时即为 2x1 平均（I422）
+       * U = ((-38R - 74G + 112B + 128) >> 8) + 128, V = ((112R - 94G - 18B + 128) >> 8) + 128
+       */
+      inline void BgraRowsToUv(const uint8_t* rowA, const uint8_t* rowB, uint8_t* u, uint8_t* v, int width)
+      {
+        const int cw = (width + 1) / 2;
+        for (int i = 0; i < cw; ++i) {
+          const int x0 = i * 2;
+          const int x1 = x0 + 1 < width ? x0 + 1 : x0;
+          const uint8_t* a0 = rowA + x0 * 4;
+          const uint8_t* a1 = rowA + x1 * 4;
+          const uint8_t* b0 = rowB + x0 * 4;
+          const uint8_t* b1 = rowB + x1 * 4;
+          const int b = (a0[0] + a1[0] + b0[0] + b1[0] + 2) >> 2;
+          const int g = (a0[1] + a1[1] + b0[1] + b1[1] + 2) >> 2;
+          const int r = (a0[2] + a1[2] + b0[2] + b1[2] + 2) >> 2;
+          u[i] = ClampU8(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+          v[i] = ClampU8(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+      }
+
+      /** 4字节像素通道重排：dst[j] = src[perm[j]] */
+      inline void SwizzleRow32(const uint8_t* ALI_RTC_RESTRICT src, uint8_t* ALI_RTC_RESTRICT dst,
+                               int width, const uint8_t perm[4])
+      {
+        int x = 0;
+#if defined(ALI_RTC_SIMD_NEON)
+        for (; x + 8 <= width; x += 8) {
+          const uint8x8x4_t in = vld4_u8(src + x * 4);
+          uint8x8x4_t out;
+          out.val[0] = in.val[perm[0]];
+          out.val[1] = in.val[perm[1]];
+          out.val[2] = in.val[perm[2]];
+          out.val[3] = in.val[perm[3]];
+          vst4_u8(dst + x * 4, out);
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        uint8_t mask[16];
+        for (int i = 0; i < 16; ++i) {
+          mask[i] = static_cast<uint8_t>((i & ~3) + perm[i & 3]);
+        }
+        const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+        for (; x + 4 <= width; x += 4) {
+          const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm_shuffle_epi8(in, shuffle));
+        }
+#endif
+        for (; x < width; ++x) {
+          const uint8_t* s = src + x * 4;
+          uint8_t* d = dst + x * 4;
+          const uint8_t p0 = s[perm[0]], p1 = s[perm[1]], p2 = s[perm[2]], p3 = s[perm[3]];
+          d[0] = p0; d[1] = p1; d[2] = p2; d[3] = p3;
+        }
+      }
+
+      /** 交错UV行 -> 平面U/V行；swapUV 为 true 时输入为 VU 顺序（NV21） */
+      inline void SplitUvRow(const uint8_t* ALI_RTC_RESTRICT uv, uint8_t* ALI_RTC_RESTRICT u,
+                             uint8_t* ALI_RTC_RESTRICT v, int chromaWidth, bool swapUV)
+      {
+        uint8_t* first = swapUV ? v : u;
+        uint8_t* second = swapUV ? u : v;
+        int x = 0;
+#if defined(ALI_RTC_SIMD_NEON)
+        for (; x + 16 <= chromaWidth; x += 16) {
+          const uint8x16x2_t in = vld2q_u8(uv + x * 2);
+          vst1q_u8(first + x, in.val[0]);
+          vst1q_u8(second + x, in.val[1]);
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        const __m128i shuffle = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        for (; x + 8 <= chromaWidth; x += 8) {
+          const __m128i in = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x * 2)), shuffle);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(first + x), in);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(second + x), _mm_srli_si128(in, 8));
+        }
+#endif
+        for (; x < chromaWidth; ++x) {
+          first[x] = uv[x * 2];
+          second[x] = uv[x * 2 + 1];
+        }
+      }
+
+      /** 平面U/V行 -> 交错UV行；swapUV 为 true 时输出 VU 顺序（NV21） */
+      inline void MergeUvRow(const uint8_t* ALI_RTC_RESTRICT u, const uint8_t* ALI_RTC_RESTRICT v,
+                             uint8_t* ALI_RTC_RESTRICT uv, int chromaWidth, bool swapUV)
+      {
+        const uint8_t* first = swapUV ? v : u;
+        const uint8_t* second = swapUV ? u : v;
+        int x = 0;
+#if defined(ALI_RTC_SIMD_NEON)
+        for (; x + 16 <= chromaWidth; x += 16) {
+          uint8x16x2_t out;
+          out.val[0] = vld1q_u8(first + x);
+          out.val[1] = vld1q_u8(second + x);
+          vst2q_u8(uv + x * 2, out);
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        for (; x + 16 <= chromaWidth; x += 16) {
+          const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + x));
+          const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + x));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x * 2), _mm_unpacklo_epi8(a, b));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x * 2 + 16), _mm_unpackhi_epi8(a, b));
+        }
+#endif
+        for (; x < chromaWidth; ++x) {
+          uv[x * 2] = first[x];
+          uv[x * 2 + 1] = second[x];
+        }
+      }
+
+      /** 两行取平均（422 -> 420 色度下采样） */
+      inline void AverageRows(const uint8_t* ALI_RTC_RESTRICT a, const uint8_t* ALI_RTC_RESTRICT b,
+                              uint8_t* ALI_RTC_RESTRICT dst, int width)
+      {
+        int x = 0;
+#if defined(ALI_RTC_SIMD_NEON)
+        for (; x + 16 <= width; x += 16) {
+          vst1q_u8(dst + x, vrhaddq_u8(vld1q_u8(a + x), vld1q_u8(b + x)));
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        for (; x + 16 <= width; x += 16) {
+          const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x));
+          const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_avg_epu8(va, vb));
+        }
+#endif
+        for (; x < width; ++x) {
+          dst[x] = static_cast<uint8_t>((a[x] + b[x] + 1) >> 1);
+        }
+      }
+
+      /** 打包像素行 -> BGRA行 */
+      inline void PackedRowToBgra(AliEngineVideoFormat format, const uint8_t* ALI_RTC_RESTRICT src,
+                                  uint8_t* ALI_RTC_RESTRICT bgra, int width)
+      {
+        uint8_t order[4];
+        if (Packed32ChannelOrder(format, order)) {
+          if (format == AliEngineVideoFormatBGRA) {
+            memcpy(bgra, src, static_cast<size_t>(width) * 4);
+          } else {
+            SwizzleRow32(src, bgra, width, order);
+          }
+          return;
+        }
+        int x = 0;
+        if (format == AliEngineVideoFormatRGB24 || format == AliEngineVideoFormatBGR24) {
+          const int bi = format == AliEngineVideoFormatRGB24 ? 2 : 0;
+          const int ri = 2 - bi;
+#if defined(ALI_RTC_SIMD_NEON)
+          for (; x + 8 <= width; x += 8) {
+            const uint8x8x3_t in = vld3_u8(src + x * 3);
+            uint8x8x4_t out;
+            out.val[0] = in.val[bi];
+            out.val[1] = in.val[1];
+            out.val[2] = in.val[ri];
+            out.val[3] = vdup_n_u8(255);
+            vst4_u8(bgra + x * 4, out);
+          }
+#elif defined(ALI_RTC_SIMD_SSE41)
+          const __m128i shuffle = bi == 0
+              ? _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1)
+              : _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+          const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+          /* 每次读16字节只使用12字节，保留尾部余量避免越界 */
+          for (; x + 6 <= width; x += 4) {
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + x * 4), _mm_or_si128(_mm_shuffle_epi8(in, shuffle), alpha));
+          }
+#endif
+          for (; x < width; ++x) {
+            const uint8_t* s = src + x * 3;
+            uint8_t* d = bgra + x * 4;
+            d[0] = s[bi]; d[1] = s[1]; d[2] = s[ri]; d[3] = 255;
+          }
+          return;
+        }
+        /* RGB565: 小端存储，bit15-11 R, bit10-5 G, bit4-0 B */
+        for (; x < width; ++x) {
+          const int p = src[x * 2] | (src[x * 2 + 1] << 8);
+          const int b = p & 0x1F, g = (p >> 5) & 0x3F, r = p >> 11;
+          uint8_t* d = bgra + x * 4;
+          d[0] = static_cast<uint8_t>((b << 3) | (b >> 2));
+          d[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+          d[2] = static_cast<uint8_t>((r << 3) | (r >> 2));
+          d[3] = 255;
+        }
+      }
+
+      /** BGRA行 -> 打包像素行 */
+      inline void BgraRowToPacked(AliEngineVideoFormat format, const uint8_t* ALI_RTC_RESTRICT bgra,
+                                  uint8_t* ALI_RTC_RESTRICT dst, int width)
+      {
+        uint8_t order[4];
+        if (Packed32ChannelOrder(format, order)) {
+          if (format == AliEngineVideoFormatBGRA) {
+            memcpy(dst, bgra, static_cast<size_t>(width) * 4);
+            return;
+          }
+          /* order 是目标格式中 B/G/R/A 的位置，求逆得到 dst[j] = bgra[perm[j]] */
+          uint8_t perm[4];
+          for (uint8_t c = 0; c < 4; ++c) {
+            perm[order[c]] = c;
+          }
+          SwizzleRow32(bgra, dst, width, perm);
+          return;
+        }
+        int x = 0;
+        if (format == AliEngineVideoFormatRGB24 || format == AliEngineVideoFormatBGR24) {
+          const int bi = format == AliEngineVideoFormatRGB24 ? 2 : 0;
+          const int ri = 2 - bi;
+#if defined(ALI_RTC_SIMD_NEON)
+          for (; x + 8 <= width; x += 8) {
+            const uint8x8x4_t in = vld4_u8(bgra + x * 4);
+            uint8x8x3_t out;
+            out.val[bi] = in.val[0];
+            out.val[1] = in.val[1];
+            out.val[ri] = in.val[2];
+            vst3_u8(dst + x * 3, out);
+          }
+#endif
+          for (; x < width; ++x) {
+            const uint8_t* s = bgra + x * 4;
+            uint8_t* d = dst + x * 3;
+            d[bi] = s[0]; d[1] = s[1]; d[ri] = s[2];
+          }
+          return;
+        }
+        for (; x < width; ++x) {
+          const uint8_t* s = bgra + x * 4;
+          const int p = ((s[2] >> 3) << 11) | ((s[1] >> 2) << 5) | (s[0] >> 3);
+          dst[x * 2] = static_cast<uint8_t>(p & 0xFF);
+          dst[x * 2 + 1] = static_cast<uint8_t>(p >> 8);
+        }
+      }
+
+      inline void CopyPlane(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride, int rowBytes, int rows)
+      {
+        if (src == dst && srcStride == dstStride) {
+          return;
+        }
+        for (int r = 0; r < rows; ++r) {
+          memcpy(dst + static_cast<size_t>(r) * dstStride, src + static_cast<size_t>(r) * srcStride, rowBytes);
+        }
+      }
+    }
+
+    /**
+     * @brief 计算紧凑排列（无行填充）时一帧裸数据所需字节数
+     * @param format 视频格式，仅支持裸数据格式
+     * @param width 宽
+     * @param height 高
+     * @return 字节数，不支持的格式返回0
+     */
+    inline int AliEngineVideoFrameBufferSize(AliEngineVideoFormat format, int width, int height)
+    {
+      if (width <= 0 || height <= 0) {
+        return 0;
+      }
+      const int bpp = internal::PackedBytesPerPixel(format);
+      if (bpp > 0) {
+        return width * height * bpp;
+      }
+      const int cw = (width + 1) / 2;
+      switch (format) {
+        case AliEngineVideoFormatI420:
+        case AliEngineVideoFormatNV12:
+        case AliEngineVideoFormatNV21:
+          return width * height + cw * ((height + 1) / 2) * 2;
+        case AliEngineVideoFormatI422:
+          return width * height + cw * height * 2;
+        default:
+          return 0;
+      }
+    }
+
+    /**
+     * @brief 将一块连续内存按紧凑排列绑定到视频裸数据上，填充数据指针和stride
+     * @param frame 视频裸数据
+     * @param buffer 内存地址，大小至少为 {@link AliEngineVideoFrameBufferSize}
+     * @param format 视频格式
+     * @param width 宽
+     * @param height 高
+     * @return true: 成功；false: 参数错误或格式不支持
+     */
+    inline bool AliEngineVideoFrameAttachBuffer(AliEngineVideoRawData &frame, void* buffer,
+                                                AliEngineVideoFormat format, int width, int height)
+    {
+      const int size = AliEngineVideoFrameBufferSize(format, width, height);
+      if (!buffer || size <= 0) {
+        return false;
+      }
+      uint8_t* base = static_cast<uint8_t*>(buffer);
+      const int cw = (width + 1) / 2;
+      const int ch = format == AliEngineVideoFormatI422 ? height : (height + 1) / 2;
+      frame.format = format;
+      frame.type = AliEngineBufferTypeRawData;
+      frame.width = width;
+      frame.height = height;
+      frame.dataLength = size;
+      frame.dataPtr = base;
+      frame.dataYPtr = frame.dataUPtr = frame.dataVPtr = nullptr;
+      frame.strideY = frame.strideU = frame.strideV = frame.stride = 0;
+      const int bpp = internal::PackedBytesPerPixel(format);
+      if (bpp > 0) {
+        frame.stride = width * bpp;
+        return true;
+      }
+      frame.dataYPtr = base;
+      frame.strideY = width;
+      frame.dataUPtr = base + width * height;
+      if (internal::IsSemiPlanarFormat(format)) {
+        frame.strideU = cw * 2;
+      } else {
+        frame.strideU = frame.strideV = cw;
+        frame.dataVPtr = base + width * height + cw * ch;
+      }
+      return true;
+    }
+
+    /**
+     * @brief 视频裸数据格式转换器
+     * @details 支持 {@link AliEngineVideoFormat} 中所有裸数据格式之间的互相转换：
+     * BGRA、I420、NV21、NV12、RGBA、I422、ARGB、ABGR、RGB24、BGR24、RGB565
+     *
+     *  - 打包格式的命名为内存字节顺序，例如BGRA为 B,G,R,A（对应 kCVPixelFormatType_32BGRA）；RGB565为小端16位，高5位为R
+     *  - 打包格式使用 dataPtr + stride；I420/I422 使用 dataYPtr/dataUPtr/dataVPtr + strideY/strideU/strideV；
+     *    NV12/NV21 使用 dataYPtr + dataUPtr（交错色度平面） + strideY/strideU
+     *  - 平面指针为空时按 dataPtr 连续排列解析；stride为0时按紧凑排列处理
+     *  - YUV 与 RGB 之间按 BT.601 limited range 转换
+     *  - 按行流水处理，内部临时行缓存在转换器生命周期内复用，建议每路视频持有一个实例，避免逐帧分配
+     *  - 热点函数在 NEON / SSE4.1 下使用SIMD实现，其余尾部像素使用标量实现，结果与标量实现逐位一致
+     * @note 非线程安全，同一实例不要在多个线程同时调用
+     */
+    class AliEngineVideoFormatConverter {
+    public:
+      /**
+       * @brief 转换一帧视频数据
+       * @param src 源数据，详见 {@link AliEngineVideoRawData}
+       * @param dst 目标数据，需预先设置 format、width、height 及数据指针，宽高必须与源数据一致
+       * @return 详见 {@link AliEngineVideoConvertResult}
+       * @note 源和目标格式相同时为按行拷贝；目标中的 timeStamp、rotation 会从源数据复制
+       */
+      int Convert(const AliEngineVideoRawData &src, AliEngineVideoRawData &dst)
+      {
+        if (!IsConvertible(src.format) || !IsConvertible(dst.format)) {
+          return AliEngineVideoConvertErrorUnsupportedFormat;
+        }
+        internal::VideoPlanes sp, dp;
+        if (src.width != dst.width || src.height != dst.height ||
+            !internal::ResolveVideoPlanes(src, sp) || !internal::ResolveVideoPlanes(dst, dp)) {
+          return AliEngineVideoConvertErrorInvalidParam;
+        }
+        const int w = src.width;
+        EnsureScratch(w);
+        const bool srcYuv = internal::IsYuvFormat(src.format);
+        const bool dstYuv = internal::IsYuvFormat(dst.format);
+        if (srcYuv && dstYuv) {
+          YuvToYuv(src, sp, dst, dp);
+        } else if (srcYuv) {
+          YuvToPacked(src, sp, dst, dp);
+        } else if (dstYuv) {
+          PackedToYuv(src, sp, dst, dp);
+        } else {
+          PackedToPacked(src, sp, dst, dp);
+        }
+        dst.timeStamp = src.timeStamp;
+        dst.rotation = src.rotation;
+        return AliEngineVideoConvertOk;
+      }
+
+      /**
+       * @brief 是否为转换器支持的格式
+       */
+      static bool IsConvertible(AliEngineVideoFormat format)
+      {
+        return internal::IsYuvFormat(format) || internal::PackedBytesPerPixel(format) > 0;
+      }
+
+    private:
+      void EnsureScratch(int width)
+      {
+        /* 两行BGRA + 源色度U/V行 + 目标色度U/V行（色度行再各留一份用于422->420平均） */
+        const size_t cw = static_cast<size_t>(width + 1) / 2;
+        const size_t need = static_cast<size_t>(width) * 8 + cw * 6 + 64;
+        if (scratch_.size() < need) {
+          scratch_.resize(need);
+        }
+        rowA_ = scratch_.data();
+        rowB_ = rowA_ + static_cast<size_t>(width) * 4;
+        srcU_ = rowB_ + static_cast<size_t>(width) * 4;
+        srcV_ = srcU_ + cw;
+        srcU2_ = srcV_ + cw;
+        srcV2_ = srcU2_ + cw;
+        dstU_ = srcV2_ + cw;
+        dstV_ = dstU_ + cw;
+      }
+
+      /** 取源色度第 row 行为平面U/V指针（交错格式拆分到 u/v 临时行） */
+      static void SourceChromaRow(const AliEngineVideoRawData &src, const internal::VideoPlanes &sp, int row,
+                                  uint8_t* u, uint8_t* v, const uint8_t** outU, const uint8_t** outV)
+      {
+        const int cw = (src.width + 1) / 2;
+        if (internal::IsSemiPlanarFormat(src.format)) {
+          internal::SplitUvRow(sp.u + static_cast<size_t>(row) * sp.strideU, u, v, cw,
+                               src.format == AliEngineVideoFormatNV21);
+          *outU = u;
+          *outV = v;
+        } else {
+          *outU = sp.u + static_cast<size_t>(row) * sp.strideU;
+          *outV = sp.v + static_cast<size_t>(row) * sp.strideV;
+        }
+      }
+
+      /** 写目标色度第 row 行 */
+      static void WriteChromaRow(const AliEngineVideoRawData &dst, const internal::VideoPlanes &dp, int row,
+                                 const uint8_t* u, const uint8_t* v)
+      {
+        const int cw = (dst.width + 1) / 2;
+        if (internal::IsSemiPlanarFormat(dst.format)) {
+          internal::MergeUvRow(u, v, dp.u + static_cast<size_t>(row) * dp.strideU, cw,
+                               dst.format == AliEngineVideoFormatNV21);
+        } else {
+          memcpy(dp.u + static_cast<size_t>(row) * dp.strideU, u, cw);
+          memcpy(dp.v + static_cast<size_t>(row) * dp.strideV, v, cw);
+        }
+      }
+
+      static int ChromaRows(const AliEngineVideoRawData &frame)
+      {
+        return frame.format == AliEngineVideoFormatI422 ? frame.height : (frame.height + 1) / 2;
+      }
+
+      void YuvToYuv(const AliEngineVideoRawData &src, const internal::VideoPlanes &sp,
+                    const AliEngineVideoRawData &dst, const internal::VideoPlanes &dp)
+      {
+        internal::CopyPlane(sp.y, sp.strideY, dp.y, dp.strideY, src.width, src.height);
+        const int cw = (src.width + 1) / 2;
+        const int srcRows = ChromaRows(src);
+        const int dstRows = ChromaRows(dst);
+        if (src.format == dst.format) {
+          if (internal::IsSemiPlanarFormat(src.format)) {
+            internal::CopyPlane(sp.u, sp.strideU, dp.u, dp.strideU, cw * 2, srcRows);
+          } else {
+            internal::CopyPlane(sp.u, sp.strideU, dp.u, dp.strideU, cw, srcRows);
+            internal::CopyPlane(sp.v, sp.strideV, dp.v, dp.strideV, cw, srcRows);
+          }
+          return;
+        }
+        for (int r = 0; r < dstRows; ++r) {
+          const uint8_t* u = nullptr;
+          const uint8_t* v = nullptr;
+          if (srcRows > dstRows) {
+            /* 422 -> 420：相邻两行色度取平均 */
+            const int r0 = r * 2;
+            const int r1 = r0 + 1 < srcRows ? r0 + 1 : r0;
+            const uint8_t *u0, *v0, *u1, *v1;
+            SourceChromaRow(src, sp, r0, srcU_, srcV_, &u0, &v0);
+            SourceChromaRow(src, sp, r1, srcU2_, srcV2_, &u1, &v1);
+            internal::AverageRows(u0, u1, dstU_, cw);
+            internal::AverageRows(v0, v1, dstV_, cw);
+            u = dstU_;
+            v = dstV_;
+          } else {
+            /* 420 -> 422 行复制，同采样率时逐行对应 */
+            const int sr = srcRows < dstRows ? r / 2 : r;
+            SourceChromaRow(src, sp, sr, srcU_, srcV_, &u, &v);
+          }
+          WriteChromaRow(dst, dp, r, u, v);
+        }
+      }
+
+      void YuvToPacked(const AliEngineVideoRawData &src, const internal::VideoPlanes &sp,
+                       const AliEngineVideoRawData &dst, const internal::VideoPlanes &dp)
+      {
+        const bool is422 = src.format == AliEngineVideoFormatI422;
+        const bool direct = dst.format == AliEngineVideoFormatBGRA;
+        int cachedRow = -1;
+        const uint8_t* u = nullptr;
+        const uint8_t* v = nullptr;
+        for (int r = 0; r < src.height; ++r) {
+          const int cr = is422 ? r : r / 2;
+          if (cr != cachedRow) {
+            SourceChromaRow(src, sp, cr, srcU_, srcV_, &u, &v);
+            cachedRow = cr;
+          }
+          uint8_t* out = dp.packed + static_cast<size_t>(r) * dp.stride;
+          uint8_t* bgra = direct ? out : rowA_;
+          internal::YuvRowToBgra(sp.y + static_cast<size_t>(r) * sp.strideY, u, v, bgra, src.width);
+          if (!direct) {
+            internal::BgraRowToPacked(dst.format, bgra, out, src.width);
+          }
+        }
+      }
+
+      void PackedToYuv(const AliEngineVideoRawData &src, const internal::VideoPlanes &sp,
+                       const AliEngineVideoRawData &dst, const internal::VideoPlanes &dp)
+      {
+        const bool is422 = dst.format == AliEngineVideoFormatI422;
+        const int step = is422 ? 1 : 2;
+        for (int r = 0; r < src.height; r += step) {
+          const uint8_t* a = ToBgra(src, sp, r, rowA_);
+          const uint8_t* b = a;
+          internal::BgraRowToY(a, dp.y + static_cast<size_t>(r) * dp.strideY, src.width);
+          if (!is422 && r + 1 < src.height) {
+            b = ToBgra(src, sp, r + 1, rowB_);
+            internal::BgraRowToY(b, dp.y + static_cast<size_t>(r + 1) * dp.strideY, src.width);
+          }
+          internal::BgraRowsToUv(a, b, dstU_, dstV_, src.width);
+          WriteChromaRow(dst, dp, r / step, dstU_, dstV_);
+        }
+      }
+
+      void PackedToPacked(const AliEngineVideoRawData &src, const internal::VideoPlanes &sp,
+                          const AliEngineVideoRawData &dst, const internal::VideoPlanes &dp)
+      {
+        const int w = src.width;
+        if (src.format == dst.format) {
+          internal::CopyPlane(sp.packed, sp.stride, dp.packed, dp.stride,
+                              w * internal::PackedBytesPerPixel(src.format), src.height);
+          return;
+        }
+        uint8_t srcOrder[4], dstOrder[4];
+        const bool swizzle = internal::Packed32ChannelOrder(src.format, srcOrder) &&
+                             internal::Packed32ChannelOrder(dst.format, dstOrder);
+        uint8_t perm[4];
+        if (swizzle) {
+          for (int c = 0; c < 4; ++c) {
+            perm[dstOrder[c]] = srcOrder[c];
+          }
+        }
+        for (int r = 0; r < src.height; ++r) {
+          const uint8_t* in = sp.packed + static_cast<size_t>(r) * sp.stride;
+          uint8_t* out = dp.packed + static_cast<size_t>(r) * dp.stride;
+          if (swizzle) {
+            internal::SwizzleRow32(in, out, w, perm);
+          } else if (src.format == AliEngineVideoFormatBGRA) {
+            internal::BgraRowToPacked(dst.format, in, out, w);
+          } else if (dst.format == AliEngineVideoFormatBGRA) {
+            internal::PackedRowToBgra(src.format, in, out, w);
+          } else {
+            internal::PackedRowToBgra(src.format, in, rowA_, w);
+            internal::BgraRowToPacked(dst.format, rowA_, out, w);
+          }
+        }
+      }
+
+      /** 源第 row 行转为BGRA，源本身为BGRA时直接返回源行指针 */
+      static const uint8_t* ToBgra(const AliEngineVideoRawData &src, const internal::VideoPlanes &sp,
+                                   int row, uint8_t* scratch)
+      {
+        const uint8_t* in = sp.packed + static_cast<size_t>(row) * sp.stride;
+        if (src.format == AliEngineVideoFormatBGRA) {
+          return in;
+        }
+        internal::PackedRowToBgra(src.format, in, scratch, src.width);
+        return scratch;
+      }
+
+      std::vector<uint8_t> scratch_;
+      uint8_t* rowA_ = nullptr;
+      uint8_t* rowB_ = nullptr;
+      uint8_t* srcU_ = nullptr;
+      uint8_t* srcV_ = nullptr;
+      uint8_t* srcU2_ = nullptr;
+      uint8_t* srcV2_ = nullptr;
+      uint8_t* dstU_ = nullptr;
+      uint8_t* dstV_ = nullptr;
+    };
+}
+
+#endif /* ali_rtc_engine_video_convert_h */
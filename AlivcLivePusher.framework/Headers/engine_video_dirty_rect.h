@@ -0,0 +1,446 @@
+#ifndef ali_rtc_engine_video_dirty_rect_h
+#define ali_rtc_engine_video_dirty_rect_h
+
+#include <string.h>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_media_engine.h"
+#include "engine_video_convert.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 变化区域，帧内像素坐标
+     */
+    typedef struct AliEngineVideoDirtyRect {
+      int x = 0;
+      int y = 0;
+      int width = 0;
+      int height = 0;
+    } AliEngineVideoDirtyRect;
+
+    /**
+     * @brief 变化区域跟踪配置
+     */
+    typedef struct AliEngineDirtyRectConfig {
+      /** 分块边长，向上取整到16的倍数以便与编码宏块对齐，单位：像素，默认值：32 */
+      int tileSize = 32;
+      /** 输出区域数上限，超过后合并为一个外接矩形，默认值：32 */
+      int maxRects = 32;
+    } AliEngineDirtyRectConfig;
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      /** 64bit 分块哈希，4路独立累加以提高指令并行度 */
+      struct TileHasher {
+        uint64_t lane[4];
+
+        TileHasher() { lane[0] = 0x9E3779B97F4A7C15ULL; lane[1] = 0xC2B2AE3D27D4EB4FULL; lane[2] = 0x165667B19E3779F9ULL; lane[3] = 0x27D4EB2F165667C5ULL; }
+
+        static ALI_RTC_FORCE_INLINE uint64_t Mix(uint64_t h, uint64_t v)
+        {
+          h ^= v;
+          h *= 0xFF51AFD7ED558CCDULL;
+          return h ^ (h >> 29);
+        }
+
+        void Row(const uint8_t* p, int bytes)
+        {
+          int i = 0;
+          for (; i + 32 <= bytes; i += 32) {
+            uint64_t v[4];
+            memcpy(v, p + i, sizeof(v));
+            lane[0] = Mix(lane[0], v[0]);
+            lane[1] = Mix(lane[1], v[1]);
+            lane[2] = Mix(lane[2], v[2]);
+            lane[3] = Mix(lane[3], v[3]);
+          }
+          for (; i + 8 <= bytes; i += 8) {
+            uint64_t v;
+            memcpy(&v, p + i, sizeof(v));
+            lane[0] = Mix(lane[0], v);
+          }
+          if (i < bytes) {
+            uint64_t v = 0;
+            memcpy(&v, p + i, static_cast<size_t>(bytes - i));
+            lane[1] = Mix(lane[1], v ^ (static_cast<uint64_t>(bytes - i) << 56));
+          }
+        }
+
+        uint64_t Final() const
+        {
+          return Mix(Mix(lane[0], lane[1]), Mix(lane[2], lane[3]));
+        }
+      };
+    }
+
+    /**
+     * @brief 屏幕共享变化区域跟踪器
+     * @details 把帧划分为固定大小的分块，逐块计算64bit哈希并与上一帧比较，变化的分块先按行合并成水平区间，
+     * 再把上下相邻、左右边界相同的区间合并为矩形。屏幕内容无噪声，哈希比较即可精确判断变化，光标或文字光标闪烁
+     * 通常只产生一两个矩形。分块边长为16的倍数，可直接换算为编码宏块的跳过标记
+     * @note 非线程安全
+     */
+    class AliEngineDirtyRectTracker {
+    public:
+      explicit AliEngineDirtyRectTracker(const AliEngineDirtyRectConfig &config = AliEngineDirtyRectConfig())
+        : config_(config) {
+        config_.tileSize = static_cast<int>(internal::AlignUp(config_.tileSize > 0 ? config_.tileSize : 32, 16));
+        if (config_.maxRects <= 0) {
+          config_.maxRects = 1;
+        }
+      }
+
+      /**
+       * @brief 输入一帧并计算相对上一帧的变化区域
+       * @param frame 视频裸数据
+       * @return 变化区域数；首帧、分辨率或格式变化时返回整帧；帧无法解析时返回-1
+       */
+      int Update(const AliEngineVideoRawData &frame)
+      {
+        internal::VideoPlanes planes;
+        if (!internal::ResolveVideoPlanes(frame, planes)) {
+          Reset();
+          return -1;
+        }
+        const int ts = config_.tileSize;
+        const int cols = (frame.width + ts - 1) / ts;
+        const int rows = (frame.height + ts - 1) / ts;
+        const bool resized = frame.width != width_ || frame.height != height_ || frame.format != format_;
+        if (resized) {
+          width_ = frame.width;
+          height_ = frame.height;
+          format_ = frame.format;
+          cols_ = cols;
+          rows_ = rows;
+          hashes_.assign(static_cast<size_t>(cols) * rows, 0);
+          dirty_.assign(hashes_.size(), 1);
+          valid_ = false;
+        }
+        HashTiles(frame, planes);
+        rects_.clear();
+        if (!valid_) {
+          valid_ = true;
+          dirty_.assign(hashes_.size(), 1);
+          AddRect(0, 0, width_, height_);
+          dirtyTiles_ = static_cast<int>(dirty_.size());
+          return 1;
+        }
+        BuildRects();
+        return static_cast<int>(rects_.size());
+      }
+
+      /**
+       * @brief 最近一次 Update 的变化区域
+       */
+      const AliEngineVideoDirtyRect* Rects() const { return rects_.empty() ? nullptr : rects_.data(); }
+      int RectCount() const { return static_cast<int>(rects_.size()); }
+
+      /**
+       * @brief 最近一次 Update 中变化的分块数
+       */
+      int DirtyTileCount() const { return dirtyTiles_; }
+
+      /**
+       * @brief 分块总数
+       */
+      int TileCount() const { return cols_ * rows_; }
+
+      /**
+       * @brief 生成编码宏块的变化标记
+       * @param mask 输出，按行排列，1表示宏块有变化需要编码，0表示可跳过，长度至少为 mbCols * mbRows
+       * @param macroblockSize 宏块边长，需能整除分块边长，通常为16
+       * @return 宏块总数；参数不合法返回-1
+       */
+      int BuildMacroblockMask(uint8_t* mask, int macroblockSize = 16) const
+      {
+        if (!mask || macroblockSize <= 0 || config_.tileSize % macroblockSize != 0 || cols_ == 0) {
+          return -1;
+        }
+        const int mbCols = (width_ + macroblockSize - 1) / macroblockSize;
+        const int mbRows = (height_ + macroblockSize - 1) / macroblockSize;
+        const int ratio = config_.tileSize / macroblockSize;
+        for (int my = 0; my < mbRows; ++my) {
+          const uint8_t* tileRow = dirty_.data() + static_cast<size_t>(my / ratio) * cols_;
+          uint8_t* out = mask + static_cast<size_t>(my) * mbCols;
+          for (int mx = 0; mx < mbCols; ++mx) {
+            out[mx] = tileRow[mx / ratio];
+          }
+        }
+        return mbCols * mbRows;
+      }
+
+      /**
+       * @brief 清空历史，下一帧按整帧变化处理
+       */
+      void Reset()
+      {
+        valid_ = false;
+        width_ = height_ = 0;
+        cols_ = rows_ = 0;
+        rects_.clear();
+        dirty_.clear();
+        hashes_.clear();
+        dirtyTiles_ = 0;
+      }
+
+    private:
+      void HashTiles(const AliEngineVideoRawData &frame, const internal::VideoPlanes &planes)
+      {
+        const int ts = config_.tileSize;
+        const int bpp = internal::PackedBytesPerPixel(frame.format);
+        const bool semiPlanar = internal::IsSemiPlanarFormat(frame.format);
+        const int chromaRowShift = frame.format == AliEngineVideoFormatI422 ? 0 : 1;
+        dirtyTiles_ = 0;
+        hashers_.resize(cols_);
+        for (int ty = 0; ty < rows_; ++ty) {
+          const int y0 = ty * ts;
+          const int y1 = y0 + ts < height_ ? y0 + ts : height_;
+          for (int tx = 0; tx < cols_; ++tx) {
+            hashers_[tx] = internal::TileHasher();
+          }
+          /* 按行遍历整行的所有分块，保持内存顺序访问 */
+          for (int y = y0; y < y1; ++y) {
+            if (bpp > 0) {
+              const uint8_t* row = planes.packed + static_cast<size_t>(y) * planes.stride;
+              HashRow(row, bpp, ts);
+            } else {
+              HashRow(planes.y + static_cast<size_t>(y) * planes.strideY, 1, ts);
+              if (chromaRowShift == 0 || (y & 1) == 0) {
+                const int cy = y >> chromaRowShift;
+                if (semiPlanar) {
+                  HashRow(planes.u + static_cast<size_t>(cy) * planes.strideU, 2, ts / 2);
+                } else {
+                  HashRow(planes.u + static_cast<size_t>(cy) * planes.strideU, 1, ts / 2);
+                  HashRow(planes.v + static_cast<size_t>(cy) * planes.strideV, 1, ts / 2);
+                }
+              }
+            }
+          }
+          uint64_t* hashRow = hashes_.data() + static_cast<size_t>(ty) * cols_;
+          uint8_t* dirtyRow = dirty_.data() + static_cast<size_t>(ty) * cols_;
+          for (int tx = 0; tx < cols_; ++tx) {
+            const uint64_t h = hashers_[tx].Final();
+            dirtyRow[tx] = h != hashRow[tx] ? 1 : 0;
+            dirtyTiles_ += dirtyRow[tx];
+            hashRow[tx] = h;
+          }
+        }
+      }
+
+      /** 一行数据按分块切分后分别累加到各分块哈希，tilePixels 为每个分块在该行中的像素数 */
+      void HashRow(const uint8_t* row, int bytesPerPixel, int tilePixels)
+      {
+        const int rowPixels = (width_ * tilePixels + config_.tileSize - 1) / config_.tileSize;
+        for (int tx = 0; tx < cols_; ++tx) {
+          const int x0 = tx * tilePixels;
+          const int x1 = x0 + tilePixels < rowPixels ? x0 + tilePixels : rowPixels;
+          hashers_[tx].Row(row + static_cast<size_t>(x0) * bytesPerPixel, (x1 - x0) * bytesPerPixel);
+        }
+      }
+
+      void BuildRects()
+      {
+        const int ts = config_.tileSize;
+        /* open_ 记录上一行仍在延伸的矩形（以分块为单位），与本行区间完全相同时向下延伸 */
+        open_.clear();
+        next_.clear();
+        for (int ty = 0; ty <= rows_; ++ty) {
+          next_.clear();
+          if (ty < rows_) {
+            const uint8_t* dirtyRow = dirty_.data() + static_cast<size_t>(ty) * cols_;
+            for (int tx = 0; tx < cols_;) {
+              if (!dirtyRow[tx]) {
+                ++tx;
+                continue;
+              }
+              const int start = tx;
+              while (tx < cols_ && dirtyRow[tx]) {
+                ++tx;
+              }
+              TileSpan span;
+              span.x0 = start;
+              span.x1 = tx;
+              span.y0 = ty;
+              next_.push_back(span);
+            }
+          }
+          /* 区间按 x0 有序，双指针匹配 */
+          size_t j = 0;
+          for (size_t i = 0; i < open_.size(); ++i) {
+            while (j < next_.size() && next_[j].x0 < open_[i].x0) {
+              ++j;
+            }
+            if (j < next_.size() && next_[j].x0 == open_[i].x0 && next_[j].x1 == open_[i].x1) {
+              next_[j].y0 = open_[i].y0;
+            } else {
+              AddRect(open_[i].x0 * ts, open_[i].y0 * ts, (open_[i].x1 - open_[i].x0) * ts, (ty - open_[i].y0) * ts);
+            }
+          }
+          open_.swap(next_);
+        }
+        if (static_cast<int>(rects_.size()) > config_.maxRects) {
+          AliEngineVideoDirtyRect bounds = rects_[0];
+          int right = bounds.x + bounds.width;
+          int bottom = bounds.y + bounds.height;
+          for (size_t i = 1; i < rects_.size(); ++i) {
+            const AliEngineVideoDirtyRect &r = rects_[i];
+            bounds.x = r.x < bounds.x ? r.x : bounds.x;
+            bounds.y = r.y < bounds.y ? r.y : bounds.y;
+            right = r.x + r.width > right ? r.x + r.width : right;
+            bottom = r.y + r.height > bottom ? r.y + r.height : bottom;
+          }
+          rects_.clear();
+          AddRect(bounds.x, bounds.y, right - bounds.x, bottom - bounds.y);
+        }
+      }
+
+      void AddRect(int x, int y, int w, int h)
+      {
+        AliEngineVideoDirtyRect rect;
+        rect.x = x;
+        rect.y = y;
+        rect.width = x + w > width_ ? width_ - x : w;
+        rect.height = y + h > height_ ? height_ - y : h;
+        rects_.push_back(rect);
+      }
+
+      struct TileSpan {
+        int x0 = 0;
+        int x1 = 0;
+        int y0 = 0;
+      };
+
+      AliEngineDirtyRectConfig config_;
+      AliEngineVideoFormat format_ = AliEngineVideoFormatUnknow;
+      int width_ = 0;
+      int height_ = 0;
+      int cols_ = 0;
+      int rows_ = 0;
+      int dirtyTiles_ = 0;
+      bool valid_ = false;
+      std::vector<uint64_t> hashes_;
+      std::vector<uint8_t> dirty_;
+      std::vector<internal::TileHasher> hashers_;
+      std::vector<AliEngineVideoDirtyRect> rects_;
+      std::vector<TileSpan> open_;
+      std::vector<TileSpan> next_;
+    };
+
+    /**
+     * @addtogroup AliEngineCallback 回调及监听
+     * AliRtc 回调及监听
+     * @{
+     */
+
+    /**
+     * @brief 编码前变化区域监听接口
+     */
+    class IVideoFrameDirtyRectObserver {
+    public:
+      virtual ~IVideoFrameDirtyRectObserver() {}
+
+      /**
+       * @brief 编码前视频数据及其相对上一帧的变化区域
+       * @param videoSource 视频数据源
+       * @param videoRawData 视频裸数据
+       * @param rects 变化区域，帧内像素坐标，仅在回调期间有效
+       * @param count 区域数，0表示画面无变化
+       * @param tracker 跟踪器，可通过 {@link AliEngineDirtyRectTracker::BuildMacroblockMask} 获取宏块跳过标记
+       * @return true: 写回修改后的视频数据；false: 不写回
+       */
+      virtual bool OnPreEncodeVideoDirtyRects(AliEngineVideoSource videoSource, AliEngineVideoRawData &videoRawData,
+                                              const AliEngineVideoDirtyRect* rects, int count,
+                                              const AliEngineDirtyRectTracker &tracker) = 0;
+    };
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 带变化区域的编码前观测器
+     * @details 作为 {@link IVideoFrameObserver} 注册到SDK，对编码前的屏幕共享数据计算变化区域并回调
+     * {@link IVideoFrameDirtyRectObserver::OnPreEncodeVideoDirtyRects}，其余数据和格式偏好透传给可选的 forward 观测器
+     */
+    class AliEngineDirtyRectVideoFrameObserver : public IVideoFrameObserver {
+    public:
+      /**
+       * @param observer 变化区域回调对象
+       * @param config 跟踪配置，详见 {@link AliEngineDirtyRectConfig}
+       * @param forward 其余回调透传的观测器，可为空
+       */
+      AliEngineDirtyRectVideoFrameObserver(IVideoFrameDirtyRectObserver* observer,
+                                           const AliEngineDirtyRectConfig &config = AliEngineDirtyRectConfig(),
+                                           IVideoFrameObserver* forward = nullptr)
+        : observer_(observer), forward_(forward), tracker_(config) {}
+
+      bool OnCaptureVideoSample(AliEngineVideoSource videoSource, AliEngineVideoRawData &videoRawData) override
+      {
+        return forward_ ? forward_->OnCaptureVideoSample(videoSource, videoRawData) : false;
+      }
+
+      bool OnPreEncodeVideoSample(AliEngineVideoSource videoSource, AliEngineVideoRawData &videoRawData) override
+      {
+        if (videoSource != AliEngineVideoSourceScreenShare || !observer_) {
+          return forward_ ? forward_->OnPreEncodeVideoSample(videoSource, videoRawData) : false;
+        }
+        const int count = tracker_.Update(videoRawData);
+        if (count < 0) {
+          return false;
+        }
+        return observer_->OnPreEncodeVideoDirtyRects(videoSource, videoRawData, tracker_.Rects(), count, tracker_);
+      }
+
+      bool OnRemoteVideoSample(const char *uid, AliEngineVideoSource videoSource,
+                               AliEngineVideoRawData &videoRawData) override
+      {
+        return forward_ ? forward_->OnRemoteVideoSample(uid, videoSource, videoRawData) : false;
+      }
+
+      AliEngineVideoFormat GetVideoFormatPreference() override
+      {
+        return forward_ ? forward_->GetVideoFormatPreference() : AliEngineVideoFormatI420;
+      }
+
+      AliEngineVideoObserAlignment GetVideoAlignment() override
+      {
+        return forward_ ? forward_->GetVideoAlignment() : AliEngineAlignmentDefault;
+      }
+
+      uint32_t GetObservedFramePosition() override
+      {
+        const uint32_t position = forward_ ? forward_->GetObservedFramePosition() : 0;
+        return position | static_cast<uint32_t>(AliEnginePositionPreEncoder);
+      }
+
+      bool GetObserverDataMirrorApplied() override
+      {
+        return forward_ ? forward_->GetObserverDataMirrorApplied() : false;
+      }
+
+    private:
+      AliEngineDirtyRectVideoFrameObserver(const AliEngineDirtyRectVideoFrameObserver&);
+      AliEngineDirtyRectVideoFrameObserver& operator=(const AliEngineDirtyRectVideoFrameObserver&);
+
+      IVideoFrameDirtyRectObserver* observer_;
+      IVideoFrameObserver* forward_;
+      AliEngineDirtyRectTracker tracker_;
+    };
+}
+
+#endif /* ali_rtc_engine_video_dirty_rect_h */
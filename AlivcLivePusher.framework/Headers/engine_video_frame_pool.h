@@ -0,0 +1,364 @@
+#ifndef ali_rtc_engine_video_frame_pool_h
+#define ali_rtc_engine_video_frame_pool_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_media_engine.h"
+#include "engine_video_aligned_frame.h"
+#include "engine_video_convert.h"
+
+/**
+ * @brief {@link AliEngineExternalVideoFrameSender} 默认保留的帧数
+ * @details SDK未公开 PushExternalVideoFrame 是否在返回前完成拷贝，也未公开内部缓冲队列的深度。
+ * 默认值按保守估计取 8 帧（30fps 下约 266ms），确认SDK实际行为后可通过构造参数调小
+ */
+#define kAliEngineExternalVideoDefaultHoldDepth 8
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    class AliEngineVideoFramePool;
+
+    /**
+     * @brief 视频帧释放回调，引用计数归零时触发
+     * @param opaque 创建帧时传入的用户数据
+     * @param frame 被释放的帧数据
+     */
+    typedef void (*AliEngineVideoFrameReleaseCallback)(void* opaque, const AliEngineVideoRawData &frame);
+
+    /**
+     * @brief 带引用计数的视频帧
+     * @details 包装 {@link AliEngineVideoRawData} 及其释放回调，持有者通过 AddRef/Release 共享帧数据所有权，
+     * 最后一个持有者 Release 时：
+     *  - 由 {@link AliEngineVideoFramePool} 分配的帧归还到池中复用，不会释放内存
+     *  - 由 {@link AliEngineVideoFrameBuffer::Wrap} 包装的外部数据触发释放回调，由调用方回收平面内存
+     * @note 引用计数为原子操作，可在采集线程和推流线程之间传递
+     */
+    class AliEngineVideoFrameBuffer {
+    public:
+      /**
+       * @brief 包装外部视频数据，不拷贝平面数据
+       * @param frame 视频裸数据，平面内存在释放回调触发前必须保持有效
+       * @param callback 释放回调，可为空
+       * @param opaque 释放回调的用户数据
+       * @return 引用计数为1的视频帧
+       */
+      static AliEngineVideoFrameBuffer* Wrap(const AliEngineVideoRawData &frame,
+                                             AliEngineVideoFrameReleaseCallback callback,
+                                             void* opaque)
+      {
+        AliEngineVideoFrameBuffer* buffer = new AliEngineVideoFrameBuffer();
+        buffer->frame_ = frame;
+        buffer->callback_ = callback;
+        buffer->opaque_ = opaque;
+        buffer->refs_.store(1, std::memory_order_relaxed);
+        return buffer;
+      }
+
+      /**
+       * @brief 增加引用计数
+       */
+      void AddRef()
+      {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief 减少引用计数，归零时归还到池或触发释放回调
+       */
+      void Release();
+
+      /**
+       * @brief 当前引用计数
+       */
+      int RefCount() const { return refs_.load(std::memory_order_acquire); }
+
+      /**
+       * @brief 帧数据，可直接传入 {@link IAliEngineMediaEngine::PushExternalVideoFrame}
+       */
+      AliEngineVideoRawData &Frame() { return frame_; }
+      const AliEngineVideoRawData &Frame() const { return frame_; }
+
+    private:
+      friend class AliEngineVideoFramePool;
+      struct PoolState;
+
+      AliEngineVideoFrameBuffer() : refs_(0) {}
+      ~AliEngineVideoFrameBuffer() {}
+      AliEngineVideoFrameBuffer(const AliEngineVideoFrameBuffer&);
+      AliEngineVideoFrameBuffer& operator=(const AliEngineVideoFrameBuffer&);
+
+      std::atomic<int> refs_;
+      AliEngineVideoRawData frame_;
+      AliEngineVideoFrameReleaseCallback callback_ = nullptr;
+      void* opaque_ = nullptr;
+      void* storage_ = nullptr;
+      std::shared_ptr<PoolState> pool_;
+    };
+
+    /**
+     * @brief 视频帧池共享状态，池销毁后仍在使用的帧归还时负责释放内存
+     */
+    struct AliEngineVideoFrameBuffer::PoolState {
+      std::mutex lock;
+      std::vector<AliEngineVideoFrameBuffer*> freeList;
+      bool closed = false;
+      int outstanding = 0;
+      uint64_t reuseCount = 0;
+
+      static void Destroy(AliEngineVideoFrameBuffer* buffer)
+      {
+        internal::AlignedFree(buffer->storage_);
+        delete buffer;
+      }
+
+      void Recycle(AliEngineVideoFrameBuffer* buffer)
+      {
+        bool destroy = false;
+        {
+          std::lock_guard<std::mutex> guard(lock);
+          --outstanding;
+          if (closed) {
+            destroy = true;
+          } else {
+            freeList.push_back(buffer);
+          }
+        }
+        if (destroy) {
+          buffer->pool_.reset();
+          Destroy(buffer);
+        }
+      }
+    };
+
+    inline void AliEngineVideoFrameBuffer::Release()
+    {
+      if (refs_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+      }
+      if (pool_) {
+        /* 拷贝一份共享状态，避免 Recycle 中销毁帧时释放自身 */
+        std::shared_ptr<PoolState> pool = pool_;
+        pool->Recycle(this);
+        return;
+      }
+      if (callback_) {
+        callback_(opaque_, frame_);
+      }
+      delete this;
+    }
+
+    /**
+     * @brief 视频帧池
+     * @details 预分配固定格式、分辨率的帧内存，Acquire 获取引用计数为1的空闲帧，所有持有者 Release 后自动回到池中，
+     * 稳定运行时不再产生内存分配。布局见 {@link AliEngineVideoComputeAlignedLayout}：平面起始地址按
+     * {@link kAliEngineVideoPlaneBaseAlignment} 对齐，stride 按构造时指定的字节数对齐，平面末尾带 {@link kAliEngineVideoPlaneTailPadding} 字节填充
+     * @note 池可以先于帧销毁，未归还的帧在最后一次 Release 时释放内存
+     */
+    class AliEngineVideoFramePool {
+    public:
+      /**
+       * @brief 构造视频帧池
+       * @param format 视频格式，仅支持裸数据格式
+       * @param width 宽
+       * @param height 高
+       * @param capacity 最大帧数，池中帧全部被占用时 Acquire 返回空
+       * @param strideAlignment stride对齐字节数，可由 {@link AliEngineVideoAlignmentBytes} 得到，默认值：1
+       */
+      AliEngineVideoFramePool(AliEngineVideoFormat format, int width, int height, int capacity, int strideAlignment = 1)
+        : format_(format), width_(width), height_(height),
+          capacity_(capacity), strideAlignment_(strideAlignment), state_(std::make_shared<AliEngineVideoFrameBuffer::PoolState>()) {
+        state_->freeList.reserve(capacity > 0 ? capacity : 0);
+      }
+
+      ~AliEngineVideoFramePool()
+      {
+        std::vector<AliEngineVideoFrameBuffer*> idle;
+        {
+          std::lock_guard<std::mutex> guard(state_->lock);
+          state_->closed = true;
+          idle.swap(state_->freeList);
+        }
+        for (size_t i = 0; i < idle.size(); ++i) {
+          idle[i]->pool_.reset();
+          AliEngineVideoFrameBuffer::PoolState::Destroy(idle[i]);
+        }
+      }
+
+      /**
+       * @brief 获取空闲帧
+       * @return 引用计数为1的帧；池已满或参数非法时返回空
+       * @note 复用的帧保留上一次写入的内容，timeStamp、rotation 会被重置为0
+       */
+      AliEngineVideoFrameBuffer* Acquire()
+      {
+        AliEngineVideoFrameBuffer* buffer = nullptr;
+        {
+          std::lock_guard<std::mutex> guard(state_->lock);
+          if (!state_->freeList.empty()) {
+            buffer = state_->freeList.back();
+            state_->freeList.pop_back();
+            ++state_->reuseCount;
+          } else if (allocated_ >= capacity_) {
+            return nullptr;
+          }
+          ++state_->outstanding;
+          if (!buffer) {
+            ++allocated_;
+          }
+        }
+        if (!buffer) {
+          buffer = Allocate();
+          if (!buffer) {
+            std::lock_guard<std::mutex> guard(state_->lock);
+            --state_->outstanding;
+            --allocated_;
+            return nullptr;
+          }
+        }
+        buffer->frame_.timeStamp = 0;
+        buffer->frame_.rotation = 0;
+        buffer->refs_.store(1, std::memory_order_release);
+        return buffer;
+      }
+
+      /**
+       * @brief 已分配的帧数
+       */
+      int AllocatedCount()
+      {
+        std::lock_guard<std::mutex> guard(state_->lock);
+        return allocated_;
+      }
+
+      /**
+       * @brief 正在被使用（未归还）的帧数
+       */
+      int OutstandingCount()
+      {
+        std::lock_guard<std::mutex> guard(state_->lock);
+        return state_->outstanding;
+      }
+
+      /**
+       * @brief 帧复用次数
+       */
+      uint64_t ReuseCount()
+      {
+        std::lock_guard<std::mutex> guard(state_->lock);
+        return state_->reuseCount;
+      }
+
+    private:
+      AliEngineVideoFramePool(const AliEngineVideoFramePool&);
+      AliEngineVideoFramePool& operator=(const AliEngineVideoFramePool&);
+
+      AliEngineVideoFrameBuffer* Allocate()
+      {
+        AliEngineVideoAlignedLayout layout;
+        if (!AliEngineVideoComputeAlignedLayout(format_, width_, height_, strideAlignment_, layout)) {
+          return nullptr;
+        }
+        void* storage = internal::AlignedMalloc(static_cast<size_t>(layout.totalSize), kAliEngineVideoPlaneBaseAlignment);
+        if (!storage) {
+          return nullptr;
+        }
+        AliEngineVideoFrameBuffer* buffer = new AliEngineVideoFrameBuffer();
+        buffer->storage_ = storage;
+        buffer->pool_ = state_;
+        AliEngineVideoFrameAttachAlignedBuffer(buffer->frame_, storage, format_, width_, height_, layout);
+        return buffer;
+      }
+
+      AliEngineVideoFormat format_;
+      int width_;
+      int height_;
+      int capacity_;
+      int strideAlignment_;
+      int allocated_ = 0;
+      std::shared_ptr<AliEngineVideoFrameBuffer::PoolState> state_;
+    };
+
+    /**
+     * @brief 外部视频帧输入器
+     * @details {@link IAliEngineMediaEngine::PushExternalVideoFrame} 以常量引用接收帧数据，接口本身不转移所有权，
+     * SDK也未说明返回后是否仍会读取帧内存。输入器在推送成功后持有最近 holdDepth 帧的引用，
+     * 更早的帧自动 Release 归还到池中，调用方无需为每一帧自行拷贝或长期保留buffer。
+     * holdDepth 必须不小于SDK内部可能排队的帧数，否则帧内存可能在SDK读取前被池复用；
+     * 配合 {@link AliEngineVideoFramePool} 使用时，池容量应大于 holdDepth 加上采集侧同时持有的帧数
+     * @note 非线程安全，请在同一推流线程调用
+     */
+    class AliEngineExternalVideoFrameSender {
+    public:
+      /**
+       * @param engine 媒体引擎
+       * @param track 流类型，详见 {@link AliEngineVideoTrack}
+       * @param holdDepth 推送后保留的帧数，小于1时按1处理，默认值：{@link kAliEngineExternalVideoDefaultHoldDepth}
+       */
+      AliEngineExternalVideoFrameSender(IAliEngineMediaEngine* engine, AliEngineVideoTrack track,
+                                        int holdDepth = kAliEngineExternalVideoDefaultHoldDepth)
+        : engine_(engine), track_(track), hold_(holdDepth > 0 ? holdDepth : 1, nullptr) {}
+
+      ~AliEngineExternalVideoFrameSender() { Flush(); }
+
+      /**
+       * @brief 推送一帧
+       * @param frame 视频帧，推送期间由输入器增加引用，调用方仍需 Release 自己持有的引用
+       * @return PushExternalVideoFrame 的返回值，失败时不保留该帧
+       */
+      int Push(AliEngineVideoFrameBuffer* frame)
+      {
+        if (!engine_ || !frame) {
+          return -1;
+        }
+        const int ret = engine_->PushExternalVideoFrame(frame->Frame(), track_);
+        if (ret != 0) {
+          return ret;
+        }
+        frame->AddRef();
+        AliEngineVideoFrameBuffer* &slot = hold_[next_];
+        if (slot) {
+          slot->Release();
+        }
+        slot = frame;
+        next_ = (next_ + 1) % hold_.size();
+        return ret;
+      }
+
+      /**
+       * @brief 推送后保留的帧数
+       */
+      int HoldDepth() const { return static_cast<int>(hold_.size()); }
+
+      /**
+       * @brief 释放所有保留的帧，停止外部输入时调用
+       */
+      void Flush()
+      {
+        for (size_t i = 0; i < hold_.size(); ++i) {
+          if (hold_[i]) {
+            hold_[i]->Release();
+            hold_[i] = nullptr;
+          }
+        }
+        next_ = 0;
+      }
+
+    private:
+      AliEngineExternalVideoFrameSender(const AliEngineExternalVideoFrameSender&);
+      AliEngineExternalVideoFrameSender& operator=(const AliEngineExternalVideoFrameSender&);
+
+      IAliEngineMediaEngine* engine_;
+      AliEngineVideoTrack track_;
+      std::vector<AliEngineVideoFrameBuffer*> hold_;
+      size_t next_ = 0;
+    };
+}
+
+#endif /* ali_rtc_engine_video_frame_pool_h */
@@ -0,0 +1,502 @@
+#ifndef ali_rtc_engine_video_ingest_queue_h
+#define ali_rtc_engine_video_ingest_queue_h
+
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "engine_c_interface.h"
+#include "engine_interface.h"
+#include "engine_lockfree_queue.h"
+#include "engine_video_frame_pool.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 外部视频输入队列满时的处理策略
+     */
+    typedef enum {
+      /** 丢弃最早入队的帧，保留最新帧（默认） */
+      AliEngineVideoIngestDropOldest = 0,
+      /**
+       * 优先丢弃非参考帧：积压超过一半容量时投递线程从最早的非参考帧开始跳过；
+       * 非参考帧最多占用 3/4 容量，剩余空位只留给参考帧，非参考帧积压时参考帧仍能入队；
+       * 队列满时拒绝新帧，不挤掉已入队的帧，以免丢失参考帧破坏解码依赖
+       */
+      AliEngineVideoIngestDropNonReference = 1,
+      /** 阻塞等待空位，超时后丢弃新帧。会阻塞调用线程，不建议在采集线程使用 */
+      AliEngineVideoIngestBlockWithTimeout = 2,
+    } AliEngineVideoIngestPolicy;
+
+    /**
+     * @brief 入队结果
+     */
+    typedef enum {
+      /** 已入队 */
+      AliEngineVideoIngestQueued = 0,
+      /** 已入队，同时丢弃了一帧较早的帧 */
+      AliEngineVideoIngestQueuedDropOldest = 1,
+      /** 队列满，新帧被丢弃 */
+      AliEngineVideoIngestDropped = -1,
+      /** 阻塞等待超时，新帧被丢弃 */
+      AliEngineVideoIngestTimeout = -2,
+      /** 参数错误或队列未启动 */
+      AliEngineVideoIngestInvalid = -3,
+    } AliEngineVideoIngestResult;
+
+    /**
+     * @brief 外部视频输入队列配置
+     */
+    typedef struct AliEngineVideoIngestConfig {
+      /** 队列容量（帧），向上取整到2的幂，默认值：8 */
+      int capacity = 8;
+      /** 队列满时的策略，默认值：AliEngineVideoIngestDropOldest */
+      AliEngineVideoIngestPolicy policy = AliEngineVideoIngestDropOldest;
+      /** AliEngineVideoIngestBlockWithTimeout 策略的等待时长，单位：ms，默认值：33 */
+      int blockTimeoutMs = 33;
+      /** SDK返回 AliEngineErrorVideoBufferFull 后投递线程的重试间隔，单位：ms，默认值：5 */
+      int retryIntervalMs = 5;
+      /** 帧在队列中的最长停留时间，超过后丢弃，单位：ms，默认值：200 */
+      int maxFrameAgeMs = 200;
+    } AliEngineVideoIngestConfig;
+
+    /**
+     * @brief 外部视频输入队列统计信息
+     */
+    typedef struct AliEngineVideoIngestStats {
+      /** 当前队列深度 */
+      int queueDepth = 0;
+      /** 队列容量 */
+      int capacity = 0;
+      /** 入队帧数 */
+      unsigned long long enqueuedFrames = 0;
+      /** 成功投递给SDK的帧数 */
+      unsigned long long deliveredFrames = 0;
+      /** 因队列满丢弃的最早帧数 */
+      unsigned long long droppedOldestFrames = 0;
+      /** 丢弃的非参考帧数 */
+      unsigned long long droppedNonReferenceFrames = 0;
+      /** 因队列满或等待超时丢弃的新帧数 */
+      unsigned long long droppedNewFrames = 0;
+      /** 在队列中停留超时丢弃的帧数 */
+      unsigned long long droppedStaleFrames = 0;
+      /** SDK返回buffer满后的重试次数 */
+      unsigned long long sinkRetries = 0;
+      /** 最近一帧从入队到被SDK接收的耗时，单位：us */
+      int lastLatencyUs = 0;
+      /** 入队到被SDK接收的平滑耗时，单位：us */
+      int avgLatencyUs = 0;
+      /** 入队到被SDK接收的最大耗时，单位：us */
+      int maxLatencyUs = 0;
+    } AliEngineVideoIngestStats;
+
+    /**
+     * @brief 投递函数，返回值语义与 {@link IAliEngineMediaEngine::PushExternalVideoFrame} 一致
+     */
+    typedef int (*AliEngineVideoIngestSink)(void* opaque, const AliEngineVideoRawData &frame, AliEngineVideoTrack track);
+
+    /**
+     * @brief 通过C接口 {@link push_external_video_frame} 投递，opaque 不使用
+     */
+    inline int AliEngineVideoIngestSinkCInterface(void* opaque, const AliEngineVideoRawData &frame, AliEngineVideoTrack track)
+    {
+      (void)opaque;
+      ali_engine_video_raw_data_t raw;
+      memset(&raw, 0, sizeof(raw));
+      raw.format = static_cast<ali_engine_video_format>(frame.format);
+      raw.type = static_cast<ali_engine_buffer_type>(frame.type);
+      raw.data_length = frame.dataLength;
+      raw.pixel_buffer = frame.pixelBuffer;
+      raw.data_ptr = frame.dataPtr;
+      raw.data_y_ptr = frame.dataYPtr;
+      raw.data_u_ptr = frame.dataUPtr;
+      raw.data_v_ptr = frame.dataVPtr;
+      raw.stride_y = frame.strideY;
+      raw.stride_u = frame.strideU;
+      raw.stride_v = frame.strideV;
+      raw.height = frame.height;
+      raw.width = frame.width;
+      raw.rotation = frame.rotation;
+      raw.stride = frame.stride;
+      raw.time_stamp = frame.timeStamp;
+      raw.texture_id = frame.textureId;
+      memcpy(raw.transform_matrix, frame.transformMatrix, sizeof(raw.transform_matrix));
+      raw.encode_cost_ms = frame.encodeCostMs;
+      return push_external_video_frame(&raw, static_cast<ali_engine_video_track>(track));
+    }
+
+    /**
+     * @brief 通过 {@link IAliEngineMediaEngine::PushExternalVideoFrame} 投递，opaque 为 IAliEngineMediaEngine*
+     */
+    inline int AliEngineVideoIngestSinkMediaEngine(void* opaque, const AliEngineVideoRawData &frame, AliEngineVideoTrack track)
+    {
+      IAliEngineMediaEngine* engine = static_cast<IAliEngineMediaEngine*>(opaque);
+      return engine ? engine->PushExternalVideoFrame(frame, track) : AliEngineErrorInvaildArgument;
+    }
+
+    /**
+     * @}
+     */
+
+    /**
+     * @brief 外部视频异步输入队列
+     * @details 位于外部视频输入接口之前的有界无锁队列，由独立投递线程把帧送入SDK：
+     *  - 采集线程调用 Enqueue 只做无锁入队，不自旋、不休眠（AliEngineVideoIngestBlockWithTimeout 策略除外）
+     *  - SDK返回 AliEngineErrorVideoBufferFull 时由投递线程按 retryIntervalMs 重试，调用方无需编写重试逻辑
+     *  - 帧以 {@link AliEngineVideoFrameBuffer} 引用计数形式入队，投递完成或丢弃时自动 Release
+     *  - 延时统计为入队到SDK接收该帧的耗时，SDK内部的编码耗时可参考 {@link AliEngineVideoRawData::encodeCostMs}
+     */
+    class AliEngineVideoIngestQueue {
+    public:
+      /**
+       * @param sink 投递函数，详见 {@link AliEngineVideoIngestSinkCInterface}、{@link AliEngineVideoIngestSinkMediaEngine}
+       * @param opaque 投递函数的用户数据
+       * @param track 流类型
+       * @param config 队列配置
+       */
+      AliEngineVideoIngestQueue(AliEngineVideoIngestSink sink, void* opaque, AliEngineVideoTrack track,
+                                const AliEngineVideoIngestConfig &config = AliEngineVideoIngestConfig())
+        : sink_(sink), opaque_(opaque), track_(track), config_(config),
+          queue_(static_cast<size_t>(config.capacity > 1 ? config.capacity : 2))
+      {
+        const int capacity = static_cast<int>(queue_.Capacity());
+        nonReferenceLimit_ = capacity - (capacity / 4 > 1 ? capacity / 4 : 1);
+      }
+
+      ~AliEngineVideoIngestQueue()
+      {
+        Stop();
+      }
+
+      /**
+       * @brief 启动投递线程
+       */
+      void Start()
+      {
+        std::lock_guard<std::mutex> guard(threadLock_);
+        if (worker_.joinable()) {
+          return;
+        }
+        running_.store(true, std::memory_order_release);
+        worker_ = std::thread(&AliEngineVideoIngestQueue::Run, this);
+      }
+
+      /**
+       * @brief 停止投递线程，并释放队列中未投递的帧
+       */
+      void Stop()
+      {
+        {
+          std::lock_guard<std::mutex> guard(threadLock_);
+          {
+            std::lock_guard<std::mutex> waitGuard(waitLock_);
+            running_.store(false, std::memory_order_seq_cst);
+          }
+          dataCv_.notify_all();
+          spaceCv_.notify_all();
+          if (worker_.joinable()) {
+            worker_.join();
+          }
+        }
+        /* 等待已通过 running_ 检查的 Enqueue 完成，之后不会再有帧入队 */
+        while (producers_.load(std::memory_order_seq_cst) > 0) {
+          spaceCv_.notify_all();
+          std::this_thread::yield();
+        }
+        Item item;
+        while (queue_.TryPop(item)) {
+          OnPopped(item);
+          item.frame->Release();
+        }
+      }
+
+      /**
+       * @brief 入队一帧
+       * @param frame 视频帧，入队成功时队列增加一次引用，调用方仍需 Release 自己的引用
+       * @param isReference 是否为参考帧（例如编码数据中的关键帧），仅 AliEngineVideoIngestDropNonReference 策略使用
+       * @return 详见 {@link AliEngineVideoIngestResult}
+       */
+      int Enqueue(AliEngineVideoFrameBuffer* frame, bool isReference = true)
+      {
+        if (!frame) {
+          return AliEngineVideoIngestInvalid;
+        }
+        /* 与 Stop 构成 Dekker 式握手：要么 Stop 看到 producers_ 非零并等待，要么这里看到 running_ 为 false */
+        producers_.fetch_add(1, std::memory_order_seq_cst);
+        if (!running_.load(std::memory_order_seq_cst)) {
+          producers_.fetch_sub(1, std::memory_order_release);
+          return AliEngineVideoIngestInvalid;
+        }
+        Item item;
+        item.frame = frame;
+        item.reference = isReference;
+        item.enqueueUs = NowUs();
+        frame->AddRef();
+
+        int result = AliEngineVideoIngestQueued;
+        if (!ReserveNonReference(item)) {
+          droppedNonReference_.fetch_add(1, std::memory_order_relaxed);
+          result = AliEngineVideoIngestDropped;
+        } else if (!queue_.TryPush(item)) {
+          result = HandleFull(item);
+          if (result < 0) {
+            OnPopped(item);
+          }
+        }
+        if (result >= 0) {
+          enqueued_.fetch_add(1, std::memory_order_relaxed);
+          WakeConsumer();
+        } else {
+          frame->Release();
+        }
+        producers_.fetch_sub(1, std::memory_order_release);
+        return result;
+      }
+
+      /**
+       * @brief 获取统计信息
+       */
+      AliEngineVideoIngestStats GetStats() const
+      {
+        AliEngineVideoIngestStats stats;
+        stats.queueDepth = static_cast<int>(queue_.SizeApprox());
+        stats.capacity = static_cast<int>(queue_.Capacity());
+        stats.enqueuedFrames = enqueued_.load(std::memory_order_relaxed);
+        stats.deliveredFrames = delivered_.load(std::memory_order_relaxed);
+        stats.droppedOldestFrames = droppedOldest_.load(std::memory_order_relaxed);
+        stats.droppedNonReferenceFrames = droppedNonReference_.load(std::memory_order_relaxed);
+        stats.droppedNewFrames = droppedNew_.load(std::memory_order_relaxed);
+        stats.droppedStaleFrames = droppedStale_.load(std::memory_order_relaxed);
+        stats.sinkRetries = retries_.load(std::memory_order_relaxed);
+        stats.lastLatencyUs = lastLatencyUs_.load(std::memory_order_relaxed);
+        stats.avgLatencyUs = avgLatencyUs_.load(std::memory_order_relaxed);
+        stats.maxLatencyUs = maxLatencyUs_.load(std::memory_order_relaxed);
+        return stats;
+      }
+
+    private:
+      struct Item {
+        AliEngineVideoFrameBuffer* frame = nullptr;
+        long long enqueueUs = 0;
+        bool reference = true;
+      };
+
+      AliEngineVideoIngestQueue(const AliEngineVideoIngestQueue&);
+      AliEngineVideoIngestQueue& operator=(const AliEngineVideoIngestQueue&);
+
+      static long long NowUs()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /** DropNonReference 策略下为非参考帧占用一个名额，超出 nonReferenceLimit_ 时返回 false，空位留给参考帧 */
+      bool ReserveNonReference(const Item &item)
+      {
+        if (config_.policy != AliEngineVideoIngestDropNonReference || item.reference) {
+          return true;
+        }
+        if (nonReferenceQueued_.fetch_add(1, std::memory_order_relaxed) >= nonReferenceLimit_) {
+          nonReferenceQueued_.fetch_sub(1, std::memory_order_relaxed);
+          return false;
+        }
+        return true;
+      }
+
+      /** 帧离开队列（或入队失败）时归还非参考帧名额 */
+      void OnPopped(const Item &item)
+      {
+        if (config_.policy == AliEngineVideoIngestDropNonReference && !item.reference) {
+          nonReferenceQueued_.fetch_sub(1, std::memory_order_relaxed);
+        }
+      }
+
+      int HandleFull(const Item &item)
+      {
+        switch (config_.policy) {
+          case AliEngineVideoIngestDropNonReference:
+            /* 无锁队列无法从中间移除，队首可能是参考帧，因此拒绝新帧；非参考帧占不满队列，参考帧走到这里说明预留空位也已被参考帧占满 */
+            if (item.reference) {
+              droppedNew_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+              droppedNonReference_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return AliEngineVideoIngestDropped;
+          case AliEngineVideoIngestBlockWithTimeout: {
+            std::unique_lock<std::mutex> lock(waitLock_);
+            const std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.blockTimeoutMs);
+            producersWaiting_.fetch_add(1, std::memory_order_seq_cst);
+            /* 与 Run 中出队后的栅栏配对，保证投递线程能看到等待者 */
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool pushed = false;
+            while (running_.load(std::memory_order_acquire)) {
+              if (queue_.TryPush(item)) {
+                pushed = true;
+                break;
+              }
+              if (spaceCv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+                pushed = queue_.TryPush(item);
+                break;
+              }
+            }
+            producersWaiting_.fetch_sub(1, std::memory_order_relaxed);
+            if (!pushed) {
+              droppedNew_.fetch_add(1, std::memory_order_relaxed);
+              return AliEngineVideoIngestTimeout;
+            }
+            return AliEngineVideoIngestQueued;
+          }
+          case AliEngineVideoIngestDropOldest:
+          default:
+            return PushEvictingOldest(item);
+        }
+      }
+
+      /** 挤掉最早的帧后入队；与投递线程竞争时有限次尝试，不自旋等待 */
+      int PushEvictingOldest(const Item &item)
+      {
+        for (int attempt = 0; attempt < 4; ++attempt) {
+          Item oldest;
+          if (queue_.TryPop(oldest)) {
+            oldest.frame->Release();
+            droppedOldest_.fetch_add(1, std::memory_order_relaxed);
+          }
+          if (queue_.TryPush(item)) {
+            return AliEngineVideoIngestQueuedDropOldest;
+          }
+        }
+        droppedNew_.fetch_add(1, std::memory_order_relaxed);
+        return AliEngineVideoIngestDropped;
+      }
+
+      /*
+       * 入队与 consumerWaiting_ 的读取之间、consumerWaiting_ 的写入与再次出队之间各有一个 seq_cst 栅栏，
+       * 两侧至少有一方能看到对方的写入，投递线程不会错过唤醒
+       */
+      void WakeConsumer()
+      {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerWaiting_.load(std::memory_order_relaxed)) {
+          std::lock_guard<std::mutex> guard(waitLock_);
+          dataCv_.notify_one();
+        }
+      }
+
+      void Run()
+      {
+        Item item;
+        while (running_.load(std::memory_order_acquire)) {
+          if (!queue_.TryPop(item)) {
+            std::unique_lock<std::mutex> lock(waitLock_);
+            consumerWaiting_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!queue_.TryPop(item)) {
+              dataCv_.wait_for(lock, std::chrono::milliseconds(20));
+              consumerWaiting_.store(false, std::memory_order_relaxed);
+              continue;
+            }
+            consumerWaiting_.store(false, std::memory_order_relaxed);
+          }
+          OnPopped(item);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (producersWaiting_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> guard(waitLock_);
+            spaceCv_.notify_one();
+          }
+          Deliver(item);
+        }
+      }
+
+      void Deliver(const Item &item)
+      {
+        /* 积压超过一半容量时跳过非参考帧，尽快追上实时 */
+        if (config_.policy == AliEngineVideoIngestDropNonReference && !item.reference &&
+            queue_.SizeApprox() * 2 > queue_.Capacity()) {
+          droppedNonReference_.fetch_add(1, std::memory_order_relaxed);
+          item.frame->Release();
+          return;
+        }
+        for (;;) {
+          const long long now = NowUs();
+          if (now - item.enqueueUs > static_cast<long long>(config_.maxFrameAgeMs) * 1000) {
+            droppedStale_.fetch_add(1, std::memory_order_relaxed);
+            break;
+          }
+          const int ret = sink_ ? sink_(opaque_, item.frame->Frame(), track_) : AliEngineErrorInvaildArgument;
+          if (ret == AliEngineErrorVideoBufferFull) {
+            retries_.fetch_add(1, std::memory_order_relaxed);
+            std::unique_lock<std::mutex> lock(waitLock_);
+            if (!running_.load(std::memory_order_acquire)) {
+              break;
+            }
+            dataCv_.wait_for(lock, std::chrono::milliseconds(config_.retryIntervalMs));
+            continue;
+          }
+          if (ret == 0) {
+            RecordLatency(static_cast<int>(NowUs() - item.enqueueUs));
+            delivered_.fetch_add(1, std::memory_order_relaxed);
+          }
+          break;
+        }
+        item.frame->Release();
+      }
+
+      void RecordLatency(int latencyUs)
+      {
+        lastLatencyUs_.store(latencyUs, std::memory_order_relaxed);
+        const int avg = avgLatencyUs_.load(std::memory_order_relaxed);
+        avgLatencyUs_.store(avg == 0 ? latencyUs : avg + (latencyUs - avg) / 8, std::memory_order_relaxed);
+        if (latencyUs > maxLatencyUs_.load(std::memory_order_relaxed)) {
+          maxLatencyUs_.store(latencyUs, std::memory_order_relaxed);
+        }
+      }
+
+      AliEngineVideoIngestSink sink_;
+      void* opaque_;
+      AliEngineVideoTrack track_;
+      AliEngineVideoIngestConfig config_;
+      internal::BoundedMpmcQueue<Item> queue_;
+
+      std::mutex threadLock_;
+      std::thread worker_;
+      std::atomic<bool> running_{false};
+      /* 正在执行 Enqueue 的生产者数 */
+      std::atomic<int> producers_{0};
+
+      std::mutex waitLock_;
+      std::condition_variable dataCv_;
+      std::condition_variable spaceCv_;
+      std::atomic<bool> consumerWaiting_{false};
+      std::atomic<int> producersWaiting_{0};
+
+      /* DropNonReference 策略下队列中的非参考帧数及其上限 */
+      std::atomic<int> nonReferenceQueued_{0};
+      int nonReferenceLimit_ = 0;
+
+      std::atomic<unsigned long long> enqueued_{0};
+      std::atomic<unsigned long long> delivered_{0};
+      std::atomic<unsigned long long> droppedOldest_{0};
+      std::atomic<unsigned long long> droppedNonReference_{0};
+      std::atomic<unsigned long long> droppedNew_{0};
+      std::atomic<unsigned long long> droppedStale_{0};
+      std::atomic<unsigned long long> retries_{0};
+      std::atomic<int> lastLatencyUs_{0};
+      std::atomic<int> avgLatencyUs_{0};
+      std::atomic<int> maxLatencyUs_{0};
+    };
+}
+
+#endif /* ali_rtc_engine_video_ingest_queue_h */
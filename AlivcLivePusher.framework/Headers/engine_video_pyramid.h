@@ -0,0 +1,581 @@
+#ifndef ali_rtc_engine_video_pyramid_h
+#define ali_rtc_engine_video_pyramid_h
+
+#include <math.h>
+#include <string.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_media_engine.h"
+#include "engine_video_aligned_frame.h"
+#include "engine_video_convert.h"
+#include "engine_worker_pool.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 缩放滤波器
+     */
+    typedef enum {
+      /** 区域平均，开销最低，适合整数倍缩小 */
+      AliEngineVideoPyramidFilterBox = 0,
+      /** 双线性（按缩放比例展宽），默认 */
+      AliEngineVideoPyramidFilterBilinear = 1,
+      /** Lanczos3，锐度最好，开销约为双线性的3倍 */
+      AliEngineVideoPyramidFilterLanczos = 2,
+    } AliEngineVideoPyramidFilter;
+
+    /**
+     * @brief 缩放金字塔配置
+     */
+    typedef struct AliEngineVideoPyramidConfig {
+      /** 滤波器，默认值：AliEngineVideoPyramidFilterBilinear */
+      AliEngineVideoPyramidFilter filter = AliEngineVideoPyramidFilterBilinear;
+      /** 并行线程数（包含调用线程），默认值：2 */
+      int threads = 2;
+    } AliEngineVideoPyramidConfig;
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      /** 滤波系数定点精度 */
+      enum { kPyramidCoefBits = 14, kPyramidInterBits = 6 };
+
+      /**
+       * @brief 一维缩放系数表
+       * @details 每个输出像素使用固定数量的抽头，源坐标已钳位到边界，不足的抽头权重为0
+       */
+      struct PyramidFilterTable {
+        int srcSize = 0;
+        int dstSize = 0;
+        int taps = 0;
+        /** 抽头数向上取整到8的倍数，供单通道SIMD路径整块读取 */
+        int paddedTaps = 0;
+        std::vector<int> index;
+        std::vector<int16_t> coef;
+        /** 每个输出像素首个抽头的源坐标（未钳位） */
+        std::vector<int> start;
+        /** 补零到 paddedTaps 的系数 */
+        std::vector<int16_t> paddedCoef;
+
+        static double Kernel(AliEngineVideoPyramidFilter filter, double t)
+        {
+          t = fabs(t);
+          switch (filter) {
+            case AliEngineVideoPyramidFilterBox:
+              return t < 0.5 ? 1.0 : (t == 0.5 ? 0.5 : 0.0);
+            case AliEngineVideoPyramidFilterLanczos: {
+              if (t < 1e-8) {
+                return 1.0;
+              }
+              if (t >= 3.0) {
+                return 0.0;
+              }
+              const double x = 3.14159265358979323846 * t;
+              return 3.0 * sin(x) * sin(x / 3.0) / (x * x);
+            }
+            default:
+              return t < 1.0 ? 1.0 - t : 0.0;
+          }
+        }
+
+        void Build(AliEngineVideoPyramidFilter filter, int src, int dst)
+        {
+          srcSize = src;
+          dstSize = dst;
+          const double scale = static_cast<double>(src) / dst;
+          const double stretch = scale > 1.0 ? scale : 1.0;
+          const double radius = (filter == AliEngineVideoPyramidFilterLanczos ? 3.0 :
+                                 filter == AliEngineVideoPyramidFilterBox ? 0.5 : 1.0) * stretch;
+          taps = static_cast<int>(ceil(radius * 2)) + 1;
+          paddedTaps = static_cast<int>(AlignUp(static_cast<size_t>(taps), 8));
+          index.assign(static_cast<size_t>(dst) * taps, 0);
+          coef.assign(index.size(), 0);
+          start.assign(dst, 0);
+          paddedCoef.assign(static_cast<size_t>(dst) * paddedTaps, 0);
+          std::vector<double> weights(taps);
+          for (int i = 0; i < dst; ++i) {
+            const double center = (i + 0.5) * scale - 0.5;
+            const int first = static_cast<int>(floor(center - radius)) + 1;
+            double sum = 0;
+            for (int k = 0; k < taps; ++k) {
+              weights[k] = Kernel(filter, (first + k - center) / stretch);
+              sum += weights[k];
+            }
+            int total = 0;
+            int largest = 0;
+            for (int k = 0; k < taps; ++k) {
+              const int j = first + k;
+              const int16_t c = static_cast<int16_t>(lrint(weights[k] / sum * (1 << kPyramidCoefBits)));
+              index[i * taps + k] = j < 0 ? 0 : (j >= src ? src - 1 : j);
+              coef[i * taps + k] = c;
+              total += c;
+              if (c > coef[i * taps + largest]) {
+                largest = k;
+              }
+            }
+            /* 舍入误差补到最大的抽头上，保证系数和严格为 1 << kPyramidCoefBits */
+            coef[i * taps + largest] = static_cast<int16_t>(coef[i * taps + largest] + (1 << kPyramidCoefBits) - total);
+            start[i] = first;
+            memcpy(&paddedCoef[static_cast<size_t>(i) * paddedTaps], &coef[static_cast<size_t>(i) * taps], taps * sizeof(int16_t));
+          }
+        }
+      };
+
+      /** 水平缩放一行，输出为放大 1 << kPyramidInterBits 倍的int16 */
+      template <int Channels>
+      inline void PyramidHorizontalRow(const uint8_t* ALI_RTC_RESTRICT src, int16_t* ALI_RTC_RESTRICT dst,
+                                       const PyramidFilterTable &table)
+      {
+        const int taps = table.taps;
+        const int width = table.dstSize;
+        const int* ALI_RTC_RESTRICT index = table.index.data();
+        const int16_t* ALI_RTC_RESTRICT coef = table.coef.data();
+        const int shift = kPyramidCoefBits - kPyramidInterBits;
+        const int round = 1 << (shift - 1);
+        for (int x = 0; x < width; ++x, index += taps, coef += taps) {
+          /* 远离边界时抽头在源行中连续，走SIMD路径 */
+          const int first = table.start[x];
+          if (Channels == 1 && first >= 0 && first + table.paddedTaps <= table.srcSize) {
+#if defined(ALI_RTC_SIMD_NEON)
+            const int16_t* padded = table.paddedCoef.data() + static_cast<size_t>(x) * table.paddedTaps;
+            int32x4_t sum = vdupq_n_s32(0);
+            for (int k = 0; k < table.paddedTaps; k += 8) {
+              const int16x8_t px = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src + first + k)));
+              const int16x8_t w = vld1q_s16(padded + k);
+              sum = vmlal_s16(sum, vget_low_s16(px), vget_low_s16(w));
+              sum = vmlal_s16(sum, vget_high_s16(px), vget_high_s16(w));
+            }
+            const int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+            dst[x] = static_cast<int16_t>((vget_lane_s32(vpadd_s32(half, half), 0) + round) >> shift);
+            continue;
+#elif defined(ALI_RTC_SIMD_SSE41)
+            const int16_t* padded = table.paddedCoef.data() + static_cast<size_t>(x) * table.paddedTaps;
+            __m128i sum = _mm_setzero_si128();
+            for (int k = 0; k < table.paddedTaps; k += 8) {
+              const __m128i px = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + first + k)));
+              sum = _mm_add_epi32(sum, _mm_madd_epi16(px, _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded + k))));
+            }
+            sum = _mm_hadd_epi32(sum, sum);
+            sum = _mm_hadd_epi32(sum, sum);
+            dst[x] = static_cast<int16_t>((_mm_cvtsi128_si32(sum) + round) >> shift);
+            continue;
+#endif
+          }
+          if (Channels == 4 && first >= 0 && first + taps <= table.srcSize) {
+#if defined(ALI_RTC_SIMD_NEON)
+            int32x4_t sum = vdupq_n_s32(round);
+            for (int k = 0; k < taps; ++k) {
+              uint32_t pixel;
+              memcpy(&pixel, src + (first + k) * 4, sizeof(pixel));
+              const int16x4_t px = vreinterpret_s16_u16(vget_low_u16(vmovl_u8(vcreate_u8(pixel))));
+              sum = vmlal_n_s16(sum, px, coef[k]);
+            }
+            vst1_s16(dst + x * 4, vmovn_s32(vshrq_n_s32(sum, shift)));
+            continue;
+#elif defined(ALI_RTC_SIMD_SSE41)
+            /* 像素扩展为32位后高16位为0，madd 与 (w, 0) 相乘即得 p * w */
+            __m128i sum = _mm_set1_epi32(round);
+            for (int k = 0; k < taps; ++k) {
+              int pixel;
+              memcpy(&pixel, src + (first + k) * 4, sizeof(pixel));
+              const __m128i px = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(pixel));
+              sum = _mm_add_epi32(sum, _mm_madd_epi16(px, _mm_set1_epi32(static_cast<uint16_t>(coef[k]))));
+            }
+            sum = _mm_srai_epi32(sum, shift);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packs_epi32(sum, sum));
+            continue;
+#endif
+          }
+          int acc[Channels];
+          for (int c = 0; c < Channels; ++c) {
+            acc[c] = round;
+          }
+          for (int k = 0; k < taps; ++k) {
+            const uint8_t* p = src + index[k] * Channels;
+            const int w = coef[k];
+            for (int c = 0; c < Channels; ++c) {
+              acc[c] += p[c] * w;
+            }
+          }
+          for (int c = 0; c < Channels; ++c) {
+            dst[x * Channels + c] = static_cast<int16_t>(acc[c] >> shift);
+          }
+        }
+      }
+
+      /** 垂直方向对若干中间行加权求和，输出8bit */
+      inline void PyramidVerticalRow(const int16_t* const* rows, const int16_t* coef, int taps,
+                                     uint8_t* ALI_RTC_RESTRICT dst, int width)
+      {
+        const int shift = kPyramidCoefBits + kPyramidInterBits;
+        int x = 0;
+#if defined(ALI_RTC_SIMD_NEON)
+        const int32x4_t kRound = vdupq_n_s32(1 << (shift - 1));
+        for (; x + 8 <= width; x += 8) {
+          int32x4_t lo = kRound;
+          int32x4_t hi = kRound;
+          for (int k = 0; k < taps; ++k) {
+            const int16x8_t v = vld1q_s16(rows[k] + x);
+            lo = vmlal_n_s16(lo, vget_low_s16(v), coef[k]);
+            hi = vmlal_n_s16(hi, vget_high_s16(v), coef[k]);
+          }
+          const int16x8_t packed = vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, shift)), vqmovn_s32(vshrq_n_s32(hi, shift)));
+          vst1_u8(dst + x, vqmovun_s16(packed));
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        const __m128i kRound = _mm_set1_epi32(1 << (shift - 1));
+        for (; x + 8 <= width; x += 8) {
+          __m128i lo = kRound;
+          __m128i hi = kRound;
+          int k = 0;
+          /* 两行交错后用 madd 一次完成两个抽头 */
+          for (; k + 2 <= taps; k += 2) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + x));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + x));
+            const __m128i c = _mm_set1_epi32(static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(coef[k + 1])) << 16) |
+                                                              static_cast<uint16_t>(coef[k])));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+          }
+          if (k < taps) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + x));
+            const __m128i c = _mm_set1_epi32(static_cast<uint16_t>(coef[k]));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, _mm_setzero_si128()), c));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, _mm_setzero_si128()), c));
+          }
+          const __m128i packed = _mm_packs_epi32(_mm_srai_epi32(lo, shift), _mm_srai_epi32(hi, shift));
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(packed, packed));
+        }
+#endif
+        for (; x < width; ++x) {
+          int acc = 1 << (shift - 1);
+          for (int k = 0; k < taps; ++k) {
+            acc += rows[k][x] * coef[k];
+          }
+          dst[x] = ClampU8(acc >> shift);
+        }
+      }
+    }
+
+    /**
+     * @brief 多级缩放金字塔
+     * @details 每帧采集数据只构建一次，双流的小流、预览以及各观测器需要的分辨率都从金字塔中取，避免各自独立缩放：
+     *  - 各级按面积从大到小构建，每一级从已构建的、尺寸不小于它的最小一级缩放得到，级联后总开销接近只缩放一次
+     *  - 缩放为可分离滤波，先水平后垂直，两个阶段都按行带分配到常驻线程池并行执行
+     *  - 垂直阶段使用 SSE4.1/NEON，系数表和各级内存在分辨率不变时复用
+     * 支持 I420、I422、NV12、NV21 以及32位打包格式，各级输出与输入格式相同
+     * @note 非线程安全，Build 与读取各级数据需在同一线程或由调用方同步
+     */
+    class AliEngineVideoPyramid {
+    public:
+      explicit AliEngineVideoPyramid(const AliEngineVideoPyramidConfig &config = AliEngineVideoPyramidConfig())
+        : config_(config), workers_(config.threads)
+      {
+        /* 行带任务只捕获 this，参数经 pass_ 传递，逐帧调用不构造 std::function */
+        horizontalBand_ = [this](int begin, int end) { HorizontalBand(begin, end); };
+        verticalBand_ = [this](int begin, int end) { VerticalBand(begin, end); };
+      }
+
+      /**
+       * @brief 添加一级输出
+       * @param width 宽
+       * @param height 高
+       * @return 该级的序号；参数错误返回-1
+       * @note 双流小流的分辨率可按 {@link AliEngineVideoEncoderConfiguration} 中大流尺寸的1/2或1/4添加
+       */
+      int AddLevel(int width, int height)
+      {
+        if (width <= 0 || height <= 0) {
+          return -1;
+        }
+        PyramidLevel* level = new PyramidLevel();
+        level->width = width;
+        level->height = height;
+        levels_.push_back(std::unique_ptr<PyramidLevel>(level));
+        order_.clear();
+        return static_cast<int>(levels_.size()) - 1;
+      }
+
+      /**
+       * @brief 移除所有级
+       */
+      void ClearLevels()
+      {
+        levels_.clear();
+        order_.clear();
+      }
+
+      /**
+       * @brief 由一帧采集数据构建所有级
+       * @param src 源帧
+       * @return true: 成功；false: 格式不支持或内存不足
+       */
+      bool Build(const AliEngineVideoRawData &src)
+      {
+        internal::VideoPlanes planes;
+        if (!internal::ResolveVideoPlanes(src, planes) || !IsSupported(src.format)) {
+          return false;
+        }
+        if (order_.size() != levels_.size()) {
+          SortLevels();
+        }
+        for (size_t i = 0; i < order_.size(); ++i) {
+          PyramidLevel &level = *levels_[order_[i]];
+          level.valid = false;
+          if (!level.frame.Allocate(src.format, level.width, level.height, 16)) {
+            return false;
+          }
+          /* 从尺寸不小于本级的最小一级取源，没有则用原始帧 */
+          const AliEngineVideoRawData* source = &src;
+          for (size_t j = i; j-- > 0;) {
+            const PyramidLevel &larger = *levels_[order_[j]];
+            if (larger.valid && larger.width >= level.width && larger.height >= level.height) {
+              source = &larger.frame.Frame();
+              break;
+            }
+          }
+          if (!Scale(*source, level)) {
+            return false;
+          }
+          level.frame.Frame().timeStamp = src.timeStamp;
+          level.frame.Frame().rotation = src.rotation;
+          level.valid = true;
+        }
+        return true;
+      }
+
+      /**
+       * @brief 获取某一级数据
+       * @param index {@link AddLevel} 返回的序号
+       * @return 该级帧数据，未构建或序号无效时返回空，数据在下一次 Build 前有效
+       */
+      const AliEngineVideoRawData* Level(int index) const
+      {
+        if (index < 0 || index >= static_cast<int>(levels_.size()) || !levels_[index]->valid) {
+          return nullptr;
+        }
+        return &levels_[index]->frame.Frame();
+      }
+
+      /**
+       * @brief 级数
+       */
+      int LevelCount() const { return static_cast<int>(levels_.size()); }
+
+      /**
+       * @brief 是否支持该格式
+       */
+      static bool IsSupported(AliEngineVideoFormat format)
+      {
+        return internal::IsYuvFormat(format) || internal::PackedBytesPerPixel(format) == 4;
+      }
+
+    private:
+      struct PlaneFilter {
+        internal::PyramidFilterTable horizontal;
+        internal::PyramidFilterTable vertical;
+      };
+
+      /* 当前平面的缩放参数，由 ScalePlane 设置，供各行带读取 */
+      struct ScalePass {
+        const uint8_t* src = nullptr;
+        int srcStride = 0;
+        uint8_t* dst = nullptr;
+        int dstStride = 0;
+        int channels = 0;
+        int rowElems = 0;
+        size_t interStride = 0;
+        const PlaneFilter* filter = nullptr;
+      };
+
+      struct PyramidLevel {
+        int width = 0;
+        int height = 0;
+        bool valid = false;
+        AliEngineAlignedVideoFrame frame;
+        /* 0: 亮度/打包平面 1: 色度平面 */
+        PlaneFilter filters[2];
+        /* 滤波表对应的源格式与各平面尺寸，任一变化都需重建 */
+        AliEngineVideoFormat sourceFormat = AliEngineVideoFormatUnknow;
+        int sourceWidth = 0;
+        int sourceHeight = 0;
+        int sourceChromaWidth = 0;
+        int sourceChromaHeight = 0;
+      };
+
+      AliEngineVideoPyramid(const AliEngineVideoPyramid&);
+      AliEngineVideoPyramid& operator=(const AliEngineVideoPyramid&);
+
+      void SortLevels()
+      {
+        order_.resize(levels_.size());
+        for (size_t i = 0; i < order_.size(); ++i) {
+          order_[i] = i;
+        }
+        for (size_t i = 1; i < order_.size(); ++i) {
+          for (size_t j = i; j > 0 && Area(order_[j]) > Area(order_[j - 1]); --j) {
+            const size_t t = order_[j];
+            order_[j] = order_[j - 1];
+            order_[j - 1] = t;
+          }
+        }
+      }
+
+      long long Area(size_t index) const
+      {
+        return static_cast<long long>(levels_[index]->width) * levels_[index]->height;
+      }
+
+      bool Scale(const AliEngineVideoRawData &src, PyramidLevel &level)
+      {
+        internal::VideoPlanes in;
+        internal::VideoPlanes out;
+        if (!internal::ResolveVideoPlanes(src, in) || !internal::ResolveVideoPlanes(level.frame.Frame(), out)) {
+          return false;
+        }
+        if (src.width == level.width && src.height == level.height) {
+          CopyLevel(src, in, out);
+          return true;
+        }
+        const int chromaRows = src.format == AliEngineVideoFormatI422 ? 0 : 1;
+        const int scw = in.packed ? 0 : (src.width + 1) / 2;
+        const int sch = in.packed ? 0 : (chromaRows ? (src.height + 1) / 2 : src.height);
+        const int dcw = (level.width + 1) / 2;
+        const int dch = chromaRows ? (level.height + 1) / 2 : level.height;
+        const bool rebuild = src.format != level.sourceFormat || src.width != level.sourceWidth ||
+                             src.height != level.sourceHeight || scw != level.sourceChromaWidth ||
+                             sch != level.sourceChromaHeight;
+        level.sourceFormat = src.format;
+        level.sourceWidth = src.width;
+        level.sourceHeight = src.height;
+        level.sourceChromaWidth = scw;
+        level.sourceChromaHeight = sch;
+        if (in.packed) {
+          if (rebuild) {
+            BuildFilters(level.filters[0], src.width, src.height, level.width, level.height);
+          }
+          ScalePlane(in.packed, in.stride, out.packed, out.stride, 4, level.filters[0]);
+          return true;
+        }
+        if (rebuild) {
+          BuildFilters(level.filters[0], src.width, src.height, level.width, level.height);
+          BuildFilters(level.filters[1], scw, sch, dcw, dch);
+        }
+        ScalePlane(in.y, in.strideY, out.y, out.strideY, 1, level.filters[0]);
+        if (internal::IsSemiPlanarFormat(src.format)) {
+          ScalePlane(in.u, in.strideU, out.u, out.strideU, 2, level.filters[1]);
+        } else {
+          ScalePlane(in.u, in.strideU, out.u, out.strideU, 1, level.filters[1]);
+          ScalePlane(in.v, in.strideV, out.v, out.strideV, 1, level.filters[1]);
+        }
+        return true;
+      }
+
+      /* 与源帧同尺寸的级直接拷贝 */
+      void CopyLevel(const AliEngineVideoRawData &src, const internal::VideoPlanes &in, const internal::VideoPlanes &out)
+      {
+        if (in.packed) {
+          internal::CopyPlane(in.packed, in.stride, out.packed, out.stride, src.width * 4, src.height);
+          return;
+        }
+        const int cw = (src.width + 1) / 2;
+        const int ch = src.format == AliEngineVideoFormatI422 ? src.height : (src.height + 1) / 2;
+        internal::CopyPlane(in.y, in.strideY, out.y, out.strideY, src.width, src.height);
+        if (internal::IsSemiPlanarFormat(src.format)) {
+          internal::CopyPlane(in.u, in.strideU, out.u, out.strideU, cw * 2, ch);
+        } else {
+          internal::CopyPlane(in.u, in.strideU, out.u, out.strideU, cw, ch);
+          internal::CopyPlane(in.v, in.strideV, out.v, out.strideV, cw, ch);
+        }
+      }
+
+      void BuildFilters(PlaneFilter &filter, int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+      {
+        filter.horizontal.Build(config_.filter, srcWidth, dstWidth);
+        filter.vertical.Build(config_.filter, srcHeight, dstHeight);
+      }
+
+      void ScalePlane(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride, int channels,
+                      const PlaneFilter &filter)
+      {
+        const internal::PyramidFilterTable &h = filter.horizontal;
+        const internal::PyramidFilterTable &v = filter.vertical;
+        pass_.src = src;
+        pass_.srcStride = srcStride;
+        pass_.dst = dst;
+        pass_.dstStride = dstStride;
+        pass_.channels = channels;
+        pass_.rowElems = h.dstSize * channels;
+        pass_.interStride = internal::AlignUp(static_cast<size_t>(pass_.rowElems), 16);
+        pass_.filter = &filter;
+        /* 中间结果与行指针表只增不减，稳定状态下不分配内存 */
+        if (intermediate_.size() < pass_.interStride * v.srcSize) {
+          intermediate_.resize(pass_.interStride * v.srcSize);
+        }
+        if (rowPointers_.size() < static_cast<size_t>(v.dstSize) * v.taps) {
+          rowPointers_.resize(static_cast<size_t>(v.dstSize) * v.taps);
+        }
+        workers_.Run(v.srcSize, horizontalBand_);
+        workers_.Run(v.dstSize, verticalBand_);
+      }
+
+      void HorizontalBand(int begin, int end)
+      {
+        const internal::PyramidFilterTable &h = pass_.filter->horizontal;
+        for (int y = begin; y < end; ++y) {
+          const uint8_t* row = pass_.src + static_cast<size_t>(y) * pass_.srcStride;
+          int16_t* out = intermediate_.data() + y * pass_.interStride;
+          if (pass_.channels == 1) {
+            internal::PyramidHorizontalRow<1>(row, out, h);
+          } else if (pass_.channels == 2) {
+            internal::PyramidHorizontalRow<2>(row, out, h);
+          } else {
+            internal::PyramidHorizontalRow<4>(row, out, h);
+          }
+        }
+      }
+
+      /* 每个输出行使用行指针表中自己的一段，各行带互不重叠 */
+      void VerticalBand(int begin, int end)
+      {
+        const internal::PyramidFilterTable &v = pass_.filter->vertical;
+        const int16_t* inter = intermediate_.data();
+        for (int y = begin; y < end; ++y) {
+          const int* index = v.index.data() + y * v.taps;
+          const int16_t** rows = rowPointers_.data() + static_cast<size_t>(y) * v.taps;
+          for (int k = 0; k < v.taps; ++k) {
+            rows[k] = inter + index[k] * pass_.interStride;
+          }
+          internal::PyramidVerticalRow(rows, v.coef.data() + y * v.taps, v.taps,
+                                       pass_.dst + static_cast<size_t>(y) * pass_.dstStride, pass_.rowElems);
+        }
+      }
+
+      AliEngineVideoPyramidConfig config_;
+      internal::BandWorkerPool workers_;
+      std::vector<std::unique_ptr<PyramidLevel>> levels_;
+      std::vector<size_t> order_;
+      std::vector<int16_t> intermediate_;
+      std::vector<const int16_t*> rowPointers_;
+      ScalePass pass_;
+      std::function<void(int, int)> horizontalBand_;
+      std::function<void(int, int)> verticalBand_;
+    };
+}
+
+#endif /* ali_rtc_engine_video_pyramid_h */
@@ -0,0 +1,336 @@
+#ifndef ali_rtc_engine_video_static_detector_h
+#define ali_rtc_engine_video_static_detector_h
+
+#include <string.h>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_interface.h"
+#include "engine_video_convert.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 静止画面检测配置
+     */
+    typedef struct AliEngineStaticFrameConfig {
+      /** 分块边长，在2x2下采样后的亮度平面上计算，单位：像素，默认值：16 */
+      int blockSize = 16;
+      /** 分块亮度差绝对值之和（SAD）的阈值，超过视为该块变化。默认值适合屏幕内容，细如光标的变化也能检出；
+       * 摄像头等带噪声的画面可按 blockSize * blockSize * 3 设置，默认值：64 */
+      int blockSadThreshold = 64;
+      /** 变化块数不超过该值时视为画面未变化，默认值：0 */
+      int maxChangedBlocks = 0;
+      /** 连续多少帧未变化后进入静止状态，默认值：3 */
+      int framesToStatic = 3;
+      /** 静止状态下的保活帧间隔，单位：ms，默认值：1000 */
+      int keepAliveIntervalMs = 1000;
+    } AliEngineStaticFrameConfig;
+
+    /**
+     * @brief 静止画面检测结果
+     */
+    typedef enum {
+      /** 画面有变化，正常送编码 */
+      AliEngineStaticFrameEncode = 0,
+      /** 画面静止，跳过该帧 */
+      AliEngineStaticFrameSkip = 1,
+      /** 画面静止，按保活间隔送出该帧 */
+      AliEngineStaticFrameKeepAlive = 2,
+    } AliEngineStaticFrameDecision;
+
+    /**
+     * @brief 静止画面检测统计信息
+     */
+    typedef struct AliEngineStaticFrameStats {
+      /** 检测帧数 */
+      unsigned long long totalFrames = 0;
+      /** 跳过的帧数 */
+      unsigned long long skippedFrames = 0;
+      /** 保活帧数 */
+      unsigned long long keepAliveFrames = 0;
+      /** 进入静止状态的次数 */
+      unsigned long long staticTransitions = 0;
+      /** 最近一帧的变化块数 */
+      int lastChangedBlocks = 0;
+      /** 分块总数 */
+      int totalBlocks = 0;
+      /** 当前是否处于静止状态 */
+      bool isStatic = false;
+    } AliEngineStaticFrameStats;
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      /** 行内相邻两像素取平均，输出宽度为 width / 2 */
+      inline void HalveRow(const uint8_t* ALI_RTC_RESTRICT src, uint8_t* ALI_RTC_RESTRICT dst, int width)
+      {
+        const int half = width / 2;
+        int x = 0;
+#if defined(ALI_RTC_SIMD_NEON)
+        for (; x + 8 <= half; x += 8) {
+          vst1_u8(dst + x, vrshrn_n_u16(vpaddlq_u8(vld1q_u8(src + x * 2)), 1));
+        }
+#elif defined(ALI_RTC_SIMD_SSE41)
+        const __m128i kOnes = _mm_set1_epi8(1);
+        const __m128i kRound = _mm_set1_epi16(1);
+        for (; x + 8 <= half; x += 8) {
+          const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+          const __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_maddubs_epi16(s, kOnes), kRound), 1);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(sum, sum));
+        }
+#endif
+        for (; x < half; ++x) {
+          dst[x] = static_cast<uint8_t>((src[x * 2] + src[x * 2 + 1] + 1) >> 1);
+        }
+      }
+
+      /** 按 blockSize 像素分段累加两行的绝对差，sums[i] 对应第 i 段 */
+      inline void AccumulateBlockSad(const uint8_t* a, const uint8_t* b, int width, int blockSize, uint32_t* sums)
+      {
+        int x = 0;
+        if ((blockSize & 15) == 0) {
+#if defined(ALI_RTC_SIMD_AVX2)
+          if ((blockSize & 31) == 0) {
+            for (; x + 32 <= width; x += 32) {
+              const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + x));
+              const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x));
+              const __m256i sad = _mm256_sad_epu8(va, vb);
+              const __m128i s = _mm_add_epi64(_mm256_castsi256_si128(sad), _mm256_extracti128_si256(sad, 1));
+              sums[x / blockSize] += static_cast<uint32_t>(_mm_cvtsi128_si32(s) + _mm_extract_epi32(s, 2));
+            }
+          }
+#endif
+#if defined(ALI_RTC_SIMD_NEON)
+          for (; x + 16 <= width; x += 16) {
+            const uint16x8_t d = vpaddlq_u8(vabdq_u8(vld1q_u8(a + x), vld1q_u8(b + x)));
+            const uint64x2_t s = vpaddlq_u32(vpaddlq_u16(d));
+            sums[x / blockSize] += static_cast<uint32_t>(vgetq_lane_u64(s, 0) + vgetq_lane_u64(s, 1));
+          }
+#elif defined(ALI_RTC_SIMD_SSE41)
+          for (; x + 16 <= width; x += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+            const __m128i sad = _mm_sad_epu8(va, vb);
+            sums[x / blockSize] += static_cast<uint32_t>(_mm_cvtsi128_si32(sad) + _mm_extract_epi32(sad, 2));
+          }
+#endif
+        }
+        for (; x < width; ++x) {
+          const int d = a[x] - b[x];
+          sums[x / blockSize] += static_cast<uint32_t>(d < 0 ? -d : d);
+        }
+      }
+    }
+
+    /**
+     * @brief 静止画面检测器
+     * @details 放在 {@link IAliEngineMediaEngine::PushExternalVideoFrame} 之前，每帧：
+     *  - 提取亮度并做2x2下采样，计算量约为原图的1/4
+     *  - 与上一次送出的帧按块计算SAD（SSE4.1/AVX2/NEON），以送出帧而不是上一帧为参考，缓慢渐变累积超过阈值后仍会送出
+     *  - 连续 framesToStatic 帧未变化后进入静止状态，只按保活间隔送帧，编码器在静止期间基本空闲
+     *  - 进入和退出静止状态时回调 {@link AliEngineEventListener::OnPublishStaticVideoFrame}
+     * 适用于屏幕共享中的幻灯片、暂停的游戏画面等场景
+     * @note 非线程安全，请在推流线程调用；支持所有裸数据格式，打包RGB格式需先转换亮度，开销高于YUV格式
+     */
+    class AliEngineStaticFrameDetector {
+    public:
+      /**
+       * @param config 检测配置，详见 {@link AliEngineStaticFrameConfig}
+       * @param listener 状态变化回调，可为空
+       * @param track 回调中携带的流类型
+       */
+      explicit AliEngineStaticFrameDetector(const AliEngineStaticFrameConfig &config = AliEngineStaticFrameConfig(),
+                                            AliEngineEventListener* listener = nullptr,
+                                            AliEngineVideoTrack track = AliEngineVideoTrackScreen)
+        : config_(config), listener_(listener), track_(track) {
+        if (config_.blockSize <= 0) {
+          config_.blockSize = 16;
+        }
+      }
+
+      /**
+       * @brief 检测一帧
+       * @param frame 视频裸数据
+       * @param nowMs 当前时间，单位：ms，用于保活间隔
+       * @return 处理结果，详见 {@link AliEngineStaticFrameDecision}；无法解析的帧返回 AliEngineStaticFrameEncode
+       */
+      AliEngineStaticFrameDecision Process(const AliEngineVideoRawData &frame, long long nowMs)
+      {
+        ++stats_.totalFrames;
+        if (!ExtractLuma(frame)) {
+          Invalidate();
+          return AliEngineStaticFrameEncode;
+        }
+        if (!hasReference_) {
+          return Send(nowMs, AliEngineStaticFrameEncode);
+        }
+        stats_.lastChangedBlocks = CountChangedBlocks();
+        if (stats_.lastChangedBlocks > config_.maxChangedBlocks) {
+          unchangedFrames_ = 0;
+          if (stats_.isStatic) {
+            SetStatic(false);
+          }
+          return Send(nowMs, AliEngineStaticFrameEncode);
+        }
+        if (!stats_.isStatic) {
+          if (++unchangedFrames_ < config_.framesToStatic) {
+            return Send(nowMs, AliEngineStaticFrameEncode);
+          }
+          SetStatic(true);
+        }
+        if (nowMs - lastSentMs_ >= config_.keepAliveIntervalMs) {
+          ++stats_.keepAliveFrames;
+          return Send(nowMs, AliEngineStaticFrameKeepAlive);
+        }
+        ++stats_.skippedFrames;
+        return AliEngineStaticFrameSkip;
+      }
+
+      /**
+       * @brief 强制下一帧送出，例如编码器请求关键帧时
+       */
+      void Invalidate()
+      {
+        hasReference_ = false;
+        unchangedFrames_ = 0;
+        if (stats_.isStatic) {
+          SetStatic(false);
+        }
+      }
+
+      /**
+       * @brief 获取统计信息
+       */
+      const AliEngineStaticFrameStats &GetStats() const { return stats_; }
+
+    private:
+      AliEngineStaticFrameDetector(const AliEngineStaticFrameDetector&);
+      AliEngineStaticFrameDetector& operator=(const AliEngineStaticFrameDetector&);
+
+      AliEngineStaticFrameDecision Send(long long nowMs, AliEngineStaticFrameDecision decision)
+      {
+        current_.swap(reference_);
+        hasReference_ = true;
+        lastSentMs_ = nowMs;
+        return decision;
+      }
+
+      void SetStatic(bool isStatic)
+      {
+        stats_.isStatic = isStatic;
+        if (isStatic) {
+          ++stats_.staticTransitions;
+        }
+        if (listener_) {
+          listener_->OnPublishStaticVideoFrame(track_, isStatic);
+        }
+      }
+
+      bool ExtractLuma(const AliEngineVideoRawData &frame)
+      {
+        internal::VideoPlanes planes;
+        if (frame.width < 2 || frame.height < 2 || !internal::ResolveVideoPlanes(frame, planes)) {
+          return false;
+        }
+        const int w = frame.width / 2;
+        const int h = frame.height / 2;
+        if (w != width_ || h != height_) {
+          width_ = w;
+          height_ = h;
+          current_.assign(static_cast<size_t>(w) * h, 0);
+          reference_.assign(current_.size(), 0);
+          hasReference_ = false;
+          const int bw = (w + config_.blockSize - 1) / config_.blockSize;
+          const int bh = (h + config_.blockSize - 1) / config_.blockSize;
+          stats_.totalBlocks = bw * bh;
+          blockSums_.assign(bw, 0);
+        }
+        const int fullWidth = w * 2;
+        average_.resize(fullWidth);
+        const bool packed = planes.packed != nullptr;
+        if (packed) {
+          rowA_.resize(fullWidth);
+          rowB_.resize(fullWidth);
+          bgra_.resize(static_cast<size_t>(fullWidth) * 4);
+        }
+        for (int y = 0; y < h; ++y) {
+          const uint8_t* r0;
+          const uint8_t* r1;
+          if (packed) {
+            r0 = PackedRowToLuma(frame.format, planes.packed + static_cast<size_t>(y * 2) * planes.stride, rowA_.data(), fullWidth);
+            r1 = PackedRowToLuma(frame.format, planes.packed + static_cast<size_t>(y * 2 + 1) * planes.stride, rowB_.data(), fullWidth);
+          } else {
+            r0 = planes.y + static_cast<size_t>(y * 2) * planes.strideY;
+            r1 = r0 + planes.strideY;
+          }
+          internal::AverageRows(r0, r1, average_.data(), fullWidth);
+          internal::HalveRow(average_.data(), current_.data() + static_cast<size_t>(y) * w, fullWidth);
+        }
+        return true;
+      }
+
+      const uint8_t* PackedRowToLuma(AliEngineVideoFormat format, const uint8_t* src, uint8_t* luma, int width)
+      {
+        const uint8_t* bgra = src;
+        if (format != AliEngineVideoFormatBGRA) {
+          internal::PackedRowToBgra(format, src, bgra_.data(), width);
+          bgra = bgra_.data();
+        }
+        internal::BgraRowToY(bgra, luma, width);
+        return luma;
+      }
+
+      int CountChangedBlocks()
+      {
+        const int bs = config_.blockSize;
+        const int bw = static_cast<int>(blockSums_.size());
+        int changed = 0;
+        for (int by = 0; by * bs < height_; ++by) {
+          const int rows = height_ - by * bs < bs ? height_ - by * bs : bs;
+          memset(blockSums_.data(), 0, blockSums_.size() * sizeof(uint32_t));
+          for (int r = 0; r < rows; ++r) {
+            const size_t offset = static_cast<size_t>(by * bs + r) * width_;
+            internal::AccumulateBlockSad(current_.data() + offset, reference_.data() + offset, width_, bs, blockSums_.data());
+          }
+          for (int bx = 0; bx < bw; ++bx) {
+            if (blockSums_[bx] > static_cast<uint32_t>(config_.blockSadThreshold)) {
+              ++changed;
+            }
+          }
+        }
+        return changed;
+      }
+
+      AliEngineStaticFrameConfig config_;
+      AliEngineEventListener* listener_;
+      AliEngineVideoTrack track_;
+      AliEngineStaticFrameStats stats_;
+      std::vector<uint8_t> current_;
+      std::vector<uint8_t> reference_;
+      std::vector<uint8_t> average_;
+      std::vector<uint8_t> rowA_;
+      std::vector<uint8_t> rowB_;
+      std::vector<uint8_t> bgra_;
+      std::vector<uint32_t> blockSums_;
+      int width_ = 0;
+      int height_ = 0;
+      int unchangedFrames_ = 0;
+      bool hasReference_ = false;
+      long long lastSentMs_ = 0;
+    };
+}
+
+#endif /* ali_rtc_engine_video_static_detector_h */
@@ -0,0 +1,447 @@
+#ifndef ali_rtc_engine_video_transform_h
+#define ali_rtc_engine_video_transform_h
+
+#include <algorithm>
+#include <vector>
+
+#include "engine_simd_utils.h"
+#include "engine_interface.h"
+#include "engine_video_convert.h"
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+    /**
+     * @addtogroup AliRtcDef_cpp 关键类型定义
+     * AliRtc 关键类型定义
+     * @{
+     */
+
+    /**
+     * @brief 缩放滤波方式
+     */
+    typedef enum {
+      /** 最近邻，速度最快 */
+      AliEngineVideoFilterNearest = 0,
+      /** 双线性（默认） */
+      AliEngineVideoFilterBilinear = 1,
+    } AliEngineVideoFilterMode;
+
+    /**
+     * @brief 裁剪、缩放、旋转、镜像参数
+     * @details 处理顺序等价于：裁剪 -> 缩放 -> 顺时针旋转 -> 水平镜像，实际在一次遍历中完成
+     */
+    typedef struct AliEngineVideoTransformParam {
+      /** 裁剪区域，宽或高为0时使用整帧。I420/NV12 下起点会向下取偶 */
+      int cropX = 0;
+      int cropY = 0;
+      int cropWidth = 0;
+      int cropHeight = 0;
+      /** 输出宽高（旋转后），为0时等于裁剪区域旋转后的尺寸 */
+      int dstWidth = 0;
+      int dstHeight = 0;
+      /** 顺时针旋转角度，仅支持0、90、180、270 */
+      AliEngineRotationMode rotation = AliEngineRotationMode_0;
+      /** 是否在旋转后做水平镜像 */
+      bool mirror = false;
+      /** 缩放滤波方式 */
+      AliEngineVideoFilterMode filter = AliEngineVideoFilterBilinear;
+    } AliEngineVideoTransformParam;
+
+    /**
+     * @}
+     */
+
+    namespace internal
+    {
+      /**
+       * 单方向采样表：每个输出位置 taps 个抽头，源索引已乘像素字节数或行stride，权重之和为256，不足 taps 的补零权重。
+       * 缩小不足2倍时为双线性两抽头；缩小2倍及以上时为区域平均：每个源像素视为以其中心为中点、宽2像素的足迹，
+       * 按与输出像素足迹的重叠长度加权。足迹加宽一倍等价于区域平均再叠加2像素盒式滤波，在源 Nyquist 处响应为零，
+       * 缩小比例为奇数时也不会把逐像素的高频混叠到输出
+       */
+      struct SampleTaps {
+        int taps = 0;
+        /* 每个输出位置连续存放 taps 个源索引和 taps 个权重 */
+        std::vector<int> entries;
+
+        const int* At(int k) const { return &entries[static_cast<size_t>(k) * taps * 2]; }
+      };
+
+      /** 源像素 i 的2像素宽足迹与输出足迹 [lo, hi) 的重叠长度，单位见 BuildSampleTaps */
+      inline long long AreaOverlap(int i, int outLen, long long lo, long long hi)
+      {
+        const long long a = (2LL * i - 1) * outLen;
+        const long long overlap = std::min(hi, a + 4LL * outLen) - std::max(lo, a);
+        return overlap > 0 ? overlap : 0;
+      }
+
+      /**
+       * 计算单方向采样表
+       * @param count 驱动该方向的输出长度
+       * @param outLen 缩放后（旋转前）该方向长度
+       * @param reverse 是否反向（旋转/镜像带来的翻转）
+       * @param srcStart 裁剪起点
+       * @param srcLen 裁剪长度
+       * @param scale 索引乘数（像素字节数或行stride）
+       */
+      inline void BuildSampleTaps(SampleTaps &table, int count, int outLen, bool reverse,
+                                  int srcStart, int srcLen, int scale, bool nearest)
+      {
+        const bool area = !nearest && srcLen >= outLen * 2;
+        /* 区域平均时与输出足迹重叠的源像素中心落在长为 srcLen / outLen + 2 的开区间内，最多 ceil(srcLen / outLen) + 2 个 */
+        table.taps = nearest ? 1 : (area ? (srcLen + outLen - 1) / outLen + 2 : 2);
+        table.entries.resize(static_cast<size_t>(count) * table.taps * 2);
+        const long long step = (static_cast<long long>(srcLen) << 16) / outLen;
+        const long long maxPos = static_cast<long long>(srcLen - 1) << 16;
+        for (int k = 0; k < count; ++k) {
+          const int u = reverse ? outLen - 1 - k : k;
+          int* index = &table.entries[static_cast<size_t>(k) * table.taps * 2];
+          int* weight = index + table.taps;
+          if (area) {
+            /*
+             * 以 1 / (2 * outLen) 像素为单位做整数运算：输出像素 u 的足迹为 [2u * srcLen, 2(u + 1) * srcLen)，
+             * 源像素 i 的足迹为 [(2i - 1) * outLen, (2i + 3) * outLen)；越界的抽头以边缘像素为轴镜像取值，
+             * 保持边缘处的滤波对称，奇偶交替的图案不会在边缘偏亮或偏暗
+             */
+            const long long lo = 2LL * u * srcLen;
+            const long long hi = lo + 2LL * srcLen;
+            /* 第一个重叠的源像素：大于 u * srcLen / outLen - 1.5 的最小整数 */
+            const long long edge = lo - 3LL * outLen;
+            const int first = static_cast<int>((edge >= 0 ? edge / (2LL * outLen) : -((-edge + 2LL * outLen - 1) / (2LL * outLen))) + 1);
+            /* 源足迹宽2像素、间隔1像素，输出足迹上每一点恰被两个源足迹覆盖，重叠长度之和为 2 * (hi - lo) */
+            const long long covered = 4LL * srcLen;
+            /* 按累计重叠量取整后做差，权重非负且和恰为256 */
+            long long accumulated = 0;
+            int previous = 0;
+            for (int t = 0; t < table.taps; ++t) {
+              int i = first + t < 0 ? -(first + t) : (first + t < srcLen ? first + t : 2 * (srcLen - 1) - (first + t));
+              i = i < 0 ? 0 : (i < srcLen ? i : srcLen - 1);
+              accumulated += AreaOverlap(first + t, outLen, lo, hi);
+              const int rounded = static_cast<int>((accumulated * 256 + covered / 2) / covered);
+              index[t] = (srcStart + i) * scale;
+              weight[t] = rounded - previous;
+              previous = rounded;
+            }
+            continue;
+          }
+          /* 像素中心对齐：src = (u + 0.5) * srcLen / outLen - 0.5 */
+          long long pos = u * step + step / 2 - 32768;
+          pos = pos < 0 ? 0 : (pos > maxPos ? maxPos : pos);
+          if (nearest) {
+            index[0] = (srcStart + static_cast<int>((pos + 32768) >> 16)) * scale;
+            weight[0] = 256;
+            continue;
+          }
+          const int i0 = static_cast<int>(pos >> 16);
+          const int f = static_cast<int>((pos >> 8) & 0xFF);
+          const int i1 = i0 + 1 < srcLen ? i0 + 1 : i0;
+          index[0] = (srcStart + i0) * scale;
+          index[1] = (srcStart + i1) * scale;
+          weight[0] = 256 - f;
+          weight[1] = f;
+        }
+      }
+
+      /** 按 x、y 两个方向的抽头做可分离加权，TAPS 为0时抽头数取运行时的 tx/ty */
+      template <int BPP, int TAPS>
+      ALI_RTC_FORCE_INLINE void SampleFiltered(const uint8_t* src, const int* xi, int tx, const int* yi, int ty, uint8_t* out)
+      {
+        if (TAPS == 2) {
+          /* 双线性：权重为 (256 - f, f) */
+          const uint8_t* row0 = src + yi[0];
+          const uint8_t* row1 = src + yi[1];
+          const int fx = xi[3], fy = yi[3];
+          for (int c = 0; c < BPP; ++c) {
+            const int top = row0[xi[0] + c] * (256 - fx) + row0[xi[1] + c] * fx;
+            const int bottom = row1[xi[0] + c] * (256 - fx) + row1[xi[1] + c] * fx;
+            out[c] = static_cast<uint8_t>((top * (256 - fy) + bottom * fy + 32768) >> 16);
+          }
+          return;
+        }
+        tx = TAPS ? TAPS : tx;
+        ty = TAPS ? TAPS : ty;
+        const int* xw = xi + tx;
+        const int* yw = yi + ty;
+        int sum[BPP] = {0};
+        for (int j = 0; j < ty; ++j) {
+          const uint8_t* row = src + yi[j];
+          int rowSum[BPP] = {0};
+          for (int i = 0; i < tx; ++i) {
+            const uint8_t* p = row + xi[i];
+            const int w = xw[i];
+            for (int c = 0; c < BPP; ++c) {
+              rowSum[c] += p[c] * w;
+            }
+          }
+          for (int c = 0; c < BPP; ++c) {
+            sum[c] += rowSum[c] * yw[j];
+          }
+        }
+        for (int c = 0; c < BPP; ++c) {
+          out[c] = static_cast<uint8_t>((sum[c] + 32768) >> 16);
+        }
+      }
+
+      /**
+       * 单平面融合变换
+       * @param tapsX 源x方向采样表（不交换时按输出列索引，交换时按输出行索引）
+       * @param tapsY 源y方向采样表（不交换时按输出行索引，交换时按输出列索引）
+       * @param swapped 90/270度旋转时源x由输出行驱动
+       */
+      template <int BPP, int TAPS>
+      inline void TransformPlaneTaps(const uint8_t* src, uint8_t* dst, int dstStride, int dstWidth, int dstHeight,
+                                     const SampleTaps &tapsX, const SampleTaps &tapsY, bool swapped)
+      {
+        const int tx = TAPS ? TAPS : tapsX.taps, ty = TAPS ? TAPS : tapsY.taps;
+        if (!swapped) {
+          /* 0/180度：输出行对应源行，按行顺序流式访问 */
+          for (int oy = 0; oy < dstHeight; ++oy) {
+            const int* yi = tapsY.At(oy);
+            const int* xi = tapsX.At(0);
+            uint8_t* out = dst + static_cast<size_t>(oy) * dstStride;
+            for (int ox = 0; ox < dstWidth; ++ox, xi += tx * 2) {
+              SampleFiltered<BPP, TAPS>(src, xi, tx, yi, ty, out + ox * BPP);
+            }
+          }
+          return;
+        }
+        /* 90/270度：输出行对应源列，按块遍历使源访问落在小范围内，避免跨行跳读造成缓存失效 */
+        const int kTile = 32;
+        for (int by = 0; by < dstHeight; by += kTile) {
+          const int ey = by + kTile < dstHeight ? by + kTile : dstHeight;
+          for (int bx = 0; bx < dstWidth; bx += kTile) {
+            const int ex = bx + kTile < dstWidth ? bx + kTile : dstWidth;
+            for (int oy = by; oy < ey; ++oy) {
+              const int* xi = tapsX.At(oy);
+              const int* yi = tapsY.At(bx);
+              uint8_t* out = dst + static_cast<size_t>(oy) * dstStride;
+              for (int ox = bx; ox < ex; ++ox, yi += ty * 2) {
+                SampleFiltered<BPP, TAPS>(src, xi, tx, yi, ty, out + ox * BPP);
+              }
+            }
+          }
+        }
+      }
+
+      /** 双线性两抽头展开为定长内循环，其余（最近邻、区域平均）按运行时抽头数 */
+      template <int BPP>
+      inline void TransformPlane(const uint8_t* src, uint8_t* dst, int dstStride, int dstWidth, int dstHeight,
+                                 const SampleTaps &tapsX, const SampleTaps &tapsY, bool swapped)
+      {
+        switch (tapsX.taps == tapsY.taps ? tapsX.taps : 0) {
+          case 2:
+            TransformPlaneTaps<BPP, 2>(src, dst, dstStride, dstWidth, dstHeight, tapsX, tapsY, swapped);
+            break;
+          case 4:
+            TransformPlaneTaps<BPP, 4>(src, dst, dstStride, dstWidth, dstHeight, tapsX, tapsY, swapped);
+            break;
+          case 5:
+            TransformPlaneTaps<BPP, 5>(src, dst, dstStride, dstWidth, dstHeight, tapsX, tapsY, swapped);
+            break;
+          case 6:
+            TransformPlaneTaps<BPP, 6>(src, dst, dstStride, dstWidth, dstHeight, tapsX, tapsY, swapped);
+            break;
+          default:
+            TransformPlaneTaps<BPP, 0>(src, dst, dstStride, dstWidth, dstHeight, tapsX, tapsY, swapped);
+            break;
+        }
+      }
+    }
+
+    /**
+     * @brief 根据镜像模式判断输出是否需要镜像
+     * @param mirrorMode 镜像模式，详见 {@link AliEngineVideoPipelineMirrorMode}
+     * @param forPreview true: 预览输出；false: 推流输出
+     */
+    inline bool AliEngineVideoMirrorApplied(AliEngineVideoPipelineMirrorMode mirrorMode, bool forPreview)
+    {
+      switch (mirrorMode) {
+        case AliEngineVideoPipelineMirrorModeBothMirror:
+          return true;
+        case AliEngineVideoPipelineMirrorModeOnlyPreviewMirror:
+          return forPreview;
+        case AliEngineVideoPipelineMirrorModeOnlyPublishMirror:
+          return !forPreview;
+        default:
+          return false;
+      }
+    }
+
+    /**
+     * @brief 按目标分辨率和显示模式生成变换参数
+     * @param src 源帧，使用其 width、height、rotation
+     * @param targetWidth 目标宽（旋转后）
+     * @param targetHeight 目标高（旋转后）
+     * @param renderMode 显示模式：Crop 居中裁剪到目标比例；Auto 保持比例缩放到目标范围内（输出尺寸可能小于目标）；其他按拉伸处理
+     * @param mirror 是否镜像，可由 {@link AliEngineVideoMirrorApplied} 得到
+     */
+    inline AliEngineVideoTransformParam AliEngineVideoTransformParamForTarget(const AliEngineVideoRawData &src,
+                                                                             int targetWidth, int targetHeight,
+                                                                             AliEngineRenderMode renderMode,
+                                                                             bool mirror)
+    {
+      AliEngineVideoTransformParam param;
+      const int rotation = ((src.rotation % 360) + 360) % 360;
+      param.rotation = static_cast<AliEngineRotationMode>(rotation - rotation % 90);
+      param.mirror = mirror;
+      const bool swapped = param.rotation == AliEngineRotationMode_90 || param.rotation == AliEngineRotationMode_270;
+      /* 目标尺寸换算到旋转前坐标系 */
+      const int tw = swapped ? targetHeight : targetWidth;
+      const int th = swapped ? targetWidth : targetHeight;
+      param.cropWidth = src.width;
+      param.cropHeight = src.height;
+      param.dstWidth = targetWidth;
+      param.dstHeight = targetHeight;
+      if (tw <= 0 || th <= 0) {
+        return param;
+      }
+      const long long lhs = static_cast<long long>(src.width) * th;
+      const long long rhs = static_cast<long long>(src.height) * tw;
+      if (renderMode == AliEngineRenderModeCrop) {
+        if (lhs > rhs) {
+          param.cropWidth = static_cast<int>(rhs / th) & ~1;
+        } else {
+          param.cropHeight = static_cast<int>(lhs / tw) & ~1;
+        }
+        param.cropX = ((src.width - param.cropWidth) / 2) & ~1;
+        param.cropY = ((src.height - param.cropHeight) / 2) & ~1;
+      } else if (renderMode == AliEngineRenderModeAuto) {
+        int ow = tw, oh = th;
+        if (lhs > rhs) {
+          oh = static_cast<int>(static_cast<long long>(src.height) * tw / src.width);
+        } else {
+          ow = static_cast<int>(static_cast<long long>(src.width) * th / src.height);
+        }
+        ow = ow & ~1 ? ow & ~1 : 2;
+        oh = oh & ~1 ? oh & ~1 : 2;
+        param.dstWidth = swapped ? oh : ow;
+        param.dstHeight = swapped ? ow : oh;
+      }
+      return param;
+    }
+
+    /**
+     * @brief 视频融合变换器
+     * @details 在一次遍历中完成裁剪、缩放、90/180/270度旋转和镜像，支持 I420、NV12、BGRA。
+     * 相比逐步处理（旋转、镜像、缩放各一次整帧读写），源数据只读一次、目标只写一次，
+     * 大分辨率采集缩放到540p时可显著降低内存带宽。采集管线缩放模式
+     * {@link AliEngineCapturePipelineScaleMode} 的 Pre/Post 差别只在于缩放发生的位置，两者均可用本变换在对应位置一次完成。
+     *
+     *  - 采样坐标按行、列预先计算为查表，内循环只做查表和插值，表内存在实例生命周期内复用
+     *  - 90/270度旋转按32x32输出块遍历，保证源访问的局部性
+     *  - 双线性缩小时按方向改用区域平均：采样表为每个输出像素列出其覆盖的全部源像素及重叠面积权重，
+     *    避免只取2x2邻域造成的混叠，仍在同一次遍历中完成，不需要中间缓冲
+     * @note 非线程安全，同一实例不要在多个线程同时调用
+     */
+    class AliEngineVideoTransformer {
+    public:
+      /**
+       * @brief 执行变换
+       * @param src 源数据
+       * @param dst 目标数据，需预先设置与源相同的 format、输出宽高及数据指针
+       * @param param 变换参数
+       * @return 详见 {@link AliEngineVideoConvertResult}
+       * @note 目标 rotation 置为0，timeStamp 从源复制
+       */
+      int Transform(const AliEngineVideoRawData &src, AliEngineVideoRawData &dst, const AliEngineVideoTransformParam &param)
+      {
+        if (src.format != AliEngineVideoFormatI420 && src.format != AliEngineVideoFormatNV12 &&
+            src.format != AliEngineVideoFormatBGRA) {
+          return AliEngineVideoConvertErrorUnsupportedFormat;
+        }
+        if (dst.format != src.format) {
+          return AliEngineVideoConvertErrorInvalidParam;
+        }
+        const bool yuv = src.format != AliEngineVideoFormatBGRA;
+        int cropX = param.cropX, cropY = param.cropY;
+        int cropW = param.cropWidth > 0 ? param.cropWidth : src.width;
+        int cropH = param.cropHeight > 0 ? param.cropHeight : src.height;
+        if (yuv) {
+          cropX &= ~1;
+          cropY &= ~1;
+        }
+        if (cropX < 0 || cropY < 0 || cropW <= 0 || cropH <= 0 ||
+            cropX + cropW > src.width || cropY + cropH > src.height) {
+          return AliEngineVideoConvertErrorInvalidParam;
+        }
+        const int rotation = param.rotation;
+        if (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270) {
+          return AliEngineVideoConvertErrorInvalidParam;
+        }
+        const bool swapped = rotation == 90 || rotation == 270;
+        const int dw = param.dstWidth > 0 ? param.dstWidth : (swapped ? cropH : cropW);
+        const int dh = param.dstHeight > 0 ? param.dstHeight : (swapped ? cropW : cropH);
+        if (dst.width != dw || dst.height != dh) {
+          return AliEngineVideoConvertErrorInvalidParam;
+        }
+        internal::VideoPlanes sp, dp;
+        if (!internal::ResolveVideoPlanes(src, sp) || !internal::ResolveVideoPlanes(dst, dp)) {
+          return AliEngineVideoConvertErrorInvalidParam;
+        }
+        const bool nearest = param.filter == AliEngineVideoFilterNearest;
+
+        if (src.format == AliEngineVideoFormatBGRA) {
+          TransformScaled<4>(sp.packed, sp.stride, cropX, cropY, cropW, cropH, dp.packed, dp.stride, dw, dh,
+                             rotation, param.mirror, nearest);
+        } else {
+          TransformScaled<1>(sp.y, sp.strideY, cropX, cropY, cropW, cropH, dp.y, dp.strideY, dw, dh,
+                             rotation, param.mirror, nearest);
+          const int cdw = (dw + 1) / 2, cdh = (dh + 1) / 2;
+          const int ccw = (cropW + 1) / 2, cch = (cropH + 1) / 2;
+          if (src.format == AliEngineVideoFormatNV12) {
+            TransformScaled<2>(sp.u, sp.strideU, cropX / 2, cropY / 2, ccw, cch, dp.u, dp.strideU, cdw, cdh,
+                               rotation, param.mirror, nearest);
+          } else {
+            TransformScaled<1>(sp.u, sp.strideU, cropX / 2, cropY / 2, ccw, cch, dp.u, dp.strideU, cdw, cdh,
+                               rotation, param.mirror, nearest);
+            TransformScaled<1>(sp.v, sp.strideV, cropX / 2, cropY / 2, ccw, cch, dp.v, dp.strideV, cdw, cdh,
+                               rotation, param.mirror, nearest);
+          }
+        }
+        dst.rotation = 0;
+        dst.timeStamp = src.timeStamp;
+        return AliEngineVideoConvertOk;
+      }
+
+    private:
+      /* 单平面变换：缩小时的区域平均已折算进采样表，一次遍历完成 */
+      template <int BPP>
+      void TransformScaled(const uint8_t* plane, int stride, int cropX, int cropY, int cropW, int cropH,
+                           uint8_t* dst, int dstStride, int dw, int dh, int rotation, bool mirror, bool nearest)
+      {
+        BuildTaps(cropX, cropY, cropW, cropH, dw, dh, rotation, mirror, BPP, stride, nearest);
+        internal::TransformPlane<BPP>(plane, dst, dstStride, dw, dh, tapsX_, tapsY_, rotation == 90 || rotation == 270);
+      }
+
+      /**
+       * 生成采样表。逆映射：输出(ox, oy) -> 镜像 -> 逆旋转 -> 缩放前坐标 -> 源坐标
+       *  - 0度: ux = ox', uy = oy
+       *  - 90度: ux = oy, uy = UH-1-ox'
+       *  - 180度: ux = UW-1-ox', uy = UH-1-oy
+       *  - 270度: ux = UW-1-oy, uy = ox'
+       * 其中 ox' 为镜像后的列坐标
+       */
+      void BuildTaps(int cropX, int cropY, int cropW, int cropH, int dw, int dh, int rotation, bool mirror,
+                     int bpp, int stride, bool nearest)
+      {
+        const bool swapped = rotation == 90 || rotation == 270;
+        const int uw = swapped ? dh : dw;
+        const int uh = swapped ? dw : dh;
+        if (!swapped) {
+          internal::BuildSampleTaps(tapsX_, dw, uw, (rotation == 180) != mirror, cropX, cropW, bpp, nearest);
+          internal::BuildSampleTaps(tapsY_, dh, uh, rotation == 180, cropY, cropH, stride, nearest);
+        } else {
+          internal::BuildSampleTaps(tapsX_, dh, uw, rotation == 270, cropX, cropW, bpp, nearest);
+          internal::BuildSampleTaps(tapsY_, dw, uh, (rotation == 90) != mirror, cropY, cropH, stride, nearest);
+        }
+      }
+
+      internal::SampleTaps tapsX_;
+      internal::SampleTaps tapsY_;
+    };
+}
+
+#endif /* ali_rtc_engine_video_transform_h */
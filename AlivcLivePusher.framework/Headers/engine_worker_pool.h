@@ -0,0 +1,159 @@
+#ifndef ali_rtc_engine_worker_pool_h
+#define ali_rtc_engine_worker_pool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief AliRTCSdk namespace
+ */
+namespace AliRTCSdk
+{
+  namespace internal
+  {
+    /**
+     * @brief 按行带并行的常驻线程池
+     * @details Run 把 [0, count) 均分为若干行带，由常驻工作线程和调用线程共同处理，全部完成后返回。
+     * 线程在构造时创建并一直复用，单次 Run 只有一次唤醒和一次等待，适合逐帧调用
+     * @note Run 不可重入，同一时刻只能有一个线程调用
+     */
+    class BandWorkerPool {
+    public:
+      /**
+       * @param threads 并行度（包含调用线程），小于等于1时在调用线程串行执行
+       */
+      explicit BandWorkerPool(int threads)
+        : bands_(threads > 1 ? threads : 1) {
+        for (int i = 1; i < bands_; ++i) {
+          workers_.push_back(std::thread(&BandWorkerPool::WorkerLoop, this));
+        }
+      }
+
+      ~BandWorkerPool()
+      {
+        {
+          std::lock_guard<std::mutex> guard(lock_);
+          stop_ = true;
+        }
+        wake_.notify_all();
+        for (size_t i = 0; i < workers_.size(); ++i) {
+          workers_[i].join();
+        }
+      }
+
+      /**
+       * @brief 并行度
+       */
+      int Concurrency() const { return bands_; }
+
+      /**
+       * @brief 并行处理 [0, count)
+       * @param count 总行数
+       * @param task 行带处理函数，参数为 [begin, end)
+       */
+      void Run(int count, const std::function<void(int, int)> &task)
+      {
+        if (count <= 0) {
+          return;
+        }
+        const int bands = count < bands_ ? count : bands_;
+        if (bands == 1) {
+          task(0, count);
+          return;
+        }
+        unsigned long long generation;
+        {
+          std::lock_guard<std::mutex> guard(lock_);
+          task_ = &task;
+          count_ = count;
+          taskBands_ = bands;
+          done_ = 0;
+          generation = ++generation_;
+          next_.store(generation << 32, std::memory_order_release);
+        }
+        wake_.notify_all();
+        const int finished = Drain(generation, task, count, bands);
+        std::unique_lock<std::mutex> guard(lock_);
+        done_ += finished;
+        finish_.wait(guard, [&] { return done_ == taskBands_; });
+        task_ = nullptr;
+      }
+
+    private:
+      BandWorkerPool(const BandWorkerPool&);
+      BandWorkerPool& operator=(const BandWorkerPool&);
+
+      /* 领取并处理本轮的行带，返回处理的行带数。计数器高32位为轮次，迟到的线程不会领取下一轮的行带 */
+      int Drain(unsigned long long generation, const std::function<void(int, int)> &task, int count, int bands)
+      {
+        int finished = 0;
+        unsigned long long value = next_.load(std::memory_order_acquire);
+        for (;;) {
+          if ((value >> 32) != generation || static_cast<int>(value & 0xFFFFFFFFULL) >= bands) {
+            return finished;
+          }
+          if (!next_.compare_exchange_weak(value, value + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            continue;
+          }
+          const int band = static_cast<int>(value & 0xFFFFFFFFULL);
+          const int begin = static_cast<int>(static_cast<long long>(count) * band / bands);
+          const int end = static_cast<int>(static_cast<long long>(count) * (band + 1) / bands);
+          task(begin, end);
+          ++finished;
+          value = next_.load(std::memory_order_acquire);
+        }
+      }
+
+      void WorkerLoop()
+      {
+        unsigned long long seen = 0;
+        for (;;) {
+          const std::function<void(int, int)>* task;
+          int count;
+          int bands;
+          {
+            std::unique_lock<std::mutex> guard(lock_);
+            wake_.wait(guard, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+              return;
+            }
+            seen = generation_;
+            task = task_;
+            count = count_;
+            bands = taskBands_;
+          }
+          if (!task) {
+            continue;
+          }
+          const int finished = Drain(seen, *task, count, bands);
+          if (finished > 0) {
+            std::lock_guard<std::mutex> guard(lock_);
+            done_ += finished;
+            if (done_ == taskBands_) {
+              finish_.notify_one();
+            }
+          }
+        }
+      }
+
+      const int bands_;
+      std::vector<std::thread> workers_;
+      std::mutex lock_;
+      std::condition_variable wake_;
+      std::condition_variable finish_;
+      const std::function<void(int, int)>* task_ = nullptr;
+      int count_ = 0;
+      int taskBands_ = 0;
+      std::atomic<unsigned long long> next_{0};
+      int done_ = 0;
+      unsigned long long generation_ = 0;
+      bool stop_ = false;
+    };
+  }
+}
+
+#endif /* ali_rtc_engine_worker_pool_h */
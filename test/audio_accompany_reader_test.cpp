@@ -0,0 +1,225 @@
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine_audio_accompany_reader.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  const int kSamplesPerFrame = 1152;
+  const int kFrames = 20;
+
+  /* MPEG-1 Layer III 128 kbps 44.1 kHz 立体声，帧体前 4 字节写入帧号，不带 LAME 头 */
+  void WriteMp3(const std::string &path)
+  {
+    FILE* file = fopen(path.c_str(), "wb");
+    ALI_CHECK(file != nullptr);
+    for (int n = 0; n < kFrames; ++n) {
+      const int padding = n % 3 == 0 ? 1 : 0;
+      std::vector<unsigned char> frame(144 * 128000 / 44100 + padding, 0x11);
+      frame[0] = 0xFF;
+      frame[1] = 0xFB;
+      frame[2] = static_cast<unsigned char>(0x90 | (padding << 1));
+      frame[3] = 0x00;
+      memcpy(&frame[4], &n, sizeof(n));
+      fwrite(&frame[0], 1, frame.size(), file);
+    }
+    fclose(file);
+  }
+
+  /* 输出的采样值等于其在文件中的位置，可据此检查跳转落点 */
+  struct PositionDecoder : public IAliEngineAudioAccompanyDecoder {
+    bool OpenDecoder(AliEngineAudioAccompanyCodec codec, int sampleRate, int channels) override
+    {
+      return codec == AliEngineAudioAccompanyCodecMp3 && sampleRate == 44100 && channels == 2;
+    }
+    int DecodeFrame(const uint8_t* frame, int size, int16_t* pcm, int maxFrames) override
+    {
+      int n;
+      memcpy(&n, frame + 4, sizeof(n));
+      for (int i = 0; i < kSamplesPerFrame; ++i) {
+        pcm[2 * i] = static_cast<int16_t>(n * kSamplesPerFrame + i);
+        pcm[2 * i + 1] = pcm[2 * i];
+      }
+      return kSamplesPerFrame;
+    }
+  };
+
+  std::vector<std::string> ListDir(const std::string &dir)
+  {
+    std::vector<std::string> names;
+    DIR* handle = opendir(dir.c_str());
+    ALI_CHECK(handle != nullptr);
+    struct dirent* item;
+    while ((item = readdir(handle)) != nullptr) {
+      const std::string name = item->d_name;
+      if (name != "." && name != "..") {
+        names.push_back(name);
+      }
+    }
+    closedir(handle);
+    return names;
+  }
+
+  /* 读取线程持续读取时另一线程反复跳转：每次不连续处都必须落在某个跳转目标或循环起点上，跳转后的第一块不会丢失 */
+  void TestSeekWhileReading(const std::string &path)
+  {
+    PositionDecoder decoder;
+    AliEngineAudioAccompanyReaderConfig config;
+    config.readAheadMs = 50;
+    AliEngineAudioAccompanyReader reader(&decoder, config);
+    AliEngineAudioAccompanyConfig accompany;
+    accompany.loopCycles = -1;
+    ALI_CHECK_EQ(reader.Open(path.c_str(), accompany), 0);
+
+    std::mutex targetsLock;
+    std::set<int> targets;
+    targets.insert(0);
+    std::atomic<bool> stop(false);
+    std::atomic<int> jumps(0);
+    std::atomic<int> badJumps(0);
+    std::thread consumer([&]() {
+      std::vector<int16_t> pcm(441 * 2);
+      int expected = 0;
+      while (!stop.load()) {
+        const int got = reader.Read(&pcm[0], 441);
+        for (int i = 0; i < got; ++i) {
+          const int value = pcm[2 * i];
+          if (value != expected) {
+            jumps.fetch_add(1);
+            std::lock_guard<std::mutex> guard(targetsLock);
+            if (!targets.count(value)) {
+              badJumps.fetch_add(1);
+            }
+          }
+          expected = value + 1;
+        }
+        if (got == 0) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    unsigned seed = 7;
+    for (int k = 0; k < 100; ++k) {
+      seed = seed * 1103515245 + 12345;
+      const int posMs = 1 + static_cast<int>((seed >> 8) % 500);
+      {
+        std::lock_guard<std::mutex> guard(targetsLock);
+        targets.insert(static_cast<int>(static_cast<long long>(posMs) * 44100 / 1000));
+      }
+      ALI_CHECK_EQ(reader.SetPosition(posMs), 0);
+      usleep(1000);
+    }
+    stop.store(true);
+    consumer.join();
+    ALI_CHECK(jumps.load() > 0);
+    ALI_CHECK_EQ(badJumps.load(), 0);
+  }
+
+  /* 预读块远少于文件帧数时依靠读取端唤醒连续播放，完整播放所有循环 */
+  /* 预读已满时跳转，一个帧周期后的第一次 Read 即返回新位置的数据，而不是先消耗旧块 */
+  void TestFirstReadAfterSeek(const std::string &path)
+  {
+    PositionDecoder decoder;
+    AliEngineAudioAccompanyReaderConfig config;
+    config.readAheadMs = 200;
+    AliEngineAudioAccompanyReader reader(&decoder, config);
+    AliEngineAudioAccompanyConfig accompany;
+    accompany.loopCycles = -1;
+    ALI_CHECK_EQ(reader.Open(path.c_str(), accompany), 0);
+    const int framePeriodUs = kSamplesPerFrame * 1000000 / 44100;
+    std::vector<int16_t> pcm(441 * 2);
+    const int positionsMs[] = {300, 20, 450, 100, 0};
+    for (size_t k = 0; k < sizeof(positionsMs) / sizeof(positionsMs[0]); ++k) {
+      /* 等预读填满所有空闲块 */
+      usleep(50000);
+      ALI_CHECK_EQ(reader.SetPosition(positionsMs[k]), 0);
+      usleep(framePeriodUs);
+      ALI_CHECK_EQ(reader.Read(&pcm[0], 441), 441);
+      ALI_CHECK_EQ(pcm[0], positionsMs[k] * 44100 / 1000);
+    }
+  }
+
+  void TestPlaybackWithSmallReadAhead(const std::string &path)
+  {
+    PositionDecoder decoder;
+    AliEngineAudioAccompanyReaderConfig config;
+    config.readAheadMs = 10;
+    AliEngineAudioAccompanyReader reader(&decoder, config);
+    AliEngineAudioAccompanyConfig accompany;
+    accompany.loopCycles = 3;
+    ALI_CHECK_EQ(reader.Open(path.c_str(), accompany), 0);
+    std::vector<int16_t> pcm(480 * 2);
+    long long total = 0;
+    const double start = ali_rtc_test::NowUs();
+    while (!reader.IsEnded()) {
+      ALI_CHECK(ali_rtc_test::NowUs() - start < 10e6);
+      const int got = reader.Read(&pcm[0], 480);
+      for (int i = 0; i < got; ++i) {
+        ALI_CHECK_EQ(pcm[2 * i], (total + i) % (kFrames * kSamplesPerFrame));
+      }
+      total += got;
+      if (got == 0) {
+        std::this_thread::yield();
+      }
+    }
+    ALI_CHECK_EQ(total, 3LL * kFrames * kSamplesPerFrame);
+  }
+
+  /* 多个读取器同时为同一文件建立索引缓存，不留临时文件 */
+  void TestConcurrentIndexCache(const std::string &root, const std::string &path)
+  {
+    const std::string dir = root + "/cache";
+    ALI_CHECK(mkdir(dir.c_str(), 0700) == 0);
+    AliEngineAudioAccompanyReaderConfig config;
+    config.indexCacheDir = dir.c_str();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.push_back(std::thread([&config, &path]() {
+        AliEngineAudioAccompanyReader reader(nullptr, config);
+        ALI_CHECK_EQ(reader.PrepareIndex(path.c_str()), 0);
+      }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+      threads[i].join();
+    }
+    const std::vector<std::string> names = ListDir(dir);
+    ALI_CHECK_EQ(names.size(), 1);
+    ALI_CHECK(names[0].find(".tmp") == std::string::npos);
+
+    PositionDecoder decoder;
+    AliEngineAudioAccompanyReader reader(&decoder, config);
+    AliEngineAudioAccompanyConfig accompany;
+    ALI_CHECK_EQ(reader.Open(path.c_str(), accompany), 0);
+    ALI_CHECK(reader.GetStats().indexFromCache);
+    ALI_CHECK_EQ(reader.GetStats().frames, kFrames);
+    reader.Close();
+    remove((dir + "/" + names[0]).c_str());
+    rmdir(dir.c_str());
+  }
+}
+
+int main()
+{
+  char root[] = "/tmp/ali_rtc_accompany_XXXXXX";
+  ALI_CHECK(mkdtemp(root) != nullptr);
+  const std::string path = std::string(root) + "/song.mp3";
+  WriteMp3(path);
+  TestSeekWhileReading(path);
+  TestFirstReadAfterSeek(path);
+  TestPlaybackWithSmallReadAhead(path);
+  TestConcurrentIndexCache(root, path);
+  remove(path.c_str());
+  rmdir(root);
+  printf("audio_accompany_reader_test passed\n");
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "engine_audio_ear_monitor.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  enum { kRate = 48000, kFrame = 480 };
+
+  /* 以 10 ms 单声道 float 帧送入采集或播放回调 */
+  void Feed(AliEngineAudioEarMonitor &monitor, AliEngineAudioSource source, std::vector<float> &pcm, int rate = kRate)
+  {
+    AliEngineAudioRawData raw;
+    raw.dataPtr = pcm.data();
+    raw.numOfSamples = kFrame;
+    raw.bytesPerSample = 4;
+    raw.numOfChannels = 1;
+    raw.samplesPerSec = rate;
+    monitor.OnProcessAudioFrame(source, nullptr, raw);
+  }
+
+  AliEngineAudioEarMonitorConfig Config()
+  {
+    AliEngineAudioEarMonitorConfig config;
+    config.sampleRate = kRate;
+    config.maxBufferMs = 20;
+    config.deviceLatencyMs = 5;
+    return config;
+  }
+
+  /* 时延 = 采集回调到播放回调的间隔 + 帧内排在前面的采样时长 + deviceLatencyMs */
+  void TestLatency()
+  {
+    AliEngineAudioEarMonitor monitor(Config());
+    monitor.Enable(true);
+    std::vector<float> capture(kFrame, 0.25f), playout(kFrame, 0.0f);
+    Feed(monitor, AliEngineAudioSourceCaptured, capture);
+    usleep(2000);
+    Feed(monitor, AliEngineAudioSourcePlayback, playout);
+    AliEngineAudioEarMonitorStats stats = monitor.GetStats();
+    ALI_CHECK_EQ(stats.frames, 1);
+    ALI_CHECK(stats.latencyUs >= 17000);
+    ALI_CHECK(stats.latencyUs < 17000 + 50000);
+    ALI_CHECK_EQ(stats.avgLatencyUs, stats.latencyUs);
+    ALI_CHECK_EQ(stats.maxLatencyUs, stats.latencyUs);
+    ALI_CHECK_EQ(stats.underruns, 0);
+    ALI_CHECK_EQ(stats.droppedSamples, 0);
+    /* 音量从0线性升到1，最后一个采样为满音量 */
+    ALI_CHECK(playout[kFrame - 1] > 0.24f && playout[kFrame - 1] < 0.26f);
+  }
+
+  /* 积压超过 maxBufferMs 时丢弃最早的数据；缓冲为空时计为欠载；采样率不一致的帧被跳过 */
+  void TestDropAccounting()
+  {
+    AliEngineAudioEarMonitor monitor(Config());
+    monitor.Enable(true);
+    std::vector<float> capture(kFrame, 0.25f), playout(kFrame, 0.0f);
+    for (int i = 0; i < 5; ++i) {
+      Feed(monitor, AliEngineAudioSourceCaptured, capture);
+    }
+    Feed(monitor, AliEngineAudioSourcePlayback, playout);
+    AliEngineAudioEarMonitorStats stats = monitor.GetStats();
+    /* 5 帧积压，播放一帧后最多保留 20 ms */
+    ALI_CHECK_EQ(stats.droppedSamples, 5 * kFrame - kFrame - kRate / 50);
+    ALI_CHECK_EQ(stats.bufferedMs, 20);
+    ALI_CHECK_EQ(stats.frames, 1);
+
+    Feed(monitor, AliEngineAudioSourcePlayback, playout);
+    Feed(monitor, AliEngineAudioSourcePlayback, playout);
+    Feed(monitor, AliEngineAudioSourcePlayback, playout);
+    stats = monitor.GetStats();
+    ALI_CHECK_EQ(stats.frames, 3);
+    ALI_CHECK_EQ(stats.underruns, 1);
+    ALI_CHECK_EQ(stats.bufferedMs, 0);
+
+    Feed(monitor, AliEngineAudioSourceCaptured, capture, 44100);
+    ALI_CHECK_EQ(monitor.GetStats().formatMismatches, 1);
+  }
+
+  /* 采集、播放与统计读取并发，计数与单线程语义一致 */
+  void TestConcurrentStats()
+  {
+    AliEngineAudioEarMonitor monitor(Config());
+    monitor.Enable(true);
+    std::atomic<bool> running(true);
+    std::thread reader([&]() {
+      while (running.load()) {
+        const AliEngineAudioEarMonitorStats stats = monitor.GetStats();
+        ALI_CHECK(stats.maxLatencyUs >= 0);
+      }
+    });
+    std::thread capture([&]() {
+      std::vector<float> pcm(kFrame, 0.1f), other(kFrame, 0.1f);
+      for (int i = 0; i < 200; ++i) {
+        Feed(monitor, AliEngineAudioSourceCaptured, pcm);
+        Feed(monitor, AliEngineAudioSourceCaptured, other, 16000);
+      }
+    });
+    std::vector<float> pcm(kFrame, 0.0f);
+    for (int i = 0; i < 200; ++i) {
+      Feed(monitor, AliEngineAudioSourcePlayback, pcm);
+      std::this_thread::yield();
+    }
+    capture.join();
+    running.store(false);
+    reader.join();
+    const AliEngineAudioEarMonitorStats stats = monitor.GetStats();
+    ALI_CHECK_EQ(stats.formatMismatches, 200);
+    ALI_CHECK(stats.frames <= 200);
+    ALI_CHECK(stats.avgLatencyUs <= stats.maxLatencyUs);
+  }
+}
+
+int main()
+{
+  TestLatency();
+  TestDropAccounting();
+  TestConcurrentStats();
+  printf("audio_ear_monitor_test passed\n");
+  return 0;
+}
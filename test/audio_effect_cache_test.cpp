@@ -0,0 +1,103 @@
+#include <dirent.h>
+#include <sys/stat.h>
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine_audio_effect_cache.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  /* 1 秒 48 kHz 单声道正弦，无需重采样 */
+  struct ToneDecoder : public IAliEngineAudioEffectDecoder {
+    std::atomic<int> calls{0};
+    bool DecodeAudioEffect(const char* filePath, std::vector<int16_t> &pcm, int &sampleRate, int &channels) override
+    {
+      calls.fetch_add(1);
+      sampleRate = 48000;
+      channels = 1;
+      pcm.resize(48000);
+      for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(8000 * sin(0.05 * i));
+      }
+      return true;
+    }
+  };
+
+  std::vector<std::string> ListDir(const std::string &dir)
+  {
+    std::vector<std::string> names;
+    DIR* handle = opendir(dir.c_str());
+    ALI_CHECK(handle != nullptr);
+    struct dirent* item;
+    while ((item = readdir(handle)) != nullptr) {
+      const std::string name = item->d_name;
+      if (name != "." && name != "..") {
+        names.push_back(name);
+      }
+    }
+    closedir(handle);
+    return names;
+  }
+
+  /* 多个实例同时把同一音效写入磁盘缓存，不留临时文件，之后的实例可直接从磁盘读取 */
+  void TestConcurrentDiskStores()
+  {
+    char root[] = "/tmp/ali_rtc_effect_cache_XXXXXX";
+    ALI_CHECK(mkdtemp(root) != nullptr);
+    const std::string dir = std::string(root) + "/cache";
+    ALI_CHECK(mkdir(dir.c_str(), 0700) == 0);
+    const std::string effect = std::string(root) + "/fx.wav";
+    FILE* file = fopen(effect.c_str(), "wb");
+    ALI_CHECK(file != nullptr);
+    fputs("fx", file);
+    fclose(file);
+
+    ToneDecoder decoder;
+    AliEngineAudioEffectCacheConfig config;
+    config.diskCacheDir = dir.c_str();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.push_back(std::thread([&decoder, &config, &effect]() {
+        for (int round = 0; round < 5; ++round) {
+          AliEngineAudioEffectCache cache(&decoder, config);
+          AliEngineAudioEffectCache::PcmHandle pcm = cache.Acquire(effect.c_str());
+          ALI_CHECK(pcm && pcm->frames == 48000);
+        }
+      }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+      threads[i].join();
+    }
+    const std::vector<std::string> names = ListDir(dir);
+    ALI_CHECK_EQ(names.size(), 1);
+    ALI_CHECK(names[0].size() > 5 && names[0].compare(names[0].size() - 5, 5, ".apcm") == 0);
+
+    const int before = decoder.calls.load();
+    AliEngineAudioEffectCache cache(&decoder, config);
+    AliEngineAudioEffectCache::PcmHandle pcm = cache.Acquire(effect.c_str());
+    ALI_CHECK(pcm && pcm->frames == 48000);
+    ALI_CHECK_EQ(pcm->samples[100], static_cast<int16_t>(8000 * sin(0.05 * 100)));
+    ALI_CHECK_EQ(decoder.calls.load(), before);
+    ALI_CHECK_EQ(cache.GetStats().diskHits, 1);
+
+    unlink((dir + "/" + names[0]).c_str());
+    rmdir(dir.c_str());
+    unlink(effect.c_str());
+    rmdir(root);
+  }
+}
+
+int main()
+{
+  TestConcurrentDiskStores();
+  printf("audio_effect_cache_test passed\n");
+  return 0;
+}
@@ -0,0 +1,168 @@
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include "engine_audio_jitter_buffer.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 统计全局 operator new 的调用次数，检查读取路径（补偿、淡入、时间压缩）不分配内存 */
+namespace
+{
+  std::atomic<long long> g_allocations(0);
+}
+
+void* operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+namespace
+{
+  enum { kRate = 48000, kFrame = 480 };
+
+  const double kPi = 3.14159265358979323846;
+
+  /* 200 Hz 正弦，基音周期 240 个采样 */
+  void WriteSine(AliEngineAudioRenderJitterBuffer &buffer, long long &phase, int frames)
+  {
+    int16_t pcm[kFrame];
+    for (int done = 0; done < frames; done += kFrame) {
+      for (int i = 0; i < kFrame; ++i) {
+        pcm[i] = static_cast<int16_t>(10000 * sin(2 * kPi * 200 * (phase + i) / kRate));
+      }
+      phase += kFrame;
+      ALI_CHECK_EQ(buffer.Write(pcm, kFrame), kFrame);
+    }
+  }
+
+  int Peak(const int16_t* pcm, int frames)
+  {
+    int peak = 0;
+    for (int i = 0; i < frames; ++i) {
+      peak = abs(pcm[i]) > peak ? abs(pcm[i]) : peak;
+    }
+    return peak;
+  }
+
+  /* 数据中断时按基音周期补偿并渐弱，超过 maxConcealMs 后静音并重新缓冲，数据恢复后继续播放；读取路径不分配内存 */
+  void TestLossConcealment()
+  {
+    AliEngineAudioJitterConfig config;
+    config.maxConcealMs = 60;
+    AliEngineAudioRenderJitterBuffer buffer(config);
+    int16_t out[kFrame];
+    long long phase = 0;
+    WriteSine(buffer, phase, kRate / 10);
+    const long long before = g_allocations.load();
+    /* 缓冲已超过目标，直接开始播放；读空后的第一帧为补偿数据，接近原音量 */
+    int played = 0;
+    while (played < 20 && buffer.Read(out, kFrame) == kFrame) {
+      ++played;
+    }
+    ALI_CHECK_EQ(played, 10);
+    ALI_CHECK(Peak(out, kFrame) > 5000);
+    AliEngineAudioJitterStats stats = buffer.GetStats();
+    ALI_CHECK_EQ(stats.underruns, 1);
+    ALI_CHECK_EQ(stats.rebuffers, 0);
+    for (int i = 0; i < 5; ++i) {
+      ALI_CHECK_EQ(buffer.Read(out, kFrame), 0);
+    }
+    stats = buffer.GetStats();
+    ALI_CHECK_EQ(stats.concealedSamples, 6 * kFrame);
+    ALI_CHECK_EQ(stats.rebuffers, 1);
+    ALI_CHECK_EQ(buffer.Read(out, kFrame), 0);
+    ALI_CHECK_EQ(Peak(out, kFrame), 0);
+    ALI_CHECK_EQ(g_allocations.load() - before, 0);
+
+    WriteSine(buffer, phase, kRate / 10);
+    ALI_CHECK_EQ(buffer.Read(out, kFrame), kFrame);
+    ALI_CHECK(Peak(out, kFrame) > 9000);
+    ALI_CHECK_EQ(g_allocations.load() - before, 0);
+  }
+
+  /* 持续积压时按周期压缩，同样不分配内存，且读取长度超过一帧时也只压缩开头部分 */
+  void TestCompressionDoesNotAllocate()
+  {
+    AliEngineAudioRenderJitterBuffer buffer;
+    std::vector<int16_t> out(kFrame * 3);
+    long long phase = 0;
+    WriteSine(buffer, phase, kRate / 2);
+    const long long before = g_allocations.load();
+    for (int i = 0; i < 300; ++i) {
+      WriteSine(buffer, phase, kFrame * 3);
+      ALI_CHECK_EQ(buffer.Read(out.data(), kFrame * 3), kFrame * 3);
+    }
+    ALI_CHECK_EQ(g_allocations.load() - before, 0);
+    ALI_CHECK(buffer.GetStats().stretchedSamples > 0);
+  }
+
+  /*
+   * 网络乱序表现为被延迟的包与其后的包一起到达：输出仍按写入顺序连续，
+   * 到达抖动估计随之增大，目标缓冲时长相应提高
+   */
+  void TestReorderedBurst()
+  {
+    AliEngineAudioRenderJitterBuffer buffer;
+    int16_t pcm[kFrame], out[kFrame];
+    int next = 0;
+    for (int k = 0; k < 10; ++k) {
+      if (k == 5) {
+        /* 第 5 个包被推迟 80 ms，随后 5 个包一次到达；前面的包连续写入，相对基准晚到 70 ms */
+        usleep(80000);
+      }
+      for (int i = 0; i < kFrame; ++i) {
+        pcm[i] = static_cast<int16_t>((next + i) % 30000);
+      }
+      next += kFrame;
+      ALI_CHECK_EQ(buffer.Write(pcm, kFrame), kFrame);
+    }
+    ALI_CHECK(buffer.GetStats().jitterMs >= 60);
+    int expected = -1;
+    int played = 0;
+    for (int k = 0; k < 10; ++k) {
+      if (buffer.Read(out, kFrame) != kFrame) {
+        continue;
+      }
+      for (int i = 0; i < kFrame; ++i) {
+        if (expected >= 0) {
+          ALI_CHECK_EQ(out[i], expected % 30000);
+        }
+        expected = out[i] + 1;
+      }
+      played += kFrame;
+    }
+    const AliEngineAudioJitterStats stats = buffer.GetStats();
+    ALI_CHECK(stats.targetMs >= 60);
+    ALI_CHECK(played > 0);
+    ALI_CHECK_EQ(stats.underruns, 0);
+  }
+}
+
+int main()
+{
+  TestLossConcealment();
+  TestCompressionDoesNotAllocate();
+  TestReorderedBurst();
+  printf("audio_jitter_buffer_test passed\n");
+  return 0;
+}
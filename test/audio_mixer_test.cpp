@@ -0,0 +1,124 @@
+#include <math.h>
+#include <vector>
+
+#include "engine_audio_mixer.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  /* 参考实现：钳位后 0.5 远离零 */
+  int16_t Reference(float sample)
+  {
+    float v = sample * 32768.0f;
+    v = v > 32767.0f ? 32767.0f : (v < -32768.0f ? -32768.0f : v);
+    return static_cast<int16_t>(v < 0 ? v - 0.5f : v + 0.5f);
+  }
+
+  /* SIMD 主循环与标量尾部对半值、饱和值的取整一致 */
+  void TestStoreS16RoundsHalfAwayFromZero()
+  {
+    std::vector<float> acc;
+    const float halves[] = {0.5f, 1.5f, 2.5f, -0.5f, -1.5f, -2.5f, 100.5f, -100.5f};
+    for (int i = 0; i < 8; ++i) {
+      acc.push_back(halves[i] / 32768.0f);
+    }
+    const float edges[] = {0.0f, -0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 32767.4f / 32768.0f, 32767.6f / 32768.0f,
+                           -32768.4f / 32768.0f, -32768.6f / 32768.0f, 1e9f, -1e9f, 0.49999997f / 32768.0f};
+    for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i) {
+      acc.push_back(edges[i]);
+    }
+    for (int i = 0; i < 4096; ++i) {
+      acc.push_back(static_cast<float>(sin(i * 0.37) * 1.2));
+      acc.push_back((i - 2048 + 0.5f) / 32768.0f);
+    }
+    /* 各种长度覆盖 SIMD 主循环与尾部 */
+    for (size_t start = 0; start < 8; ++start) {
+      const int count = static_cast<int>(acc.size() - start);
+      std::vector<int16_t> dst(count);
+      internal::MixStoreS16(acc.data() + start, dst.data(), count);
+      for (int i = 0; i < count; ++i) {
+        ALI_CHECK_EQ(dst[i], Reference(acc[start + i]));
+      }
+    }
+    int16_t dst[8];
+    internal::MixStoreS16(acc.data(), dst, 8);
+    ALI_CHECK_EQ(dst[0], 1);
+    ALI_CHECK_EQ(dst[1], 2);
+    ALI_CHECK_EQ(dst[2], 3);
+    ALI_CHECK_EQ(dst[3], -1);
+    ALI_CHECK_EQ(dst[5], -3);
+  }
+
+  /* 增益 0.5 使奇数采样落在 .5 上，整帧输出与取整规则一致 */
+  void TestMixOddSamplesAtHalfGain()
+  {
+    AliEngineAudioMixer mixer;
+    const int id = mixer.AddStream(0.5f);
+    std::vector<int16_t> pcm(480);
+    for (size_t i = 0; i < pcm.size(); ++i) {
+      pcm[i] = static_cast<int16_t>((i % 2 ? 1 : -1) * (2 * static_cast<int>(i) + 1));
+    }
+    AliEngineAudioRawData raw;
+    raw.dataPtr = pcm.data();
+    raw.numOfSamples = 480;
+    raw.bytesPerSample = 2;
+    raw.numOfChannels = 1;
+    raw.samplesPerSec = 48000;
+    AliEngineAudioMixerInput input;
+    input.streamId = id;
+    input.data = &raw;
+    AliEngineAudioRawData output;
+    ALI_CHECK_EQ(mixer.Mix(&input, 1, output), 480);
+    const int16_t* out = static_cast<const int16_t*>(output.dataPtr);
+    for (int i = 0; i < 480; ++i) {
+      const int expected = pcm[i] > 0 ? (pcm[i] + 1) / 2 : (pcm[i] - 1) / 2;
+      ALI_CHECK_EQ(out[i], expected);
+    }
+  }
+
+  /* 增益过渡跨越多次 Mix 时保持线性，并在 rampMs 内到达目标 */
+  void TestGainRampFinishesInRampMs()
+  {
+    AliEngineAudioMixerConfig config;
+    config.rampMs = 20;
+    config.outputBytesPerSample = 4;
+    AliEngineAudioMixer mixer(config);
+    const int id = mixer.AddStream(0.0f);
+    mixer.SetStreamGain(id, 1.0f);
+    const int rampFrames = 48000 * 20 / 1000;
+    std::vector<float> pcm(100, 1.0f);
+    AliEngineAudioRawData raw;
+    raw.dataPtr = pcm.data();
+    raw.numOfSamples = 100;
+    raw.bytesPerSample = 4;
+    raw.numOfChannels = 1;
+    raw.samplesPerSec = 48000;
+    AliEngineAudioMixerInput input;
+    input.streamId = id;
+    input.data = &raw;
+    for (int block = 0; block < 12; ++block) {
+      AliEngineAudioRawData output;
+      ALI_CHECK_EQ(mixer.Mix(&input, 1, output), 100);
+      const float* out = static_cast<const float*>(output.dataPtr);
+      for (int i = 0; i < 100; ++i) {
+        const int frame = block * 100 + i;
+        if (frame < rampFrames - 1) {
+          ALI_CHECK(fabs(out[i] - (frame + 1.0f) / rampFrames) < 1e-4f);
+        } else {
+          ALI_CHECK(out[i] == 1.0f);
+        }
+      }
+    }
+  }
+}
+
+int main()
+{
+  TestStoreS16RoundsHalfAwayFromZero();
+  TestMixOddSamplesAtHalfGain();
+  TestGainRampFinishesInRampMs();
+  printf("audio_mixer_test passed\n");
+  return 0;
+}
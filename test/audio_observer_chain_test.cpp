@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "engine_audio_observer_chain.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 统计全局 operator new 的调用次数，检查回调中的格式转换不分配内存 */
+namespace
+{
+  std::atomic<long long> g_allocations(0);
+}
+
+void* operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+namespace
+{
+  /* float 节点，乘以固定增益 */
+  struct GainStage : public IAliEngineAudioProcessStage {
+    float gain;
+    explicit GainStage(float value) : gain(value) {}
+    const char* GetStageName() override { return "gain"; }
+    AliEngineAudioStageFormat GetStageFormat() override { return AliEngineAudioStageFormatFloat; }
+    bool OnProcessAudioFrame(AliEngineAudioSource audioSource, const char* uid, AliEngineAudioRawData &data) override
+    {
+      float* samples = static_cast<float*>(data.dataPtr);
+      for (int i = 0; i < data.numOfSamples * data.numOfChannels; ++i) {
+        samples[i] *= gain;
+      }
+      return true;
+    }
+  };
+
+  /* 记录调用次数；removed 置位后再被调用视为错误 */
+  struct CountingStage : public IAliEngineAudioProcessStage {
+    std::atomic<int> calls{0};
+    std::atomic<bool> removed{false};
+    std::atomic<bool> calledAfterRemove{false};
+    bool OnProcessAudioFrame(AliEngineAudioSource audioSource, const char* uid, AliEngineAudioRawData &data) override
+    {
+      if (removed.load()) {
+        calledAfterRemove.store(true);
+      }
+      calls.fetch_add(1);
+      return true;
+    }
+  };
+
+  /* float 节点，检查整帧数据都等于 uid 对应的值，中途让出 CPU 以放大与其他 uid 回调交错的机会 */
+  struct UidCheckStage : public IAliEngineAudioProcessStage {
+    std::atomic<int> mismatches{0};
+    std::atomic<int> calls{0};
+    AliEngineAudioStageFormat GetStageFormat() override { return AliEngineAudioStageFormatFloat; }
+    bool OnProcessAudioFrame(AliEngineAudioSource audioSource, const char* uid, AliEngineAudioRawData &data) override
+    {
+      const float expected = atoi(uid) / 32768.0f;
+      const float* samples = static_cast<const float*>(data.dataPtr);
+      const int count = data.numOfSamples * data.numOfChannels;
+      for (int i = 0; i < count; ++i) {
+        if (i == count / 2) {
+          std::this_thread::yield();
+        }
+        if (samples[i] != expected) {
+          mismatches.fetch_add(1);
+          break;
+        }
+      }
+      calls.fetch_add(1);
+      return true;
+    }
+  };
+
+  /* float 节点，等待 release 置位后才返回，用于占住转换缓冲 */
+  struct BlockingStage : public IAliEngineAudioProcessStage {
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    AliEngineAudioStageFormat GetStageFormat() override { return AliEngineAudioStageFormatFloat; }
+    bool OnProcessAudioFrame(AliEngineAudioSource audioSource, const char* uid, AliEngineAudioRawData &data) override
+    {
+      entered.store(true);
+      while (!release.load()) {
+        std::this_thread::yield();
+      }
+      return true;
+    }
+  };
+
+  struct Frame {
+    std::vector<int16_t> pcm;
+    AliEngineAudioRawData raw;
+
+    explicit Frame(int16_t value, int samples = 480) : pcm(samples * 2, value)
+    {
+      raw.dataPtr = pcm.data();
+      raw.numOfSamples = samples;
+      raw.numOfChannels = 2;
+      raw.bytesPerSample = 2;
+      raw.samplesPerSec = 48000;
+    }
+  };
+
+  /* MixedAll 支持读写，节点修改写回SDK缓冲 */
+  void TestMixedAllIsReadWrite()
+  {
+    AliEngineAudioFrameObserverChain chain;
+    GainStage half(0.5f);
+    CountingStage counter;
+    ALI_CHECK_EQ(chain.AddStage(AliEngineAudioSourceMixedAll, &half), 0);
+    ALI_CHECK_EQ(chain.AddStage(AliEngineAudioSourceMixedAll, &counter), 0);
+    Frame frame(8000);
+    chain.OnMixedAllAudioFrame(frame.raw);
+    ALI_CHECK_EQ(frame.pcm[0], 4000);
+    ALI_CHECK_EQ(counter.calls.load(), 1);
+    const std::vector<AliEngineAudioStageStats> stats = chain.GetStageStats(AliEngineAudioSourceMixedAll);
+    ALI_CHECK_EQ(stats.size(), 2);
+    ALI_CHECK(strcmp(stats[0].name, "gain") == 0);
+    ALI_CHECK_EQ(stats[1].frames, 1);
+    ALI_CHECK_EQ(chain.RemoveStage(AliEngineAudioSourceMixedAll, &half), 0);
+    ALI_CHECK_EQ(chain.RemoveStage(AliEngineAudioSourceMixedAll, &half), -1);
+    chain.OnMixedAllAudioFrame(frame.raw);
+    ALI_CHECK_EQ(frame.pcm[0], 4000);
+    ALI_CHECK_EQ(chain.GetStageStats(AliEngineAudioSourceMixedAll)[0].frames, 2);
+  }
+
+  /* 回调持续执行时增删节点：RemoveStage 返回后节点不再被调用，常驻节点的统计不丢 */
+  void TestConcurrentAddRemove()
+  {
+    AliEngineAudioFrameObserverChain chain;
+    CountingStage resident;
+    chain.AddStage(AliEngineAudioSourcePlayback, &resident);
+    std::atomic<bool> running(true);
+    std::atomic<int> dispatched(0);
+    Frame frame(100);
+    std::thread audio([&chain, &running, &dispatched, &frame]() {
+      while (running.load()) {
+        chain.OnPlaybackAudioFrame(frame.raw);
+        dispatched.fetch_add(1);
+      }
+    });
+    for (int round = 0; round < 200; ++round) {
+      CountingStage transient;
+      ALI_CHECK_EQ(chain.AddStage(AliEngineAudioSourcePlayback, &transient), 0);
+      std::this_thread::yield();
+      ALI_CHECK_EQ(chain.RemoveStage(AliEngineAudioSourcePlayback, &transient), 0);
+      transient.removed.store(true);
+      std::this_thread::yield();
+      ALI_CHECK(!transient.calledAfterRemove.load());
+      chain.GetStageStats(AliEngineAudioSourcePlayback);
+    }
+    running.store(false);
+    audio.join();
+    const std::vector<AliEngineAudioStageStats> stats = chain.GetStageStats(AliEngineAudioSourcePlayback);
+    ALI_CHECK_EQ(stats.size(), 1);
+    ALI_CHECK_EQ(stats[0].frames, dispatched.load());
+  }
+
+  /* 格式转换缓冲在构造时分配：播放和远端用户回调中 float 节点往返转换不分配内存 */
+  void TestConvertDoesNotAllocate()
+  {
+    AliEngineAudioFrameObserverChain chain;
+    GainStage unity(1.0f);
+    chain.AddStage(AliEngineAudioSourcePlayback, &unity);
+    chain.AddStage(AliEngineAudioSourceRemoteUser, &unity);
+    Frame frame(1000);
+    const char* uids[] = {"101", "202", "303"};
+    const long long before = g_allocations.load();
+    for (int n = 0; n < 100; ++n) {
+      chain.OnPlaybackAudioFrame(frame.raw);
+      chain.OnRemoteUserAudioFrame(uids[n % 3], frame.raw);
+    }
+    ALI_CHECK_EQ(g_allocations.load() - before, 0);
+    ALI_CHECK_EQ(frame.pcm[0], 1000);
+  }
+
+  /* 超过 maxFrameSamples 的帧不做转换，需要转换的节点跳过该帧并计入 bypassedFrames，数据保持不变 */
+  void TestOversizedFrameBypassed()
+  {
+    AliEngineAudioChainConfig config;
+    config.maxFrameSamples = 960;
+    AliEngineAudioFrameObserverChain chain(config);
+    GainStage half(0.5f);
+    CountingStage counter;
+    chain.AddStage(AliEngineAudioSourcePlayback, &half);
+    chain.AddStage(AliEngineAudioSourcePlayback, &counter);
+    Frame small(8000), large(8000, 960);
+    chain.OnPlaybackAudioFrame(large.raw);
+    ALI_CHECK_EQ(large.pcm[0], 8000);
+    chain.OnPlaybackAudioFrame(small.raw);
+    ALI_CHECK_EQ(small.pcm[0], 4000);
+    const std::vector<AliEngineAudioStageStats> stats = chain.GetStageStats(AliEngineAudioSourcePlayback);
+    ALI_CHECK_EQ(stats[0].frames, 1);
+    ALI_CHECK_EQ(stats[0].bypassedFrames, 1);
+    ALI_CHECK_EQ(counter.calls.load(), 2);
+  }
+
+  /* 不同 uid 的远端回调并发执行时各自使用独立的转换缓冲，节点看到的数据不会被其他 uid 覆盖 */
+  void TestRemoteUsersDoNotShareBuffers()
+  {
+    AliEngineAudioFrameObserverChain chain;
+    UidCheckStage check;
+    chain.AddStage(AliEngineAudioSourceRemoteUser, &check);
+    Frame f0(1000), f1(1111), f2(1222), f3(1333);
+    Frame* frames[] = {&f0, &f1, &f2, &f3};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      Frame* frame = frames[t];
+      threads.push_back(std::thread([&chain, frame]() {
+        char uid[16];
+        snprintf(uid, sizeof(uid), "%d", frame->pcm[0]);
+        const int16_t value = frame->pcm[0];
+        for (int n = 0; n < 300; ++n) {
+          chain.OnRemoteUserAudioFrame(uid, frame->raw);
+          ALI_CHECK_EQ(frame->pcm[n % frame->pcm.size()], value);
+        }
+      }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+      threads[t].join();
+    }
+    ALI_CHECK_EQ(check.calls.load(), 1200);
+    ALI_CHECK_EQ(check.mismatches.load(), 0);
+  }
+
+  /* 转换缓冲全部被其他 uid 占用时，需要转换的节点跳过该帧，不与正在使用的缓冲共用 */
+  void TestRemoteSlotsExhausted()
+  {
+    AliEngineAudioChainConfig config;
+    config.maxRemoteUsers = 1;
+    AliEngineAudioFrameObserverChain chain(config);
+    BlockingStage blocking;
+    chain.AddStage(AliEngineAudioSourceRemoteUser, &blocking);
+    Frame held(100);
+    std::thread first([&chain, &held]() {
+      chain.OnRemoteUserAudioFrame("1", held.raw);
+    });
+    while (!blocking.entered.load()) {
+      std::this_thread::yield();
+    }
+    Frame frame(200);
+    chain.OnRemoteUserAudioFrame("2", frame.raw);
+    ALI_CHECK_EQ(chain.GetStageStats(AliEngineAudioSourceRemoteUser)[0].bypassedFrames, 1);
+    blocking.release.store(true);
+    first.join();
+    chain.OnRemoteUserAudioFrame("2", frame.raw);
+    const std::vector<AliEngineAudioStageStats> stats = chain.GetStageStats(AliEngineAudioSourceRemoteUser);
+    ALI_CHECK_EQ(stats[0].frames, 2);
+    ALI_CHECK_EQ(stats[0].bypassedFrames, 1);
+  }
+}
+
+int main()
+{
+  TestMixedAllIsReadWrite();
+  TestConcurrentAddRemove();
+  TestConvertDoesNotAllocate();
+  TestOversizedFrameBypassed();
+  TestRemoteUsersDoNotShareBuffers();
+  TestRemoteSlotsExhausted();
+  printf("audio_observer_chain_test passed\n");
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include <math.h>
+#include <vector>
+
+#include "engine_audio_pitch_shifter.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  enum { kRate = 48000 };
+
+  const double kPi = 3.14159265358979323846;
+  const AliEngineAudioPitchShiftMode kModes[] = {AliEngineAudioPitchShiftLowLatency, AliEngineAudioPitchShiftHighQuality};
+
+  /* 以 10 ms 分块处理，与音频回调一致 */
+  void ProcessInBlocks(AliEngineAudioPitchShifter &shifter, std::vector<float> &pcm)
+  {
+    for (size_t offset = 0; offset < pcm.size(); offset += kRate / 100) {
+      const size_t count = pcm.size() - offset < kRate / 100 ? pcm.size() - offset : kRate / 100;
+      shifter.Process(&pcm[offset], static_cast<int>(count));
+    }
+  }
+
+  /* [begin, end) 内 frequency 处的归一化幅度 */
+  double Magnitude(const std::vector<float> &pcm, int begin, int end, double frequency)
+  {
+    double re = 0, im = 0;
+    for (int i = begin; i < end; ++i) {
+      const double angle = 2 * kPi * frequency * i / kRate;
+      re += pcm[i] * cos(angle);
+      im += pcm[i] * sin(angle);
+    }
+    return 2 * sqrt(re * re + im * im) / (end - begin);
+  }
+
+  /* 在 [low, high] 内以 0.5 Hz 步长寻找幅度最大的频率 */
+  double DominantFrequency(const std::vector<float> &pcm, int begin, int end, double low, double high)
+  {
+    double best = low, bestMagnitude = -1;
+    for (double f = low; f <= high; f += 0.5) {
+      const double m = Magnitude(pcm, begin, end, f);
+      if (m > bestMagnitude) {
+        bestMagnitude = m;
+        best = f;
+      }
+    }
+    return best;
+  }
+
+  /*
+   * 不变调时输出是输入的纯延迟：在两个不成谐波关系的正弦叠加信号上求互相关峰值，
+   * 实测延迟与 LatencyFrames/LatencyUs 报告的一致
+   */
+  void TestMeasuredLatency()
+  {
+    for (int m = 0; m < 2; ++m) {
+      AliEngineAudioPitchShifter shifter(kRate, 1, kModes[m]);
+      std::vector<float> input(kRate);
+      for (int i = 0; i < kRate; ++i) {
+        input[i] = static_cast<float>(0.3 * sin(2 * kPi * 317 * i / kRate) + 0.2 * sin(2 * kPi * 1123 * i / kRate + 1.0));
+      }
+      std::vector<float> output(input);
+      ProcessInBlocks(shifter, output);
+      const int reported = shifter.LatencyFrames();
+      ALI_CHECK_EQ(shifter.LatencyUs(), static_cast<long long>(reported * 1000000.0 / kRate + 0.5));
+      ALI_CHECK(shifter.LatencyUs() <= shifter.MaxLatencyUs());
+      const int begin = kRate / 4, end = kRate * 3 / 4;
+      int bestLag = -1;
+      double bestScore = -1e300;
+      for (int lag = 0; lag <= reported * 2; ++lag) {
+        double score = 0;
+        for (int i = begin; i < end; ++i) {
+          score += static_cast<double>(output[i]) * input[i - lag];
+        }
+        if (score > bestScore) {
+          bestScore = score;
+          bestLag = lag;
+        }
+      }
+      ALI_CHECK(abs(bestLag - reported) <= 1);
+      double error = 0, energy = 0;
+      for (int i = begin; i < end; ++i) {
+        error += (output[i] - input[i - bestLag]) * (output[i] - input[i - bestLag]);
+        energy += input[i] * input[i];
+      }
+      ALI_CHECK(error < energy * 0.01);
+    }
+  }
+
+  /* 440 Hz 正弦按 pitch 变调后，输出主频为 440 * pitch，原频率处基本没有能量 */
+  void TestDetectedPitchRatio()
+  {
+    const double pitches[] = {0.5, 0.75, 1.5, 2.0};
+    for (int m = 0; m < 2; ++m) {
+      for (size_t p = 0; p < sizeof(pitches) / sizeof(pitches[0]); ++p) {
+        AliEngineAudioPitchShifter shifter(kRate, 1, kModes[m]);
+        ALI_CHECK_EQ(shifter.SetPitch(pitches[p]), 0);
+        std::vector<float> pcm(kRate * 6 / 5);
+        for (size_t i = 0; i < pcm.size(); ++i) {
+          pcm[i] = static_cast<float>(0.5 * sin(2 * kPi * 440 * i / kRate));
+        }
+        ProcessInBlocks(shifter, pcm);
+        const int begin = kRate / 5, end = static_cast<int>(pcm.size());
+        const double expected = 440 * pitches[p];
+        const double measured = DominantFrequency(pcm, begin, end, expected * 0.9, expected * 1.1);
+        ALI_CHECK(fabs(measured / 440 - pitches[p]) < pitches[p] * 0.005);
+        ALI_CHECK(Magnitude(pcm, begin, end, measured) > 0.25);
+        ALI_CHECK(Magnitude(pcm, begin, end, 440) < 0.05);
+      }
+    }
+  }
+}
+
+int main()
+{
+  TestMeasuredLatency();
+  TestDetectedPitchRatio();
+  printf("audio_pitch_shifter_test passed\n");
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <math.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include "engine_audio_resampler.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 统计全局 operator new 的调用次数，检查音频回调中的 Process 不分配内存 */
+namespace
+{
+  std::atomic<long long> g_allocations(0);
+}
+
+void* operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+namespace
+{
+  const double kPi = 3.14159265358979323846;
+
+  /*
+   * int16 接口按 10 ms 帧处理不分配内存，包括输出容量大于预分配缓冲的情况；
+   * 分段转换的结果与 float 接口一致
+   */
+  void TestInt16DoesNotAllocate()
+  {
+    const int rates[][2] = {{48000, 44100}, {16000, 48000}, {44100, 48000}};
+    for (int r = 0; r < 3; ++r) {
+      const int inRate = rates[r][0], outRate = rates[r][1];
+      const int inFrames = inRate / 100;
+      AliEngineAudioResampler a, b;
+      ALI_CHECK_EQ(a.Init(inRate, outRate, 2), 0);
+      ALI_CHECK_EQ(b.Init(inRate, outRate, 2), 0);
+      const int capacity = a.MaxOutputFrames(inFrames) * 4;
+      std::vector<int16_t> in(inFrames * 2), out(capacity * 2);
+      std::vector<float> inFloat(inFrames * 2), outFloat(capacity * 2);
+      long long phase = 0;
+      const long long before = g_allocations.load();
+      for (int n = 0; n < 200; ++n) {
+        for (int i = 0; i < inFrames; ++i, ++phase) {
+          const int16_t v = static_cast<int16_t>(12000 * sin(2 * kPi * 997 * phase / inRate));
+          in[i * 2] = v;
+          in[i * 2 + 1] = static_cast<int16_t>(-v);
+          inFloat[i * 2] = v / 32768.0f;
+          inFloat[i * 2 + 1] = -v / 32768.0f;
+        }
+        const int frames = a.Process(in.data(), inFrames, out.data(), capacity);
+        ALI_CHECK_EQ(b.Process(inFloat.data(), inFrames, outFloat.data(), capacity), frames);
+        for (int i = 0; i < frames * 2; ++i) {
+          ALI_CHECK(abs(out[i] - static_cast<int>(lrintf(outFloat[i] * 32768.0f))) <= 1);
+        }
+      }
+      ALI_CHECK_EQ(g_allocations.load() - before, 0);
+    }
+  }
+
+  /*
+   * 约分后相位数超过 kResamplerMaxPhases 时四舍五入取最近相位：第 n 个输出对应输入时刻 n * inRate / outRate - 群时延，
+   * 以该时刻拟合正弦的相位偏差接近0；向下取整会带来平均半个相位步长的固定偏移
+   */
+  void TestNearestPhase()
+  {
+    const int inRate = 44100, outRate = 47999;
+    const double frequency = 10000;
+    AliEngineAudioResampler resampler;
+    ALI_CHECK_EQ(resampler.Init(inRate, outRate, 1, AliEngineAudioResampleQualityHigh, inRate), 0);
+    std::vector<float> in(inRate), out(resampler.MaxOutputFrames(inRate));
+    for (int i = 0; i < inRate; ++i) {
+      in[i] = static_cast<float>(0.5 * sin(2 * kPi * frequency * i / inRate));
+    }
+    const int frames = resampler.Process(in.data(), inRate, out.data(), static_cast<int>(out.size()));
+    const double center = (resampler.Taps() - 1) / 2.0;
+    double ss = 0, sc = 0;
+    for (int n = frames / 4; n < frames * 3 / 4; ++n) {
+      const double t = static_cast<double>(n) * inRate / outRate - center;
+      const double angle = 2 * kPi * frequency * t / inRate;
+      ss += out[n] * sin(angle);
+      sc += out[n] * cos(angle);
+    }
+    /* 半个相位步长（0.5 / 1024 个输入采样）在 10 kHz 处约为 7e-4 弧度 */
+    const double phaseError = atan2(sc, ss);
+    const double halfStep = 2 * kPi * frequency / inRate * 0.5 / internal::kResamplerMaxPhases;
+    ALI_CHECK(fabs(phaseError) < halfStep * 0.2);
+  }
+}
+
+int main()
+{
+  TestInt16DoesNotAllocate();
+  TestNearestPhase();
+  printf("audio_resampler_test passed\n");
+  return 0;
+}
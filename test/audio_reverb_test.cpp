@@ -0,0 +1,135 @@
+#include <math.h>
+#include <vector>
+
+#include "engine_audio_reverb.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  enum { kRate = 48000, kBlock = 32 };
+
+  /* 大房间预设，关闭高频阻尼和音调调整，使衰减只由反馈增益决定 */
+  void Configure(AliEngineAudioReverb &reverb, float dryDb, float wetDb)
+  {
+    ALI_CHECK_EQ(reverb.SetReverbMode(AliEngineAudioEffectReverbLargeRoom), 0);
+    ALI_CHECK_EQ(reverb.SetReverbParam(AliEngineAudioEffectReverbHfDamping, 0.0f), 0);
+    ALI_CHECK_EQ(reverb.SetReverbParam(AliEngineAudioEffectReverbToneLow, 100.0f), 0);
+    ALI_CHECK_EQ(reverb.SetReverbParam(AliEngineAudioEffectReverbToneHigh, 100.0f), 0);
+    ALI_CHECK_EQ(reverb.SetReverbParam(AliEngineAudioEffectReverbPreDelay, 20.0f), 0);
+    ALI_CHECK_EQ(reverb.SetReverbParam(AliEngineAudioEffectReverbDryGain, dryDb), 0);
+    ALI_CHECK_EQ(reverb.SetReverbParam(AliEngineAudioEffectReverbWetGain, wetDb), 0);
+    /* 先处理一个静音分块，干湿增益渐变到目标值 */
+    float silence[kBlock * 2] = {};
+    reverb.Process(silence, kBlock);
+  }
+
+  double EnergyDb(const std::vector<float> &pcm, int begin, int end)
+  {
+    double energy = 1e-30;
+    for (int i = begin; i < end; ++i) {
+      energy += static_cast<double>(pcm[i]) * pcm[i];
+    }
+    return 10.0 * log10(energy);
+  }
+
+  /*
+   * 单位冲激响应：预延时加最短延迟线之前没有湿信号；之后按 50 ms 窗口的能量单调衰减，
+   * 衰减斜率换算出的 RT60 与参数给出的值一致
+   */
+  void TestImpulseResponseDecay()
+  {
+    AliEngineAudioReverb reverb(kRate, 1);
+    Configure(reverb, -20.0f, 0.0f);
+    std::vector<float> pcm(kRate * 3, 0.0f);
+    pcm[0] = 1.0f;
+    reverb.Process(&pcm[0], static_cast<int>(pcm.size()));
+
+    const double room = reverb.GetReverbParam(AliEngineAudioEffectReverbRoomSize) / 100.0;
+    const double rt60 = (0.2 + 0.04 * reverb.GetReverbParam(AliEngineAudioEffectReverbReverberance)) * (0.4 + 0.6 * room);
+    const int firstWet = static_cast<int>(0.020 * kRate) + static_cast<int>(29.7 * (0.3 + 0.7 * room) * 0.001 * kRate);
+    ALI_CHECK(fabs(pcm[0] - 0.1f) < 1e-6f);
+    for (int i = 1; i < firstWet; ++i) {
+      ALI_CHECK(fabs(pcm[i]) < 1e-6f);
+    }
+    ALI_CHECK(EnergyDb(pcm, firstWet, firstWet + kRate / 50) > -60.0);
+
+    const int window = kRate / 20;
+    const int start = firstWet + kRate / 10;
+    double previous = EnergyDb(pcm, start, start + window);
+    const double first = previous;
+    int windows = 1;
+    for (int begin = start + window; begin + window <= start + kRate; begin += window, ++windows) {
+      const double current = EnergyDb(pcm, begin, begin + window);
+      ALI_CHECK(current < previous + 1.0);
+      previous = current;
+    }
+    /* 1 秒内衰减的 dB 数，换算为衰减 60 dB 所需时间 */
+    const double slope = (first - previous) / ((windows - 1) * 0.05);
+    const double measured = 60.0 / slope;
+    ALI_CHECK(measured > rt60 * 0.8 && measured < rt60 * 1.25);
+    /* 尾部持续按同一斜率衰减，不会停在某个底噪上 */
+    const int end = static_cast<int>(pcm.size());
+    const double elapsed = static_cast<double>(end - window - start) / kRate;
+    ALI_CHECK(EnergyDb(pcm, end - window, end) < first - 60.0 * elapsed / rt60 * 0.8);
+  }
+
+  /* 干声增益只缩放直达声，湿增益只缩放混响声：两次处理的差值与增益差精确对应 */
+  void TestWetDryBalance()
+  {
+    std::vector<float> input(kRate);
+    unsigned seed = 11;
+    for (size_t i = 0; i < input.size(); ++i) {
+      seed = seed * 1103515245 + 12345;
+      input[i] = (static_cast<int>(seed >> 16 & 0x7fff) - 16384) / 65536.0f;
+    }
+    std::vector<float> base(input), quieterDry(input), louderWet(input);
+    AliEngineAudioReverb a(kRate, 1), b(kRate, 1), c(kRate, 1);
+    Configure(a, 0.0f, -6.0f);
+    Configure(b, -6.0f, -6.0f);
+    Configure(c, 0.0f, 0.0f);
+    a.Process(&base[0], kRate);
+    b.Process(&quieterDry[0], kRate);
+    c.Process(&louderWet[0], kRate);
+
+    const float dryDelta = 1.0f - powf(10.0f, -6.0f / 20.0f);
+    const float wetRatio = powf(10.0f, 6.0f / 20.0f);
+    double wetEnergy = 0, dryEnergy = 0;
+    for (int i = 0; i < kRate; ++i) {
+      ALI_CHECK(fabs((base[i] - quieterDry[i]) - dryDelta * input[i]) < 1e-4f);
+      const float wet = base[i] - input[i];
+      ALI_CHECK(fabs((louderWet[i] - input[i]) - wetRatio * wet) < 1e-4f);
+      wetEnergy += static_cast<double>(wet) * wet;
+      dryEnergy += static_cast<double>(input[i]) * input[i];
+    }
+    /* 稳态噪声下 -6 dB 湿增益的混响声能量低于直达声，但不可忽略 */
+    const double wetDb = 10.0 * log10(wetEnergy / dryEnergy);
+    ALI_CHECK(wetDb < 0.0 && wetDb > -20.0);
+  }
+
+  /* 双声道输入时左右湿信号来自不同的延迟线组合，不完全相同 */
+  void TestStereoWetDecorrelated()
+  {
+    AliEngineAudioReverb reverb(kRate, 2);
+    Configure(reverb, -20.0f, 0.0f);
+    std::vector<float> pcm(kRate * 2, 0.0f);
+    pcm[0] = pcm[1] = 1.0f;
+    reverb.Process(&pcm[0], kRate);
+    double difference = 0, energy = 0;
+    for (int i = 0; i < kRate; ++i) {
+      difference += fabs(pcm[i * 2] - pcm[i * 2 + 1]);
+      energy += fabs(pcm[i * 2]);
+    }
+    ALI_CHECK(difference > energy * 0.1);
+  }
+}
+
+int main()
+{
+  TestImpulseResponseDecay();
+  TestWetDryBalance();
+  TestStereoWetDecorrelated();
+  printf("audio_reverb_test passed\n");
+  return 0;
+}
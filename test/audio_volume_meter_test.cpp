@@ -0,0 +1,105 @@
+#include <math.h>
+#include <vector>
+
+#include "engine_audio_volume_meter.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  struct Stream {
+    std::vector<int16_t> pcm;
+    AliEngineAudioRawData raw;
+
+    Stream() : pcm(480)
+    {
+      raw.dataPtr = pcm.data();
+      raw.numOfSamples = 480;
+      raw.bytesPerSample = 2;
+      raw.numOfChannels = 1;
+      raw.samplesPerSec = 48000;
+    }
+
+    void Tone(int frame, double amplitude)
+    {
+      for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(amplitude * sin(0.07 * (frame * 480.0 + i)));
+      }
+    }
+  };
+
+  int FindSpeech(const AliEngineAudioVolumeMeter &meter, const char* uid, int &volume)
+  {
+    int count = 0;
+    int total = 0;
+    const AliEngineUserVolumeInfo* infos = meter.GetVolumeInfo(count, total);
+    for (int i = 0; i < count; ++i) {
+      if (strcmp(infos[i].uid.c_str(), uid) == 0) {
+        volume = infos[i].volume;
+        return infos[i].speechState;
+      }
+    }
+    return -1;
+  }
+
+  /* 停止送入数据的流按静音计：拖尾结束后不再判为说话，音量衰减 */
+  void TestMissingStreamCountsAsSilent()
+  {
+    AliEngineAudioVolumeIndicationConfig config;
+    config.interval = 100;
+    AliEngineAudioVolumeMeter meter(config);
+    const int alice = meter.AddStream("alice");
+    const int bob = meter.AddStream("bob");
+    Stream a;
+    Stream b;
+    AliEngineAudioVolumeMeterInput inputs[2];
+    inputs[0].streamId = alice;
+    inputs[0].data = &a.raw;
+    inputs[1].streamId = bob;
+    inputs[1].data = &b.raw;
+    int volume = 0;
+    for (int t = 0; t < 300; ++t) {
+      a.Tone(t, 8000.0);
+      b.Tone(t, 8000.0);
+      if (t < 50) {
+        meter.Process(inputs, 2);
+      } else {
+        meter.Process(&inputs[1], 1);
+      }
+      if (t == 49) {
+        ALI_CHECK_EQ(FindSpeech(meter, "alice", volume), 1);
+      }
+    }
+    ALI_CHECK_EQ(FindSpeech(meter, "alice", volume), 0);
+    ALI_CHECK(volume < 10);
+    ALI_CHECK_EQ(FindSpeech(meter, "bob", volume), 1);
+  }
+
+  /* 数据中断后恢复，噪声底不应被静音拉低，平稳噪声不判为说话 */
+  void TestResumeAfterGapIsNotSpeech()
+  {
+    AliEngineAudioVolumeIndicationConfig config;
+    config.interval = 100;
+    AliEngineAudioVolumeMeter meter(config);
+    const int id = meter.AddStream("carol");
+    Stream s;
+    AliEngineAudioVolumeMeterInput input;
+    input.streamId = id;
+    input.data = &s.raw;
+    int volume = 0;
+    for (int t = 0; t < 400; ++t) {
+      s.Tone(t, 300.0);
+      meter.Process(t >= 200 && t < 250 ? nullptr : &input, t >= 200 && t < 250 ? 0 : 1);
+    }
+    ALI_CHECK_EQ(FindSpeech(meter, "carol", volume), 0);
+  }
+}
+
+int main()
+{
+  TestMissingStreamCountsAsSilent();
+  TestResumeAfterGapIsNotSpeech();
+  printf("audio_volume_meter_test passed\n");
+  return 0;
+}
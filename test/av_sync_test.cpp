@@ -0,0 +1,116 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "engine_av_sync.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  enum { kRate = 48000, kAudioFrame = 480, kAudioFrameUs = 10000, kVideoFrameUs = 33333 };
+
+  /* 在 [0, range) 内的伪随机到达抖动，单位：us */
+  struct Jitter {
+    unsigned seed;
+    explicit Jitter(unsigned s) : seed(s) {}
+    long long Next(int range)
+    {
+      seed = seed * 1103515245 + 12345;
+      return static_cast<long long>((seed >> 8) % static_cast<unsigned>(range));
+    }
+  };
+
+  /*
+   * 音频源时钟快 300 ppm、视频源时钟慢 200 ppm，到达时刻带 0~8 ms 抖动，模拟 2 小时推流：
+   * 以采集时刻（引擎时钟）为基准，音频输出时间线与视频输出时间戳相对采集时刻的偏移各自保持稳定，
+   * 两者之差（唇音偏差）始终在 ±20 ms 以内；漂移估计收敛到实际值（源时钟偏快时映射斜率小于1，漂移为负）
+   */
+  void TestDriftOverHours()
+  {
+    const double audioPpm = 300, videoPpm = -200;
+    const long long latencyUs = 40000;
+    const long long durationUs = 2LL * 3600 * 1000000;
+    AliEngineAvSyncConfig config;
+    config.videoFrameIntervalUs = kVideoFrameUs;
+    AliEngineAvSynchronizer sync(config);
+    Jitter audioJitter(3), videoJitter(5);
+    std::vector<int16_t> pcm(kAudioFrame, 0);
+    AliEngineAudioRawData input;
+    input.dataPtr = pcm.data();
+    input.numOfSamples = kAudioFrame;
+    input.bytesPerSample = 2;
+    input.numOfChannels = 1;
+    input.samplesPerSec = kRate;
+
+    long long audioFrames = 0, videoFrames = 0;
+    unsigned long long outputSamples = 0;
+    long long audioStartUs = 0;
+    double audioOffsetUs = 0, videoOffsetUs = 0;
+    bool hasVideo = false;
+    double maxLipSyncUs = 0, minAudioUs = 1e18, maxAudioUs = -1e18, minVideoUs = 1e18, maxVideoUs = -1e18;
+    for (;;) {
+      /* 源时间戳按各自时钟等间隔，换算为引擎时钟上的采集时刻 */
+      const double audioCaptureUs = audioFrames * static_cast<double>(kAudioFrameUs) / (1 + audioPpm * 1e-6);
+      const double videoCaptureUs = videoFrames * static_cast<double>(kVideoFrameUs) / (1 + videoPpm * 1e-6);
+      if (audioCaptureUs > durationUs && videoCaptureUs > durationUs) {
+        break;
+      }
+      if (audioCaptureUs <= videoCaptureUs) {
+        const long long arrival = static_cast<long long>(audioCaptureUs) + latencyUs + audioJitter.Next(8000);
+        AliEngineAudioRawData output;
+        ALI_CHECK(sync.ProcessAudio(input, audioFrames * kAudioFrameUs, arrival, output));
+        if (audioFrames == 0) {
+          audioStartUs = arrival;
+        }
+        /* 本帧之前已输出的采样在引擎时间线上的终点，对应本帧首个采样的采集时刻 */
+        audioOffsetUs = audioStartUs + outputSamples * 1e6 / kRate - audioCaptureUs;
+        outputSamples += output.numOfSamples;
+        ++audioFrames;
+        if (audioCaptureUs > 10e6) {
+          minAudioUs = audioOffsetUs < minAudioUs ? audioOffsetUs : minAudioUs;
+          maxAudioUs = audioOffsetUs > maxAudioUs ? audioOffsetUs : maxAudioUs;
+        }
+      } else {
+        const long long arrival = static_cast<long long>(videoCaptureUs) + latencyUs + videoJitter.Next(8000);
+        long long outputUs = 0;
+        int repeat = 0;
+        const AliEngineAvSyncVideoAction action = sync.ProcessVideo(videoFrames * kVideoFrameUs, arrival, outputUs, repeat);
+        ++videoFrames;
+        if (action == AliEngineAvSyncVideoDrop) {
+          continue;
+        }
+        videoOffsetUs = outputUs - videoCaptureUs;
+        hasVideo = true;
+        if (videoCaptureUs > 10e6) {
+          minVideoUs = videoOffsetUs < minVideoUs ? videoOffsetUs : minVideoUs;
+          maxVideoUs = videoOffsetUs > maxVideoUs ? videoOffsetUs : maxVideoUs;
+        }
+      }
+      if (hasVideo && audioFrames > 0 && audioCaptureUs > 10e6) {
+        const double lipSync = fabs(audioOffsetUs - videoOffsetUs);
+        maxLipSyncUs = lipSync > maxLipSyncUs ? lipSync : maxLipSyncUs;
+      }
+    }
+    ALI_CHECK(maxLipSyncUs <= 20000);
+    ALI_CHECK(maxAudioUs - minAudioUs <= 20000);
+    /* 视频按固定帧间隔输出，偏移允许多出一个帧间隔的量化误差 */
+    ALI_CHECK(maxVideoUs - minVideoUs <= 20000 + kVideoFrameUs);
+
+    const AliEngineAvSyncStats stats = sync.GetStats();
+    ALI_CHECK_EQ(stats.resyncCount, 0u);
+    ALI_CHECK(fabs(stats.audioDriftPpm + audioPpm) < 30);
+    ALI_CHECK(fabs(stats.videoDriftPpm + videoPpm) < 30);
+    /* 视频源时钟偏慢，靠重复帧补齐输出帧率 */
+    ALI_CHECK(stats.repeatedVideoFrames > 0);
+  }
+}
+
+int main()
+{
+  TestDriftOverHours();
+  printf("av_sync_test passed\n");
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <vector>
+
+#include "engine_audio_active_speaker.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/*
+ * 500 个远端用户、每 100 ms 一次音量回调：6 个音量相近的发言人两两轮流发言，其余为背景噪声。
+ * 统计每次回调的耗时、单用户 Update 耗时，以及不同迟滞/保持时间下主要说话人与 top-K 列表的切换次数
+ */
+namespace
+{
+  enum { kUsers = 500, kTalkers = 6, kIntervalMs = 100 };
+
+  struct SwitchListener : public AliEngineEventListener {
+    int switches = 0;
+    void OnActiveSpeaker(const char *uid) override { ++switches; }
+  };
+
+  struct ChangeObserver : public IAliEngineActiveSpeakerObserver {
+    int changes = 0;
+    void OnTopSpeakersChanged(const AliEngineActiveSpeakerInfo* speakers, int count) override { ++changes; }
+  };
+
+  void Run(int hysteresis, int holdMs, int ticks)
+  {
+    AliEngineActiveSpeakerConfig config;
+    config.hysteresis = hysteresis;
+    config.holdMs = holdMs;
+    AliEngineActiveSpeakerTracker tracker(config);
+    SwitchListener listener;
+    ChangeObserver observer;
+    tracker.SetListener(&listener);
+    tracker.SetObserver(&observer);
+    std::vector<AliEngineUserVolumeInfo> infos(kUsers);
+    char name[32];
+    for (int i = 0; i < kUsers; ++i) {
+      snprintf(name, sizeof(name), "user%d", i);
+      infos[i].uid = name;
+    }
+    unsigned seed = 7;
+    long long nowMs = 0;
+    double tickUs = 0;
+    for (int k = 0; k < ticks; ++k) {
+      nowMs += kIntervalMs;
+      const int turn = static_cast<int>(nowMs / 10000) % (kTalkers / 2);
+      for (int i = 0; i < kUsers; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const int noise = static_cast<int>(seed >> 16) % 30;
+        const bool talking = i < kTalkers && i / 2 == turn;
+        infos[i].volume = talking ? 140 + noise : (i < kTalkers ? noise / 2 : noise / 3);
+        infos[i].speechState = talking || noise > 25;
+      }
+      const double start = ali_rtc_test::NowUs();
+      tracker.OnVolume(&infos[0], kUsers, nowMs);
+      tickUs += ali_rtc_test::NowUs() - start;
+    }
+    ALI_CHECK(tracker.GetActiveSpeaker() != nullptr);
+    const int rounds = ticks > 20 ? 200 : 2;
+    const double start = ali_rtc_test::NowUs();
+    for (int k = 0; k < rounds; ++k) {
+      for (int i = 0; i < kUsers; ++i) {
+        tracker.Update(infos[i].uid.c_str(), infos[i].volume, nowMs + k);
+      }
+    }
+    const double updateNs = (ali_rtc_test::NowUs() - start) * 1000.0 / (static_cast<double>(rounds) * kUsers);
+    printf("%10d %8d %12.1f %12.1f %10d %10d\n", hysteresis, holdMs, tickUs / ticks, updateNs, listener.switches, observer.changes);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const int ticks = ali_rtc_test::QuickMode(argc, argv) ? 20 : 2000;
+  printf("%10s %8s %12s %12s %10s %10s\n", "hysteresis", "hold ms", "us/tick", "ns/update", "switches", "top-K chg");
+  Run(0, 0, ticks);
+  Run(12, 0, ticks);
+  Run(12, 1500, ticks);
+  Run(30, 3000, ticks);
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include <math.h>
+#include <vector>
+
+#include "engine_audio_equalizer.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 48 kHz 立体声 10 ms 帧，统计不同激活频段数、增益渐变时每帧耗时 */
+namespace
+{
+  enum { kFrames = 480, kChannels = 2 };
+
+  template <typename T>
+  double MeasureUs(int activeBands, bool ramp, int iterations)
+  {
+    AliEngineAudioEqualizer equalizer(48000, kChannels);
+    for (int b = 0; b < activeBands; ++b) {
+      equalizer.SetBandGain(static_cast<AliEngineAudioEffectEqualizationBandFrequency>(b), b % 2 ? -6.0f : 6.0f);
+    }
+    equalizer.Reset();
+    ALI_CHECK_EQ(equalizer.ActiveBands(), activeBands);
+    std::vector<T> pcm(kFrames * kChannels);
+    for (int i = 0; i < kFrames * kChannels; ++i) {
+      pcm[i] = static_cast<T>(0.1 * sin(0.05 * i) * (sizeof(T) == 2 ? 32767 : 1));
+    }
+    std::vector<T> frame(pcm.size());
+    double total = 0;
+    for (int n = 0; n < iterations; ++n) {
+      if (ramp && activeBands > 0) {
+        equalizer.SetBandGain(static_cast<AliEngineAudioEffectEqualizationBandFrequency>(n % activeBands), n % 2 ? 3.0f : 9.0f);
+      }
+      frame = pcm;
+      const double start = ali_rtc_test::NowUs();
+      equalizer.Process(&frame[0], kFrames);
+      total += ali_rtc_test::NowUs() - start;
+    }
+    return total / iterations;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const int iterations = ali_rtc_test::QuickMode(argc, argv) ? 50 : 20000;
+  const int bands[] = {0, 1, 4, 8, 10};
+  printf("%-6s %12s %12s %12s\n", "bands", "float us", "int16 us", "ramp us");
+  for (size_t i = 0; i < sizeof(bands) / sizeof(bands[0]); ++i) {
+    const double f32 = MeasureUs<float>(bands[i], false, iterations);
+    const double s16 = MeasureUs<int16_t>(bands[i], false, iterations);
+    const double ramp = MeasureUs<float>(bands[i], true, iterations);
+    printf("%-6d %12.2f %12.2f %12.2f\n", bands[i], f32, s16, ramp);
+  }
+  return 0;
+}
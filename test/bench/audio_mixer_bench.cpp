@@ -0,0 +1,64 @@
+#include <math.h>
+#include <vector>
+
+#include "engine_audio_mixer.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 每路 10 ms、48 kHz 立体声，统计 1~32 路混音耗时 */
+namespace
+{
+  enum { kFrames = 480, kChannels = 2 };
+
+  double MeasureUs(int streams, int bytesPerSample, bool ramp, int iterations)
+  {
+    AliEngineAudioMixerConfig config;
+    config.channels = kChannels;
+    AliEngineAudioMixer mixer(config);
+    std::vector<std::vector<int16_t> > s16(streams, std::vector<int16_t>(kFrames * kChannels));
+    std::vector<std::vector<float> > f32(streams, std::vector<float>(kFrames * kChannels));
+    std::vector<AliEngineAudioRawData> raws(streams);
+    std::vector<AliEngineAudioMixerInput> inputs(streams);
+    for (int s = 0; s < streams; ++s) {
+      for (int i = 0; i < kFrames * kChannels; ++i) {
+        const double v = 0.3 * sin(0.01 * (s + 1) * i);
+        s16[s][i] = static_cast<int16_t>(v * 32767);
+        f32[s][i] = static_cast<float>(v);
+      }
+      raws[s].dataPtr = bytesPerSample == 2 ? static_cast<void*>(s16[s].data()) : static_cast<void*>(f32[s].data());
+      raws[s].numOfSamples = kFrames;
+      raws[s].bytesPerSample = bytesPerSample;
+      raws[s].numOfChannels = kChannels;
+      raws[s].samplesPerSec = 48000;
+      inputs[s].streamId = mixer.AddStream(0.8f);
+      inputs[s].data = &raws[s];
+    }
+    AliEngineAudioRawData output;
+    mixer.Mix(inputs.data(), streams, output);
+    const double start = ali_rtc_test::NowUs();
+    for (int n = 0; n < iterations; ++n) {
+      if (ramp) {
+        for (int s = 0; s < streams; ++s) {
+          mixer.SetStreamGain(inputs[s].streamId, n % 2 ? 0.5f : 0.8f);
+        }
+      }
+      mixer.Mix(inputs.data(), streams, output);
+    }
+    return (ali_rtc_test::NowUs() - start) / iterations;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const int iterations = ali_rtc_test::QuickMode(argc, argv) ? 50 : 20000;
+  const int counts[] = {1, 2, 4, 8, 16, 32};
+  printf("%-8s %12s %12s %12s\n", "streams", "int16 us", "float us", "ramp us");
+  for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+    const double s16 = MeasureUs(counts[i], 2, false, iterations);
+    const double f32 = MeasureUs(counts[i], 4, false, iterations);
+    const double ramp = MeasureUs(counts[i], 2, true, iterations);
+    printf("%-8d %12.2f %12.2f %12.2f\n", counts[i], s16, f32, ramp);
+  }
+  return 0;
+}
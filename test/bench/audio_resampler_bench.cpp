@@ -0,0 +1,50 @@
+#include <math.h>
+#include <vector>
+
+#include "engine_audio_resampler.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 每次输入 10 ms 立体声，统计常用采样率组合在各质量等级下每帧耗时 */
+namespace
+{
+  enum { kChannels = 2 };
+
+  template <typename T>
+  double MeasureUs(int inRate, int outRate, AliEngineAudioResampleQuality quality, int iterations)
+  {
+    const int frames = inRate / 100;
+    std::vector<T> in(static_cast<size_t>(frames) * kChannels);
+    for (int i = 0; i < frames * kChannels; ++i) {
+      in[i] = static_cast<T>(0.3 * sin(0.01 * i) * (sizeof(T) == 2 ? 32767 : 1));
+    }
+    AliEngineAudioResampler resampler;
+    ALI_CHECK_EQ(resampler.Init(inRate, outRate, kChannels, quality), 0);
+    std::vector<T> out(static_cast<size_t>(resampler.MaxOutputFrames(frames)) * kChannels);
+    const int capacity = static_cast<int>(out.size() / kChannels);
+    resampler.Process(&in[0], frames, &out[0], capacity);
+    const double start = ali_rtc_test::NowUs();
+    for (int n = 0; n < iterations; ++n) {
+      resampler.Process(&in[0], frames, &out[0], capacity);
+    }
+    return (ali_rtc_test::NowUs() - start) / iterations;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const int iterations = ali_rtc_test::QuickMode(argc, argv) ? 20 : 5000;
+  const int rates[][2] = {{44100, 48000}, {48000, 44100}, {48000, 16000}, {16000, 48000}, {8000, 48000}, {48000, 8000}};
+  const char* const qualities[] = {"low", "medium", "high"};
+  printf("%-13s %-7s %12s %12s\n", "rates", "quality", "float us", "int16 us");
+  for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r) {
+    for (int q = 0; q < 3; ++q) {
+      const AliEngineAudioResampleQuality quality = static_cast<AliEngineAudioResampleQuality>(q);
+      const double f32 = MeasureUs<float>(rates[r][0], rates[r][1], quality, iterations);
+      const double s16 = MeasureUs<int16_t>(rates[r][0], rates[r][1], quality, iterations);
+      printf("%5d->%-6d %-7s %12.2f %12.2f\n", rates[r][0], rates[r][1], qualities[q], f32, s16);
+    }
+  }
+  return 0;
+}
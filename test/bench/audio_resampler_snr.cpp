@@ -0,0 +1,123 @@
+#include <math.h>
+#include <vector>
+
+#include "engine_audio_resampler.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/*
+ * 重采样 SNR 测试：对通带内的正弦按报告的群时延对齐理想输出，统计信噪比；
+ * 同时检查输出 Nyquist 以上的正弦被抑制，以及分块输入与整段输入结果一致
+ */
+namespace
+{
+  const char* const kQualityNames[] = {"low", "medium", "high"};
+  /* 各质量等级通带 SNR 与阻带抑制的下限，单位：dB；低质量的滚降点较低，通带边缘的 SNR 下限相应放宽 */
+  const double kMinSnrDb[] = {35.0, 70.0, 90.0};
+  const double kMinRejectDb[] = {55.0, 85.0, 100.0};
+
+  const double kPi = 3.14159265358979323846;
+
+  std::vector<float> Tone(int rate, double frequency, int frames)
+  {
+    std::vector<float> pcm(static_cast<size_t>(frames) * 2);
+    for (int i = 0; i < frames; ++i) {
+      pcm[2 * i] = static_cast<float>(0.5 * sin(2 * kPi * frequency * i / rate));
+      pcm[2 * i + 1] = pcm[2 * i];
+    }
+    return pcm;
+  }
+
+  /* 返回输出帧数；chunked 为 true 时按不规则的块长输入 */
+  int Resample(AliEngineAudioResampler &resampler, const std::vector<float> &in, std::vector<float> &out, bool chunked)
+  {
+    const int frames = static_cast<int>(in.size() / 2);
+    out.assign(static_cast<size_t>(resampler.MaxOutputFrames(frames)) * 2 + 64, 0.0f);
+    const int capacity = static_cast<int>(out.size() / 2);
+    if (!chunked) {
+      return resampler.Process(&in[0], frames, &out[0], capacity);
+    }
+    const int chunks[] = {1, 7, 441, 13, 1000};
+    int produced = 0;
+    for (int pos = 0, k = 0; pos < frames; ++k) {
+      const int count = chunks[k % 5] < frames - pos ? chunks[k % 5] : frames - pos;
+      produced += resampler.Process(&in[static_cast<size_t>(pos) * 2], count, &out[static_cast<size_t>(produced) * 2], capacity - produced);
+      pos += count;
+    }
+    return produced;
+  }
+
+  /* 跳过首尾各 margin 个输出采样 */
+  double SnrDb(const std::vector<float> &out, int frames, int rate, double frequency, double delay, int margin)
+  {
+    double signal = 0, noise = 0;
+    for (int i = margin; i < frames - margin; ++i) {
+      const double ref = 0.5 * sin(2 * kPi * frequency * (i - delay) / rate);
+      signal += ref * ref;
+      noise += (out[2 * i] - ref) * (out[2 * i] - ref);
+    }
+    return noise > 0 ? 10 * log10(signal / noise) : 200.0;
+  }
+
+  double RejectDb(const std::vector<float> &out, int frames, int margin)
+  {
+    double energy = 0;
+    for (int i = margin; i < frames - margin; ++i) {
+      energy += out[2 * i] * out[2 * i];
+    }
+    const double rms = sqrt(energy / (frames - 2 * margin));
+    return rms > 0 ? 20 * log10(0.5 / sqrt(2.0) / rms) : 200.0;
+  }
+}
+
+/* 全部组合耗时不到 1 秒，--quick 也完整运行 */
+int main()
+{
+  const int allRates[][2] = {{44100, 48000}, {48000, 44100}, {48000, 16000}, {16000, 48000},
+                             {8000, 48000}, {48000, 8000}, {32000, 44100}, {22050, 16000}};
+  const int pairs = static_cast<int>(sizeof(allRates) / sizeof(allRates[0]));
+  printf("%-13s %-7s %5s %9s %9s %9s %10s %8s\n", "rates", "quality", "taps", "snr 100", "snr 1k", "snr edge", "reject dB", "delay us");
+  for (int p = 0; p < pairs; ++p) {
+    const int inRate = allRates[p][0], outRate = allRates[p][1];
+    const int minRate = inRate < outRate ? inRate : outRate;
+    /* 通带取较低采样率的 0.35 倍，阻带取输出 Nyquist 的 1.3 倍（仍低于输入 Nyquist 才有意义） */
+    const double frequencies[] = {100.0, 1000.0, 0.35 * minRate};
+    const double stopFrequency = 0.65 * outRate;
+    for (int q = 0; q < 3; ++q) {
+      const AliEngineAudioResampleQuality quality = static_cast<AliEngineAudioResampleQuality>(q);
+      double snr[3];
+      long long delayUs = 0;
+      int taps = 0;
+      for (int f = 0; f < 3; ++f) {
+        AliEngineAudioResampler whole, chunked;
+        ALI_CHECK_EQ(whole.Init(inRate, outRate, 2, quality), 0);
+        ALI_CHECK_EQ(chunked.Init(inRate, outRate, 2, quality), 0);
+        const std::vector<float> in = Tone(inRate, frequencies[f], inRate / 2);
+        std::vector<float> a, b;
+        const int frames = Resample(whole, in, a, false);
+        const int framesChunked = Resample(chunked, in, b, true);
+        ALI_CHECK_EQ(frames, framesChunked);
+        for (int i = 0; i < frames * 2; ++i) {
+          ALI_CHECK(a[i] == b[i]);
+        }
+        delayUs = whole.GroupDelayUs();
+        taps = whole.Taps();
+        snr[f] = SnrDb(a, frames, outRate, frequencies[f], whole.GroupDelayFrames(), outRate / 20);
+        ALI_CHECK(snr[f] >= kMinSnrDb[q]);
+      }
+      double reject = 200.0;
+      if (stopFrequency < 0.5 * inRate) {
+        AliEngineAudioResampler resampler;
+        ALI_CHECK_EQ(resampler.Init(inRate, outRate, 2, quality), 0);
+        std::vector<float> out;
+        const int frames = Resample(resampler, Tone(inRate, stopFrequency, inRate / 2), out, false);
+        reject = RejectDb(out, frames, outRate / 20);
+        ALI_CHECK(reject >= kMinRejectDb[q]);
+      }
+      printf("%5d->%-6d %-7s %5d %9.1f %9.1f %9.1f %10.1f %8lld\n", inRate, outRate, kQualityNames[q], taps,
+             snr[0], snr[1], snr[2], reject, delayUs);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include <vector>
+
+#include "engine_video_convert.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 11 种裸数据格式两两转换，统计 720p 与 1080p 下每像素耗时 */
+namespace
+{
+  const char* const kNames[] = {"BGRA", "I420", "NV21", "NV12", "RGBA", "I422", "ARGB", "ABGR", "RGB24", "BGR24", "RGB565"};
+  enum { kFormatCount = 11 };
+
+  double MeasureNsPerPixel(AliEngineVideoFormat from, AliEngineVideoFormat to, int width, int height, int iterations)
+  {
+    std::vector<uint8_t> source(AliEngineVideoFrameBufferSize(from, width, height));
+    std::vector<uint8_t> output(AliEngineVideoFrameBufferSize(to, width, height));
+    for (size_t i = 0; i < source.size(); ++i) {
+      source[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+    }
+    AliEngineVideoRawData src, dst;
+    AliEngineVideoFrameAttachBuffer(src, &source[0], from, width, height);
+    AliEngineVideoFrameAttachBuffer(dst, &output[0], to, width, height);
+    AliEngineVideoFormatConverter converter;
+    ALI_CHECK_EQ(converter.Convert(src, dst), AliEngineVideoConvertOk);
+    const double start = ali_rtc_test::NowUs();
+    for (int n = 0; n < iterations; ++n) {
+      converter.Convert(src, dst);
+    }
+    return (ali_rtc_test::NowUs() - start) * 1000.0 / iterations / (static_cast<double>(width) * height);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const bool quick = ali_rtc_test::QuickMode(argc, argv);
+  const int sizes[][2] = {{1280, 720}, {1920, 1080}};
+  for (int s = 0; s < 2; ++s) {
+    /* 冒烟运行只跑 720p 且每对一次 */
+    if (quick && s > 0) {
+      break;
+    }
+    const int iterations = quick ? 1 : (s == 0 ? 40 : 20);
+    printf("%dx%d ns/pixel (row: source, column: destination)\n%-7s", sizes[s][0], sizes[s][1], "");
+    for (int to = 0; to < kFormatCount; ++to) {
+      printf(" %7s", kNames[to]);
+    }
+    printf("\n");
+    for (int from = 0; from < kFormatCount; ++from) {
+      printf("%-7s", kNames[from]);
+      for (int to = 0; to < kFormatCount; ++to) {
+        const double ns = MeasureNsPerPixel(static_cast<AliEngineVideoFormat>(from), static_cast<AliEngineVideoFormat>(to),
+                                            sizes[s][0], sizes[s][1], iterations);
+        printf(" %7.3f", ns);
+      }
+      printf("\n");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include <string.h>
+#include <vector>
+
+#include "engine_video_dirty_rect.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 1080p BGRA 合成桌面序列：静止、光标闪烁、打字、窗口拖动、视频播放、整屏滚动，统计每帧耗时与变化比例 */
+namespace
+{
+  enum { kWidth = 1920, kHeight = 1080, kBpp = 4 };
+
+  enum Scene {
+    kSceneStatic,
+    kSceneCaret,
+    kSceneTyping,
+    kSceneWindowDrag,
+    kSceneVideo,
+    kSceneScroll,
+    kSceneCount,
+  };
+
+  const char* const kSceneNames[] = {"static", "caret", "typing", "window drag", "video 640x360", "scroll"};
+
+  void FillRect(std::vector<uint8_t> &frame, int x, int y, int w, int h, uint32_t color)
+  {
+    for (int row = y; row < y + h && row < kHeight; ++row) {
+      uint8_t* p = &frame[(static_cast<size_t>(row) * kWidth + x) * kBpp];
+      for (int col = 0; col < w && x + col < kWidth; ++col) {
+        memcpy(p + col * kBpp, &color, kBpp);
+      }
+    }
+  }
+
+  /* 桌面背景加若干窗口，按行带有文字状的细节 */
+  void DrawDesktop(std::vector<uint8_t> &frame, int scroll)
+  {
+    for (int y = 0; y < kHeight; ++y) {
+      const int line = (y + scroll) % 24;
+      for (int x = 0; x < kWidth; ++x) {
+        const uint32_t color = line < 14 && ((x * 7 + (y + scroll) * 3) % 11) < 4 ? 0xFF202020u : 0xFFF0F0F0u;
+        memcpy(&frame[(static_cast<size_t>(y) * kWidth + x) * kBpp], &color, kBpp);
+      }
+    }
+  }
+
+  void Advance(Scene scene, int n, std::vector<uint8_t> &frame, const std::vector<uint8_t> &desktop, unsigned &seed)
+  {
+    switch (scene) {
+      case kSceneStatic:
+        break;
+      case kSceneCaret:
+        FillRect(frame, 800, 500, 2, 18, n % 30 < 15 ? 0xFF000000u : 0xFFF0F0F0u);
+        break;
+      case kSceneTyping:
+        FillRect(frame, 200 + (n % 120) * 10, 300 + (n / 120) * 24, 9, 16, 0xFF101010u);
+        FillRect(frame, 210 + (n % 120) * 10, 300 + (n / 120) * 24, 2, 18, 0xFF000000u);
+        break;
+      case kSceneWindowDrag: {
+        const int x = 100 + (n * 7) % 1000, y = 100 + (n * 3) % 500;
+        const int px = 100 + ((n - 1) * 7) % 1000, py = 100 + ((n - 1) * 3) % 500;
+        for (int row = py; row < py + 400; ++row) {
+          memcpy(&frame[(static_cast<size_t>(row) * kWidth + px) * kBpp], &desktop[(static_cast<size_t>(row) * kWidth + px) * kBpp],
+                 600 * kBpp);
+        }
+        FillRect(frame, x, y, 600, 400, 0xFF3060A0u);
+        break;
+      }
+      case kSceneVideo:
+        for (int row = 360; row < 720; ++row) {
+          uint8_t* p = &frame[(static_cast<size_t>(row) * kWidth + 640) * kBpp];
+          for (int i = 0; i < 640 * kBpp; ++i) {
+            seed = seed * 1103515245 + 12345;
+            p[i] = static_cast<uint8_t>(seed >> 16);
+          }
+        }
+        break;
+      case kSceneScroll:
+        DrawDesktop(frame, n * 3);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const int frames = ali_rtc_test::QuickMode(argc, argv) ? 4 : 300;
+  std::vector<uint8_t> desktop(AliEngineVideoFrameBufferSize(AliEngineVideoFormatBGRA, kWidth, kHeight));
+  DrawDesktop(desktop, 0);
+  printf("%-14s %10s %10s %12s %12s\n", "scene", "us/frame", "rects", "dirty tiles", "skipped MBs");
+  std::vector<uint8_t> mask(((kWidth + 15) / 16) * ((kHeight + 15) / 16));
+  for (int s = 0; s < kSceneCount; ++s) {
+    std::vector<uint8_t> frame = desktop;
+    AliEngineVideoRawData raw;
+    AliEngineVideoFrameAttachBuffer(raw, &frame[0], AliEngineVideoFormatBGRA, kWidth, kHeight);
+    AliEngineDirtyRectTracker tracker;
+    tracker.Update(raw);
+    unsigned seed = 1;
+    double us = 0;
+    long long rects = 0, dirtyTiles = 0, skipped = 0, macroblocks = 0;
+    for (int n = 1; n <= frames; ++n) {
+      Advance(static_cast<Scene>(s), n, frame, desktop, seed);
+      const double start = ali_rtc_test::NowUs();
+      const int count = tracker.Update(raw);
+      us += ali_rtc_test::NowUs() - start;
+      ALI_CHECK(count >= 0);
+      rects += count;
+      dirtyTiles += tracker.DirtyTileCount();
+      const int total = tracker.BuildMacroblockMask(&mask[0]);
+      macroblocks += total;
+      for (int i = 0; i < total; ++i) {
+        skipped += mask[i] == 0;
+      }
+    }
+    printf("%-14s %10.1f %10.2f %11.2f%% %11.2f%%\n", kSceneNames[s], us / frames, static_cast<double>(rects) / frames,
+           100.0 * dirtyTiles / (static_cast<double>(tracker.TileCount()) * frames), 100.0 * skipped / macroblocks);
+  }
+  return 0;
+}
@@ -0,0 +1,400 @@
+#include <stdlib.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine_event_dispatcher.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 统计全局 operator new 的调用次数，检查引擎线程上的投递不分配内存 */
+namespace
+{
+  std::atomic<long long> g_allocations(0);
+}
+
+/* operator new 内联后 GCC 会把 free 误判为与 new 不匹配 */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+  /* 上线回调阻塞到 Release，用于在分发线程积压事件；记录每个用户最后收到的网络质量 */
+  class RecordingListener : public AliEngineEventListener {
+  public:
+    void OnRemoteUserOnLineNotify(const char *uid, int elapsed) override
+    {
+      std::unique_lock<std::mutex> guard(lock_);
+      blocked_ = true;
+      changed_.notify_all();
+      changed_.wait(guard, [this]() { return released_; });
+    }
+
+    void OnRemoteUserOffLineNotify(const char *uid, AliEngineUserOfflineReason reason) override
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      ++offline_;
+    }
+
+    void OnNetworkQualityChanged(const char *uid, AliEngineNetworkQuality upQuality, AliEngineNetworkQuality downQuality) override
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      ++deliveries_[uid];
+      quality_[uid] = upQuality;
+    }
+
+    void OnOccurWarning(int warn, const char *msg) override
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      warnings_.push_back(warn);
+      lastMessage_ = msg ? msg : "(null)";
+    }
+
+    void OnAudioVolumeCallback(const AliEngineUserVolumeInfo* volumeInfo, int volumeInfoCount, int totalVolume) override
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      volumes_.assign(volumeInfo, volumeInfo + volumeInfoCount);
+      totalVolume_ = totalVolume;
+    }
+
+    void OnMediaExtensionMsgReceived(const char* uid, const uint8_t payloadType, const int8_t * message, uint32_t size) override
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      extension_.assign(message, message + size);
+      extensionType_ = payloadType;
+    }
+
+    void WaitBlocked()
+    {
+      std::unique_lock<std::mutex> guard(lock_);
+      changed_.wait(guard, [this]() { return blocked_; });
+    }
+
+    void Release()
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      released_ = true;
+      changed_.notify_all();
+    }
+
+    int Deliveries(const std::string &uid)
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      return deliveries_[uid];
+    }
+
+    int Quality(const std::string &uid)
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      return quality_.count(uid) ? quality_[uid] : -1;
+    }
+
+    std::vector<int> Warnings()
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      return warnings_;
+    }
+
+    std::string LastMessage()
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      return lastMessage_;
+    }
+
+    std::vector<AliEngineUserVolumeInfo> Volumes(int &totalVolume)
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      totalVolume = totalVolume_;
+      return volumes_;
+    }
+
+    std::vector<int8_t> Extension(int &payloadType)
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      payloadType = extensionType_;
+      return extension_;
+    }
+
+  private:
+    std::mutex lock_;
+    std::condition_variable changed_;
+    bool blocked_ = false;
+    bool released_ = false;
+    int offline_ = 0;
+    std::map<std::string, int> deliveries_;
+    std::map<std::string, int> quality_;
+    std::vector<int> warnings_;
+    std::string lastMessage_;
+    std::vector<AliEngineUserVolumeInfo> volumes_;
+    int totalVolume_ = 0;
+    std::vector<int8_t> extension_;
+    int extensionType_ = -1;
+  };
+
+  /* 送达计数在队列深度减少之后更新，以计数对齐为准 */
+  void WaitDrained(AliEngineEventDispatcher &dispatcher)
+  {
+    const double start = ali_rtc_test::NowUs();
+    while (true) {
+      const AliEngineEventDispatcherStats stats = dispatcher.GetStats();
+      if (stats.queueDepth == 0 && stats.delivered + stats.coalesced + stats.dropped == stats.posted) {
+        break;
+      }
+      ALI_CHECK(ali_rtc_test::NowUs() - start < 10e6);
+      std::this_thread::yield();
+    }
+  }
+
+  AliEngineNetworkQuality Quality(int value)
+  {
+    return static_cast<AliEngineNetworkQuality>(value);
+  }
+
+  /* 监听者阻塞期间同一用户的统计类回调只保留最新值 */
+  void TestCoalesceKeepsLatest()
+  {
+    RecordingListener listener;
+    AliEngineEventDispatcher dispatcher(&listener);
+    dispatcher.OnRemoteUserOnLineNotify("gate", 0);
+    listener.WaitBlocked();
+    for (int i = 0; i < 100; ++i) {
+      dispatcher.OnNetworkQualityChanged("alice", Quality(i % 7), Quality(0));
+    }
+    dispatcher.OnNetworkQualityChanged("bob", Quality(3), Quality(0));
+    listener.Release();
+    WaitDrained(dispatcher);
+    ALI_CHECK_EQ(listener.Deliveries("alice"), 1);
+    ALI_CHECK_EQ(listener.Quality("alice"), 99 % 7);
+    ALI_CHECK_EQ(listener.Quality("bob"), 3);
+    const AliEngineEventDispatcherStats stats = dispatcher.GetStats();
+    ALI_CHECK_EQ(stats.coalesced, 99);
+    ALI_CHECK_EQ(stats.posted, 102);
+    ALI_CHECK_EQ(stats.delivered, 3);
+  }
+
+  /*
+   * 用户下线回收槽位：未送达的值仍按序送达，复用槽位的新用户收到自己的值；
+   * 第二轮连续投递 2000 个回调，队列容量按此设置，不会因溢出列表满而丢弃
+   */
+  void TestOfflineReclaimsSlots()
+  {
+    RecordingListener listener;
+    AliEngineEventDispatcherConfig config;
+    config.queueCapacity = 4096;
+    AliEngineEventDispatcher dispatcher(&listener, config);
+    dispatcher.OnRemoteUserOnLineNotify("gate", 0);
+    listener.WaitBlocked();
+    for (int u = 0; u < 200; ++u) {
+      const std::string uid = "user" + std::to_string(u);
+      dispatcher.OnNetworkQualityChanged(uid.c_str(), Quality(u % 6), Quality(0));
+      dispatcher.OnRemoteUserOffLineNotify(uid.c_str(), AliEngineUserOfflineQuit);
+    }
+    listener.Release();
+    WaitDrained(dispatcher);
+    for (int round = 0; round < 50; ++round) {
+      for (int u = 0; u < 20; ++u) {
+        const std::string uid = "next" + std::to_string(round * 20 + u);
+        dispatcher.OnNetworkQualityChanged(uid.c_str(), Quality((round + u) % 6), Quality(0));
+        dispatcher.OnRemoteUserOffLineNotify(uid.c_str(), AliEngineUserOfflineDropped);
+      }
+    }
+    WaitDrained(dispatcher);
+    for (int u = 0; u < 200; ++u) {
+      const std::string uid = "user" + std::to_string(u);
+      ALI_CHECK_EQ(listener.Deliveries(uid), 1);
+      ALI_CHECK_EQ(listener.Quality(uid), u % 6);
+    }
+    for (int round = 0; round < 50; ++round) {
+      for (int u = 0; u < 20; ++u) {
+        const std::string uid = "next" + std::to_string(round * 20 + u);
+        ALI_CHECK_EQ(listener.Deliveries(uid), 1);
+        ALI_CHECK_EQ(listener.Quality(uid), (round + u) % 6);
+      }
+    }
+  }
+
+  /* 多个引擎线程并发投递与下线，全局统计与送达一致 */
+  void TestConcurrentPosts()
+  {
+    RecordingListener listener;
+    AliEngineEventDispatcher dispatcher(&listener);
+    std::thread threads[3];
+    for (int t = 0; t < 3; ++t) {
+      threads[t] = std::thread([&dispatcher, t]() {
+        for (int i = 0; i < 2000; ++i) {
+          const std::string uid = "t" + std::to_string(t) + "-" + std::to_string(i % 10);
+          dispatcher.OnNetworkQualityChanged(uid.c_str(), Quality(i % 6), Quality(0));
+          if (i % 10 == 9) {
+            dispatcher.OnRemoteUserOffLineNotify(uid.c_str(), AliEngineUserOfflineQuit);
+          }
+        }
+      });
+    }
+    for (int t = 0; t < 3; ++t) {
+      threads[t].join();
+    }
+    WaitDrained(dispatcher);
+    const AliEngineEventDispatcherStats stats = dispatcher.GetStats();
+    ALI_CHECK_EQ(stats.posted, 3 * 2200);
+    ALI_CHECK_EQ(stats.delivered + stats.coalesced + stats.dropped, stats.posted);
+  }
+
+  /*
+   * 队列与溢出列表都满后状态类回调被丢弃并计数，已入队的按序送达；
+   * 统计类回调仍按键合并，令牌进入溢出列表的余量，不被丢弃
+   */
+  void TestSpillBoundedAndDropsCounted()
+  {
+    RecordingListener listener;
+    AliEngineEventDispatcherConfig config;
+    config.queueCapacity = 16;
+    config.spillCapacity = 8;
+    AliEngineEventDispatcher dispatcher(&listener, config);
+    dispatcher.OnRemoteUserOnLineNotify("gate", 0);
+    listener.WaitBlocked();
+    /* 事件池共 24 个，上线回调占用一个 */
+    for (int i = 0; i < 100; ++i) {
+      dispatcher.OnOccurWarning(i, "warn");
+      dispatcher.OnNetworkQualityChanged("alice", Quality(i % 6), Quality(0));
+    }
+    AliEngineEventDispatcherStats stats = dispatcher.GetStats();
+    ALI_CHECK_EQ(stats.dropped, 77);
+    ALI_CHECK_EQ(stats.coalesced, 99);
+    ALI_CHECK(stats.spilled >= 7);
+    ALI_CHECK(stats.maxQueueDepth <= 16 + 8 + 1);
+    listener.Release();
+    WaitDrained(dispatcher);
+    const std::vector<int> warnings = listener.Warnings();
+    ALI_CHECK_EQ(warnings.size(), 23);
+    for (size_t i = 0; i < warnings.size(); ++i) {
+      ALI_CHECK_EQ(warnings[i], static_cast<int>(i));
+    }
+    ALI_CHECK_EQ(listener.Deliveries("alice"), 1);
+    ALI_CHECK_EQ(listener.Quality("alice"), 99 % 6);
+
+    /* 排空后事件全部归还，可继续投递 */
+    dispatcher.OnOccurWarning(1000, "again");
+    WaitDrained(dispatcher);
+    ALI_CHECK_EQ(listener.Warnings().back(), 1000);
+    stats = dispatcher.GetStats();
+    ALI_CHECK_EQ(stats.posted, 1 + 200 + 1);
+    ALI_CHECK_EQ(stats.dropped, 77);
+  }
+
+  /* 事件从预分配的池中取用：槽位建立后，状态类与统计类回调的投递都不分配内存 */
+  void TestPostDoesNotAllocate()
+  {
+    RecordingListener listener;
+    AliEngineEventDispatcher dispatcher(&listener);
+    dispatcher.OnRemoteUserOnLineNotify("gate", 0);
+    listener.WaitBlocked();
+    AliEngineStats engineStats;
+    AliEngineRemoteAudioStats audioStats;
+    audioStats.userId = "alice";
+    dispatcher.OnNetworkQualityChanged("alice", Quality(1), Quality(0));
+    dispatcher.OnStats(engineStats);
+    dispatcher.OnRemoteAudioStats(audioStats);
+    const long long before = g_allocations.load();
+    for (int i = 0; i < 500; ++i) {
+      dispatcher.OnOccurWarning(i, "message within the inline buffer");
+      dispatcher.OnUserAudioMuted("alice", i % 2 == 0);
+      dispatcher.OnNetworkQualityChanged("alice", Quality(i % 6), Quality(0));
+      dispatcher.OnStats(engineStats);
+      dispatcher.OnRemoteAudioStats(audioStats);
+    }
+    ALI_CHECK_EQ(g_allocations.load() - before, 0);
+    listener.Release();
+    WaitDrained(dispatcher);
+    ALI_CHECK_EQ(listener.Warnings().size(), 500);
+  }
+
+  /* 超出内嵌缓冲的字符串和数据块、以及音量回调中的 uid 都完整送达 */
+  void TestPayloadRoundTrip()
+  {
+    RecordingListener listener;
+    AliEngineEventDispatcher dispatcher(&listener);
+    const std::string longMessage(5000, 'x');
+    dispatcher.OnOccurWarning(7, longMessage.c_str());
+    dispatcher.OnOccurWarning(8, nullptr);
+    WaitDrained(dispatcher);
+    ALI_CHECK_EQ(listener.Warnings().size(), 2);
+    ALI_CHECK(listener.LastMessage() == "(null)");
+    dispatcher.OnOccurWarning(9, longMessage.c_str());
+    WaitDrained(dispatcher);
+    ALI_CHECK(listener.LastMessage() == longMessage);
+
+    std::vector<int8_t> payload(3000);
+    for (size_t i = 0; i < payload.size(); ++i) {
+      payload[i] = static_cast<int8_t>(i * 7);
+    }
+    dispatcher.OnMediaExtensionMsgReceived("bob", 5, &payload[0], static_cast<uint32_t>(payload.size()));
+
+    std::vector<AliEngineUserVolumeInfo> infos(40);
+    for (size_t i = 0; i < infos.size(); ++i) {
+      infos[i].uid = ("speaker-" + std::to_string(i)).c_str();
+      infos[i].speechState = i % 3 == 0;
+      infos[i].volume = static_cast<int>(i * 5);
+      infos[i].sumVolume = static_cast<int>(i * 6);
+    }
+    dispatcher.OnAudioVolumeCallback(&infos[0], static_cast<int>(infos.size()), 123);
+    WaitDrained(dispatcher);
+
+    int payloadType = -1;
+    ALI_CHECK(listener.Extension(payloadType) == payload);
+    ALI_CHECK_EQ(payloadType, 5);
+    int totalVolume = 0;
+    const std::vector<AliEngineUserVolumeInfo> received = listener.Volumes(totalVolume);
+    ALI_CHECK_EQ(totalVolume, 123);
+    ALI_CHECK_EQ(received.size(), infos.size());
+    for (size_t i = 0; i < infos.size(); ++i) {
+      ALI_CHECK(received[i].uid == infos[i].uid);
+      ALI_CHECK_EQ(received[i].speechState, infos[i].speechState);
+      ALI_CHECK_EQ(received[i].volume, infos[i].volume);
+      ALI_CHECK_EQ(received[i].sumVolume, infos[i].sumVolume);
+    }
+  }
+}
+
+int main()
+{
+  TestCoalesceKeepsLatest();
+  TestOfflineReclaimsSlots();
+  TestConcurrentPosts();
+  TestSpillBoundedAndDropsCounted();
+  TestPostDoesNotAllocate();
+  TestPayloadRoundTrip();
+  printf("event_dispatcher_test passed\n");
+  return 0;
+}
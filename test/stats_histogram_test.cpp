@@ -0,0 +1,103 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine_stats_histogram.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  /* 超过 63 个字符的 uid 反复记录只占一个直方图，表不会被耗尽 */
+  void TestLongUidKeepsOneHistogram()
+  {
+    AliEngineStatsHistogramConfig config;
+    config.maxHistograms = 4;
+    AliEngineStatsHistogram histogram(config);
+    const std::string longUid(70, 'x');
+    for (int i = 0; i < 100; ++i) {
+      histogram.Record(AliEngineStatsMetricJitterBufferDelay, longUid.c_str(), 40);
+    }
+    histogram.Record(AliEngineStatsMetricJitterBufferDelay, "bob", 10);
+    ALI_CHECK_EQ(histogram.GetDroppedCount(), 0);
+    AliEngineStatsPercentiles result;
+    ALI_CHECK(histogram.GetPercentiles(AliEngineStatsMetricJitterBufferDelay, longUid.c_str(), 30000, result));
+    ALI_CHECK_EQ(result.count, 100);
+    ALI_CHECK_EQ(result.max, 40);
+    ALI_CHECK(histogram.GetPercentiles(AliEngineStatsMetricJitterBufferDelay, "bob", 30000, result));
+    ALI_CHECK_EQ(result.count, 1);
+  }
+
+  /* 前 63 个字符相同的两个长 uid 是不同用户，下线只影响自己 */
+  void TestLongUidsWithSharedPrefix()
+  {
+    AliEngineStatsHistogram histogram;
+    const std::string first = std::string(63, 'p') + "-first";
+    const std::string second = std::string(63, 'p') + "-second";
+    histogram.Record(AliEngineStatsMetricNetworkTransportDelay, first.c_str(), 1);
+    histogram.Record(AliEngineStatsMetricNetworkTransportDelay, second.c_str(), 2);
+    histogram.Record(AliEngineStatsMetricNetworkTransportDelay, second.c_str(), 2);
+    AliEngineStatsPercentiles result;
+    ALI_CHECK(histogram.GetPercentiles(AliEngineStatsMetricNetworkTransportDelay, first.c_str(), 30000, result));
+    ALI_CHECK_EQ(result.count, 1);
+    ALI_CHECK(histogram.GetPercentiles(AliEngineStatsMetricNetworkTransportDelay, second.c_str(), 30000, result));
+    ALI_CHECK_EQ(result.count, 2);
+    ALI_CHECK(!histogram.GetPercentiles(AliEngineStatsMetricNetworkTransportDelay, std::string(63, 'p').c_str(), 30000, result));
+    histogram.RemoveUser(first.c_str());
+    histogram.Record(AliEngineStatsMetricNetworkTransportDelay, second.c_str(), 2);
+    ALI_CHECK(histogram.GetPercentiles(AliEngineStatsMetricNetworkTransportDelay, second.c_str(), 30000, result));
+    ALI_CHECK_EQ(result.count, 3);
+  }
+
+  /* 超出上限的样本计入最高桶，最大值仍精确 */
+  void TestOutOfRangeValues()
+  {
+    AliEngineStatsHistogram histogram;
+    histogram.Record(AliEngineStatsMetricRtt, nullptr, -5);
+    histogram.Record(AliEngineStatsMetricRtt, nullptr, 100000);
+    AliEngineStatsPercentiles result;
+    ALI_CHECK(histogram.GetPercentiles(AliEngineStatsMetricRtt, nullptr, 30000, result));
+    ALI_CHECK_EQ(result.count, 2);
+    ALI_CHECK_EQ(result.p50, 0);
+    ALI_CHECK_EQ(result.max, 100000);
+  }
+
+  /* 多线程记录长 uid 时不丢样本 */
+  void TestConcurrentLongUidRecords()
+  {
+    AliEngineStatsHistogramConfig config;
+    config.maxHistograms = 4;
+    AliEngineStatsHistogram histogram(config);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 3; ++t) {
+      writers.push_back(std::thread([&histogram, t]() {
+        const std::string uid = std::string(64, 'w') + static_cast<char>('0' + t);
+        for (int i = 0; i < 10000; ++i) {
+          histogram.Record(AliEngineStatsMetricJitterBufferDelay, uid.c_str(), i % 100);
+        }
+      }));
+    }
+    for (size_t i = 0; i < writers.size(); ++i) {
+      writers[i].join();
+    }
+    ALI_CHECK_EQ(histogram.GetDroppedCount(), 0);
+    for (int t = 0; t < 3; ++t) {
+      const std::string uid = std::string(64, 'w') + static_cast<char>('0' + t);
+      AliEngineStatsPercentiles result;
+      ALI_CHECK(histogram.GetPercentiles(AliEngineStatsMetricJitterBufferDelay, uid.c_str(), 30000, result));
+      ALI_CHECK_EQ(result.count, 10000);
+    }
+  }
+}
+
+int main()
+{
+  TestLongUidKeepsOneHistogram();
+  TestLongUidsWithSharedPrefix();
+  TestOutOfRangeValues();
+  TestConcurrentLongUidRecords();
+  printf("stats_histogram_test passed\n");
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <string>
+#include <thread>
+
+#include "engine_stats_snapshot.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  void PushAudio(AliEngineStatsSnapshot &snapshot, const char* uid, int delay)
+  {
+    AliEngineRemoteAudioStats stats;
+    stats.userId = uid;
+    stats.track = AliEngineAudioTrackMic;
+    stats.jitterBufferDelay = delay;
+    snapshot.Update(stats);
+  }
+
+  /* 超过 userId 容量的 uid 反复更新只占一个位置，其他用户不受影响 */
+  void TestLongUidKeepsOneSlot()
+  {
+    AliEngineStatsSnapshotConfig config;
+    config.maxRemoteUsers = 8;
+    AliEngineStatsSnapshot snapshot(config);
+    const std::string longUid(70, 'x');
+    for (int i = 0; i < 20; ++i) {
+      PushAudio(snapshot, longUid.c_str(), i);
+    }
+    PushAudio(snapshot, "bob", 42);
+    AliEngineRemoteStatsSnapshot out;
+    ALI_CHECK(snapshot.GetRemoteStats("bob", out));
+    ALI_CHECK_EQ(out.audio[0].jitterBufferDelay, 42);
+    ALI_CHECK(snapshot.GetRemoteStats(longUid.c_str(), out));
+    ALI_CHECK_EQ(out.audio[0].jitterBufferDelay, 19);
+    ALI_CHECK_EQ(strlen(out.userId), 63);
+    AliEngineRemoteStatsSnapshot list[8];
+    ALI_CHECK_EQ(snapshot.GetRemoteStatsList(list, 8), 2);
+  }
+
+  /* 前63字节相同的两个长 uid 是不同用户 */
+  void TestLongUidsWithSharedPrefix()
+  {
+    AliEngineStatsSnapshot snapshot;
+    const std::string first = std::string(63, 'p') + "-first";
+    const std::string second = std::string(63, 'p') + "-second";
+    PushAudio(snapshot, first.c_str(), 1);
+    PushAudio(snapshot, second.c_str(), 2);
+    AliEngineRemoteStatsSnapshot out;
+    ALI_CHECK(snapshot.GetRemoteStats(first.c_str(), out));
+    ALI_CHECK_EQ(out.audio[0].jitterBufferDelay, 1);
+    ALI_CHECK(snapshot.GetRemoteStats(second.c_str(), out));
+    ALI_CHECK_EQ(out.audio[0].jitterBufferDelay, 2);
+    ALI_CHECK(!snapshot.GetRemoteStats(std::string(63, 'p').c_str(), out));
+    snapshot.RemoveUser(first.c_str());
+    ALI_CHECK(snapshot.GetRemoteStats(first.c_str(), out) && !out.online);
+    ALI_CHECK(snapshot.GetRemoteStats(second.c_str(), out) && out.online);
+  }
+
+  /* 下线用户的位置在表满时被新用户复用 */
+  void TestOfflineSlotReuse()
+  {
+    AliEngineStatsSnapshotConfig config;
+    config.maxRemoteUsers = 2;
+    AliEngineStatsSnapshot snapshot(config);
+    PushAudio(snapshot, "a", 1);
+    PushAudio(snapshot, "b", 2);
+    PushAudio(snapshot, "c", 3);
+    AliEngineRemoteStatsSnapshot out;
+    ALI_CHECK(!snapshot.GetRemoteStats("c", out));
+    snapshot.RemoveUser("a");
+    PushAudio(snapshot, "c", 3);
+    ALI_CHECK(snapshot.GetRemoteStats("c", out) && out.audio[0].jitterBufferDelay == 3);
+    ALI_CHECK(!snapshot.GetRemoteStats("a", out));
+  }
+
+  /* 写者持续更新时读者读到的每个条目都是一致的 */
+  void TestConcurrentReadsAreConsistent()
+  {
+    AliEngineStatsSnapshot snapshot;
+    std::atomic<bool> running(true);
+    std::thread writer([&snapshot, &running]() {
+      for (int i = 1; i <= 50000; ++i) {
+        AliEngineStats stats;
+        stats.sentBytes = i;
+        stats.rcvdBytes = i;
+        stats.lastmileDelay = i;
+        snapshot.Update(stats);
+        AliEngineRemoteVideoStats video;
+        char uid[16];
+        snprintf(uid, sizeof(uid), "u%d", i % 6);
+        video.userId = uid;
+        video.track = AliEngineVideoTrackCamera;
+        video.width = i;
+        video.height = i;
+        snapshot.Update(video);
+      }
+      running.store(false);
+    });
+    AliEngineRemoteStatsSnapshot list[8];
+    while (running.load()) {
+      AliEngineStats stats;
+      if (snapshot.GetStats(stats)) {
+        ALI_CHECK(stats.sentBytes == stats.rcvdBytes && stats.sentBytes == stats.lastmileDelay);
+      }
+      const int count = snapshot.GetRemoteStatsList(list, 8);
+      for (int k = 0; k < count; ++k) {
+        ALI_CHECK(list[k].video[0].width == list[k].video[0].height);
+        ALI_CHECK(list[k].video[0].userId == list[k].userId);
+      }
+    }
+    writer.join();
+  }
+}
+
+int main()
+{
+  TestLongUidKeepsOneSlot();
+  TestLongUidsWithSharedPrefix();
+  TestOfflineSlotReuse();
+  TestConcurrentReadsAreConsistent();
+  printf("stats_snapshot_test passed\n");
+  return 0;
+}
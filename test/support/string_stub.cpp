@@ -0,0 +1,46 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "engine_utils.h"
+
+namespace AliRTCSdk
+{
+    static char* Duplicate(const char* str, int &length)
+    {
+      if (!str) {
+        length = 0;
+        return nullptr;
+      }
+      length = static_cast<int>(strlen(str));
+      char* data = static_cast<char*>(malloc(length + 1));
+      memcpy(data, str, length + 1);
+      return data;
+    }
+
+    String::String(const char* str) { data = Duplicate(str, dataLen); }
+    String::String(const String &other) { data = Duplicate(other.data, dataLen); }
+    String::~String() { free(data); }
+
+    String& String::operator=(const String &other)
+    {
+      if (this != &other) {
+        char* copy = Duplicate(other.data, dataLen);
+        free(data);
+        data = copy;
+      }
+      return *this;
+    }
+
+    String& String::operator=(const char* str)
+    {
+      char* copy = Duplicate(str, dataLen);
+      free(data);
+      data = copy;
+      return *this;
+    }
+
+    bool String::operator==(const String &other) const { return strcmp(c_str(), other.c_str()) == 0; }
+    const char* String::c_str() const { return data ? data : ""; }
+    bool String::isEmpty() const { return dataLen == 0; }
+    int String::size() const { return dataLen; }
+}
@@ -0,0 +1,43 @@
+#ifndef ali_rtc_test_util_h
+#define ali_rtc_test_util_h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+/* 失败时打印位置并以非零值退出，供 ctest 判定 */
+#define ALI_CHECK(cond)                                                             \
+  do {                                                                              \
+    if (!(cond)) {                                                                  \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);      \
+      exit(1);                                                                      \
+    }                                                                               \
+  } while (0)
+
+#define ALI_CHECK_EQ(a, b)                                                          \
+  do {                                                                              \
+    const long long va_ = static_cast<long long>(a);                                \
+    const long long vb_ = static_cast<long long>(b);                                \
+    if (va_ != vb_) {                                                               \
+      fprintf(stderr, "%s:%d: check failed: %s == %s (%lld vs %lld)\n",             \
+              __FILE__, __LINE__, #a, #b, va_, vb_);                                \
+      exit(1);                                                                      \
+    }                                                                               \
+  } while (0)
+
+namespace ali_rtc_test
+{
+  inline double NowUs()
+  {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /* 基准以 --quick 运行时缩短规模 */
+  inline bool QuickMode(int argc, char** argv)
+  {
+    return argc > 1 && strcmp(argv[1], "--quick") == 0;
+  }
+}
+
+#endif /* ali_rtc_test_util_h */
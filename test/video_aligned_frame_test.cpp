@@ -0,0 +1,150 @@
+#include <stdint.h>
+#include <vector>
+
+#include "engine_video_aligned_frame.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  const AliEngineVideoFormat kFormats[] = {
+    AliEngineVideoFormatBGRA, AliEngineVideoFormatI420, AliEngineVideoFormatNV21, AliEngineVideoFormatNV12,
+    AliEngineVideoFormatRGBA, AliEngineVideoFormatI422, AliEngineVideoFormatARGB, AliEngineVideoFormatABGR,
+    AliEngineVideoFormatRGB24, AliEngineVideoFormatBGR24, AliEngineVideoFormatRGB565,
+  };
+  const int kFormatCount = sizeof(kFormats) / sizeof(kFormats[0]);
+
+  const AliEngineVideoObserAlignment kAlignments[] = {
+    AliEngineAlignmentDefault, AliEngineAlignmentEven, AliEngineAlignment4, AliEngineAlignment8, AliEngineAlignment16,
+  };
+
+  /* 每个平面起始地址 64 字节对齐、stride 对齐，且末尾填充落在分配的内存内 */
+  void CheckAlignedFrame(const AliEngineAlignedVideoFrame &aligned, int strideAlignment)
+  {
+    const AliEngineVideoRawData &frame = aligned.Frame();
+    ALI_CHECK(AliEngineVideoFrameIsAligned(frame, kAliEngineVideoPlaneBaseAlignment, strideAlignment));
+    const uint8_t* base = static_cast<const uint8_t*>(frame.dataPtr);
+    const uint8_t* end = base + frame.dataLength;
+    internal::VideoPlanes planes;
+    ALI_CHECK(internal::ResolveVideoPlanes(frame, planes));
+    if (planes.packed) {
+      ALI_CHECK(planes.packed + static_cast<size_t>(planes.stride) * frame.height + kAliEngineVideoPlaneTailPadding <= end);
+      return;
+    }
+    const int chromaHeight = frame.format == AliEngineVideoFormatI422 ? frame.height : (frame.height + 1) / 2;
+    ALI_CHECK(planes.y + static_cast<size_t>(planes.strideY) * frame.height + kAliEngineVideoPlaneTailPadding <= planes.u);
+    ALI_CHECK(planes.u + static_cast<size_t>(planes.strideU) * chromaHeight + kAliEngineVideoPlaneTailPadding <= end);
+    if (planes.v) {
+      ALI_CHECK(planes.u < planes.v);
+      ALI_CHECK(planes.v + static_cast<size_t>(planes.strideV) * chromaHeight + kAliEngineVideoPlaneTailPadding <= end);
+    }
+  }
+
+  /* 所有裸数据格式、所有对齐方式、奇数和偶数尺寸的布局 */
+  void TestLayoutForEveryFormat()
+  {
+    const int sizes[][2] = {{1, 1}, {17, 9}, {640, 360}, {1281, 719}};
+    for (int f = 0; f < kFormatCount; ++f) {
+      for (size_t a = 0; a < sizeof(kAlignments) / sizeof(kAlignments[0]); ++a) {
+        const int strideAlignment = AliEngineVideoAlignmentBytes(kAlignments[a]);
+        AliEngineAlignedVideoFrame aligned;
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+          ALI_CHECK(aligned.Allocate(kFormats[f], sizes[s][0], sizes[s][1], strideAlignment));
+          CheckAlignedFrame(aligned, strideAlignment);
+        }
+      }
+    }
+    AliEngineVideoAlignedLayout layout;
+    ALI_CHECK(!AliEngineVideoComputeAlignedLayout(AliEngineVideoFormatH264, 16, 16, 16, layout));
+    ALI_CHECK(!AliEngineVideoComputeAlignedLayout(AliEngineVideoFormatI420, 16, 16, 3, layout));
+  }
+
+  /* 记录收到的帧，并在 Y/首字节写入标记以验证写回 */
+  struct RecordingObserver : public IVideoFrameObserver {
+    AliEngineVideoObserAlignment alignment = AliEngineAlignment16;
+    const void* seen = nullptr;
+    bool aligned = false;
+
+    AliEngineVideoObserAlignment GetVideoAlignment() override { return alignment; }
+
+    bool OnCaptureVideoSample(AliEngineVideoSource videoSource, AliEngineVideoRawData &frame) override
+    {
+      internal::VideoPlanes planes;
+      ALI_CHECK(internal::ResolveVideoPlanes(frame, planes));
+      seen = planes.packed ? planes.packed : planes.y;
+      aligned = AliEngineVideoFrameIsAligned(frame, kAliEngineVideoPlaneBaseAlignment,
+                                             AliEngineVideoAlignmentBytes(alignment));
+      return false;
+    }
+
+    bool OnPreEncodeVideoSample(AliEngineVideoSource videoSource, AliEngineVideoRawData &frame) override
+    {
+      internal::VideoPlanes planes;
+      ALI_CHECK(internal::ResolveVideoPlanes(frame, planes));
+      uint8_t* first = planes.packed ? planes.packed : planes.y;
+      first[0] = 0xA5;
+      return true;
+    }
+
+    bool OnRemoteVideoSample(const char* uid, AliEngineVideoSource videoSource, AliEngineVideoRawData &frame) override
+    {
+      return false;
+    }
+  };
+
+  /* 以 offset 偏移绑定到 storage 上的源帧，offset 为 0 时满足对齐 */
+  void MakeSource(AliEngineVideoFormat format, int width, int height, int offset, std::vector<uint8_t> &storage,
+                  AliEngineVideoRawData &frame)
+  {
+    AliEngineVideoAlignedLayout layout;
+    ALI_CHECK(AliEngineVideoComputeAlignedLayout(format, width, height, 16, layout));
+    storage.assign(static_cast<size_t>(layout.totalSize) + kAliEngineVideoPlaneBaseAlignment * 2, 0x40);
+    uint8_t* base = storage.data();
+    base += (kAliEngineVideoPlaneBaseAlignment - reinterpret_cast<uintptr_t>(base) % kAliEngineVideoPlaneBaseAlignment) %
+            kAliEngineVideoPlaneBaseAlignment;
+    AliEngineVideoFrameAttachAlignedBuffer(frame, base + offset, format, width, height, layout);
+  }
+
+  /* 不要求尾部填充时已对齐的帧直接回调不拷贝，未对齐的帧拷贝后回调，且写回生效；默认每帧拷贝以保证填充 */
+  void TestObserverCopiesOnlyMisalignedFrames()
+  {
+    for (int f = 0; f < kFormatCount; ++f) {
+      RecordingObserver observer;
+      AliEngineAlignedVideoFrameObserver wrapper(&observer, false);
+      std::vector<uint8_t> storage;
+      AliEngineVideoRawData frame;
+      internal::VideoPlanes planes;
+
+      MakeSource(kFormats[f], 128, 32, 0, storage, frame);
+      ALI_CHECK(internal::ResolveVideoPlanes(frame, planes));
+      wrapper.OnCaptureVideoSample(AliEngineVideoSourceCamera, frame);
+      ALI_CHECK(observer.seen == (planes.packed ? planes.packed : planes.y));
+      ALI_CHECK(observer.aligned);
+
+      MakeSource(kFormats[f], 128, 32, 1, storage, frame);
+      ALI_CHECK(internal::ResolveVideoPlanes(frame, planes));
+      wrapper.OnCaptureVideoSample(AliEngineVideoSourceCamera, frame);
+      ALI_CHECK(observer.seen != (planes.packed ? planes.packed : planes.y));
+      ALI_CHECK(observer.aligned);
+
+      ALI_CHECK(wrapper.OnPreEncodeVideoSample(AliEngineVideoSourceCamera, frame));
+      ALI_CHECK_EQ((planes.packed ? planes.packed : planes.y)[0], 0xA5);
+
+      AliEngineAlignedVideoFrameObserver padded(&observer);
+      MakeSource(kFormats[f], 128, 32, 0, storage, frame);
+      ALI_CHECK(internal::ResolveVideoPlanes(frame, planes));
+      padded.OnCaptureVideoSample(AliEngineVideoSourceCamera, frame);
+      ALI_CHECK(observer.seen != (planes.packed ? planes.packed : planes.y));
+      ALI_CHECK(observer.aligned);
+    }
+  }
+}
+
+int main()
+{
+  TestLayoutForEveryFormat();
+  TestObserverCopiesOnlyMisalignedFrames();
+  printf("video_aligned_frame_test passed\n");
+  return 0;
+}
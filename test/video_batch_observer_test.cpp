@@ -0,0 +1,154 @@
+#include <thread>
+#include <vector>
+
+#include "engine_video_batch_observer.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  struct BatchRecorder : public IVideoFrameBatchObserver {
+    std::vector<std::string> uids;
+    std::vector<long long> timeStamps;
+
+    void OnRemoteVideoBatch(const AliEngineRemoteVideoBatchItem* items, int count, long long) override
+    {
+      uids.clear();
+      timeStamps.clear();
+      for (int i = 0; i < count; ++i) {
+        uids.push_back(items[i].uid);
+        timeStamps.push_back(items[i].timeStamp);
+        const uint8_t* y = static_cast<const uint8_t*>(items[i].frame->dataYPtr);
+        ALI_CHECK(y[0] == static_cast<uint8_t>(items[i].timeStamp));
+      }
+    }
+  };
+
+  struct Frame {
+    std::vector<uint8_t> storage;
+    AliEngineVideoRawData raw;
+
+    Frame(int width, int height) : storage(AliEngineVideoFrameBufferSize(AliEngineVideoFormatI420, width, height))
+    {
+      AliEngineVideoFrameAttachBuffer(raw, storage.data(), AliEngineVideoFormatI420, width, height);
+    }
+
+    AliEngineVideoRawData& Stamp(long long timeStamp)
+    {
+      memset(storage.data(), static_cast<uint8_t>(timeStamp), storage.size());
+      raw.timeStamp = timeStamp;
+      return raw;
+    }
+  };
+
+  /* 反复加入、离开超过 maxStreams 个不同用户，位置应被复用，不丢新用户的帧 */
+  void TestChurnReusesSlots()
+  {
+    const int kMaxStreams = 32;
+    BatchRecorder recorder;
+    AliEngineBatchedVideoFrameObserver observer(&recorder, kMaxStreams);
+    Frame frame(64, 48);
+    char uid[32];
+    for (int user = 0; user < kMaxStreams * 8; ++user) {
+      snprintf(uid, sizeof(uid), "user%d", user);
+      observer.OnRemoteVideoSample(uid, AliEngineVideoSourceCamera, frame.Stamp(user + 1));
+      ALI_CHECK_EQ(observer.Tick(), 1);
+      ALI_CHECK(recorder.uids.size() == 1 && recorder.uids[0] == uid);
+      observer.RemoveUser(uid);
+      ALI_CHECK_EQ(observer.Tick(), 0);
+    }
+    ALI_CHECK_EQ(observer.GetRejectedFrameCount(), 0);
+  }
+
+  /* 同时在线达到上限后新用户被拒绝，有人离开后可以加入 */
+  void TestFullTableThenLeave()
+  {
+    BatchRecorder recorder;
+    AliEngineBatchedVideoFrameObserver observer(&recorder, 4);
+    Frame frame(32, 32);
+    char uid[32];
+    for (int user = 0; user < 5; ++user) {
+      snprintf(uid, sizeof(uid), "u%d", user);
+      observer.OnRemoteVideoSample(uid, AliEngineVideoSourceCamera, frame.Stamp(user + 1));
+    }
+    ALI_CHECK_EQ(observer.Tick(), 4);
+    ALI_CHECK_EQ(observer.GetRejectedFrameCount(), 1);
+    observer.RemoveUser("u1");
+    observer.Tick();
+    observer.OnRemoteVideoSample("u4", AliEngineVideoSourceCamera, frame.Stamp(40));
+    ALI_CHECK_EQ(observer.Tick(), 4);
+    ALI_CHECK(recorder.uids[1] == "u4" && recorder.timeStamps[1] == 40);
+  }
+
+  /* 用户离开后重新加入，不应收到离开前的旧帧 */
+  void TestRejoinDoesNotSeeStaleFrame()
+  {
+    BatchRecorder recorder;
+    AliEngineBatchedVideoFrameObserver observer(&recorder, 2);
+    Frame frame(32, 32);
+    observer.OnRemoteVideoSample("alice", AliEngineVideoSourceCamera, frame.Stamp(7));
+    ALI_CHECK_EQ(observer.Tick(), 1);
+    observer.RemoveUser("alice");
+    observer.Tick();
+    observer.OnRemoteVideoSample("bob", AliEngineVideoSourceCamera, frame.Stamp(9));
+    observer.OnRemoteVideoSample("alice", AliEngineVideoSourceCamera, frame.Stamp(11));
+    ALI_CHECK_EQ(observer.Tick(), 2);
+    for (size_t i = 0; i < recorder.uids.size(); ++i) {
+      ALI_CHECK(recorder.timeStamps[i] == (recorder.uids[i] == "alice" ? 11 : 9));
+    }
+    /* 复用的位置在新帧到达前不输出 */
+    observer.RemoveUser("bob");
+    observer.Tick();
+    observer.RemoveUser("alice");
+    observer.Tick();
+    ALI_CHECK_EQ(observer.Tick(), 0);
+  }
+
+  /* 引擎线程持续推帧、渲染线程 Tick、控制线程反复移除时的并发 */
+  void TestConcurrentChurn()
+  {
+    BatchRecorder recorder;
+    AliEngineBatchedVideoFrameObserver observer(&recorder, 8);
+    std::atomic<bool> running(true);
+    std::vector<std::thread> engines;
+    for (int t = 0; t < 4; ++t) {
+      engines.push_back(std::thread([&observer, &running, t]() {
+        Frame frame(32, 32);
+        char uid[32];
+        long long timeStamp = 0;
+        while (running.load()) {
+          snprintf(uid, sizeof(uid), "t%d-u%lld", t, (timeStamp / 50) % 6);
+          observer.OnRemoteVideoSample(uid, AliEngineVideoSourceCamera, frame.Stamp(++timeStamp));
+        }
+      }));
+    }
+    std::thread control([&observer, &running]() {
+      char uid[32];
+      for (int round = 0; running.load(); ++round) {
+        snprintf(uid, sizeof(uid), "t%d-u%d", round % 4, (round / 4) % 6);
+        observer.RemoveUser(uid);
+        std::this_thread::yield();
+      }
+    });
+    for (int tick = 0; tick < 500; ++tick) {
+      observer.Tick();
+      std::this_thread::yield();
+    }
+    running.store(false);
+    for (size_t t = 0; t < engines.size(); ++t) {
+      engines[t].join();
+    }
+    control.join();
+  }
+}
+
+int main()
+{
+  TestChurnReusesSlots();
+  TestFullTableThenLeave();
+  TestRejoinDoesNotSeeStaleFrame();
+  TestConcurrentChurn();
+  printf("video_batch_observer_test passed\n");
+  return 0;
+}
@@ -0,0 +1,209 @@
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "engine_video_frame_pool.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 统计全局 operator new 的调用次数，检查预热之后获取、归还帧不分配内存 */
+namespace
+{
+  std::atomic<long long> g_allocations(0);
+}
+
+void* operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+namespace
+{
+  enum { kWidth = 320, kHeight = 180, kCapacity = 4 };
+
+  /* 归还的帧被下一次 Acquire 取回：同一块内存、内容保留、时间戳和旋转角度清零 */
+  void TestReuse()
+  {
+    AliEngineVideoFramePool pool(AliEngineVideoFormatI420, kWidth, kHeight, kCapacity, 64);
+    AliEngineVideoFrameBuffer* first = pool.Acquire();
+    ALI_CHECK(first != nullptr);
+    ALI_CHECK_EQ(first->RefCount(), 1);
+    ALI_CHECK_EQ(first->Frame().width, kWidth);
+    ALI_CHECK_EQ(first->Frame().height, kHeight);
+    ALI_CHECK_EQ(first->Frame().strideY % 64, 0);
+    uint8_t* const data = static_cast<uint8_t*>(first->Frame().dataYPtr);
+    memset(data, 77, kWidth);
+    first->Frame().timeStamp = 1234;
+    first->Frame().rotation = 90;
+
+    /* 多个持有者共享，最后一次 Release 才归还 */
+    first->AddRef();
+    first->Release();
+    ALI_CHECK_EQ(pool.OutstandingCount(), 1);
+    first->Release();
+    ALI_CHECK_EQ(pool.OutstandingCount(), 0);
+
+    AliEngineVideoFrameBuffer* again = pool.Acquire();
+    ALI_CHECK(again == first);
+    ALI_CHECK(again->Frame().dataYPtr == data);
+    ALI_CHECK_EQ(data[kWidth - 1], 77);
+    ALI_CHECK_EQ(again->Frame().timeStamp, 0);
+    ALI_CHECK_EQ(again->Frame().rotation, 0);
+    ALI_CHECK_EQ(pool.AllocatedCount(), 1);
+    ALI_CHECK_EQ(pool.ReuseCount(), 1u);
+    again->Release();
+  }
+
+  /* 容量用满后 Acquire 返回空，归还一帧后又可取得 */
+  void TestCapacity()
+  {
+    AliEngineVideoFramePool pool(AliEngineVideoFormatNV12, kWidth, kHeight, kCapacity);
+    AliEngineVideoFrameBuffer* frames[kCapacity];
+    for (int i = 0; i < kCapacity; ++i) {
+      frames[i] = pool.Acquire();
+      ALI_CHECK(frames[i] != nullptr);
+    }
+    ALI_CHECK(pool.Acquire() == nullptr);
+    ALI_CHECK_EQ(pool.OutstandingCount(), kCapacity);
+    frames[2]->Release();
+    frames[2] = pool.Acquire();
+    ALI_CHECK(frames[2] != nullptr);
+    ALI_CHECK_EQ(pool.AllocatedCount(), kCapacity);
+    for (int i = 0; i < kCapacity; ++i) {
+      frames[i]->Release();
+    }
+    ALI_CHECK_EQ(pool.OutstandingCount(), 0);
+  }
+
+  /* 预热（同时持有的帧数达到峰值）之后，按滑动窗口持有、归还帧不再分配帧或堆内存 */
+  void TestNoGrowthAfterWarmUp()
+  {
+    AliEngineVideoFramePool pool(AliEngineVideoFormatI420, kWidth, kHeight, kCapacity);
+    AliEngineVideoFrameBuffer* held[3] = {};
+    for (int i = 0; i < 3; ++i) {
+      held[i] = pool.Acquire();
+    }
+    for (int i = 0; i < 3; ++i) {
+      held[i]->Release();
+      held[i] = nullptr;
+    }
+    const int allocated = pool.AllocatedCount();
+    ALI_CHECK_EQ(allocated, 3);
+    const long long before = g_allocations.load();
+    for (int n = 0; n < 1000; ++n) {
+      AliEngineVideoFrameBuffer* &slot = held[n % 3];
+      if (slot) {
+        slot->Release();
+      }
+      slot = pool.Acquire();
+      ALI_CHECK(slot != nullptr);
+    }
+    ALI_CHECK_EQ(g_allocations.load() - before, 0);
+    ALI_CHECK_EQ(pool.AllocatedCount(), allocated);
+    ALI_CHECK(pool.ReuseCount() >= 1000u);
+    for (int i = 0; i < 3; ++i) {
+      held[i]->Release();
+    }
+  }
+
+  /* 采集线程获取、推流线程归还，帧数不超过同时在途的上限 */
+  void TestCrossThreadRelease()
+  {
+    AliEngineVideoFramePool pool(AliEngineVideoFormatI420, kWidth, kHeight, kCapacity);
+    std::mutex lock;
+    std::deque<AliEngineVideoFrameBuffer*> queue;
+    std::atomic<bool> done(false);
+    std::thread consumer([&]() {
+      for (;;) {
+        AliEngineVideoFrameBuffer* frame = nullptr;
+        {
+          std::lock_guard<std::mutex> guard(lock);
+          if (!queue.empty()) {
+            frame = queue.front();
+            queue.pop_front();
+          }
+        }
+        if (frame) {
+          frame->Release();
+        } else if (done.load()) {
+          return;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+    int produced = 0;
+    while (produced < 2000) {
+      AliEngineVideoFrameBuffer* frame = pool.Acquire();
+      if (!frame) {
+        std::this_thread::yield();
+        continue;
+      }
+      frame->Frame().timeStamp = produced++;
+      std::lock_guard<std::mutex> guard(lock);
+      queue.push_back(frame);
+    }
+    done.store(true);
+    consumer.join();
+    ALI_CHECK_EQ(pool.OutstandingCount(), 0);
+    ALI_CHECK(pool.AllocatedCount() <= kCapacity);
+    ALI_CHECK_EQ(pool.ReuseCount(), static_cast<uint64_t>(2000 - pool.AllocatedCount()));
+  }
+
+  /* 池先于帧销毁，最后一次 Release 释放内存；外部数据包装在归零时回调 */
+  void TestOutlivesPool()
+  {
+    AliEngineVideoFrameBuffer* frame = nullptr;
+    {
+      AliEngineVideoFramePool pool(AliEngineVideoFormatBGRA, kWidth, kHeight, kCapacity);
+      frame = pool.Acquire();
+      AliEngineVideoFrameBuffer* idle = pool.Acquire();
+      idle->Release();
+    }
+    memset(frame->Frame().dataPtr, 1, kWidth * 4);
+    frame->Release();
+
+    struct Counter {
+      static void OnRelease(void* opaque, const AliEngineVideoRawData &frame) { ++*static_cast<int*>(opaque); }
+    };
+    int released = 0;
+    AliEngineVideoRawData raw;
+    AliEngineVideoFrameBuffer* wrapped = AliEngineVideoFrameBuffer::Wrap(raw, &Counter::OnRelease, &released);
+    wrapped->AddRef();
+    wrapped->Release();
+    ALI_CHECK_EQ(released, 0);
+    wrapped->Release();
+    ALI_CHECK_EQ(released, 1);
+  }
+}
+
+int main()
+{
+  TestReuse();
+  TestCapacity();
+  TestNoGrowthAfterWarmUp();
+  TestCrossThreadRelease();
+  TestOutlivesPool();
+  printf("video_frame_pool_test passed\n");
+  return 0;
+}
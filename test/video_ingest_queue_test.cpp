@@ -0,0 +1,183 @@
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "engine_video_ingest_queue.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  /* 阀门关闭时返回 buffer 满，记录成功投递的帧序号 */
+  struct GatedSink {
+    std::atomic<bool> open{false};
+    std::atomic<int> calls{0};
+    std::mutex lock;
+    std::vector<long long> delivered;
+
+    static int Push(void* opaque, const AliEngineVideoRawData &frame, AliEngineVideoTrack track)
+    {
+      GatedSink* sink = static_cast<GatedSink*>(opaque);
+      sink->calls.fetch_add(1);
+      if (!sink->open.load()) {
+        return AliEngineErrorVideoBufferFull;
+      }
+      std::lock_guard<std::mutex> guard(sink->lock);
+      sink->delivered.push_back(frame.timeStamp);
+      return 0;
+    }
+  };
+
+  std::atomic<int> g_released(0);
+
+  void OnRelease(void* opaque, const AliEngineVideoRawData &frame)
+  {
+    g_released.fetch_add(1);
+  }
+
+  int EnqueueFrame(AliEngineVideoIngestQueue &queue, long long id, bool reference)
+  {
+    AliEngineVideoRawData raw;
+    raw.timeStamp = id;
+    AliEngineVideoFrameBuffer* frame = AliEngineVideoFrameBuffer::Wrap(raw, OnRelease, nullptr);
+    const int result = queue.Enqueue(frame, reference);
+    frame->Release();
+    return result;
+  }
+
+  void WaitFor(const std::atomic<int> &value, int target)
+  {
+    for (int i = 0; i < 2000 && value.load() < target; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  /* 队列满时拒绝新帧，已入队的参考帧按顺序全部投递 */
+  void TestDropNonReferenceNeverEvictsReferenceFrames()
+  {
+    GatedSink sink;
+    AliEngineVideoIngestConfig config;
+    config.capacity = 4;
+    config.policy = AliEngineVideoIngestDropNonReference;
+    config.retryIntervalMs = 1;
+    config.maxFrameAgeMs = 10000;
+    AliEngineVideoIngestQueue queue(GatedSink::Push, &sink, AliEngineVideoTrackCamera, config);
+    queue.Start();
+    ALI_CHECK_EQ(EnqueueFrame(queue, 0, true), AliEngineVideoIngestQueued);
+    /* 投递线程取走第 0 帧后在重试中等待 */
+    WaitFor(sink.calls, 1);
+    for (int i = 1; i <= 4; ++i) {
+      ALI_CHECK_EQ(EnqueueFrame(queue, i, true), AliEngineVideoIngestQueued);
+    }
+    ALI_CHECK_EQ(EnqueueFrame(queue, 5, true), AliEngineVideoIngestDropped);
+    ALI_CHECK_EQ(EnqueueFrame(queue, 6, false), AliEngineVideoIngestDropped);
+    sink.open.store(true);
+    for (int i = 0; i < 2000 && queue.GetStats().deliveredFrames < 5; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    queue.Stop();
+    const AliEngineVideoIngestStats stats = queue.GetStats();
+    ALI_CHECK_EQ(stats.deliveredFrames, 5);
+    ALI_CHECK_EQ(stats.droppedOldestFrames, 0);
+    ALI_CHECK_EQ(stats.droppedNewFrames, 1);
+    ALI_CHECK_EQ(stats.droppedNonReferenceFrames, 1);
+    ALI_CHECK_EQ(sink.delivered.size(), 5);
+    for (int i = 0; i < 5; ++i) {
+      ALI_CHECK_EQ(sink.delivered[i], i);
+    }
+  }
+
+  /* 非参考帧积压到上限后，参考帧仍能使用预留空位入队并被投递 */
+  void TestDropNonReferenceAdmitsReferenceWhenBacklogged()
+  {
+    GatedSink sink;
+    AliEngineVideoIngestConfig config;
+    config.capacity = 4;
+    config.policy = AliEngineVideoIngestDropNonReference;
+    config.retryIntervalMs = 1;
+    config.maxFrameAgeMs = 10000;
+    AliEngineVideoIngestQueue queue(GatedSink::Push, &sink, AliEngineVideoTrackCamera, config);
+    queue.Start();
+    ALI_CHECK_EQ(EnqueueFrame(queue, 0, true), AliEngineVideoIngestQueued);
+    WaitFor(sink.calls, 1);
+    /* 容量 4 的队列最多容纳 3 个非参考帧 */
+    for (int i = 1; i <= 3; ++i) {
+      ALI_CHECK_EQ(EnqueueFrame(queue, i, false), AliEngineVideoIngestQueued);
+    }
+    ALI_CHECK_EQ(EnqueueFrame(queue, 4, false), AliEngineVideoIngestDropped);
+    ALI_CHECK_EQ(EnqueueFrame(queue, 5, true), AliEngineVideoIngestQueued);
+    sink.open.store(true);
+    for (int i = 0; i < 2000 && queue.GetStats().deliveredFrames + queue.GetStats().droppedNonReferenceFrames < 6; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    queue.Stop();
+    const AliEngineVideoIngestStats stats = queue.GetStats();
+    ALI_CHECK_EQ(stats.droppedNewFrames, 0);
+    ALI_CHECK_EQ(stats.deliveredFrames + stats.droppedNonReferenceFrames, 6);
+    ALI_CHECK(!sink.delivered.empty());
+    ALI_CHECK_EQ(sink.delivered.front(), 0);
+    ALI_CHECK_EQ(sink.delivered.back(), 5);
+  }
+
+  /* Stop 返回后队列为空，与之并发的 Enqueue 不会把帧留在队列中 */
+  void TestStopDrainsConcurrentEnqueue()
+  {
+    GatedSink sink;
+    AliEngineVideoIngestConfig config;
+    config.capacity = 64;
+    config.retryIntervalMs = 1;
+    AliEngineVideoIngestQueue queue(GatedSink::Push, &sink, AliEngineVideoTrackCamera, config);
+    const int before = g_released.load();
+    std::atomic<bool> running(true);
+    std::atomic<int> created(0);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 3; ++t) {
+      producers.push_back(std::thread([&queue, &running, &created]() {
+        while (running.load()) {
+          created.fetch_add(1);
+          EnqueueFrame(queue, 0, true);
+        }
+      }));
+    }
+    for (int round = 0; round < 200; ++round) {
+      queue.Start();
+      std::this_thread::yield();
+      queue.Stop();
+      ALI_CHECK_EQ(queue.GetStats().queueDepth, 0);
+    }
+    running.store(false);
+    for (size_t i = 0; i < producers.size(); ++i) {
+      producers[i].join();
+    }
+    ALI_CHECK_EQ(g_released.load() - before, created.load());
+  }
+
+  /* 低速入队时投递线程被及时唤醒，而不是等到 20 ms 的兜底超时 */
+  void TestConsumerWakeup()
+  {
+    GatedSink sink;
+    sink.open.store(true);
+    AliEngineVideoIngestQueue queue(GatedSink::Push, &sink, AliEngineVideoTrackCamera);
+    queue.Start();
+    for (int i = 0; i < 50; ++i) {
+      EnqueueFrame(queue, i, true);
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    queue.Stop();
+    const AliEngineVideoIngestStats stats = queue.GetStats();
+    ALI_CHECK_EQ(stats.deliveredFrames, 50);
+    ALI_CHECK(stats.avgLatencyUs < 10000);
+  }
+}
+
+int main()
+{
+  TestDropNonReferenceNeverEvictsReferenceFrames();
+  TestDropNonReferenceAdmitsReferenceWhenBacklogged();
+  TestStopDrainsConcurrentEnqueue();
+  TestConsumerWakeup();
+  printf("video_ingest_queue_test passed\n");
+  return 0;
+}
@@ -0,0 +1,169 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include "engine_video_pyramid.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+/* 统计全局 operator new 的调用次数，检查稳定状态下逐帧构建不分配内存 */
+namespace
+{
+  std::atomic<long long> g_allocations(0);
+}
+
+void* operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+namespace
+{
+  const AliEngineVideoFormat kFormats[] = {AliEngineVideoFormatBGRA, AliEngineVideoFormatI420, AliEngineVideoFormatNV12,
+                                           AliEngineVideoFormatI422};
+  const AliEngineVideoPyramidFilter kFilters[] = {AliEngineVideoPyramidFilterBox, AliEngineVideoPyramidFilterBilinear,
+                                                  AliEngineVideoPyramidFilterLanczos};
+
+  /* 亮度/打包平面填 90，色度按行从 20 线性增加到 220 */
+  void FillFrame(std::vector<uint8_t> &buffer, AliEngineVideoRawData &frame, AliEngineVideoFormat format, int width, int height)
+  {
+    buffer.assign(AliEngineVideoFrameBufferSize(format, width, height), 90);
+    AliEngineVideoFrameAttachBuffer(frame, &buffer[0], format, width, height);
+    internal::VideoPlanes planes;
+    ALI_CHECK(internal::ResolveVideoPlanes(frame, planes));
+    if (planes.packed) {
+      return;
+    }
+    const int cw = (width + 1) / 2;
+    const int ch = format == AliEngineVideoFormatI422 ? height : (height + 1) / 2;
+    const int bytes = internal::IsSemiPlanarFormat(format) ? cw * 2 : cw;
+    for (int y = 0; y < ch; ++y) {
+      const uint8_t value = static_cast<uint8_t>(20 + 200 * y / (ch - 1));
+      memset(planes.u + static_cast<size_t>(y) * planes.strideU, value, bytes);
+      if (planes.v) {
+        memset(planes.v + static_cast<size_t>(y) * planes.strideV, value, bytes);
+      }
+    }
+  }
+
+  void CheckLevel(const AliEngineVideoRawData &level)
+  {
+    internal::VideoPlanes planes;
+    ALI_CHECK(internal::ResolveVideoPlanes(level, planes));
+    const uint8_t* first = planes.packed ? planes.packed : planes.y;
+    const int stride = planes.packed ? planes.stride : planes.strideY;
+    const int bytes = planes.packed ? level.width * 4 : level.width;
+    for (int y = 0; y < level.height; ++y) {
+      for (int x = 0; x < bytes; ++x) {
+        ALI_CHECK_EQ(first[static_cast<size_t>(y) * stride + x], 90);
+      }
+    }
+    if (planes.packed) {
+      return;
+    }
+    const int cw = (level.width + 1) / 2;
+    const int ch = level.format == AliEngineVideoFormatI422 ? level.height : (level.height + 1) / 2;
+    const int chromaBytes = internal::IsSemiPlanarFormat(level.format) ? cw * 2 : cw;
+    for (int y = 0; y < ch; ++y) {
+      const double expected = 20 + 200.0 * (y + 0.5) / ch;
+      for (int x = 0; x < chromaBytes; ++x) {
+        ALI_CHECK(fabs(planes.u[static_cast<size_t>(y) * planes.strideU + x] - expected) <= 8);
+        if (planes.v) {
+          ALI_CHECK(fabs(planes.v[static_cast<size_t>(y) * planes.strideV + x] - expected) <= 8);
+        }
+      }
+    }
+  }
+
+  /* 同一尺寸下切换格式（I422/I420/BGRA/NV12）须重建滤波表，色度几何正确且不越界 */
+  void TestSameSizeFormatSwitch()
+  {
+    const int width = 640, height = 360;
+    const AliEngineVideoFormat sequence[] = {AliEngineVideoFormatI422, AliEngineVideoFormatI420, AliEngineVideoFormatBGRA,
+                                             AliEngineVideoFormatI420, AliEngineVideoFormatNV12, AliEngineVideoFormatI422};
+    for (int k = 0; k < 3; ++k) {
+      AliEngineVideoPyramidConfig config;
+      config.filter = kFilters[k];
+      AliEngineVideoPyramid pyramid(config);
+      const int levels[] = {pyramid.AddLevel(320, 180), pyramid.AddLevel(160, 90)};
+      for (size_t i = 0; i < sizeof(sequence) / sizeof(sequence[0]); ++i) {
+        std::vector<uint8_t> buffer;
+        AliEngineVideoRawData src;
+        FillFrame(buffer, src, sequence[i], width, height);
+        ALI_CHECK(pyramid.Build(src));
+        for (int l = 0; l < 2; ++l) {
+          const AliEngineVideoRawData* level = pyramid.Level(levels[l]);
+          ALI_CHECK(level != nullptr);
+          ALI_CHECK_EQ(level->format, sequence[i]);
+          CheckLevel(*level);
+        }
+      }
+    }
+  }
+
+  /* 首帧之后的构建不再分配内存；均匀颜色经各级缩放后保持不变 */
+  void TestSteadyStateDoesNotAllocate()
+  {
+    const int width = 1280, height = 720;
+    for (int f = 0; f < 4; ++f) {
+      for (int k = 0; k < 3; ++k) {
+        AliEngineVideoPyramidConfig config;
+        config.filter = kFilters[k];
+        config.threads = 3;
+        AliEngineVideoPyramid pyramid(config);
+        const int levels[] = {pyramid.AddLevel(640, 360), pyramid.AddLevel(320, 180), pyramid.AddLevel(161, 91),
+                              pyramid.AddLevel(1280, 720)};
+        std::vector<uint8_t> buffer(AliEngineVideoFrameBufferSize(kFormats[f], width, height), 90);
+        AliEngineVideoRawData src;
+        AliEngineVideoFrameAttachBuffer(src, &buffer[0], kFormats[f], width, height);
+        ALI_CHECK(pyramid.Build(src));
+        const long long before = g_allocations.load();
+        for (int n = 0; n < 5; ++n) {
+          ALI_CHECK(pyramid.Build(src));
+        }
+        ALI_CHECK_EQ(g_allocations.load() - before, 0);
+        for (int l = 0; l < 4; ++l) {
+          const AliEngineVideoRawData* level = pyramid.Level(levels[l]);
+          ALI_CHECK(level != nullptr);
+          internal::VideoPlanes planes;
+          ALI_CHECK(internal::ResolveVideoPlanes(*level, planes));
+          const uint8_t* first = planes.packed ? planes.packed : planes.y;
+          const int stride = planes.packed ? planes.stride : planes.strideY;
+          const int bytes = planes.packed ? level->width * 4 : level->width;
+          for (int y = 0; y < level->height; ++y) {
+            for (int x = 0; x < bytes; ++x) {
+              ALI_CHECK_EQ(first[static_cast<size_t>(y) * stride + x], 90);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+int main()
+{
+  TestSteadyStateDoesNotAllocate();
+  TestSameSizeFormatSwitch();
+  printf("video_pyramid_test passed\n");
+  return 0;
+}
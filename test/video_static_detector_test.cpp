@@ -0,0 +1,165 @@
+#include <string.h>
+#include <vector>
+
+#include "engine_video_static_detector.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  enum { kWidth = 320, kHeight = 192 };
+
+  struct StaticListener : public AliEngineEventListener {
+    int enter = 0;
+    int leave = 0;
+    void OnPublishStaticVideoFrame(AliEngineVideoTrack trackType, bool isStaticFrame) override
+    {
+      ALI_CHECK_EQ(trackType, AliEngineVideoTrackScreen);
+      ++(isStaticFrame ? enter : leave);
+    }
+  };
+
+  struct Frame {
+    std::vector<uint8_t> buffer;
+    AliEngineVideoRawData raw;
+    AliEngineVideoFormat format;
+
+    explicit Frame(AliEngineVideoFormat f) : format(f)
+    {
+      buffer.assign(AliEngineVideoFrameBufferSize(format, kWidth, kHeight), 100);
+      AliEngineVideoFrameAttachBuffer(raw, &buffer[0], format, kWidth, kHeight);
+    }
+
+    /* 在亮度平面（BGRA 为全部通道）的 [x, x+size) x [y, y+size) 区域加 delta */
+    void Add(int x, int y, int size, int delta)
+    {
+      const bool packed = format == AliEngineVideoFormatBGRA;
+      const int stride = packed ? kWidth * 4 : kWidth;
+      const int bpp = packed ? 4 : 1;
+      for (int row = y; row < y + size; ++row) {
+        for (int col = x * bpp; col < (x + size) * bpp; ++col) {
+          uint8_t &p = buffer[static_cast<size_t>(row) * stride + col];
+          p = static_cast<uint8_t>(p + delta);
+        }
+      }
+    }
+  };
+
+  /*
+   * 原图 8x8 区域改变 delta，下采样后为同一分块内的 4x4 个像素，SAD = 16 * delta：
+   * 各阈值下 SAD 超过阈值才计为变化块
+   */
+  void TestChangedBlocksAcrossThresholds()
+  {
+    const int thresholds[] = {0, 64, 255, 1024};
+    const int deltas[] = {1, 4, 16, 64, 65};
+    for (size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); ++t) {
+      for (size_t d = 0; d < sizeof(deltas) / sizeof(deltas[0]); ++d) {
+        AliEngineStaticFrameConfig config;
+        config.blockSadThreshold = thresholds[t];
+        AliEngineStaticFrameDetector detector(config);
+        Frame frame(AliEngineVideoFormatI420);
+        ALI_CHECK_EQ(detector.Process(frame.raw, 0), AliEngineStaticFrameEncode);
+        ALI_CHECK_EQ(detector.GetStats().totalBlocks, (kWidth / 32) * (kHeight / 32));
+        frame.Add(40, 72, 8, deltas[d]);
+        const bool changed = 16 * deltas[d] > thresholds[t];
+        detector.Process(frame.raw, 10);
+        ALI_CHECK_EQ(detector.GetStats().lastChangedBlocks, changed ? 1 : 0);
+      }
+    }
+  }
+
+  /* 变化块数不超过 maxChangedBlocks 时仍视为未变化 */
+  void TestMaxChangedBlocks()
+  {
+    for (int allowed = 0; allowed <= 3; ++allowed) {
+      AliEngineStaticFrameConfig config;
+      config.maxChangedBlocks = allowed;
+      config.framesToStatic = 1;
+      AliEngineStaticFrameDetector detector(config);
+      Frame frame(AliEngineVideoFormatNV12);
+      detector.Process(frame.raw, 0);
+      /* 三个不同分块各改变一处 */
+      frame.Add(0, 0, 8, 50);
+      frame.Add(64, 0, 8, 50);
+      frame.Add(128, 64, 8, 50);
+      const AliEngineStaticFrameDecision decision = detector.Process(frame.raw, 10);
+      ALI_CHECK_EQ(detector.GetStats().lastChangedBlocks, 3);
+      ALI_CHECK_EQ(decision, allowed >= 3 ? AliEngineStaticFrameSkip : AliEngineStaticFrameEncode);
+    }
+  }
+
+  /*
+   * 相同画面连续 framesToStatic 帧后进入静止：跳过其余帧，按保活间隔送出；
+   * 画面变化时立即退出静止并送出，进入和退出各回调一次
+   */
+  void TestStaticAndKeepAlive()
+  {
+    const AliEngineVideoFormat formats[] = {AliEngineVideoFormatI420, AliEngineVideoFormatNV12, AliEngineVideoFormatBGRA};
+    for (int f = 0; f < 3; ++f) {
+      StaticListener listener;
+      AliEngineStaticFrameDetector detector(AliEngineStaticFrameConfig(), &listener);
+      Frame frame(formats[f]);
+      long long now = 0;
+      ALI_CHECK_EQ(detector.Process(frame.raw, now), AliEngineStaticFrameEncode);
+      ALI_CHECK_EQ(detector.Process(frame.raw, now += 100), AliEngineStaticFrameEncode);
+      ALI_CHECK_EQ(detector.Process(frame.raw, now += 100), AliEngineStaticFrameEncode);
+      ALI_CHECK(!detector.GetStats().isStatic);
+      ALI_CHECK_EQ(detector.Process(frame.raw, now += 100), AliEngineStaticFrameSkip);
+      ALI_CHECK(detector.GetStats().isStatic);
+      ALI_CHECK_EQ(listener.enter, 1);
+      int skipped = 1;
+      while (detector.Process(frame.raw, now += 100) == AliEngineStaticFrameSkip) {
+        ++skipped;
+      }
+      /* 最后一次送出在 200 ms，1200 ms 时保活 */
+      ALI_CHECK_EQ(now, 1200);
+      ALI_CHECK_EQ(skipped, 9);
+      ALI_CHECK_EQ(detector.GetStats().keepAliveFrames, 1u);
+
+      frame.Add(100, 100, 4, 40);
+      ALI_CHECK_EQ(detector.Process(frame.raw, now += 100), AliEngineStaticFrameEncode);
+      ALI_CHECK(!detector.GetStats().isStatic);
+      ALI_CHECK_EQ(listener.leave, 1);
+      const AliEngineStaticFrameStats stats = detector.GetStats();
+      ALI_CHECK_EQ(stats.totalFrames, 14u);
+      ALI_CHECK_EQ(stats.skippedFrames, 9u);
+      ALI_CHECK_EQ(stats.staticTransitions, 1u);
+    }
+  }
+
+  /* 静止期间以最后送出的帧为参考：每帧只变化一点、单帧低于阈值，累积超过阈值后仍会送出 */
+  void TestGradualChangeAccumulates()
+  {
+    AliEngineStaticFrameConfig config;
+    config.framesToStatic = 1;
+    AliEngineStaticFrameDetector detector(config);
+    Frame frame(AliEngineVideoFormatI420);
+    detector.Process(frame.raw, 0);
+    int encoded = 0;
+    for (int i = 1; i <= 12; ++i) {
+      /* 每帧 SAD = 16，阈值 64，相对参考第 5 帧累积到 80 */
+      frame.Add(40, 72, 8, 1);
+      const AliEngineStaticFrameDecision decision = detector.Process(frame.raw, i * 10);
+      if (i % 5 == 0) {
+        ALI_CHECK_EQ(decision, AliEngineStaticFrameEncode);
+        ALI_CHECK_EQ(detector.GetStats().lastChangedBlocks, 1);
+        ++encoded;
+      } else {
+        ALI_CHECK_EQ(decision, AliEngineStaticFrameSkip);
+      }
+    }
+    ALI_CHECK_EQ(encoded, 2);
+  }
+}
+
+int main()
+{
+  TestChangedBlocksAcrossThresholds();
+  TestMaxChangedBlocks();
+  TestStaticAndKeepAlive();
+  TestGradualChangeAccumulates();
+  printf("video_static_detector_test passed\n");
+  return 0;
+}
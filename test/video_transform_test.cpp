@@ -0,0 +1,137 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "engine_video_transform.h"
+#include "test_util.h"
+
+using namespace AliRTCSdk;
+
+namespace
+{
+  const AliEngineVideoFormat kFormats[] = {AliEngineVideoFormatBGRA, AliEngineVideoFormatI420, AliEngineVideoFormatNV12};
+
+  /* 不缩放时逐像素等于裁剪、旋转、镜像后的源像素 */
+  void TestCropRotateMirrorExact()
+  {
+    const int width = 21, height = 13;
+    AliEngineVideoTransformer transformer;
+    for (int f = 0; f < 3; ++f) {
+      const AliEngineVideoFormat format = kFormats[f];
+      std::vector<uint8_t> source(AliEngineVideoFrameBufferSize(format, width, height));
+      for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<uint8_t>(i * 7 + 3);
+      }
+      AliEngineVideoRawData src;
+      AliEngineVideoFrameAttachBuffer(src, &source[0], format, width, height);
+      for (int rotation = 0; rotation < 360; rotation += 90) {
+        for (int mirror = 0; mirror < 2; ++mirror) {
+          AliEngineVideoTransformParam param;
+          param.cropX = 4;
+          param.cropY = 2;
+          param.cropWidth = 14;
+          param.cropHeight = 8;
+          param.rotation = static_cast<AliEngineRotationMode>(rotation);
+          param.mirror = mirror != 0;
+          const bool swapped = rotation == 90 || rotation == 270;
+          const int dw = swapped ? 8 : 14, dh = swapped ? 14 : 8;
+          std::vector<uint8_t> output(AliEngineVideoFrameBufferSize(format, dw, dh));
+          AliEngineVideoRawData dst;
+          AliEngineVideoFrameAttachBuffer(dst, &output[0], format, dw, dh);
+          ALI_CHECK_EQ(transformer.Transform(src, dst, param), AliEngineVideoConvertOk);
+          const int bpp = format == AliEngineVideoFormatBGRA ? 4 : 1;
+          for (int oy = 0; oy < dh; ++oy) {
+            for (int ox = 0; ox < dw; ++ox) {
+              const int mx = mirror ? dw - 1 - ox : ox;
+              const int uw = swapped ? dh : dw, uh = swapped ? dw : dh;
+              int ux = mx, uy = oy;
+              if (rotation == 90) {
+                ux = oy;
+                uy = uh - 1 - mx;
+              } else if (rotation == 180) {
+                ux = uw - 1 - mx;
+                uy = uh - 1 - oy;
+              } else if (rotation == 270) {
+                ux = uw - 1 - oy;
+                uy = mx;
+              }
+              for (int c = 0; c < bpp; ++c) {
+                ALI_CHECK_EQ(output[(oy * dw + ox) * bpp + c], source[((uy + 2) * width + ux + 4) * bpp + c]);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* 单像素棋盘缩小到1/3~1/8：盒式预滤波后应接近均值，不出现混叠条纹 */
+  void TestDownscaleDoesNotAlias()
+  {
+    const int width = 1920, height = 1080;
+    const int targets[][2] = {{640, 360}, {480, 270}, {240, 136}, {540, 960}};
+    AliEngineVideoTransformer transformer;
+    for (int f = 0; f < 3; ++f) {
+      const AliEngineVideoFormat format = kFormats[f];
+      std::vector<uint8_t> source(AliEngineVideoFrameBufferSize(format, width, height));
+      AliEngineVideoRawData src;
+      AliEngineVideoFrameAttachBuffer(src, &source[0], format, width, height);
+      internal::VideoPlanes planes;
+      ALI_CHECK(internal::ResolveVideoPlanes(src, planes));
+      uint8_t* luma = planes.packed ? planes.packed : planes.y;
+      const int bpp = planes.packed ? 4 : 1;
+      const int stride = planes.packed ? planes.stride : planes.strideY;
+      for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width * bpp; ++x) {
+          luma[static_cast<size_t>(y) * stride + x] = ((x / bpp + y) & 1) ? 255 : 0;
+        }
+      }
+      for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); ++t) {
+        AliEngineVideoTransformParam param;
+        param.rotation = targets[t][0] < targets[t][1] ? AliEngineRotationMode_90 : AliEngineRotationMode_0;
+        param.dstWidth = targets[t][0];
+        param.dstHeight = targets[t][1];
+        std::vector<uint8_t> output(AliEngineVideoFrameBufferSize(format, param.dstWidth, param.dstHeight));
+        AliEngineVideoRawData dst;
+        AliEngineVideoFrameAttachBuffer(dst, &output[0], format, param.dstWidth, param.dstHeight);
+        ALI_CHECK_EQ(transformer.Transform(src, dst, param), AliEngineVideoConvertOk);
+        for (int i = 0; i < param.dstWidth * param.dstHeight * bpp; ++i) {
+          ALI_CHECK(abs(output[i] - 128) <= 2);
+        }
+      }
+    }
+  }
+
+  /* 最近邻不做预滤波，缩小后仍是源中的取值 */
+  void TestNearestKeepsSourceValues()
+  {
+    const int width = 640, height = 360;
+    std::vector<uint8_t> source(AliEngineVideoFrameBufferSize(AliEngineVideoFormatI420, width, height));
+    for (size_t i = 0; i < source.size(); ++i) {
+      source[i] = (i & 1) ? 200 : 10;
+    }
+    AliEngineVideoRawData src;
+    AliEngineVideoFrameAttachBuffer(src, &source[0], AliEngineVideoFormatI420, width, height);
+    AliEngineVideoTransformParam param;
+    param.dstWidth = 160;
+    param.dstHeight = 90;
+    param.filter = AliEngineVideoFilterNearest;
+    std::vector<uint8_t> output(AliEngineVideoFrameBufferSize(AliEngineVideoFormatI420, 160, 90));
+    AliEngineVideoRawData dst;
+    AliEngineVideoFrameAttachBuffer(dst, &output[0], AliEngineVideoFormatI420, 160, 90);
+    AliEngineVideoTransformer transformer;
+    ALI_CHECK_EQ(transformer.Transform(src, dst, param), AliEngineVideoConvertOk);
+    for (int i = 0; i < 160 * 90; ++i) {
+      ALI_CHECK(output[i] == 200 || output[i] == 10);
+    }
+  }
+}
+
+int main()
+{
+  TestCropRotateMirrorExact();
+  TestDownscaleDoesNotAlias();
+  TestNearestKeepsSourceValues();
+  printf("video_transform_test passed\n");
+  return 0;
+}